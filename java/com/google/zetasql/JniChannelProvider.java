@@ -18,9 +18,18 @@
 package com.google.zetasql;
 
 import com.google.auto.service.AutoService;
+import com.google.protobuf.CodedOutputStream;
+import com.google.protobuf.InvalidProtocolBufferException;
+import com.google.protobuf.MessageLite;
+import io.grpc.CallOptions;
 import io.grpc.Channel;
+import io.grpc.ClientCall;
 import io.grpc.LoadBalancerProvider;
 import io.grpc.LoadBalancerRegistry;
+import io.grpc.Metadata;
+import io.grpc.MethodDescriptor;
+import io.grpc.MethodDescriptor.PrototypeMarshaller;
+import io.grpc.Status;
 import io.grpc.netty.NettyChannelBuilder;
 import io.netty.channel.ChannelException;
 import io.netty.channel.nio.NioEventLoopGroup;
@@ -29,7 +38,13 @@ import io.netty.util.concurrent.DefaultThreadFactory;
 import java.io.IOException;
 import java.net.InetSocketAddress;
 import java.net.SocketAddress;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
 import java.nio.channels.SocketChannel;
+import java.nio.charset.StandardCharsets;
+import java.util.concurrent.ConcurrentHashMap;
+import java.util.concurrent.ConcurrentMap;
+import java.util.concurrent.Executor;
 
 /** Controller class of the ZetaSQL JniChannelProvider. */
 @AutoService(ClientChannelProvider.class)
@@ -83,6 +98,178 @@ public class JniChannelProvider implements ClientChannelProvider {
   /** Returns a SocketChannel connected to the server. */
   private static native SocketChannel getSocketChannel() throws IOException;
 
+  /** Returns the id of a unary method that can be called with callDirect, or -1. */
+  private static native int getDirectMethodId(String fullMethodName);
+
+  /**
+   * Calls unary method methodId on the request serialized in the first requestSize bytes of the
+   * direct buffer. Writes the status code as a native-endian int, followed by the serialized
+   * response or the error message, at the start of the buffer, and returns the size of the latter.
+   * If that does not fit in the buffer, it must be read with takeDirectResult before the next call
+   * on this thread.
+   */
+  private static native int callDirect(int methodId, ByteBuffer buffer, int requestSize);
+
+  /** Writes the result of the last callDirect that did not fit to the buffer, after the code. */
+  private static native void takeDirectResult(ByteBuffer buffer);
+
+  /**
+   * Serves unary calls by sharing a direct ByteBuffer with the native service, which reads the
+   * request from and writes the response to it in place. This skips the socketpair, the HTTP/2
+   * framing and the copies through the kernel. Other calls go through the socketpair channel.
+   */
+  protected static class DirectChannel extends Channel {
+    private static final int RESULT_HEADER_SIZE = Integer.BYTES;
+    private static final int INITIAL_BUFFER_SIZE = 64 * 1024;
+
+    // The buffer is reused by the calls on each thread, and grown as needed.
+    private static final ThreadLocal<ByteBuffer> buffers =
+        ThreadLocal.withInitial(() -> newBuffer(INITIAL_BUFFER_SIZE));
+
+    private final Channel socketChannel;
+    private final ConcurrentMap<String, Integer> methodIds = new ConcurrentHashMap<>();
+
+    DirectChannel(Channel socketChannel) {
+      this.socketChannel = socketChannel;
+    }
+
+    private static ByteBuffer newBuffer(int size) {
+      return ByteBuffer.allocateDirect(size).order(ByteOrder.nativeOrder());
+    }
+
+    private static ByteBuffer getBuffer(int minSize) {
+      ByteBuffer buffer = buffers.get();
+      if (buffer.capacity() < minSize) {
+        buffer = newBuffer(Math.max(minSize, 2 * buffer.capacity()));
+        buffers.set(buffer);
+      }
+      return buffer;
+    }
+
+    @Override
+    public String authority() {
+      return socketChannel.authority();
+    }
+
+    @Override
+    public <ReqT, RespT> ClientCall<ReqT, RespT> newCall(
+        MethodDescriptor<ReqT, RespT> method, CallOptions callOptions) {
+      if (method.getType() == MethodDescriptor.MethodType.UNARY
+          && method.getResponseMarshaller() instanceof PrototypeMarshaller) {
+        int methodId =
+            methodIds.computeIfAbsent(
+                method.getFullMethodName(), JniChannelProvider::getDirectMethodId);
+        if (methodId >= 0) {
+          return new DirectCall<>(method, methodId, callOptions);
+        }
+      }
+      return socketChannel.newCall(method, callOptions);
+    }
+
+    /** A unary call made with callDirect when the request is half closed. */
+    private static class DirectCall<ReqT, RespT> extends ClientCall<ReqT, RespT> {
+      private final MethodDescriptor<ReqT, RespT> method;
+      private final int methodId;
+      private final Executor executor;
+      private Listener<RespT> listener;
+      private ReqT request;
+      private boolean done = false;
+
+      DirectCall(MethodDescriptor<ReqT, RespT> method, int methodId, CallOptions callOptions) {
+        this.method = method;
+        this.methodId = methodId;
+        this.executor =
+            callOptions.getExecutor() != null ? callOptions.getExecutor() : Runnable::run;
+      }
+
+      @Override
+      public void start(Listener<RespT> listener, Metadata headers) {
+        this.listener = listener;
+      }
+
+      @Override
+      public void request(int numMessages) {}
+
+      @Override
+      public void sendMessage(ReqT message) {
+        request = message;
+      }
+
+      @Override
+      public void cancel(String message, Throwable cause) {
+        close(Status.CANCELLED.withDescription(message).withCause(cause), null);
+      }
+
+      @Override
+      public void halfClose() {
+        if (done) {
+          return;
+        }
+        if (request == null) {
+          close(Status.INTERNAL.withDescription("No request sent"), null);
+          return;
+        }
+
+        MessageLite requestMessage = (MessageLite) request;
+        int requestSize = requestMessage.getSerializedSize();
+        ByteBuffer buffer = getBuffer(Math.max(requestSize, RESULT_HEADER_SIZE));
+        buffer.clear();
+        try {
+          CodedOutputStream output = CodedOutputStream.newInstance(buffer);
+          requestMessage.writeTo(output);
+          output.flush();
+        } catch (IOException e) {
+          close(Status.INTERNAL.withCause(e), null);
+          return;
+        }
+
+        int resultSize = callDirect(methodId, buffer, requestSize);
+        if (resultSize > buffer.capacity() - RESULT_HEADER_SIZE) {
+          int code = buffer.getInt(0);
+          buffer = getBuffer(RESULT_HEADER_SIZE + resultSize);
+          buffer.putInt(0, code);
+          takeDirectResult(buffer);
+        }
+        Status status = Status.fromCodeValue(buffer.getInt(0));
+        ByteBuffer result = buffer.duplicate();
+        result.limit(RESULT_HEADER_SIZE + resultSize).position(RESULT_HEADER_SIZE);
+
+        if (!status.isOk()) {
+          close(status.withDescription(StandardCharsets.UTF_8.decode(result).toString()), null);
+          return;
+        }
+        @SuppressWarnings("unchecked")
+        RespT prototype =
+            ((PrototypeMarshaller<RespT>) method.getResponseMarshaller()).getMessagePrototype();
+        RespT response;
+        try {
+          @SuppressWarnings("unchecked")
+          RespT parsed = (RespT) ((MessageLite) prototype).getParserForType().parseFrom(result);
+          response = parsed;
+        } catch (InvalidProtocolBufferException e) {
+          close(Status.INTERNAL.withCause(e), null);
+          return;
+        }
+        close(Status.OK, response);
+      }
+
+      private void close(Status status, RespT response) {
+        if (done) {
+          return;
+        }
+        done = true;
+        executor.execute(
+            () -> {
+              listener.onHeaders(new Metadata());
+              if (response != null) {
+                listener.onMessage(response);
+              }
+              listener.onClose(status, new Metadata());
+            });
+      }
+    }
+  }
+
   /** Wraps one end of a socketpair for NioSocketChannel. */
   protected static class SocketPairChannel extends NioSocketChannel {
 
@@ -144,11 +331,16 @@ public class JniChannelProvider implements ClientChannelProvider {
   /** Create a new channel that can be used to call RPC of the ZetaSQL server. */
   @Override
   public Channel newChannel() {
-    return NettyChannelBuilder.forAddress(ADDRESS)
-        .channelType(SocketPairChannel.class)
-        .eventLoopGroup(getEventLoop())
-        // Disables encryption, not needed because the socketpair is in memory.
-        .usePlaintext()
-        .build();
+    Channel channel =
+        NettyChannelBuilder.forAddress(ADDRESS)
+            .channelType(SocketPairChannel.class)
+            .eventLoopGroup(getEventLoop())
+            // Disables encryption, not needed because the socketpair is in memory.
+            .usePlaintext()
+            .build();
+    if (Boolean.parseBoolean(System.getProperty("zetasql.local_service.direct_calls", "true"))) {
+      return new DirectChannel(channel);
+    }
+    return channel;
   }
 }
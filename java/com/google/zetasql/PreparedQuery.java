@@ -22,6 +22,7 @@ import static com.google.zetasql.Parameter.normalizeAndValidate;
 import static com.google.zetasql.Parameter.serialize;
 
 import com.google.common.base.Preconditions;
+import com.google.common.collect.AbstractIterator;
 import com.google.common.collect.ImmutableList;
 import com.google.common.collect.ImmutableMap;
 import com.google.errorprone.annotations.CanIgnoreReturnValue;
@@ -31,8 +32,11 @@ import com.google.zetasql.LocalService.EvaluateQueryResponse;
 import com.google.zetasql.LocalService.PrepareQueryRequest;
 import com.google.zetasql.LocalService.PrepareQueryResponse;
 import com.google.zetasql.LocalService.PreparedQueryState;
+import com.google.zetasql.LocalService.TableData;
 import com.google.zetasql.LocalService.UnprepareQueryRequest;
+import io.grpc.Context;
 import io.grpc.StatusRuntimeException;
+import java.util.Iterator;
 import java.util.Map;
 
 /**
@@ -112,6 +116,117 @@ public final class PreparedQuery implements AutoCloseable {
     }
   }
 
+  /**
+   * Evaluate the SQL query via Service RPC, streaming the result.
+   *
+   * <p>Unlike {@link #execute}, the result is not limited by the maximum gRPC message size and is
+   * never held in memory all at once: the server sends the rows in chunks of about {@code
+   * maxChunkBytes} serialized bytes, and only computes more rows as the returned iterator is
+   * advanced. Errors, including evaluation errors after some rows were returned, are thrown as
+   * SqlException by the iterator.
+   *
+   * <p>The call is released when the returned iterator is exhausted, throws, or is closed. Close
+   * it, for example with try-with-resources, if it may be abandoned before the end.
+   *
+   * @param parameters Map of parameter name:value pairs used in the SQL query.
+   * @param maxChunkBytes Approximate size of each chunk, or 0 for the server default.
+   * @return An iterator over the rows of the result.
+   */
+  public RowIterator executeStreaming(Map<String, Value> parameters, long maxChunkBytes) {
+    Preconditions.checkNotNull(parameters);
+    Preconditions.checkArgument(maxChunkBytes >= 0);
+    Preconditions.checkState(!closed);
+
+    EvaluateQueryRequest request =
+        buildEvaluateRequest(parameters).toBuilder().setMaxChunkBytes(maxChunkBytes).build();
+    // The call is bound to the context that is current when it starts, so cancelling this context
+    // cancels the call.
+    Context.CancellableContext context = Context.current().withCancellation();
+    Context previous = context.attach();
+    try {
+      return new StreamedRowIterator(
+          columnsTypes, Client.getStub().evaluateQueryChunked(request), context);
+    } catch (StatusRuntimeException e) {
+      context.cancel(null);
+      throw new SqlException(e);
+    } finally {
+      context.detach(previous);
+    }
+  }
+
+  /** Same as {@link #executeStreaming(Map, long)} with the server's default chunk size. */
+  public RowIterator executeStreaming(Map<String, Value> parameters) {
+    return executeStreaming(parameters, 0);
+  }
+
+  /** An iterator over the rows of a streamed result, which holds a call to the server. */
+  public interface RowIterator extends Iterator<ImmutableList<Value>>, AutoCloseable {
+    /**
+     * Cancels the call if it is still running. Rows that were not returned yet are dropped, except
+     * one that hasNext() already fetched.
+     */
+    @Override
+    void close();
+  }
+
+  /** Deserializes the rows of a stream of EvaluateQueryResponse chunks, one chunk at a time. */
+  private static final class StreamedRowIterator extends AbstractIterator<ImmutableList<Value>>
+      implements RowIterator {
+    private final ImmutableList<Type> columnsTypes;
+    private final Iterator<EvaluateQueryResponse> chunks;
+    private final Context.CancellableContext context;
+    private TableData chunk = TableData.getDefaultInstance();
+    private int nextRow = 0;
+    private boolean closed = false;
+
+    StreamedRowIterator(
+        ImmutableList<Type> columnsTypes,
+        Iterator<EvaluateQueryResponse> chunks,
+        Context.CancellableContext context) {
+      this.columnsTypes = columnsTypes;
+      this.chunks = chunks;
+      this.context = context;
+    }
+
+    @Override
+    public void close() {
+      closed = true;
+      context.cancel(null);
+    }
+
+    @Override
+    protected ImmutableList<Value> computeNext() {
+      if (closed) {
+        return endOfData();
+      }
+      try {
+        while (nextRow == chunk.getRowCount()) {
+          if (!chunks.hasNext()) {
+            close();
+            return endOfData();
+          }
+          chunk = chunks.next().getContent().getTableData();
+          nextRow = 0;
+        }
+      } catch (StatusRuntimeException e) {
+        close();
+        throw new SqlException(e);
+      }
+
+      TableData.Row row = chunk.getRow(nextRow++);
+      Preconditions.checkArgument(
+          row.getCellCount() == columnsTypes.size(),
+          "Unexpected number of elements for row content. Expected: %s, but received: %s.",
+          columnsTypes.size(),
+          row.getCellCount());
+      ImmutableList.Builder<Value> rowBuilder = ImmutableList.builder();
+      for (int i = 0; i < row.getCellCount(); i++) {
+        rowBuilder.add(Value.deserialize(columnsTypes.get(i), row.getCell(i)));
+      }
+      return rowBuilder.build();
+    }
+  }
+
   private EvaluateQueryRequest buildEvaluateRequest(Map<String, Value> parameters) {
     EvaluateQueryRequest.Builder requestBuilder = EvaluateQueryRequest.newBuilder();
     requestBuilder.setPreparedQueryId(preparedQueryId);
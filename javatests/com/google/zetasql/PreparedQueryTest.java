@@ -567,6 +567,66 @@ public final class PreparedQueryTest {
     }
   }
 
+  @Test
+  public void testExecuteStreaming() {
+    AnalyzerOptions options = new AnalyzerOptions();
+    options.addQueryParameter("a", stringType);
+
+    try (PreparedQuery query =
+        PreparedQuery.builder()
+            .setSql(
+                "SELECT CONCAT(@a, CAST(x AS STRING)) AS fruit"
+                    + " FROM UNNEST(GENERATE_ARRAY(0, 99)) x ORDER BY x")
+            .setAnalyzerOptions(options)
+            .prepare()) {
+      ImmutableMap<String, Value> parameters =
+          ImmutableMap.of("a", Value.createStringValue("apple"));
+      // Small chunks, so that the result takes many responses.
+      try (PreparedQuery.RowIterator rows = query.executeStreaming(parameters, 64)) {
+        for (int i = 0; i < 100; i++) {
+          assertThat(rows.hasNext()).isTrue();
+          ImmutableList<Value> row = rows.next();
+          assertThat(row).hasSize(1);
+          assertThat(row.get(0).getType()).isEqualTo(stringType);
+          assertThat(row.get(0).getStringValue()).isEqualTo("apple" + i);
+        }
+        assertThat(rows.hasNext()).isFalse();
+      }
+    }
+  }
+
+  @Test
+  public void testExecuteStreamingClose() {
+    try (PreparedQuery query =
+        PreparedQuery.builder()
+            .setSql("SELECT x FROM UNNEST(GENERATE_ARRAY(0, 99999)) x")
+            .setAnalyzerOptions(new AnalyzerOptions())
+            .prepare()) {
+      // Abandon the result after its first row.
+      PreparedQuery.RowIterator rows = query.executeStreaming(ImmutableMap.of(), 64);
+      assertThat(rows.next()).hasSize(1);
+      rows.close();
+      assertThat(rows.hasNext()).isFalse();
+      rows.close();
+
+      // The query can still be executed.
+      try (PreparedQuery.RowIterator moreRows = query.executeStreaming(ImmutableMap.of(), 64)) {
+        assertThat(moreRows.next().get(0).getInt64Value()).isEqualTo(0);
+      }
+    }
+  }
+
+  @Test
+  public void testExecuteStreamingEmptyResult() {
+    try (PreparedQuery query =
+        PreparedQuery.builder()
+            .setSql("SELECT 1 AS x FROM UNNEST([])")
+            .setAnalyzerOptions(new AnalyzerOptions())
+            .prepare()) {
+      assertThat(query.executeStreaming(ImmutableMap.of()).hasNext()).isFalse();
+    }
+  }
+
   @Test
   public void testPrepareThenExecuteMissingParameter() {
     AnalyzerOptions options = new AnalyzerOptions();
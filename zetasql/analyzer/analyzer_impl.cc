@@ -16,6 +16,7 @@
 
 #include "zetasql/analyzer/analyzer_impl.h"
 
+#include <cstdint>
 #include <iostream>
 #include <map>
 #include <memory>
@@ -32,6 +33,7 @@
 #include "zetasql/analyzer/rewrite_resolved_ast.h"
 #include "zetasql/common/errors.h"
 #include "zetasql/common/internal_analyzer_options.h"
+#include "zetasql/common/resolver_stats.h"
 #include "zetasql/common/timer_util.h"
 #include "zetasql/parser/parse_tree.h"
 #include "zetasql/parser/parser.h"
@@ -133,9 +135,17 @@ absl::Status InternalAnalyzeExpressionFromParserAST(
     auto overall_timer = internal::MakeScopedTimerStarted(
         &analyzer_runtime_info.overall_timed_value());
 
+    ResolvedNode::ArenaScope arena_scope(
+        options.allocate_resolved_ast_in_arena() ? options.arena().get()
+                                                 : nullptr);
     std::unique_ptr<const ResolvedExpr> resolved_expr;
     Resolver resolver(catalog, type_factory, &options);
     {
+      internal::ResolverStats& resolver_stats =
+          analyzer_runtime_info.resolver_stats();
+      internal::ResolverStats::Scope resolver_stats_scope(&resolver_stats);
+      const int64_t arena_bytes_before =
+          options.arena()->status().bytes_allocated();
       auto resolver_timer = internal::MakeScopedTimerStarted(
           &analyzer_runtime_info.resolver_timed_value());
       ZETASQL_RETURN_IF_ERROR(
@@ -147,12 +157,21 @@ absl::Status InternalAnalyzeExpressionFromParserAST(
                                                 catalog, type_factory,
                                                 target_type, &resolved_expr));
       }
+      resolver_stats.add_arena_bytes(
+          options.arena()->status().bytes_allocated() - arena_bytes_before);
+      if (InternalAnalyzerOptions::GetRecordResolvedNodeCount(options)) {
+        RecordResolvedNodeCount(resolved_expr.get(), &resolver_stats);
+      }
     }
 
     if (InternalAnalyzerOptions::GetValidateResolvedAST(options)) {
       internal::ScopedTimer scoped_validator_timer = MakeScopedTimerStarted(
           &analyzer_runtime_info.validator_timed_value());
-      Validator validator(options.language());
+      ValidatorOptions validator_options{
+          .structural_validation_only =
+              InternalAnalyzerOptions::GetValidateResolvedASTStructureOnly(
+                  options)};
+      Validator validator(options.language(), validator_options);
       ZETASQL_RETURN_IF_ERROR(
           validator.ValidateStandaloneResolvedExpr(resolved_expr.get()));
     }
@@ -192,4 +211,21 @@ absl::Status InternalAnalyzeExpressionFromParserAST(
       analyzer_runtime_info);
   return absl::OkStatus();
 }
+
+void RecordResolvedNodeCount(const ResolvedNode* node,
+                             internal::ResolverStats* stats) {
+  if (node == nullptr) return;
+  // Iterative, since resolved ASTs for generated SQL can be very deep.
+  int64_t count = 0;
+  std::vector<const ResolvedNode*> stack = {node};
+  std::vector<const ResolvedNode*> child_nodes;
+  while (!stack.empty()) {
+    const ResolvedNode* current = stack.back();
+    stack.pop_back();
+    ++count;
+    current->GetChildNodes(&child_nodes);
+    stack.insert(stack.end(), child_nodes.begin(), child_nodes.end());
+  }
+  stats->add_resolved_node_count(count);
+}
 }  // namespace zetasql
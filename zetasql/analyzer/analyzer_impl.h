@@ -23,6 +23,7 @@
 
 #include <memory>
 
+#include "zetasql/common/resolver_stats.h"
 #include "zetasql/parser/parse_tree.h"
 #include "zetasql/parser/parser.h"
 #include "zetasql/public/analyzer_options.h"
@@ -68,6 +69,10 @@ absl::Status InternalAnalyzeExpressionFromParserAST(
     std::unique_ptr<ParserOutput> parser_output, absl::string_view sql,
     const AnalyzerOptions& options, Catalog* catalog, TypeFactory* type_factory,
     const Type* target_type, std::unique_ptr<AnalyzerOutput>* output);
+
+// Adds the number of nodes in the tree rooted at <node> to <stats>.
+void RecordResolvedNodeCount(const ResolvedNode* node,
+                             internal::ResolverStats* stats);
 }  // namespace zetasql
 
 #endif  // ZETASQL_ANALYZER_ANALYZER_IMPL_H_
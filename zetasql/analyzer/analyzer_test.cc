@@ -16,14 +16,18 @@
 
 #include "zetasql/public/analyzer.h"
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "zetasql/analyzer/rewriters/with_expr_rewriter.h"
+#include "zetasql/base/atomic_sequence_num.h"
 #include "zetasql/base/logging.h"
 #include "google/protobuf/compiler/importer.h"
 #include "google/protobuf/descriptor.h"
@@ -48,6 +52,9 @@
 #include "zetasql/public/rewriter_interface.h"
 #include "zetasql/public/simple_catalog.h"
 #include "zetasql/public/sql_formatter.h"
+#include "zetasql/public/sql_view.h"
+#include "zetasql/public/templated_sql_function.h"
+#include "zetasql/public/templated_sql_tvf.h"
 #include "zetasql/public/type.h"
 #include "zetasql/public/type.pb.h"
 #include "zetasql/public/types/array_type.h"
@@ -57,6 +64,7 @@
 #include "zetasql/public/types/type_factory.h"
 #include "zetasql/public/value.h"
 #include "zetasql/resolved_ast/resolved_ast.h"
+#include "zetasql/resolved_ast/resolved_ast_deep_copy_visitor.h"
 #include "zetasql/resolved_ast/resolved_column.h"
 #include "zetasql/resolved_ast/resolved_node_kind.pb.h"
 #include "zetasql/resolved_ast/sql_builder.h"
@@ -587,6 +595,207 @@ TEST_F(AnalyzerOptionsTest, AnalyzeStatementWithLeadingRewriter) {
                        HasSubstr("Leading rewriter always fails")));
 }
 
+// A view the catalog does not allow to be inlined. The rewriter relevance
+// checker still reports REWRITE_INLINE_SQL_VIEWS for scans of it.
+class NonInlinableView : public SQLView {
+ public:
+  explicit NonInlinableView(const Type* type)
+      : column_("NonInlinableView", "a", type) {}
+
+  SqlSecurity sql_security() const override { return kSecurityInvoker; }
+  const ResolvedScan* view_query() const override { return nullptr; }
+  bool enable_view_inline() const override { return false; }
+
+  std::string Name() const override { return "NonInlinableView"; }
+  std::string FullName() const override { return Name(); }
+  int NumColumns() const override { return 1; }
+  const Column* GetColumn(int i) const override { return &column_; }
+  const Column* FindColumnByName(const std::string& name) const override {
+    return name == "a" ? &column_ : nullptr;
+  }
+
+ private:
+  SimpleColumn column_;
+};
+
+TEST(AnalyzerTest, RewriterDriverConvergesWhenRewriterMakesNoChange) {
+  AnalyzerOptions options;
+  TypeFactory type_factory;
+  NonInlinableView view(types::Int64Type());
+  SimpleCatalog catalog("catalog");
+  catalog.AddTable(&view);
+  ASSERT_TRUE(options.enabled_rewrites().contains(REWRITE_INLINE_SQL_VIEWS));
+
+  std::unique_ptr<const AnalyzerOutput> output;
+  ZETASQL_ASSERT_OK(AnalyzeStatement("SELECT a FROM NonInlinableView", options,
+                             &catalog, &type_factory, &output));
+  EXPECT_EQ(output->runtime_info()
+                .rewriters_details(REWRITE_INLINE_SQL_VIEWS)
+                .count,
+            1);
+  std::vector<const ResolvedNode*> table_scans;
+  output->resolved_statement()->GetDescendantsWithKinds({RESOLVED_TABLE_SCAN},
+                                                        &table_scans);
+  EXPECT_EQ(table_scans.size(), 1);
+}
+
+// A SimpleCatalog that counts the lookups of each function name.
+class FunctionLookupCountingCatalog : public SimpleCatalog {
+ public:
+  using SimpleCatalog::SimpleCatalog;
+
+  absl::Status GetFunction(const std::string& name, const Function** function,
+                           const FindOptions& options) override {
+    ++function_lookups_[name];
+    return SimpleCatalog::GetFunction(name, function, options);
+  }
+
+  // Returns the number of lookups of <name> while analyzing <sql>.
+  int CountFunctionLookups(absl::string_view sql, absl::string_view name) {
+    AnalyzerOptions options;
+    options.mutable_language()->EnableLanguageFeature(
+        FEATURE_TABLE_VALUED_FUNCTIONS);
+    TypeFactory type_factory;
+    std::unique_ptr<const AnalyzerOutput> output;
+    function_lookups_.clear();
+    ZETASQL_EXPECT_OK(AnalyzeStatement(sql, options, this, &type_factory, &output));
+    return function_lookups_[name];
+  }
+
+ private:
+  absl::flat_hash_map<std::string, int> function_lookups_;
+};
+
+TEST(AnalyzerTest, TemplatedSQLBodiesAreResolvedOncePerArgumentTypes) {
+  FunctionLookupCountingCatalog catalog("catalog");
+  catalog.AddBuiltinFunctions(BuiltinFunctionOptions::AllReleasedFunctions());
+  const FunctionArgumentType arbitrary_type(ARG_TYPE_ARBITRARY);
+  catalog.AddOwnedFunction(new TemplatedSQLFunction(
+      {"add_one"},
+      FunctionSignature(arbitrary_type, {arbitrary_type}, /*context_id=*/-1),
+      /*argument_names=*/{"x"}, ParseResumeLocation::FromString("x + 1")));
+  catalog.AddOwnedTableValuedFunction(new TemplatedSQLTVF(
+      {"add_one_tvf"},
+      FunctionSignature(ARG_TYPE_RELATION, {arbitrary_type},
+                        /*context_id=*/-1),
+      /*arg_name_list=*/{"x"},
+      ParseResumeLocation::FromString("SELECT x + 1 AS y")));
+
+  // Each body looks up "$add" when it is resolved.
+  const int scalar_lookups =
+      catalog.CountFunctionLookups("SELECT add_one(1)", "$add");
+  ASSERT_GT(scalar_lookups, 0);
+  EXPECT_EQ(catalog.CountFunctionLookups(
+                "SELECT add_one(1), add_one(2), add_one(3)", "$add"),
+            scalar_lookups);
+  EXPECT_EQ(
+      catalog.CountFunctionLookups("SELECT add_one(1), add_one(1.5)", "$add"),
+      2 * scalar_lookups);
+
+  const int tvf_lookups =
+      catalog.CountFunctionLookups("SELECT y FROM add_one_tvf(1)", "$add");
+  ASSERT_GT(tvf_lookups, 0);
+  EXPECT_EQ(catalog.CountFunctionLookups(
+                "SELECT a.y, b.y FROM add_one_tvf(1) AS a, add_one_tvf(2) AS b",
+                "$add"),
+            tvf_lookups);
+  EXPECT_EQ(catalog.CountFunctionLookups(
+                "SELECT a.y, b.y FROM add_one_tvf(1) AS a, "
+                "add_one_tvf(1.5) AS b",
+                "$add"),
+            2 * tvf_lookups);
+}
+
+TEST(AnalyzerTest, TemplatedSQLFunctionCallsOwnTheirBodies) {
+  SimpleCatalog catalog("catalog");
+  catalog.AddBuiltinFunctions(BuiltinFunctionOptions::AllReleasedFunctions());
+  const FunctionArgumentType arbitrary_type(ARG_TYPE_ARBITRARY);
+  catalog.AddOwnedFunction(new TemplatedSQLFunction(
+      {"sum_of_squares"},
+      FunctionSignature(arbitrary_type, {arbitrary_type}, /*context_id=*/-1),
+      /*argument_names=*/{"x"},
+      ParseResumeLocation::FromString(
+          "(SELECT SUM(e * e) FROM UNNEST(x) AS e)")));
+
+  AnalyzerOptions options;
+  zetasql_base::SequenceNumber column_id_sequence;
+  options.set_column_id_sequence_number(&column_id_sequence);
+  TypeFactory type_factory;
+  std::unique_ptr<const AnalyzerOutput> output;
+  ZETASQL_ASSERT_OK(AnalyzeStatement(
+      "SELECT sum_of_squares([1, 2]), sum_of_squares([3])", options, &catalog,
+      &type_factory, &output));
+
+  std::vector<const ResolvedNode*> calls;
+  output->resolved_statement()->GetDescendantsWithKinds({RESOLVED_FUNCTION_CALL},
+                                                        &calls);
+  std::vector<const TemplatedSQLFunctionCall*> call_infos;
+  for (const ResolvedNode* node : calls) {
+    const auto* call = node->GetAs<ResolvedFunctionCall>();
+    if (call->function()->Is<TemplatedSQLFunction>()) {
+      call_infos.push_back(
+          call->function_call_info()->GetAs<TemplatedSQLFunctionCall>());
+    }
+  }
+  ASSERT_EQ(call_infos.size(), 2);
+  EXPECT_NE(call_infos[0], call_infos[1]);
+  EXPECT_EQ(call_infos[0]->expr()->type(), call_infos[1]->expr()->type());
+
+  // With a shared column id sequence, the columns defined in the two bodies
+  // are distinct.
+  std::vector<const ResolvedNode*> array_scans[2];
+  for (int i = 0; i < 2; ++i) {
+    call_infos[i]->expr()->GetDescendantsWithKinds({RESOLVED_ARRAY_SCAN},
+                                                   &array_scans[i]);
+    ASSERT_EQ(array_scans[i].size(), 1);
+  }
+  EXPECT_NE(array_scans[0][0]
+                ->GetAs<ResolvedArrayScan>()
+                ->element_column()
+                .column_id(),
+            array_scans[1][0]
+                ->GetAs<ResolvedArrayScan>()
+                ->element_column()
+                .column_id());
+}
+
+TEST(AnalyzerTest, OverloadedFunctionCallsOnlyTryCandidateSignatures) {
+  SimpleCatalog catalog("catalog");
+  catalog.AddBuiltinFunctions(BuiltinFunctionOptions::AllReleasedFunctions());
+  SimpleTable table("t", {{"i", types::Int64Type()}, {"b", types::BoolType()}});
+  catalog.AddTable(&table);
+  const Function* add_function;
+  ZETASQL_ASSERT_OK(catalog.GetFunction("$add", &add_function));
+
+  AnalyzerOptions options;
+  TypeFactory type_factory;
+  std::unique_ptr<const AnalyzerOutput> output;
+  ZETASQL_ASSERT_OK(AnalyzeStatement("SELECT i + i FROM t", options, &catalog,
+                             &type_factory, &output));
+  // Signatures like (UINT64, UINT64) or (DATE, INT64) are not tried.
+  EXPECT_LT(output->runtime_info()
+                .resolver_stats()
+                .function_signature_match_attempts(),
+            add_function->NumSignatures());
+  std::vector<const ResolvedNode*> calls;
+  output->resolved_statement()->GetDescendantsWithKinds({RESOLVED_FUNCTION_CALL},
+                                                        &calls);
+  ASSERT_EQ(calls.size(), 1);
+  EXPECT_TRUE(calls[0]
+                  ->GetAs<ResolvedFunctionCall>()
+                  ->signature()
+                  .result_type()
+                  .type()
+                  ->IsInt64());
+
+  // Mismatch details still cover the signatures that are not tried.
+  options.set_show_function_signature_mismatch_details(true);
+  EXPECT_THAT(AnalyzeStatement("SELECT i + b FROM t", options, &catalog,
+                               &type_factory, &output),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("Signature: UINT64 + UINT64")));
+}
+
 MATCHER_P(HasInvalidArgumentError, expected_message, "") {
   return ExplainMatchResult(Eq(absl::StatusCode::kInvalidArgument), arg.code(),
                             result_listener) &&
@@ -1189,6 +1398,42 @@ TEST_F(AnalyzerOptionsTest, ClassAndProtoSize) {
       << "also update the serialization code accordingly.";
 }
 
+TEST_F(AnalyzerOptionsTest, AllocateResolvedAstInArena) {
+  const std::string statement =
+      "SELECT key, COUNT(*) FROM KeyValue WHERE value LIKE 'a%' GROUP BY key";
+  const std::string expression = "IF(1 + 2 > 3, 'x', CONCAT('y', 'z'))";
+
+  std::unique_ptr<const AnalyzerOutput> heap_statement_output;
+  ZETASQL_ASSERT_OK(AnalyzeStatement(statement, options_, catalog(), &type_factory_,
+                             &heap_statement_output));
+  std::unique_ptr<const AnalyzerOutput> heap_expression_output;
+  ZETASQL_ASSERT_OK(AnalyzeExpression(expression, options_, catalog(),
+                              &type_factory_, &heap_expression_output));
+
+  options_.set_allocate_resolved_ast_in_arena(true);
+  EXPECT_TRUE(options_.allocate_resolved_ast_in_arena());
+  std::unique_ptr<const AnalyzerOutput> arena_statement_output;
+  ZETASQL_ASSERT_OK(AnalyzeStatement(statement, options_, catalog(), &type_factory_,
+                             &arena_statement_output));
+  std::unique_ptr<const AnalyzerOutput> arena_expression_output;
+  ZETASQL_ASSERT_OK(AnalyzeExpression(expression, options_, catalog(),
+                              &type_factory_, &arena_expression_output));
+
+  // The resolved nodes take up additional space in the arena, and the trees
+  // are the same.
+  EXPECT_GT(arena_statement_output->arena()->status().bytes_allocated(),
+            heap_statement_output->arena()->status().bytes_allocated());
+  EXPECT_GT(arena_expression_output->arena()->status().bytes_allocated(),
+            heap_expression_output->arena()->status().bytes_allocated());
+  EXPECT_EQ(arena_statement_output->resolved_statement()->DebugString(),
+            heap_statement_output->resolved_statement()->DebugString());
+  EXPECT_EQ(arena_expression_output->resolved_expr()->DebugString(),
+            heap_expression_output->resolved_expr()->DebugString());
+
+  // The scope doesn't outlive the analysis.
+  EXPECT_EQ(ResolvedNode::ArenaScope::current_arena(), nullptr);
+}
+
 TEST_F(AnalyzerOptionsTest, AllowedHintsAndOptionsSerializeAndDeserialize) {
   TypeFactory factory;
 
@@ -1973,6 +2218,75 @@ TEST(AnalyzerTest, AnalyzeStatementsOfScript) {
                                "Unrecognized name: garbage [at 2:8]"));
 }
 
+TEST(AnalyzerTest, AnalyzeStatementsInParallel) {
+  SampleCatalog catalog;
+  AnalyzerOptions analyzer_options;
+  analyzer_options.mutable_language()->SetSupportsAllStatementKinds();
+
+  std::vector<std::thread> threads;
+  ParallelStatementAnalysisOptions parallel_options;
+  parallel_options.schedule = [&threads](std::function<void()> task) {
+    threads.emplace_back(std::move(task));
+  };
+  int applied_ddl_statements = 0;
+  parallel_options.apply_ddl_statement =
+      [&applied_ddl_statements](const AnalyzerOutput& output) {
+        EXPECT_EQ(output.resolved_statement()->node_kind(),
+                  RESOLVED_CREATE_TABLE_STMT);
+        ++applied_ddl_statements;
+        return absl::OkStatus();
+      };
+
+  std::vector<std::unique_ptr<const AnalyzerOutput>> outputs;
+  ZETASQL_ASSERT_OK(AnalyzeStatementsInParallel(
+      "SELECT * FROM KeyValue;\n"
+      "CREATE TABLE t (x INT64);\n"
+      "SELECT 1;\n"
+      "DELETE FROM KeyValue WHERE true",
+      analyzer_options, parallel_options, catalog.catalog(),
+      catalog.type_factory(), &outputs));
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  ASSERT_EQ(outputs.size(), 4);
+  EXPECT_EQ(outputs[0]->resolved_statement()->node_kind(), RESOLVED_QUERY_STMT);
+  EXPECT_EQ(outputs[1]->resolved_statement()->node_kind(),
+            RESOLVED_CREATE_TABLE_STMT);
+  EXPECT_EQ(outputs[2]->resolved_statement()->node_kind(), RESOLVED_QUERY_STMT);
+  EXPECT_EQ(outputs[3]->resolved_statement()->node_kind(),
+            RESOLVED_DELETE_STMT);
+  EXPECT_EQ(applied_ddl_statements, 1);
+}
+
+TEST(AnalyzerTest, AnalyzeStatementsInParallelReportsFirstError) {
+  SampleCatalog catalog;
+  AnalyzerOptions analyzer_options;
+  analyzer_options.set_error_message_mode(ERROR_MESSAGE_ONE_LINE);
+
+  // Without a scheduler, statements are analyzed serially.
+  std::vector<std::unique_ptr<const AnalyzerOutput>> outputs;
+  EXPECT_THAT(
+      AnalyzeStatementsInParallel(
+          "SELECT * FROM KeyValue;\nSELECT garbage;\nSELECT more_garbage",
+          analyzer_options, ParallelStatementAnalysisOptions(),
+          catalog.catalog(), catalog.type_factory(), &outputs),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               "Unrecognized name: garbage [at 2:8]"));
+  ASSERT_EQ(outputs.size(), 1);
+  EXPECT_EQ(outputs[0]->resolved_statement()->node_kind(), RESOLVED_QUERY_STMT);
+
+  // Statements preceding a syntax error are still analyzed.
+  EXPECT_THAT(
+      AnalyzeStatementsInParallel(
+          "SELECT 1;\nSELECT 2;\nSELECT FROM", analyzer_options,
+          ParallelStatementAnalysisOptions(), catalog.catalog(),
+          catalog.type_factory(), &outputs),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("Syntax error: SELECT list must not be empty [at "
+                         "3:8]")));
+  EXPECT_EQ(outputs.size(), 2);
+}
+
 TEST(AnalyzerTest, AnalyzeInsertStatement) {
   // Setup catalog and table.
   // Table ddl representation
@@ -2148,6 +2462,49 @@ TEST(AnalyzerTest, AnalyzeInsertStatementFailsWithCyclicGenColInTable) {
               "cycle : test_table.gen., test_table.gen.")));
 }
 
+TEST(AnalyzerTest, WithExprRewriterMovesUntouchedSubtrees) {
+  AnalyzerOptions options;
+  options.mutable_language()->EnableLanguageFeature(
+      FEATURE_V_1_4_WITH_EXPRESSION);
+  options.set_enabled_rewrites({});
+  SampleCatalog catalog(options.language());
+  TypeFactory type_factory;
+  std::unique_ptr<const AnalyzerOutput> output;
+  ZETASQL_ASSERT_OK(AnalyzeStatement(
+      "SELECT key, WITH(a AS 1, a + key) AS w FROM KeyValue WHERE key > 0",
+      options, catalog.catalog(), &type_factory, &output));
+
+  // The rewriter takes ownership of its input, so rewrite a copy.
+  ResolvedASTDeepCopyVisitor copier;
+  ZETASQL_ASSERT_OK(output->resolved_statement()->Accept(&copier));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<const ResolvedNode> input,
+                       copier.ConsumeRootNode<ResolvedNode>());
+  const ResolvedScan* filter_scan = input->GetAs<ResolvedQueryStmt>()
+                                        ->query()
+                                        ->GetAs<ResolvedProjectScan>()
+                                        ->input_scan();
+  ASSERT_TRUE(filter_scan->Is<ResolvedFilterScan>());
+
+  zetasql_base::SequenceNumber sequence;
+  options.set_column_id_sequence_number(&sequence);
+  AnalyzerOutputProperties output_properties;
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<const ResolvedNode> rewritten,
+      GetWithExprRewriter()->Rewrite(options, std::move(input),
+                                     *catalog.catalog(), type_factory,
+                                     output_properties));
+
+  // The WITH expression became a subquery, and the scan that it doesn't
+  // contain was moved into the result rather than copied.
+  const ResolvedProjectScan* project_scan =
+      rewritten->GetAs<ResolvedQueryStmt>()
+          ->query()
+          ->GetAs<ResolvedProjectScan>();
+  EXPECT_EQ(project_scan->input_scan(), filter_scan);
+  ASSERT_EQ(project_scan->expr_list_size(), 1);
+  EXPECT_TRUE(project_scan->expr_list(0)->expr()->Is<ResolvedSubqueryExpr>());
+}
+
 // Verify the catalog name path of the outer proto type will be carried to its
 // inner field types.
 // Have to put it here rather than in a text-based test since the Java library
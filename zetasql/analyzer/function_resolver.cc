@@ -22,6 +22,7 @@
 #include <limits>
 #include <map>
 #include <memory>
+#include <numeric>
 #include <optional>
 #include <set>
 #include <string>
@@ -851,7 +852,20 @@ FunctionResolver::FindMatchingSignature(
   if (show_mismatch_details) {
     mismatch_errors->reserve(num_signatures);
   }
-  for (const FunctionSignature& signature : function->signatures()) {
+  // Detailed mismatch messages need every signature to be tried, and named
+  // arguments don't map positionally to the signature arguments.
+  std::vector<int> candidate_signatures;
+  if (!show_mismatch_details && named_arguments.empty() &&
+      num_signatures >= kMinSignaturesForDispatchIndex) {
+    candidate_signatures =
+        GetCandidateSignatureIndexes(function, original_input_arguments);
+  } else {
+    candidate_signatures.resize(num_signatures);
+    std::iota(candidate_signatures.begin(), candidate_signatures.end(), 0);
+  }
+  for (const int signature_index : candidate_signatures) {
+    const FunctionSignature& signature =
+        *function->GetSignature(signature_index);
     int repetitions = 0;
     int optionals = 0;
     // If a user calls a function with an internal signature, we won't match it.
@@ -1031,6 +1045,35 @@ FunctionResolver::FindMatchingSignature(
   return best_result_signature.release();
 }
 
+std::vector<int> FunctionResolver::GetCandidateSignatureIndexes(
+    const Function* function,
+    const std::vector<InputArgumentType>& input_arguments) const {
+  std::vector<TypeKind> dispatch_kinds;
+  dispatch_kinds.reserve(input_arguments.size());
+  for (const InputArgumentType& argument : input_arguments) {
+    dispatch_kinds.push_back(GetSignatureDispatchKind(argument));
+  }
+  SignatureDispatchKey key(function, std::move(dispatch_kinds));
+  if (auto it = signature_dispatch_index_.find(key);
+      it != signature_dispatch_index_.end()) {
+    return it->second;
+  }
+
+  std::vector<int> candidates;
+  const int num_signatures = function->NumSignatures();
+  for (int i = 0; i < num_signatures; ++i) {
+    if (SignatureMayMatchDispatchKinds(*function->GetSignature(i),
+                                       key.second,
+                                       function->ArgumentsAreCoercible())) {
+      candidates.push_back(i);
+    }
+  }
+  if (signature_dispatch_index_.size() < kMaxSignatureDispatchIndexEntries) {
+    signature_dispatch_index_.emplace(std::move(key), candidates);
+  }
+  return candidates;
+}
+
 static void ConvertMakeStructToLiteralIfAllExplicitLiteralFields(
     std::unique_ptr<const ResolvedExpr>* argument) {
   if (!(*argument)->type()->IsStruct() ||
@@ -1626,15 +1669,31 @@ absl::Status FunctionResolver::ResolveGeneralFunctionCall(
   bool show_mismatch_details =
       function->GetSupportedSignaturesCallback() == nullptr &&
       resolver_->analyzer_options().show_function_signature_mismatch_details();
-  auto mismatch_errors = show_mismatch_details
-                             ? std::make_unique<std::vector<std::string>>()
-                             : nullptr;
-  ZETASQL_ASSIGN_OR_RETURN(const FunctionSignature* signature,
-                   FindMatchingSignature(
-                       function, ast_location, arg_locations, named_arguments,
-                       name_scope, &input_argument_types, &arg_overrides,
-                       &arg_reorder_index_mapping, mismatch_errors.get()));
-  result_signature.reset(signature);
+  std::unique_ptr<std::vector<std::string>> mismatch_errors;
+  // Mismatch details are only needed if no signature matches, so the
+  // signatures are first matched without collecting them, which lets
+  // FindMatchingSignature() skip the signatures that cannot match.  If that
+  // fails, matching is redone with details to produce the error.
+  std::vector<InputArgumentType> original_input_argument_types;
+  if (show_mismatch_details) {
+    original_input_argument_types = input_argument_types;
+  }
+  absl::StatusOr<const FunctionSignature*> signature = FindMatchingSignature(
+      function, ast_location, arg_locations, named_arguments, name_scope,
+      &input_argument_types, &arg_overrides, &arg_reorder_index_mapping,
+      /*mismatch_errors=*/nullptr);
+  if (show_mismatch_details && (!signature.ok() || *signature == nullptr)) {
+    input_argument_types = std::move(original_input_argument_types);
+    arg_overrides.clear();
+    arg_reorder_index_mapping.clear();
+    mismatch_errors = std::make_unique<std::vector<std::string>>();
+    signature = FindMatchingSignature(
+        function, ast_location, arg_locations, named_arguments, name_scope,
+        &input_argument_types, &arg_overrides, &arg_reorder_index_mapping,
+        mismatch_errors.get());
+  }
+  ZETASQL_RETURN_IF_ERROR(signature.status());
+  result_signature.reset(*signature);
 
   if (nullptr == result_signature) {
     ZETASQL_ASSIGN_OR_RETURN(
@@ -1660,7 +1719,7 @@ absl::Status FunctionResolver::ResolveGeneralFunctionCall(
     if (!result_signature->IsConcrete()) {
       return ::zetasql_base::InternalErrorBuilder()
              << "Non-concrete result signature for non-templated function: "
-             << function->SQLName() << " " << signature->DebugString();
+             << function->SQLName() << " " << result_signature->DebugString();
     }
   }
 
@@ -2164,6 +2223,16 @@ absl::Status FunctionResolver::ResolveTemplatedSQLFunctionCall(
   // TODO: Attach proper error locations to the returned Status.
   ZETASQL_RETURN_IF_ERROR(object.DetectCycle("function"));
 
+  // Reuse the body resolved for an earlier call with the same argument types,
+  // if any.
+  ZETASQL_ASSIGN_OR_RETURN(std::shared_ptr<ResolvedFunctionCallInfo> cached_call,
+                   resolver_->templated_sql_body_cache_.FindFunctionCall(
+                       &function, actual_arguments));
+  if (cached_call != nullptr) {
+    *function_call_info_out = std::move(cached_call);
+    return absl::OkStatus();
+  }
+
   // Build a map for the function arguments.
   IdStringHashMapCase<std::unique_ptr<ResolvedArgumentRef>> function_arguments;
   ZETASQL_RET_CHECK_EQ(function.GetArgumentNames().size(), actual_arguments.size());
@@ -2278,6 +2347,7 @@ absl::Status FunctionResolver::ResolveTemplatedSQLFunctionCall(
   ZETASQL_RET_CHECK_EQ(1, function.NumSignatures());
   const FunctionArgumentType& expected_type =
       function.signatures()[0].result_type();
+  const ResolvedExpr* const uncoerced_sql_body = resolved_sql_body.get();
   if (expected_type.kind() == ARG_TYPE_FIXED) {
     if (absl::Status status = resolver_->CoerceExprToType(
             ast_location, expected_type.type(), Resolver::kImplicitCoercion,
@@ -2290,9 +2360,18 @@ absl::Status FunctionResolver::ResolveTemplatedSQLFunctionCall(
     }
   }
 
-  function_call_info_out->reset(new TemplatedSQLFunctionCall(
+  auto function_call_info = std::make_shared<TemplatedSQLFunctionCall>(
       std::move(resolved_sql_body),
-      query_resolution_info.release_aggregate_columns_to_compute()));
+      query_resolution_info.release_aggregate_columns_to_compute());
+  // A coercion added to the body may record the parse location of this call
+  // site, so that body is not reused for other calls.
+  if (function_call_info->expr() == uncoerced_sql_body ||
+      analyzer_options.parse_location_record_type() ==
+          PARSE_LOCATION_RECORD_NONE) {
+    resolver_->templated_sql_body_cache_.AddFunctionCall(
+        &function, actual_arguments, function_call_info);
+  }
+  *function_call_info_out = std::move(function_call_info);
 
   return absl::OkStatus();
 }
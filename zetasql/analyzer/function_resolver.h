@@ -39,6 +39,7 @@
 #include "zetasql/public/types/type_parameters.h"
 #include "zetasql/public/value.h"
 #include "zetasql/resolved_ast/resolved_ast.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
@@ -61,6 +62,10 @@ class FunctionResolver {
   FunctionResolver(const FunctionResolver&) = delete;
   FunctionResolver& operator=(const FunctionResolver&) = delete;
 
+  // Forgets the signatures shortlisted for calls so far.  Must be called
+  // between statements, since the Functions in the Catalog may change.
+  void ClearSignatureDispatchIndex() { signature_dispatch_index_.clear(); }
+
   // Resolves the function call given the <function>, <arguments> expressions,
   // <expected_result_type> and creates a ResolvedFunctionCall.  No special
   // handling is done for aggregate functions - they are resolved exactly like
@@ -341,10 +346,33 @@ class FunctionResolver {
       std::vector<ResolvedTVFArg>* resolved_tvf_args);
 
  private:
+  // Functions with fewer signatures than this are always matched against all
+  // of their signatures.
+  static constexpr int kMinSignaturesForDispatchIndex = 4;
+  // Bound on the number of entries in <signature_dispatch_index_>.
+  static constexpr int kMaxSignatureDispatchIndexEntries = 1024;
+
+  using SignatureDispatchKey =
+      std::pair<const Function*, std::vector<TypeKind>>;
+
   Catalog* catalog_;           // Not owned.
   TypeFactory* type_factory_;  // Not owned.
   Resolver* resolver_;         // Not owned.
 
+  // Maps a function and the dispatch kinds of the positional arguments of a
+  // call (see GetSignatureDispatchKind()) to the indexes of the signatures
+  // that such a call may match.  Overloaded builtins like $add or $equal have
+  // dozens of signatures, most of which a call with columns as arguments
+  // cannot match.
+  mutable absl::flat_hash_map<SignatureDispatchKey, std::vector<int>>
+      signature_dispatch_index_;
+
+  // Returns the indexes of the signatures of <function> that a call with
+  // positional arguments <input_arguments> may match, in signature order.
+  std::vector<int> GetCandidateSignatureIndexes(
+      const Function* function,
+      const std::vector<InputArgumentType>& input_arguments) const;
+
   // Returns a signature that matches the argument type list, returning
   // a concrete FunctionSignature if found.  If not found, returns NULL.
   // The caller takes ownership of the returned FunctionSignature.
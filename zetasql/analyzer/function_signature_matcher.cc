@@ -16,6 +16,7 @@
 
 #include "zetasql/analyzer/function_signature_matcher.h"
 
+#include <algorithm>
 #include <limits>
 #include <map>
 #include <memory>
@@ -26,8 +27,10 @@
 
 #include "zetasql/base/logging.h"
 #include "zetasql/analyzer/lambda_util.h"
+#include "zetasql/common/resolver_stats.h"
 #include "zetasql/common/thread_stack.h"
 #include "zetasql/parser/parse_tree.h"
+#include "zetasql/public/cast.h"
 #include "zetasql/public/coercer.h"
 #include "zetasql/public/function.h"
 #include "zetasql/public/function.pb.h"
@@ -617,6 +620,58 @@ FunctionSignatureMatcher::GetConcreteArguments(
     }                                                                          \
   }
 
+TypeKind GetSignatureDispatchKind(const InputArgumentType& argument) {
+  if (argument.type() == nullptr || !argument.type()->IsSimpleType() ||
+      argument.is_literal() || argument.is_untyped() ||
+      argument.is_query_parameter() || argument.is_default_argument_value() ||
+      argument.is_relation() || argument.is_model() ||
+      argument.is_connection() || argument.is_lambda() ||
+      argument.is_sequence()) {
+    return TYPE_UNKNOWN;
+  }
+  return argument.type()->kind();
+}
+
+bool SignatureMayMatchDispatchKinds(const FunctionSignature& signature,
+                                    absl::Span<const TypeKind> dispatch_kinds,
+                                    bool allow_argument_coercion) {
+  // Lambda arguments are resolved while matching, and resolving them can fail
+  // the whole call before a later argument mismatches, so signatures with
+  // lambdas are always kept.
+  for (const FunctionArgumentType& argument : signature.arguments()) {
+    if (argument.IsLambda()) return true;
+  }
+  const int num_arguments = std::min(
+      static_cast<int>(signature.arguments().size()),
+      static_cast<int>(dispatch_kinds.size()));
+  for (int i = 0; i < num_arguments; ++i) {
+    const FunctionArgumentType& argument = signature.argument(i);
+    // Optional, repeated and named-only arguments shift the positions of the
+    // arguments that follow them.
+    if (!argument.required() ||
+        argument.options().named_argument_kind() == kNamedOnly) {
+      break;
+    }
+    if (argument.kind() != ARG_TYPE_FIXED || argument.type() == nullptr ||
+        !argument.type()->IsSimpleType() ||
+        argument.options().allow_coercion_from() != nullptr) {
+      continue;
+    }
+    const TypeKind input_kind = dispatch_kinds[i];
+    const TypeKind signature_kind = argument.type()->kind();
+    if (input_kind == TYPE_UNKNOWN || input_kind == signature_kind) {
+      continue;
+    }
+    if (!allow_argument_coercion) return false;
+    const CastFunctionProperty* property = zetasql_base::FindOrNull(
+        internal::GetZetaSQLCasts(), TypeKindPair(input_kind, signature_kind));
+    if (property == nullptr || !SupportsImplicitCoercion(property->type)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 // Assumes availability of local variable `signature_match_result`.
 #define SET_MISMATCH_ERROR(msg)                           \
   if (signature_match_result->allow_mismatch_message()) { \
@@ -1509,6 +1564,7 @@ absl::StatusOr<bool> FunctionSignatureMatcher::SignatureMatches(
   ZETASQL_RETURN_IF_NOT_ENOUGH_STACK(
       "Out of stack space due to deeply nested query expression "
       "during signature matching");
+  internal::ResolverStats::RecordFunctionSignatureMatchAttempt();
   if (!signature.options().check_all_required_features_are_enabled(
           language_.GetEnabledLanguageFeatures())) {
     // Signature will be hidden in error message, so no need to set mismatch
@@ -115,6 +115,24 @@ bool SignatureArgumentCountMatches(
     int* repetitions, int* optionals,
     SignatureMatchResult* signature_match_result);
 
+// Returns the TypeKind used to shortlist the signatures that an argument may
+// match, or TYPE_UNKNOWN if the argument can match signature arguments of
+// other kinds, e.g. because it is a literal, a query parameter or an untyped
+// NULL, which can coerce in ways a column of the same type cannot, or because
+// its type is not a simple type.
+TypeKind GetSignatureDispatchKind(const InputArgumentType& argument);
+
+// Returns false if a call with positional arguments of <dispatch_kinds>, as
+// computed by GetSignatureDispatchKind(), can definitely not match
+// <signature>.  Only the leading required arguments of <signature> that have
+// a fixed simple type are checked; an argument of a different kind matches
+// one of those only if <allow_argument_coercion> is true and there is an
+// implicit coercion between the two kinds.  Returns true in all other cases,
+// so a signature for which this returns true may still not match.
+bool SignatureMayMatchDispatchKinds(const FunctionSignature& signature,
+                                    absl::Span<const TypeKind> dispatch_kinds,
+                                    bool allow_argument_coercion);
+
 }  // namespace zetasql
 
 #endif  // ZETASQL_ANALYZER_FUNCTION_SIGNATURE_MATCHER_H_
@@ -28,6 +28,7 @@
 
 #include "zetasql/base/logging.h"
 #include "zetasql/analyzer/path_expression_span.h"
+#include "zetasql/common/resolver_stats.h"
 #include "zetasql/parser/parse_tree.h"
 #include "zetasql/parser/parse_tree_errors.h"
 #include "zetasql/public/catalog_helper.h"
@@ -222,6 +223,7 @@ void NameScope::AddRangeVariable(IdString name,
 bool NameScope::LookupName(
     IdString name, NameTarget* found,
     CorrelatedColumnsSetList* correlated_columns_sets) const {
+  internal::ResolverStats::RecordNameScopeLookup();
   if (correlated_columns_sets != nullptr) {
     correlated_columns_sets->clear();
   }
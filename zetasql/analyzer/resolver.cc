@@ -44,6 +44,7 @@
 #include "zetasql/analyzer/query_resolver_helper.h"
 #include "zetasql/analyzer/resolver_common_inl.h"
 #include "zetasql/common/errors.h"
+#include "zetasql/common/resolver_stats.h"
 #include "zetasql/common/status_payload_utils.h"
 #include "zetasql/parser/ast_node_kind.h"
 #include "zetasql/parser/parse_tree.h"
@@ -112,7 +113,9 @@ Resolver::Resolver(Catalog* catalog, TypeFactory* type_factory,
       coercer_(type_factory, &analyzer_options_.language(), catalog),
       empty_name_list_(new NameList),
       empty_name_scope_(new NameScope(*empty_name_list_)),
-      id_string_pool_(analyzer_options_.id_string_pool().get()) {
+      id_string_pool_(analyzer_options_.id_string_pool().get()),
+      templated_sql_body_cache_(id_string_pool_,
+                                analyzer_options_.column_id_sequence_number()) {
   function_resolver_ =
       std::make_unique<FunctionResolver>(catalog, type_factory, this);
   annotation_propagator_ =
@@ -141,6 +144,8 @@ void Resolver::Reset(absl::string_view sql) {
   deprecation_warnings_.clear();
   function_argument_info_ = nullptr;
   resolved_columns_from_table_scans_.clear();
+  templated_sql_body_cache_.Clear();
+  function_resolver_->ClearSignatureDispatchIndex();
 
   if (analyzer_options_.column_id_sequence_number() != nullptr) {
     next_column_id_sequence_ = analyzer_options_.column_id_sequence_number();
@@ -718,10 +723,13 @@ absl::Status Resolver::ResolvePathExpressionAsType(
     single_name = absl::StrJoin(path_expr->ToIdentifierVector(), ".");
   }
 
+  internal::ResolverStats::ScopedCatalogLookup catalog_lookup(
+      internal::CatalogLookupKind::kType);
   const absl::Status status = catalog_->FindType(
       (is_single_identifier ? std::vector<std::string>{single_name}
                             : identifier_path),
       resolved_type, analyzer_options_.find_options());
+  catalog_lookup.EndTiming();
   if (status.code() == absl::StatusCode::kNotFound ||
       // TODO: Ideally, Catalogs should not include unsupported types.
       // As such, we should remove the IsSupportedType() check. But we need to
@@ -2049,8 +2057,11 @@ absl::Status Resolver::FindTable(const ASTPathExpression* name,
   ZETASQL_RET_CHECK(name != nullptr);
   ZETASQL_RET_CHECK(table != nullptr);
 
+  internal::ResolverStats::ScopedCatalogLookup catalog_lookup(
+      internal::CatalogLookupKind::kTable);
   absl::Status status = catalog_->FindTable(name->ToIdentifierVector(), table,
                                             analyzer_options_.find_options());
+  catalog_lookup.EndTiming();
   if (status.code() == absl::StatusCode::kNotFound) {
     std::string message;
     absl::StrAppend(&message,
@@ -38,6 +38,7 @@
 #include "zetasql/analyzer/name_scope.h"
 #include "zetasql/analyzer/named_argument_info.h"
 #include "zetasql/analyzer/query_resolver_helper.h"
+#include "zetasql/analyzer/templated_sql_body_cache.h"
 #include "zetasql/parser/parse_tree.h"
 #include "zetasql/public/analyzer_options.h"
 #include "zetasql/public/analyzer_output_properties.h"
@@ -418,6 +419,10 @@ class Resolver {
   // Pool where IdStrings are allocated.  Copied from AnalyzerOptions.
   IdStringPool* const id_string_pool_;
 
+  // Resolved bodies of the templated SQL function and TVF calls in the current
+  // statement, reused for later calls with the same argument types.
+  TemplatedSQLBodyCache templated_sql_body_cache_;
+
   // Next unique column_id to allocate.  Pointer may come from AnalyzerOptions.
   zetasql_base::SequenceNumber* next_column_id_sequence_ = nullptr;  // Not owned.
   std::unique_ptr<zetasql_base::SequenceNumber> owned_column_id_sequence_;
@@ -51,6 +51,7 @@
 #include "zetasql/analyzer/resolver_common_inl.h"
 #include "zetasql/common/errors.h"
 #include "zetasql/common/internal_analyzer_options.h"
+#include "zetasql/common/resolver_stats.h"
 #include "zetasql/parser/ast_node.h"
 #include "zetasql/parser/ast_node_kind.h"
 #include "zetasql/parser/parse_tree.h"
@@ -589,8 +590,11 @@ absl::StatusOr<const google::protobuf::Descriptor*> Resolver::FindMessageTypeFor
   }
 
   const Type* found_type = nullptr;
+  internal::ResolverStats::ScopedCatalogLookup catalog_lookup(
+      internal::CatalogLookupKind::kType);
   const absl::Status find_type_status = catalog_->FindType(
       type_name_path, &found_type, analyzer_options_.find_options());
+  catalog_lookup.EndTiming();
   if (find_type_status.code() == absl::StatusCode::kNotFound) {
     // We don't give an error if it wasn't found.  That will happen in
     // the caller so it has a chance to try generating a better error.
@@ -1678,10 +1682,13 @@ absl::Status Resolver::ResolvePathExpressionAsExpression(
     // (4) We still haven't found a matching name. Try to resolve the longest
     // possible prefix of <path_expr> to a named constant.
     const Constant* constant = nullptr;
+    internal::ResolverStats::ScopedCatalogLookup catalog_lookup(
+        internal::CatalogLookupKind::kConstant);
     absl::Status find_constant_with_path_prefix_status =
         catalog_->FindConstantWithPathPrefix(path_expr.ToIdentifierVector(),
                                              &num_names_consumed, &constant,
                                              analyzer_options_.find_options());
+    catalog_lookup.EndTiming();
 
     // Handle the case where a constant was found or some internal error
     // occurred. If no constant was found, <num_names_consumed> is set to 0.
@@ -2701,10 +2708,13 @@ absl::Status Resolver::ResolveSystemVariableExpression(
 
   int num_names_consumed = 0;
   const Constant* constant = nullptr;
+  internal::ResolverStats::ScopedCatalogLookup catalog_lookup(
+      internal::CatalogLookupKind::kConstant);
   absl::Status find_constant_with_path_prefix_status =
       system_variables_catalog->FindConstantWithPathPrefix(
           path_parts, &num_names_consumed, &constant,
           analyzer_options_.find_options());
+  catalog_lookup.EndTiming();
 
   if (find_constant_with_path_prefix_status.code() ==
       absl::StatusCode::kNotFound) {
@@ -4642,9 +4652,12 @@ absl::Status Resolver::ResolveSequence(
     const ASTPathExpression* path_expr,
     std::unique_ptr<const ResolvedSequence>* resolved_sequence) {
   const Sequence* sequence = nullptr;
+  internal::ResolverStats::ScopedCatalogLookup catalog_lookup(
+      internal::CatalogLookupKind::kSequence);
   const absl::Status find_status =
       catalog_->FindSequence(path_expr->ToIdentifierVector(), &sequence,
                              analyzer_options_.find_options());
+  catalog_lookup.EndTiming();
 
   if (find_status.code() == absl::StatusCode::kNotFound) {
     std::string error_message;
@@ -7757,8 +7770,11 @@ absl::Status Resolver::LookupFunctionFromCatalog(
 
     stripped_name.remove_prefix(1);
     is_stripped = true;
+    internal::ResolverStats::ScopedCatalogLookup catalog_lookup(
+        internal::CatalogLookupKind::kFunction);
     find_status = catalog_->FindFunction(stripped_name, function,
                                          analyzer_options_.find_options());
+    catalog_lookup.EndTiming();
     if (find_status.ok()) {
       if (!(*function)->SupportsSafeErrorMode()) {
         return MakeSqlErrorAt(ast_location)
@@ -7768,8 +7784,11 @@ absl::Status Resolver::LookupFunctionFromCatalog(
       *error_mode = ResolvedFunctionCallBase::SAFE_ERROR_MODE;
     }
   } else {
+    internal::ResolverStats::ScopedCatalogLookup catalog_lookup(
+        internal::CatalogLookupKind::kFunction);
     find_status = catalog_->FindFunction(function_name_path, function,
                                          analyzer_options_.find_options());
+    catalog_lookup.EndTiming();
   }
 
   bool function_lookup_succeeded = find_status.ok();
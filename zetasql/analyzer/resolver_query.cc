@@ -55,6 +55,7 @@
 #include "zetasql/resolved_ast/node_sources.h"
 // This includes common macro definitions to define in the resolver cc files.
 #include "zetasql/common/string_util.h"
+#include "zetasql/common/resolver_stats.h"
 #include "zetasql/parser/ast_node.h"
 #include "zetasql/parser/ast_node_kind.h"
 #include "zetasql/parser/parse_tree.h"
@@ -8111,9 +8112,12 @@ absl::StatusOr<const TableValuedFunction*> FindTVFOrMakeNiceError(
     absl::string_view tvf_name_string, const ASTTVF* ast_tvf,
     const AnalyzerOptions& analyzer_options, Catalog* catalog) {
   const TableValuedFunction* tvf_catalog_entry = nullptr;
+  internal::ResolverStats::ScopedCatalogLookup catalog_lookup(
+      internal::CatalogLookupKind::kTableValuedFunction);
   const absl::Status find_status = catalog->FindTableValuedFunction(
       ast_tvf->name()->ToIdentifierVector(), &tvf_catalog_entry,
       analyzer_options.find_options());
+  catalog_lookup.EndTiming();
   if (find_status.code() == absl::StatusCode::kNotFound) {
     std::string error_message;
     absl::StrAppend(&error_message,
@@ -8190,24 +8194,41 @@ absl::Status Resolver::ResolveTVF(
   // Resolver if we are analyzing one or more templated function calls.
   std::shared_ptr<TVFSignature> tvf_signature;
   absl::Status resolve_status;
-  if (analyzer_options_.find_options().cycle_detector() == nullptr) {
-    // AnalyzerOptions is a very large object, and this stack frame is already
-    // huge. Allocate it on the heap to save some stack space.
-    struct AnalyzerAndCycleDetector {
-      CycleDetector owned_cycle_detector;
-      AnalyzerOptions analyzer_options;
-    };
-    auto cycle = std::make_unique<AnalyzerAndCycleDetector>(
-        AnalyzerAndCycleDetector{.analyzer_options = analyzer_options_});
-    cycle->analyzer_options.mutable_find_options()->set_cycle_detector(
-        &cycle->owned_cycle_detector);
-    resolve_status = tvf_catalog_entry->Resolve(
-        &cycle->analyzer_options, tvf_input_arguments, *result_signature,
-        catalog_, type_factory_, &tvf_signature);
-  } else {
-    resolve_status = tvf_catalog_entry->Resolve(
-        &analyzer_options_, tvf_input_arguments, *result_signature, catalog_,
-        type_factory_, &tvf_signature);
+  const bool is_templated_sql_tvf = tvf_catalog_entry->Is<TemplatedSQLTVF>();
+  if (is_templated_sql_tvf) {
+    // Reuse the body resolved for an earlier call with the same argument
+    // types, if any.
+    ZETASQL_ASSIGN_OR_RETURN(tvf_signature,
+                     templated_sql_body_cache_.FindTVFSignature(
+                         tvf_catalog_entry, tvf_input_arguments));
+  }
+  if (tvf_signature == nullptr) {
+    if (analyzer_options_.find_options().cycle_detector() == nullptr) {
+      // AnalyzerOptions is a very large object, and this stack frame is already
+      // huge. Allocate it on the heap to save some stack space.
+      struct AnalyzerAndCycleDetector {
+        CycleDetector owned_cycle_detector;
+        AnalyzerOptions analyzer_options;
+      };
+      auto cycle = std::make_unique<AnalyzerAndCycleDetector>(
+          AnalyzerAndCycleDetector{.analyzer_options = analyzer_options_});
+      cycle->analyzer_options.mutable_find_options()->set_cycle_detector(
+          &cycle->owned_cycle_detector);
+      resolve_status = tvf_catalog_entry->Resolve(
+          &cycle->analyzer_options, tvf_input_arguments, *result_signature,
+          catalog_, type_factory_, &tvf_signature);
+    } else {
+      resolve_status = tvf_catalog_entry->Resolve(
+          &analyzer_options_, tvf_input_arguments, *result_signature, catalog_,
+          type_factory_, &tvf_signature);
+    }
+    if (resolve_status.ok() && is_templated_sql_tvf &&
+        tvf_signature->Is<TemplatedSQLTVFSignature>()) {
+      templated_sql_body_cache_.AddTVFSignature(
+          tvf_catalog_entry, tvf_input_arguments,
+          std::static_pointer_cast<const TemplatedSQLTVFSignature>(
+              tvf_signature));
+    }
   }
 
   if (!resolve_status.ok()) {
@@ -9313,9 +9334,12 @@ absl::Status Resolver::ResolveArrayScan(
               ->GetAsOrDie<ASTPathExpression>();
       const Table* table = nullptr;
       int num_names_consumed = 0;
+      internal::ResolverStats::ScopedCatalogLookup catalog_lookup(
+          internal::CatalogLookupKind::kTable);
       const absl::Status find_status = catalog_->FindTableWithPathPrefix(
           path_expr->ToIdentifierVector(), analyzer_options_.find_options(),
           &num_names_consumed, &table);
+      catalog_lookup.EndTiming();
 
       if (find_status.ok()) {
         if (table != nullptr && num_names_consumed < path_expr->num_names()) {
@@ -9643,9 +9667,12 @@ absl::Status Resolver::ResolveModel(
     const ASTPathExpression* path_expr,
     std::unique_ptr<const ResolvedModel>* resolved_model) {
   const Model* model = nullptr;
+  internal::ResolverStats::ScopedCatalogLookup catalog_lookup(
+      internal::CatalogLookupKind::kModel);
   const absl::Status find_status =
       catalog_->FindModel(path_expr->ToIdentifierVector(), &model,
                           analyzer_options_.find_options());
+  catalog_lookup.EndTiming();
 
   if (find_status.code() == absl::StatusCode::kNotFound) {
     return MakeSqlErrorAt(path_expr)
@@ -9718,9 +9745,12 @@ absl::Status Resolver::ResolveConnection(
     const ASTPathExpression* path_expr,
     std::unique_ptr<const ResolvedConnection>* resolved_connection) {
   const Connection* connection = nullptr;
+  internal::ResolverStats::ScopedCatalogLookup catalog_lookup(
+      internal::CatalogLookupKind::kConnection);
   const absl::Status find_status =
       catalog_->FindConnection(path_expr->ToIdentifierVector(), &connection,
                                analyzer_options_.find_options());
+  catalog_lookup.EndTiming();
 
   if (find_status.code() == absl::StatusCode::kNotFound) {
     return MakeSqlErrorAt(path_expr)
@@ -9791,6 +9821,8 @@ absl::Status Resolver::ResolvePathExpressionAsTableScan(
 
   const Table* table = nullptr;
   int num_names_consumed = 0;
+  internal::ResolverStats::ScopedCatalogLookup catalog_lookup(
+      internal::CatalogLookupKind::kTable);
   const absl::Status find_status =
       remaining_names != nullptr
           ? catalog_->FindTableWithPathPrefix(path_expr->ToIdentifierVector(),
@@ -9798,6 +9830,7 @@ absl::Status Resolver::ResolvePathExpressionAsTableScan(
                                               &num_names_consumed, &table)
           : catalog_->FindTable(path_expr->ToIdentifierVector(), &table,
                                 analyzer_options_.find_options());
+  catalog_lookup.EndTiming();
   if (find_status.code() == absl::StatusCode::kNotFound) {
     std::string error_message;
     absl::StrAppend(&error_message,
@@ -146,6 +146,9 @@ absl::Status InternalRewriteResolvedAstNoConvertErrorLocation(
   // We might actually be able to drop this completely with a larger effort.
   std::unique_ptr<AnalyzerOptions> options_for_rewrite;
   std::unique_ptr<const ResolvedNode> last_rewrite_result;
+  // Whether any rewriter may have changed the tree. Rewriters that don't
+  // report changes are assumed to have made one.
+  bool any_rewriter_changed_tree = false;
 
   ZETASQL_VLOG(3) << "Enabled rewriters: "
           << absl::StrJoin(analyzer_options.enabled_rewrites(), " ",
@@ -213,6 +216,7 @@ absl::Status InternalRewriteResolvedAstNoConvertErrorLocation(
         rewriter->Rewrite(*options_for_rewrite, std::move(last_rewrite_result),
                           *catalog, *type_factory,
                           output_mutator.mutable_output_properties()));
+    any_rewriter_changed_tree = true;
   }
 
   const RewriteRegistry& rewrite_registry = RewriteRegistry::global_instance();
@@ -232,6 +236,11 @@ absl::Status InternalRewriteResolvedAstNoConvertErrorLocation(
             "Query exceeded configured maximum number of rewriter iterations (",
             kMaxIterations, ") without converging."));
       }
+      // Rewriters in this iteration that reported no change, and after which
+      // no other rewriter changed the tree. They are at a fixed point and
+      // need not run again, even if the relevance checker still flags them.
+      absl::btree_set<ResolvedASTRewrite> unchanged_rewrites;
+      bool tree_changed = false;
       for (ResolvedASTRewrite ast_rewrite :
            rewrite_registry.registration_order()) {
         if (!rewrites_to_apply.contains(ast_rewrite)) {
@@ -256,27 +265,34 @@ absl::Status InternalRewriteResolvedAstNoConvertErrorLocation(
         runtime_rewriter_details.count++;
 
         ZETASQL_VLOG(2) << "Running rewriter " << rewriter->Name();
+        bool changed = true;
         ZETASQL_ASSIGN_OR_RETURN(
             last_rewrite_result,
-            rewriter->Rewrite(
+            rewriter->RewriteWithChangeTracking(
                 *options_for_rewrite, std::move(last_rewrite_result), *catalog,
-                *type_factory, output_mutator.mutable_output_properties()));
+                *type_factory, output_mutator.mutable_output_properties(),
+                &changed));
 
         ZETASQL_RET_CHECK(last_rewrite_result != nullptr)
             << "Rewriter " << rewriter->Name()
             << " returned nullptr on input\n";
 
-        // For the time being, any rewriter that we call Rewrite on is making
-        // meaningful changes to the ResolvedAST tree, so we unconditionally
-        // record that it activates. When rewriters are cheaper on no-op, that
-        // will likely change such that a Rewriter might choose not to change
-        // anything when Rewrite is called. In that case, we need to let Rewrite
-        // signal that it made no meaning ful change.
-        // TODO: Add a way for Rewrite to signal that it made no
-        //     meaningful change.
+        if (changed) {
+          tree_changed = true;
+          any_rewriter_changed_tree = true;
+          unchanged_rewrites.clear();
+        } else {
+          ZETASQL_VLOG(2) << "Rewriter " << rewriter->Name() << " made no change";
+          unchanged_rewrites.insert(ast_rewrite);
+        }
       }
 
       rewrites_to_apply.clear();
+      if (!tree_changed) {
+        // Nothing changed, so the relevant rewriters are the same ones that
+        // just ran, and all of them are at a fixed point.
+        break;
+      }
       ZETASQL_ASSIGN_OR_RETURN(
           absl::btree_set<ResolvedASTRewrite> checker_detected_rewrites,
           FindRelevantRewriters(last_rewrite_result.get()));
@@ -287,6 +303,9 @@ absl::Status InternalRewriteResolvedAstNoConvertErrorLocation(
       // anonymization rewriter from its input.
       // TODO: Improve the checker to avoid false positives.
       rewrites_to_apply.erase(REWRITE_ANONYMIZATION);
+      for (ResolvedASTRewrite unchanged_rewrite : unchanged_rewrites) {
+        rewrites_to_apply.erase(unchanged_rewrite);
+      }
     } while (!rewrites_to_apply.empty());
   }
 
@@ -305,6 +324,7 @@ absl::Status InternalRewriteResolvedAstNoConvertErrorLocation(
         rewriter->Rewrite(*options_for_rewrite, std::move(last_rewrite_result),
                           *catalog, *type_factory,
                           output_mutator.mutable_output_properties()));
+    any_rewriter_changed_tree = true;
   }
 
   if (options_for_rewrite != nullptr) {
@@ -312,13 +332,23 @@ absl::Status InternalRewriteResolvedAstNoConvertErrorLocation(
         std::move(last_rewrite_result),
         *options_for_rewrite->column_id_sequence_number()));
 
-    if (InternalAnalyzerOptions::GetValidateResolvedAST(*options_for_rewrite)) {
+    // The tree was already validated after resolution, so it only needs
+    // validating again if a rewriter changed it.
+    const bool validate =
+        InternalAnalyzerOptions::GetValidateResolvedAST(*options_for_rewrite) &&
+        (any_rewriter_changed_tree ||
+         !InternalAnalyzerOptions::GetValidateOnlyChangedRewrittenAST(
+             *options_for_rewrite));
+    if (validate) {
       internal::ScopedTimer validator_scoped_timer =
           MakeScopedTimerStarted(&runtime_info.validator_timed_value());
       // Make sure the generated ResolvedAST is valid.
       ValidatorOptions validator_options{
           .allowed_hints_and_options =
-              analyzer_options.allowed_hints_and_options()};
+              analyzer_options.allowed_hints_and_options(),
+          .structural_validation_only =
+              InternalAnalyzerOptions::GetValidateResolvedASTStructureOnly(
+                  *options_for_rewrite)};
       Validator validator(analyzer_options.language(), validator_options);
       if (analyzer_output.resolved_statement() != nullptr) {
         ZETASQL_RETURN_IF_ERROR(validator.ValidateResolvedStatement(
@@ -381,25 +381,118 @@ class SqlFunctionInlineVistor : public ResolvedASTDeepCopyVisitor {
   FunctionCallBuilder fn_builder_;
 };
 
+// Rewrites the tree in place, and only copies the subtrees rooted at calls to
+// SQL UDFs, using SqlFunctionInlineVistor.  Untouched parts of the tree are
+// moved into the result rather than copied, so the cost of the rewrite is
+// proportional to the size of the inlined calls rather than of the tree.
+//
+// Calls nested in the arguments of an inlined call are inlined by the copy, in
+// the same order as when copying the whole tree.
+class SqlFunctionInlineRewriteVisitor : public ResolvedASTRewriteVisitor {
+ public:
+  SqlFunctionInlineRewriteVisitor(const AnalyzerOptions& analyzer_options,
+                                  Catalog& catalog,
+                                  ColumnFactory* column_factory,
+                                  TypeFactory& type_factory)
+      : analyzer_options_(analyzer_options),
+        catalog_(catalog),
+        column_factory_(column_factory),
+        type_factory_(type_factory) {}
+
+  // Number of subtrees rooted at an inlinable call that were rewritten.
+  int num_inlined_calls() const { return num_inlined_calls_; }
+
+ private:
+  absl::Status PreVisitResolvedFunctionCall(
+      const ResolvedFunctionCall& node) override {
+    if (outermost_inlinable_call_ != nullptr) {
+      return absl::OkStatus();
+    }
+    std::vector<std::string> arg_names;
+    const ResolvedExpr* fn_expression = nullptr;
+    ZETASQL_ASSIGN_OR_RETURN(bool is_inlinable, IsCallInlinableAndCollectInfo(
+                                            &node, arg_names, fn_expression));
+    if (is_inlinable) {
+      outermost_inlinable_call_ = &node;
+    }
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>>
+  PostVisitResolvedFunctionCall(
+      std::unique_ptr<const ResolvedFunctionCall> node) override {
+    if (node.get() != outermost_inlinable_call_) {
+      return node;
+    }
+    outermost_inlinable_call_ = nullptr;
+    ++num_inlined_calls_;
+    SqlFunctionInlineVistor copier(analyzer_options_, catalog_,
+                                   column_factory_, type_factory_);
+    ZETASQL_RETURN_IF_ERROR(node->Accept(&copier));
+    return copier.ConsumeRootNode<ResolvedNode>();
+  }
+
+  const AnalyzerOptions& analyzer_options_;
+  Catalog& catalog_;
+  ColumnFactory* column_factory_;
+  TypeFactory& type_factory_;
+
+  // The inlinable call whose subtree is being visited, if any.  The rewrite
+  // visitor keeps node pointers stable, so this identifies the call again in
+  // PostVisitResolvedFunctionCall().
+  const ResolvedFunctionCall* outermost_inlinable_call_ = nullptr;
+  int num_inlined_calls_ = 0;
+};
+
 class SqlFunctionInliner : public Rewriter {
  public:
   absl::StatusOr<std::unique_ptr<const ResolvedNode>> Rewrite(
-      const AnalyzerOptions& options, const ResolvedNode& input,
+      const AnalyzerOptions& options, std::unique_ptr<const ResolvedNode> input,
       Catalog& catalog, TypeFactory& type_factory,
       AnalyzerOutputProperties& output_properties) const override {
+    bool changed;
+    return RewriteWithChangeTracking(options, std::move(input), catalog,
+                                     type_factory, output_properties,
+                                     &changed);
+  }
+
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>>
+  RewriteWithChangeTracking(const AnalyzerOptions& options,
+                            std::unique_ptr<const ResolvedNode> input,
+                            Catalog& catalog, TypeFactory& type_factory,
+                            AnalyzerOutputProperties& output_properties,
+                            bool* changed) const override {
     ZETASQL_RET_CHECK(options.column_id_sequence_number() != nullptr);
     ColumnFactory column_factory(0, options.id_string_pool().get(),
                                  options.column_id_sequence_number());
 
-    SqlFunctionInlineVistor rewriter(options, catalog, &column_factory,
-                                     type_factory);
-    ZETASQL_RETURN_IF_ERROR(input.Accept(&rewriter));
-    return rewriter.ConsumeRootNode<ResolvedNode>();
+    SqlFunctionInlineRewriteVisitor rewriter(options, catalog, &column_factory,
+                                             type_factory);
+    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const ResolvedNode> output,
+                     rewriter.VisitAll(std::move(input)));
+    *changed = rewriter.num_inlined_calls() > 0;
+    return output;
   }
 
   std::string Name() const override { return "SqlFunctionInliner"; }
 };
 
+// Helper function that checks to see if a ResolvedTVFScan is a call to a SQL
+// TVF that may be inlined.
+static absl::StatusOr<bool> IsTvfCallInlinable(const ResolvedTVFScan* scan) {
+  if (scan->hint_list_size() > 0) {
+    // Function inlining leaves no place to hang function call hints. It's not
+    // clear that inlining a function call with hints is even the right thing
+    // to do.
+    return false;
+  }
+  const TableValuedFunction* function = scan->tvf();
+  ZETASQL_RET_CHECK_NE(function, nullptr)
+      << "Expected ResolvedTableFunctionScan to have non-null function";
+  return function->Is<SQLTableValuedFunction>() ||
+         function->Is<TemplatedSQLTVF>();
+}
+
 // A visitor that replaces calls to SQL TDFs with the resolved function body.
 class SqlTableFunctionInlineVistor : public ResolvedASTDeepCopyVisitor {
  public:
@@ -407,22 +500,8 @@ class SqlTableFunctionInlineVistor : public ResolvedASTDeepCopyVisitor {
       : column_factory_(column_factory) {}
 
  private:
-  absl::StatusOr<bool> IsCallInlinable(const ResolvedTVFScan* scan) {
-    if (scan->hint_list_size() > 0) {
-      // Function inlining leaves no place to hang function call hints. It's not
-      // clear that inlining a function call with hints is even the right thing
-      // to do.
-      return false;
-    }
-    const TableValuedFunction* function = scan->tvf();
-    ZETASQL_RET_CHECK_NE(function, nullptr)
-        << "Expected ResolvedTableFunctionScan to have non-null function";
-    return function->Is<SQLTableValuedFunction>() ||
-           function->Is<TemplatedSQLTVF>();
-  }
-
   absl::Status VisitResolvedTVFScan(const ResolvedTVFScan* tvf_scan) override {
-    ZETASQL_ASSIGN_OR_RETURN(bool inlinable, IsCallInlinable(tvf_scan));
+    ZETASQL_ASSIGN_OR_RETURN(bool inlinable, IsTvfCallInlinable(tvf_scan));
     if (inlinable) {
       return InlineTVF(tvf_scan);
     }
@@ -617,18 +696,72 @@ class SqlTableFunctionInlineVistor : public ResolvedASTDeepCopyVisitor {
   ColumnFactory* column_factory_;
 };
 
+// Like SqlFunctionInlineRewriteVisitor, but for calls to SQL TVFs.  Only the
+// subtrees rooted at inlinable TVF scans are copied, using
+// SqlTableFunctionInlineVistor.
+class SqlTableFunctionInlineRewriteVisitor : public ResolvedASTRewriteVisitor {
+ public:
+  explicit SqlTableFunctionInlineRewriteVisitor(ColumnFactory* column_factory)
+      : column_factory_(column_factory) {}
+
+  // Number of subtrees rooted at an inlinable TVF scan that were rewritten.
+  int num_inlined_calls() const { return num_inlined_calls_; }
+
+ private:
+  absl::Status PreVisitResolvedTVFScan(const ResolvedTVFScan& node) override {
+    if (outermost_inlinable_scan_ != nullptr) {
+      return absl::OkStatus();
+    }
+    ZETASQL_ASSIGN_OR_RETURN(bool is_inlinable, IsTvfCallInlinable(&node));
+    if (is_inlinable) {
+      outermost_inlinable_scan_ = &node;
+    }
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>> PostVisitResolvedTVFScan(
+      std::unique_ptr<const ResolvedTVFScan> node) override {
+    if (node.get() != outermost_inlinable_scan_) {
+      return node;
+    }
+    outermost_inlinable_scan_ = nullptr;
+    ++num_inlined_calls_;
+    SqlTableFunctionInlineVistor copier(column_factory_);
+    ZETASQL_RETURN_IF_ERROR(node->Accept(&copier));
+    return copier.ConsumeRootNode<ResolvedNode>();
+  }
+
+  ColumnFactory* column_factory_;
+  const ResolvedTVFScan* outermost_inlinable_scan_ = nullptr;
+  int num_inlined_calls_ = 0;
+};
+
 class SqlTvfInliner : public Rewriter {
  public:
   absl::StatusOr<std::unique_ptr<const ResolvedNode>> Rewrite(
-      const AnalyzerOptions& options, const ResolvedNode& input,
+      const AnalyzerOptions& options, std::unique_ptr<const ResolvedNode> input,
       Catalog& catalog, TypeFactory& type_factory,
       AnalyzerOutputProperties& output_properties) const override {
+    bool changed;
+    return RewriteWithChangeTracking(options, std::move(input), catalog,
+                                     type_factory, output_properties,
+                                     &changed);
+  }
+
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>>
+  RewriteWithChangeTracking(const AnalyzerOptions& options,
+                            std::unique_ptr<const ResolvedNode> input,
+                            Catalog& catalog, TypeFactory& type_factory,
+                            AnalyzerOutputProperties& output_properties,
+                            bool* changed) const override {
     ZETASQL_RET_CHECK(options.column_id_sequence_number() != nullptr);
     ColumnFactory column_factory(0, options.id_string_pool().get(),
                                  options.column_id_sequence_number());
-    SqlTableFunctionInlineVistor rewriter(&column_factory);
-    ZETASQL_RETURN_IF_ERROR(input.Accept(&rewriter));
-    return rewriter.ConsumeRootNode<ResolvedNode>();
+    SqlTableFunctionInlineRewriteVisitor rewriter(&column_factory);
+    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const ResolvedNode> output,
+                     rewriter.VisitAll(std::move(input)));
+    *changed = rewriter.num_inlined_calls() > 0;
+    return output;
   }
 
   std::string Name() const override { return "SqlTvfInliner"; }
@@ -29,7 +29,7 @@
 #include "zetasql/public/sql_view.h"
 #include "zetasql/public/types/type_factory.h"
 #include "zetasql/resolved_ast/resolved_ast.h"
-#include "zetasql/resolved_ast/resolved_ast_deep_copy_visitor.h"
+#include "zetasql/resolved_ast/resolved_ast_rewrite_visitor.h"
 #include "zetasql/resolved_ast/resolved_column.h"
 #include "zetasql/resolved_ast/resolved_node.h"
 #include "zetasql/resolved_ast/rewrite_utils.h"
@@ -47,13 +47,18 @@ namespace zetasql {
 namespace {
 
 // A visitor that replaces calls to SQL view scans with the resolved query.
-class SqlViewInlineVistor : public ResolvedASTDeepCopyVisitor {
+// The rest of the tree is rewritten in place rather than copied.
+class SqlViewInlineVistor : public ResolvedASTRewriteVisitor {
  public:
   explicit SqlViewInlineVistor(ColumnFactory* column_factory)
       : column_factory_(column_factory) {}
 
+  // Number of view scans inlined so far.
+  int num_inlined_views() const { return num_inlined_views_; }
+
  private:
   ColumnFactory* column_factory_;
+  int num_inlined_views_ = 0;
 
   absl::StatusOr<bool> IsScanInlinable(const ResolvedTableScan* scan) {
     const Table* table = scan->table();
@@ -85,16 +90,19 @@ class SqlViewInlineVistor : public ResolvedASTDeepCopyVisitor {
     return true;
   }
 
-  absl::Status VisitResolvedTableScan(const ResolvedTableScan* node) override {
-    ZETASQL_ASSIGN_OR_RETURN(bool is_inlinable, IsScanInlinable(node));
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>>
+  PostVisitResolvedTableScan(
+      std::unique_ptr<const ResolvedTableScan> node) override {
+    ZETASQL_ASSIGN_OR_RETURN(bool is_inlinable, IsScanInlinable(node.get()));
     if (is_inlinable) {
-      return InlineSqlView(node, node->table()->GetAs<SQLView>());
+      ++num_inlined_views_;
+      return InlineSqlView(node.get(), node->table()->GetAs<SQLView>());
     }
-    return CopyVisitResolvedTableScan(node);
+    return node;
   }
 
-  absl::Status InlineSqlView(const ResolvedTableScan* scan,
-                             const SQLView* view) {
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>> InlineSqlView(
+      const ResolvedTableScan* scan, const SQLView* view) {
     ZETASQL_RET_CHECK_NE(column_factory_, nullptr);
     ABSL_DCHECK(scan->table()->Is<SQLView>());
 
@@ -113,33 +121,47 @@ class SqlViewInlineVistor : public ResolvedASTDeepCopyVisitor {
               *column_factory_, *view_def, scan->column_index_list(),
               CreateReplacementColumns(*column_factory_, scan->column_list())));
 
-      PushNodeToStack(MakeResolvedExecuteAsRoleScan(
-          scan->column_list(), std::move(view_query), scan->table(),
-          /*original_inlined_tvf=*/nullptr));
-    } else {
-      ZETASQL_ASSIGN_OR_RETURN(
-          std::unique_ptr<ResolvedScan> view_query,
-          ReplaceScanColumns(*column_factory_, *view_def,
-                             scan->column_index_list(), scan->column_list()));
-      PushNodeToStack(std::move(view_query));
+      return MakeResolvedExecuteAsRoleScan(scan->column_list(),
+                                           std::move(view_query), scan->table(),
+                                           /*original_inlined_tvf=*/nullptr);
     }
-
-    return absl::OkStatus();
+    ZETASQL_ASSIGN_OR_RETURN(
+        std::unique_ptr<ResolvedScan> view_query,
+        ReplaceScanColumns(*column_factory_, *view_def,
+                           scan->column_index_list(), scan->column_list()));
+    return view_query;
   }
 };
 
 class SqlViewScanInliner : public Rewriter {
  public:
   absl::StatusOr<std::unique_ptr<const ResolvedNode>> Rewrite(
-      const AnalyzerOptions& options, const ResolvedNode& input,
+      const AnalyzerOptions& options, std::unique_ptr<const ResolvedNode> input,
       Catalog& catalog, TypeFactory& type_factory,
       AnalyzerOutputProperties& output_properties) const override {
+    bool changed;
+    return RewriteWithChangeTracking(options, std::move(input), catalog,
+                                     type_factory, output_properties,
+                                     &changed);
+  }
+
+  // Views that are not inlinable are still reported as relevant by the
+  // rewriter relevance checker, so report when nothing was inlined to let
+  // the driver converge.
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>>
+  RewriteWithChangeTracking(const AnalyzerOptions& options,
+                            std::unique_ptr<const ResolvedNode> input,
+                            Catalog& catalog, TypeFactory& type_factory,
+                            AnalyzerOutputProperties& output_properties,
+                            bool* changed) const override {
     ZETASQL_RET_CHECK(options.column_id_sequence_number() != nullptr);
     ColumnFactory column_factory(0, options.id_string_pool().get(),
                                  options.column_id_sequence_number());
     SqlViewInlineVistor rewriter(&column_factory);
-    ZETASQL_RETURN_IF_ERROR(input.Accept(&rewriter));
-    return rewriter.ConsumeRootNode<ResolvedNode>();
+    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const ResolvedNode> output,
+                     rewriter.VisitAll(std::move(input)));
+    *changed = rewriter.num_inlined_views() > 0;
+    return output;
   }
 
   std::string Name() const override { return "SqlViewScanInliner"; }
@@ -44,6 +44,7 @@
 #include "zetasql/public/types/type_factory.h"
 #include "zetasql/resolved_ast/resolved_ast.h"
 #include "zetasql/resolved_ast/resolved_ast_deep_copy_visitor.h"
+#include "zetasql/resolved_ast/resolved_ast_rewrite_visitor.h"
 #include "zetasql/resolved_ast/resolved_column.h"
 #include "zetasql/resolved_ast/resolved_node.h"
 #include "zetasql/resolved_ast/rewrite_utils.h"
@@ -123,21 +124,67 @@ absl::Status WithExprRewriterVisitor::VisitResolvedWithExpr(
   return absl::OkStatus();
 }
 
+// Rewrites the tree in place, and only copies the subtrees rooted at
+// outermost ResolvedWithExprs, using WithExprRewriterVisitor.  The rest of the
+// tree is moved into the result rather than copied.  Nested ResolvedWithExprs
+// are rewritten by the copy, in the same order as when copying the whole tree.
+class WithExprInPlaceRewriteVisitor : public ResolvedASTRewriteVisitor {
+ public:
+  explicit WithExprInPlaceRewriteVisitor(ColumnFactory* column_factory)
+      : column_factory_(column_factory) {}
+
+  // Number of outermost ResolvedWithExprs that were rewritten.
+  int num_rewritten() const { return num_rewritten_; }
+
+ private:
+  absl::Status PreVisitResolvedWithExpr(const ResolvedWithExpr&) override {
+    ++with_expr_depth_;
+    return absl::OkStatus();
+  }
+
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>> PostVisitResolvedWithExpr(
+      std::unique_ptr<const ResolvedWithExpr> node) override {
+    if (--with_expr_depth_ > 0) {
+      return node;
+    }
+    ++num_rewritten_;
+    WithExprRewriterVisitor copier(column_factory_);
+    ZETASQL_RETURN_IF_ERROR(node->Accept(&copier));
+    return copier.ConsumeRootNode<ResolvedNode>();
+  }
+
+  ColumnFactory* column_factory_;
+  int with_expr_depth_ = 0;
+  int num_rewritten_ = 0;
+};
+
 }  // namespace
 
 class WithExprRewriter : public Rewriter {
  public:
   absl::StatusOr<std::unique_ptr<const ResolvedNode>> Rewrite(
-      const AnalyzerOptions& options, const ResolvedNode& input,
+      const AnalyzerOptions& options, std::unique_ptr<const ResolvedNode> input,
       Catalog& catalog, TypeFactory& type_factory,
       AnalyzerOutputProperties& output_properties) const override {
+    bool changed;
+    return RewriteWithChangeTracking(options, std::move(input), catalog,
+                                     type_factory, output_properties,
+                                     &changed);
+  }
+
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>>
+  RewriteWithChangeTracking(const AnalyzerOptions& options,
+                            std::unique_ptr<const ResolvedNode> input,
+                            Catalog& catalog, TypeFactory& type_factory,
+                            AnalyzerOutputProperties& output_properties,
+                            bool* changed) const override {
     ZETASQL_RET_CHECK(options.column_id_sequence_number() != nullptr);
     ColumnFactory column_factory(0, options.id_string_pool().get(),
                                  options.column_id_sequence_number());
-    WithExprRewriterVisitor rewriter(&column_factory);
-    ZETASQL_RETURN_IF_ERROR(input.Accept(&rewriter));
+    WithExprInPlaceRewriteVisitor rewriter(&column_factory);
     ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const ResolvedNode> result,
-                     rewriter.ConsumeRootNode<ResolvedNode>());
+                     rewriter.VisitAll(std::move(input)));
+    *changed = rewriter.num_rewritten() > 0;
     return result;
   }
 
@@ -31,6 +31,7 @@
 #include "google/protobuf/text_format.h"
 #include "zetasql/analyzer/analyzer_output_mutator.h"
 #include "zetasql/analyzer/analyzer_test_options.h"
+#include "zetasql/common/internal_analyzer_options.h"
 #include "zetasql/common/status_payload_utils.h"
 #include "zetasql/base/testing/status_matchers.h"  
 #include "zetasql/common/unicode_utils.h"
@@ -65,6 +66,7 @@
 #include "zetasql/public/value.h"
 #include "zetasql/resolved_ast/resolved_ast.h"
 #include "zetasql/resolved_ast/resolved_ast.pb.h"
+#include "zetasql/resolved_ast/resolved_ast_binary_serializer.h"
 #include "zetasql/resolved_ast/resolved_ast_comparator.h"
 #include "zetasql/resolved_ast/resolved_ast_deep_copy_visitor.h"
 #include "zetasql/resolved_ast/resolved_ast_enums.pb.h"
@@ -420,6 +422,7 @@ class AnalyzerTestRunner {
 
     TypeFactory type_factory;
     AnalyzerOptions options;
+    InternalAnalyzerOptions::SetRecordResolvedNodeCount(options, true);
 
     if (test_case_options_.GetBool(kEnableSampleAnnotation)) {
       engine_specific_annotation_specs_.push_back(
@@ -1782,6 +1785,22 @@ class AnalyzerTestRunner {
     auto restored = ResolvedStatement::RestoreFrom(proto, restore_params);
     ZETASQL_ASSERT_OK(restored.status()) << "error restoring: " << proto.DebugString();
     EXPECT_EQ(original_debug_string, restored.value()->DebugString());
+
+    // The binary format preserves parse locations, so it is compared against
+    // the original tree.
+    FileDescriptorSetMap binary_map;
+    std::string binary;
+    ZETASQL_ASSERT_OK(ResolvedASTBinarySerializer::Serialize(
+        orig_output.resolved_statement(), &binary_map, &binary));
+    std::vector<const google::protobuf::DescriptorPool*> binary_pools;
+    for (const auto& elem : binary_map) binary_pools.push_back(elem.first);
+    ResolvedNode::RestoreParams binary_restore_params(
+        binary_pools, catalog, type_factory, options.id_string_pool().get());
+    auto binary_restored =
+        ResolvedASTBinarySerializer::Deserialize(binary, binary_restore_params);
+    ZETASQL_ASSERT_OK(binary_restored.status());
+    EXPECT_EQ(orig_output.resolved_statement()->DebugString(),
+              binary_restored.value()->DebugString());
   }
 
   void CheckValidatorCoverage(const AnalyzerOptions& options,
@@ -2804,9 +2823,16 @@ void ValidateRuntimeInfo(const AnalyzerRuntimeInfo& info) {
   EXPECT_GT(info.overall_timed_value().elapsed_duration(),
             absl::ZeroDuration());
 
+  // Statements like COMMIT don't look anything up in the catalog, so
+  // catalog_lookup_count() may be zero.
+  EXPECT_GT(info.resolver_stats().resolved_node_count(), 0);
+  EXPECT_LE(info.resolver_stats().catalog_timed_value().elapsed_duration(),
+            info.resolver_timed_value().elapsed_duration());
+
   AnalyzerLogEntry log_entry = info.log_entry();
 
   EXPECT_GT(log_entry.num_lexical_tokens(), 0);
+  EXPECT_GT(log_entry.resolver_stats().resolved_node_count(), 0);
 
   std::vector<AnalyzerLogEntry::LoggedOperationCategory> expected_categories = {
       AnalyzerLogEntry::RESOLVER, AnalyzerLogEntry::PARSER};
@@ -0,0 +1,213 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/analyzer/templated_sql_body_cache.h"
+
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "zetasql/public/function.h"
+#include "zetasql/public/input_argument_type.h"
+#include "zetasql/public/table_valued_function.h"
+#include "zetasql/public/templated_sql_function.h"
+#include "zetasql/public/templated_sql_tvf.h"
+#include "zetasql/public/type.h"
+#include "zetasql/resolved_ast/resolved_ast.h"
+#include "zetasql/resolved_ast/resolved_ast_deep_copy_visitor.h"
+#include "zetasql/resolved_ast/rewrite_utils.h"
+#include "absl/status/statusor.h"
+#include "zetasql/base/status_macros.h"
+
+namespace zetasql {
+
+namespace {
+
+// Returns a copy of <node>, a part of a cached body.  If <column_factory> is
+// non-NULL, all columns are replaced by new columns, consistently with the
+// other parts of the same body copied with the same <column_map>.
+template <class T>
+absl::StatusOr<std::unique_ptr<const T>> CopyCachedNode(
+    const T& node, ColumnFactory* column_factory,
+    ColumnReplacementMap& column_map) {
+  if (column_factory == nullptr) {
+    return ResolvedASTDeepCopyVisitor::Copy(&node);
+  }
+  return CopyResolvedASTAndRemapColumns(node, *column_factory, column_map);
+}
+
+std::vector<const Type*> GetArgumentTypes(
+    const std::vector<InputArgumentType>& arguments) {
+  std::vector<const Type*> types;
+  types.reserve(arguments.size());
+  for (const InputArgumentType& argument : arguments) {
+    types.push_back(argument.type());
+  }
+  return types;
+}
+
+// Returns true if <argument> is of a kind that the templated SQL TVF body can
+// depend on, i.e. a scalar or a relation.
+bool IsCacheableTVFArgument(const TVFInputArgumentType& argument) {
+  return argument.is_scalar() || argument.is_relation();
+}
+
+// Returns true if a templated SQL TVF body resolved for <a> is also valid for
+// <b>.  Only the types of scalar arguments matter; their values are not
+// visible to the body.
+bool SameTVFArgumentTypes(const TVFInputArgumentType& a,
+                          const TVFInputArgumentType& b) {
+  if (a.is_relation()) {
+    return b.is_relation() && a.relation() == b.relation();
+  }
+  if (!a.is_scalar() || !b.is_scalar()) {
+    return false;
+  }
+  const absl::StatusOr<InputArgumentType> a_type = a.GetScalarArgType();
+  const absl::StatusOr<InputArgumentType> b_type = b.GetScalarArgType();
+  return a_type.ok() && b_type.ok() && a_type->type() == b_type->type();
+}
+
+bool SameTVFArgumentTypes(const std::vector<TVFInputArgumentType>& a,
+                          const std::vector<TVFInputArgumentType>& b) {
+  if (a.size() != b.size()) return false;
+  for (int i = 0; i < a.size(); ++i) {
+    if (!SameTVFArgumentTypes(a[i], b[i])) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+absl::StatusOr<std::shared_ptr<ResolvedFunctionCallInfo>>
+TemplatedSQLBodyCache::FindFunctionCall(
+    const Function* function,
+    const std::vector<InputArgumentType>& arguments) const {
+  auto it = function_calls_.find(
+      FunctionCallKey(function, GetArgumentTypes(arguments)));
+  if (it == function_calls_.end()) {
+    return nullptr;
+  }
+  const TemplatedSQLFunctionCall& cached = *it->second;
+
+  std::optional<ColumnFactory> column_factory;
+  if (column_id_sequence_ != nullptr) {
+    column_factory.emplace(/*max_col_id=*/0, id_string_pool_,
+                           column_id_sequence_);
+  }
+  ColumnFactory* column_factory_ptr =
+      column_factory.has_value() ? &*column_factory : nullptr;
+  ColumnReplacementMap column_map;
+
+  // Copy the aggregate columns first so that references to them from the
+  // expression are remapped consistently.
+  std::vector<std::unique_ptr<const ResolvedComputedColumn>> aggregate_columns;
+  aggregate_columns.reserve(cached.aggregate_expression_list().size());
+  for (const std::unique_ptr<const ResolvedComputedColumn>& aggregate_column :
+       cached.aggregate_expression_list()) {
+    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const ResolvedComputedColumn> copy,
+                     CopyCachedNode(*aggregate_column, column_factory_ptr,
+                                    column_map));
+    aggregate_columns.push_back(std::move(copy));
+  }
+  ZETASQL_ASSIGN_OR_RETURN(
+      std::unique_ptr<const ResolvedExpr> expr,
+      CopyCachedNode(*cached.expr(), column_factory_ptr, column_map));
+  return std::make_shared<TemplatedSQLFunctionCall>(
+      std::move(expr), std::move(aggregate_columns));
+}
+
+void TemplatedSQLBodyCache::AddFunctionCall(
+    const Function* function, const std::vector<InputArgumentType>& arguments,
+    std::shared_ptr<const TemplatedSQLFunctionCall> call_info) {
+  if (num_entries_ >= kMaxEntries) return;
+  std::vector<const Type*> argument_types = GetArgumentTypes(arguments);
+  for (const Type* type : argument_types) {
+    // Arguments without a type, like lambdas, are not part of the key.
+    if (type == nullptr) return;
+  }
+  if (function_calls_
+          .emplace(FunctionCallKey(function, std::move(argument_types)),
+                   std::move(call_info))
+          .second) {
+    ++num_entries_;
+  }
+}
+
+absl::StatusOr<std::shared_ptr<TVFSignature>>
+TemplatedSQLBodyCache::FindTVFSignature(
+    const TableValuedFunction* tvf,
+    const std::vector<TVFInputArgumentType>& arguments) const {
+  auto it = tvf_signatures_.find(tvf);
+  if (it == tvf_signatures_.end()) {
+    return nullptr;
+  }
+  for (const TVFEntry& entry : it->second) {
+    if (!SameTVFArgumentTypes(entry.arguments, arguments)) continue;
+    const TemplatedSQLTVFSignature& cached = *entry.signature;
+
+    std::optional<ColumnFactory> column_factory;
+    if (column_id_sequence_ != nullptr) {
+      column_factory.emplace(/*max_col_id=*/0, id_string_pool_,
+                             column_id_sequence_);
+    }
+    ColumnReplacementMap column_map;
+    ZETASQL_ASSIGN_OR_RETURN(
+        std::unique_ptr<const ResolvedQueryStmt> query,
+        CopyCachedNode(*cached.resolved_templated_query(),
+                       column_factory.has_value() ? &*column_factory : nullptr,
+                       column_map));
+
+    // The signature records the actual arguments of this call, which may have
+    // different literal values than the cached one.
+    auto signature = std::make_shared<TemplatedSQLTVFSignature>(
+        arguments, cached.result_schema(), cached.options(), std::move(query),
+        cached.GetArgumentNames());
+    if (std::optional<const AnonymizationInfo> anonymization_info =
+            cached.GetAnonymizationInfo();
+        anonymization_info.has_value()) {
+      signature->SetAnonymizationInfo(
+          std::make_unique<AnonymizationInfo>(*anonymization_info));
+    }
+    return signature;
+  }
+  return nullptr;
+}
+
+void TemplatedSQLBodyCache::AddTVFSignature(
+    const TableValuedFunction* tvf,
+    const std::vector<TVFInputArgumentType>& arguments,
+    std::shared_ptr<const TemplatedSQLTVFSignature> signature) {
+  if (num_entries_ >= kMaxEntries) return;
+  for (const TVFInputArgumentType& argument : arguments) {
+    if (!IsCacheableTVFArgument(argument)) return;
+  }
+  std::vector<TVFEntry>& entries = tvf_signatures_[tvf];
+  for (const TVFEntry& entry : entries) {
+    if (SameTVFArgumentTypes(entry.arguments, arguments)) return;
+  }
+  entries.push_back({arguments, std::move(signature)});
+  ++num_entries_;
+}
+
+void TemplatedSQLBodyCache::Clear() {
+  function_calls_.clear();
+  tvf_signatures_.clear();
+  num_entries_ = 0;
+}
+
+}  // namespace zetasql
@@ -0,0 +1,126 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef ZETASQL_ANALYZER_TEMPLATED_SQL_BODY_CACHE_H_
+#define ZETASQL_ANALYZER_TEMPLATED_SQL_BODY_CACHE_H_
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "zetasql/base/atomic_sequence_num.h"
+#include "zetasql/public/function.h"
+#include "zetasql/public/id_string.h"
+#include "zetasql/public/input_argument_type.h"
+#include "zetasql/public/table_valued_function.h"
+#include "zetasql/public/templated_sql_function.h"
+#include "zetasql/public/templated_sql_tvf.h"
+#include "zetasql/public/type.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/statusor.h"
+
+namespace zetasql {
+
+// Caches the resolved bodies of calls to templated SQL functions and TVFs, so
+// that a templated function called many times with the same argument types is
+// only parsed and resolved once.
+//
+// Entries are keyed by the Function or TableValuedFunction and the concrete
+// argument types of the call.  The body of a templated function also depends on
+// the LanguageOptions and Catalog used to resolve it, so a cache must only be
+// used by one Resolver, and must not outlive the Catalog and TypeFactory that
+// the cached types and functions come from.
+//
+// Callers get their own copy of a cached body, so that every call site still
+// owns an independent tree:
+//  - If <column_id_sequence> is NULL, each nested resolution of a templated
+//    body allocates column ids starting from 1, so the copy keeps the cached
+//    column ids and is identical to what resolving the body again would give.
+//  - Otherwise, every column in the copy is replaced by a new column
+//    allocated from <column_id_sequence>, which keeps column ids unique across
+//    the statement like they would be if the body was resolved again.
+//
+// Resolution errors are not cached, so error messages are unaffected.  The
+// cache is bounded by kMaxEntries; once it is full, new bodies are not added.
+class TemplatedSQLBodyCache {
+ public:
+  static constexpr int kMaxEntries = 256;
+
+  // <id_string_pool> and <column_id_sequence> must outlive this object.
+  // <column_id_sequence> may be NULL.
+  TemplatedSQLBodyCache(IdStringPool* id_string_pool,
+                        zetasql_base::SequenceNumber* column_id_sequence)
+      : id_string_pool_(id_string_pool),
+        column_id_sequence_(column_id_sequence) {}
+  TemplatedSQLBodyCache(const TemplatedSQLBodyCache&) = delete;
+  TemplatedSQLBodyCache& operator=(const TemplatedSQLBodyCache&) = delete;
+
+  // Returns a copy of the TemplatedSQLFunctionCall previously added for a call
+  // of <function> with <arguments>, or NULL if there is none.
+  absl::StatusOr<std::shared_ptr<ResolvedFunctionCallInfo>> FindFunctionCall(
+      const Function* function,
+      const std::vector<InputArgumentType>& arguments) const;
+
+  // Adds the <call_info> resolved for a call of <function> with <arguments>.
+  void AddFunctionCall(
+      const Function* function, const std::vector<InputArgumentType>& arguments,
+      std::shared_ptr<const TemplatedSQLFunctionCall> call_info);
+
+  // Returns a TVFSignature for a call of <tvf> with <arguments>, with a copy
+  // of the templated query previously added for a call with the same argument
+  // types, or NULL if there is none.
+  absl::StatusOr<std::shared_ptr<TVFSignature>> FindTVFSignature(
+      const TableValuedFunction* tvf,
+      const std::vector<TVFInputArgumentType>& arguments) const;
+
+  // Adds the <signature> resolved for a call of <tvf> with <arguments>.  Does
+  // nothing if any argument is not a scalar or a relation.
+  void AddTVFSignature(
+      const TableValuedFunction* tvf,
+      const std::vector<TVFInputArgumentType>& arguments,
+      std::shared_ptr<const TemplatedSQLTVFSignature> signature);
+
+  // Returns the number of bodies in the cache.
+  int size() const { return num_entries_; }
+
+  void Clear();
+
+ private:
+  using FunctionCallKey =
+      std::pair<const Function*, std::vector<const Type*>>;
+
+  struct TVFEntry {
+    std::vector<TVFInputArgumentType> arguments;
+    std::shared_ptr<const TemplatedSQLTVFSignature> signature;
+  };
+
+  IdStringPool* id_string_pool_;                    // Not owned.
+  zetasql_base::SequenceNumber* column_id_sequence_;  // Not owned.
+
+  absl::flat_hash_map<FunctionCallKey,
+                      std::shared_ptr<const TemplatedSQLFunctionCall>>
+      function_calls_;
+  // TVF arguments include relations, which are compared column by column, so
+  // the entries for each TVF are searched linearly.  Templated TVFs are
+  // usually called with very few distinct argument types in one statement.
+  absl::flat_hash_map<const TableValuedFunction*, std::vector<TVFEntry>>
+      tvf_signatures_;
+  int num_entries_ = 0;
+};
+
+}  // namespace zetasql
+
+#endif  // ZETASQL_ANALYZER_TEMPLATED_SQL_BODY_CACHE_H_
@@ -0,0 +1,113 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/common/binary_serialization.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "zetasql/public/id_string.h"
+#include "zetasql/public/parse_location.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "zetasql/base/status_macros.h"
+
+namespace zetasql {
+namespace binary_serialization_internal {
+
+uint64_t BinaryWriter::InternString(absl::string_view value) {
+  auto [it, inserted] = string_indexes_.try_emplace(value, strings_.size());
+  if (inserted) {
+    strings_.push_back(value);
+  }
+  return it->second;
+}
+
+uint64_t BinaryWriter::InternOwnedString(std::string value) {
+  auto it = string_indexes_.find(value);
+  if (it != string_indexes_.end()) {
+    return it->second;
+  }
+  owned_strings_.push_back(std::move(value));
+  return InternString(owned_strings_.back());
+}
+
+void BinaryWriter::AppendHeader(absl::string_view magic, uint64_t version,
+                                std::string* output) const {
+  output->append(magic.data(), magic.size());
+  AppendVarint(version, output);
+  AppendVarint(strings_.size(), output);
+  for (absl::string_view str : strings_) {
+    AppendVarint(str.size(), output);
+    output->append(str.data(), str.size());
+  }
+}
+
+absl::Status BinaryReader::ReadHeader(absl::string_view magic,
+                                      uint64_t version) {
+  if (data_.substr(0, magic.size()) != magic) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Input is not a serialized ", format_name_));
+  }
+  data_.remove_prefix(magic.size());
+  const uint64_t data_version = ReadVarint();
+  ZETASQL_RETURN_IF_ERROR(status_);
+  if (data_version != version) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Unsupported serialized ", format_name_, " version ",
+                     data_version, "; expected ", version));
+  }
+
+  // Every string takes at least one byte for its length.
+  const uint64_t num_strings = ReadCount();
+  ZETASQL_RETURN_IF_ERROR(status_);
+  strings_.reserve(num_strings);
+  for (uint64_t i = 0; i < num_strings; ++i) {
+    const uint64_t size = ReadVarint();
+    if (size > data_.size()) {
+      SetError("string table is truncated");
+    }
+    ZETASQL_RETURN_IF_ERROR(status_);
+    strings_.push_back(data_.substr(0, size));
+    data_.remove_prefix(size);
+  }
+  interned_strings_.resize(num_strings);
+  return absl::OkStatus();
+}
+
+ParseLocationPoint BinaryReader::ReadLocationPoint() {
+  // The filename must outlive the returned point, so it is interned.
+  const IdString filename = ReadIdString();
+  const uint64_t byte_offset_plus_one = ReadVarint();
+  if (byte_offset_plus_one == 0) {
+    return ParseLocationPoint();
+  }
+  return ParseLocationPoint::FromByteOffset(
+      filename.ToStringView(), static_cast<int>(byte_offset_plus_one - 1));
+}
+
+void BinaryReader::SetError(absl::string_view message) {
+  if (status_.ok()) {
+    status_ = absl::InvalidArgumentError(
+        absl::StrCat("Invalid serialized ", format_name_, ": ", message));
+  }
+  data_ = absl::string_view();
+}
+
+}  // namespace binary_serialization_internal
+}  // namespace zetasql
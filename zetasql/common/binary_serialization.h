@@ -0,0 +1,205 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef ZETASQL_COMMON_BINARY_SERIALIZATION_H_
+#define ZETASQL_COMMON_BINARY_SERIALIZATION_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "zetasql/public/id_string.h"
+#include "zetasql/public/parse_location.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+
+// The encoding shared by ParseTreeBinarySerializer and
+// ResolvedASTBinarySerializer.  A buffer starts with a 4 byte magic number, a
+// varint format version and a table of distinct strings.  Integers are stored
+// as varints, signed integers zigzag-encoded, and strings as indexes into the
+// table.  Whatever follows the string table is up to the serializer.
+namespace zetasql {
+namespace binary_serialization_internal {
+
+inline void AppendVarint(uint64_t value, std::string* output) {
+  while (value >= 0x80) {
+    output->push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  output->push_back(static_cast<char>(value));
+}
+
+// Zigzag encoding keeps small negative values small.
+inline uint64_t ZigZagEncode(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^
+         static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t ZigZagDecode(uint64_t value) {
+  return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+// Writes values to a body buffer, interning strings into the string table.
+class BinaryWriter {
+ public:
+  BinaryWriter() = default;
+  BinaryWriter(const BinaryWriter&) = delete;
+  BinaryWriter& operator=(const BinaryWriter&) = delete;
+
+  void WriteVarint(uint64_t value) { AppendVarint(value, &body_); }
+
+  void WriteSignedVarint(int64_t value) { WriteVarint(ZigZagEncode(value)); }
+
+  void WriteBool(bool value) { WriteVarint(value ? 1 : 0); }
+
+  // <value> must stay alive until the string table is written.
+  void WriteString(absl::string_view value) {
+    WriteVarint(InternString(value));
+  }
+
+  void WriteIdString(IdString value) { WriteString(value.ToStringView()); }
+
+  // Invalid points have byte offset -1, so offsets are stored plus one.
+  void WriteLocationPoint(const ParseLocationPoint& point) {
+    WriteString(point.filename());
+    WriteVarint(static_cast<uint64_t>(point.GetByteOffset() + 1));
+  }
+
+  // Returns the index of <value> in the string table.  <value> must stay
+  // alive until the string table is written.
+  uint64_t InternString(absl::string_view value);
+
+  // As InternString, for strings that are not owned by the caller, such as
+  // serialized protos.
+  uint64_t InternOwnedString(std::string value);
+
+  // Appends the magic number, <version> and the string table to <output>.
+  void AppendHeader(absl::string_view magic, uint64_t version,
+                    std::string* output) const;
+
+  // The values written so far.
+  const std::string& body() const { return body_; }
+
+ private:
+  std::string body_;
+  std::vector<absl::string_view> strings_;
+  absl::flat_hash_map<absl::string_view, uint64_t> string_indexes_;
+  // A deque, so that views into its elements stay valid.
+  std::deque<std::string> owned_strings_;
+};
+
+// Reads values written by BinaryWriter.  Errors are sticky: once a read fails,
+// all further reads return default values and status() returns the first
+// error, so callers only need to check status() after reading a group of
+// values.
+class BinaryReader {
+ public:
+  // <format_name> names the serialized data in error messages, as in
+  // "Invalid serialized <format_name>".  IdStrings are made in
+  // <id_string_pool>, which must outlive them.
+  BinaryReader(absl::string_view data, absl::string_view format_name,
+               IdStringPool* id_string_pool)
+      : data_(data),
+        format_name_(format_name),
+        id_string_pool_(id_string_pool) {}
+  BinaryReader(const BinaryReader&) = delete;
+  BinaryReader& operator=(const BinaryReader&) = delete;
+
+  // Reads the magic number, the version and the string table.
+  absl::Status ReadHeader(absl::string_view magic, uint64_t version);
+
+  uint64_t ReadVarint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (data_.empty()) {
+        SetError("unexpected end of input");
+        return 0;
+      }
+      const uint8_t byte = static_cast<uint8_t>(data_.front());
+      data_.remove_prefix(1);
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) return value;
+    }
+    SetError("varint is too long");
+    return 0;
+  }
+
+  int64_t ReadSignedVarint() { return ZigZagDecode(ReadVarint()); }
+
+  bool ReadBool() { return ReadVarint() != 0; }
+
+  // Reads the size of a vector whose elements take at least one byte each.
+  uint64_t ReadCount() {
+    const uint64_t count = ReadVarint();
+    if (count > data_.size()) {
+      SetError("count is too large");
+      return 0;
+    }
+    return count;
+  }
+
+  // The returned string_view points into the input.
+  absl::string_view ReadString() { return GetString(ReadVarint()); }
+
+  // Returns the string at <index> in the string table.
+  absl::string_view GetString(uint64_t index) {
+    if (index >= strings_.size()) {
+      SetError("string index is out of range");
+      return "";
+    }
+    return strings_[index];
+  }
+
+  // Each distinct string is interned in the IdStringPool at most once.
+  IdString ReadIdString() {
+    const uint64_t index = ReadVarint();
+    if (index >= strings_.size()) {
+      SetError("string index is out of range");
+      return IdString();
+    }
+    std::optional<IdString>& interned = interned_strings_[index];
+    if (!interned.has_value()) {
+      interned = id_string_pool_->Make(strings_[index]);
+    }
+    return *interned;
+  }
+
+  ParseLocationPoint ReadLocationPoint();
+
+  // The number of unread bytes.
+  size_t remaining() const { return data_.size(); }
+
+  const absl::Status& status() const { return status_; }
+
+  void SetError(absl::string_view message);
+
+ private:
+  absl::string_view data_;
+  absl::string_view format_name_;
+  IdStringPool* id_string_pool_;
+  std::vector<absl::string_view> strings_;
+  std::vector<std::optional<IdString>> interned_strings_;
+  absl::Status status_;
+};
+
+}  // namespace binary_serialization_internal
+}  // namespace zetasql
+
+#endif  // ZETASQL_COMMON_BINARY_SERIALIZATION_H_
@@ -0,0 +1,159 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/common/binary_serialization.h"
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include "zetasql/base/testing/status_matchers.h"
+#include "zetasql/public/id_string.h"
+#include "zetasql/public/parse_location.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+
+namespace zetasql {
+namespace binary_serialization_internal {
+namespace {
+
+using ::testing::HasSubstr;
+using ::zetasql_base::testing::StatusIs;
+
+constexpr absl::string_view kMagic = "TEST";
+constexpr uint64_t kVersion = 3;
+
+std::string Finish(const BinaryWriter& writer) {
+  std::string output;
+  writer.AppendHeader(kMagic, kVersion, &output);
+  output.append(writer.body());
+  return output;
+}
+
+TEST(BinarySerializationTest, ZigZag) {
+  for (int64_t value : {int64_t{0}, int64_t{1}, int64_t{-1}, int64_t{63},
+                        int64_t{-64}, std::numeric_limits<int64_t>::max(),
+                        std::numeric_limits<int64_t>::min()}) {
+    EXPECT_EQ(ZigZagDecode(ZigZagEncode(value)), value);
+  }
+  EXPECT_EQ(ZigZagEncode(0), 0);
+  EXPECT_EQ(ZigZagEncode(-1), 1);
+  EXPECT_EQ(ZigZagEncode(1), 2);
+}
+
+TEST(BinarySerializationTest, RoundTrip) {
+  BinaryWriter writer;
+  writer.WriteVarint(0);
+  writer.WriteVarint(std::numeric_limits<uint64_t>::max());
+  writer.WriteSignedVarint(-12345);
+  writer.WriteBool(true);
+  writer.WriteString("abc");
+  writer.WriteString("abc");
+  writer.WriteVarint(writer.InternOwnedString(std::string("owned")));
+  IdStringPool writer_pool;
+  writer.WriteIdString(writer_pool.Make("id"));
+  writer.WriteLocationPoint(ParseLocationPoint::FromByteOffset("file", 7));
+  writer.WriteLocationPoint(ParseLocationPoint());
+  const std::string data = Finish(writer);
+
+  IdStringPool pool;
+  BinaryReader reader(data, "test data", &pool);
+  ZETASQL_ASSERT_OK(reader.ReadHeader(kMagic, kVersion));
+  EXPECT_EQ(reader.ReadVarint(), 0);
+  EXPECT_EQ(reader.ReadVarint(), std::numeric_limits<uint64_t>::max());
+  EXPECT_EQ(reader.ReadSignedVarint(), -12345);
+  EXPECT_TRUE(reader.ReadBool());
+  EXPECT_EQ(reader.ReadString(), "abc");
+  EXPECT_EQ(reader.ReadString(), "abc");
+  EXPECT_EQ(reader.ReadString(), "owned");
+  EXPECT_EQ(reader.ReadIdString().ToStringView(), "id");
+  const ParseLocationPoint point = reader.ReadLocationPoint();
+  EXPECT_EQ(point.filename(), "file");
+  EXPECT_EQ(point.GetByteOffset(), 7);
+  EXPECT_FALSE(reader.ReadLocationPoint().IsValid());
+  ZETASQL_EXPECT_OK(reader.status());
+  EXPECT_EQ(reader.remaining(), 0);
+}
+
+TEST(BinarySerializationTest, StringsAreStoredOnce) {
+  BinaryWriter writer;
+  EXPECT_EQ(writer.InternString("a"), 0);
+  EXPECT_EQ(writer.InternString("b"), 1);
+  EXPECT_EQ(writer.InternOwnedString("a"), 0);
+  EXPECT_EQ(writer.InternOwnedString("c"), 2);
+  EXPECT_EQ(writer.InternString("c"), 2);
+}
+
+TEST(BinarySerializationTest, InvalidHeader) {
+  IdStringPool pool;
+  EXPECT_THAT(BinaryReader("XXXX", "test data", &pool)
+                  .ReadHeader(kMagic, kVersion),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("not a serialized test data")));
+
+  BinaryWriter writer;
+  std::string data;
+  writer.AppendHeader(kMagic, kVersion + 1, &data);
+  EXPECT_THAT(BinaryReader(data, "test data", &pool)
+                  .ReadHeader(kMagic, kVersion),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("version 4; expected 3")));
+
+  writer.InternString("a long string");
+  data.clear();
+  writer.AppendHeader(kMagic, kVersion, &data);
+  data.resize(data.size() - 1);
+  EXPECT_THAT(BinaryReader(data, "test data", &pool)
+                  .ReadHeader(kMagic, kVersion),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("string table is truncated")));
+}
+
+TEST(BinarySerializationTest, ErrorsAreSticky) {
+  BinaryWriter writer;
+  writer.WriteString("a");
+  writer.WriteVarint(5);
+  writer.WriteVarint(1);
+  const std::string data = Finish(writer);
+
+  IdStringPool pool;
+  BinaryReader reader(data, "test data", &pool);
+  ZETASQL_ASSERT_OK(reader.ReadHeader(kMagic, kVersion));
+  EXPECT_EQ(reader.ReadString(), "a");
+  EXPECT_EQ(reader.ReadString(), "");
+  EXPECT_EQ(reader.ReadVarint(), 0);
+  EXPECT_THAT(reader.status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       "Invalid serialized test data: string index is out of "
+                       "range"));
+  EXPECT_EQ(reader.remaining(), 0);
+}
+
+TEST(BinarySerializationTest, TruncatedVarint) {
+  const std::string data = "\x80\x80";
+  IdStringPool pool;
+  BinaryReader reader(data, "test data", &pool);
+  EXPECT_EQ(reader.ReadVarint(), 0);
+  EXPECT_THAT(reader.status(),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("unexpected end of input")));
+}
+
+}  // namespace
+}  // namespace binary_serialization_internal
+}  // namespace zetasql
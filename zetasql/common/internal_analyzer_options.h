@@ -63,6 +63,42 @@ class InternalAnalyzerOptions {
   static bool GetValidateResolvedAST(const AnalyzerOptions& options) {
     return options.data_->validate_resolved_ast;
   }
+
+  // If true, validation only checks the structure of the resolved AST. See
+  // ValidatorOptions::structural_validation_only.
+  static void SetValidateResolvedASTStructureOnly(AnalyzerOptions& options,
+                                                  bool structure_only) {
+    options.data_->validate_resolved_ast_structure_only = structure_only;
+  }
+
+  static bool GetValidateResolvedASTStructureOnly(
+      const AnalyzerOptions& options) {
+    return options.data_->validate_resolved_ast_structure_only;
+  }
+
+  // If true, the resolved AST is not validated again after rewriting when the
+  // rewrite driver knows that no rewriter changed it. It was already
+  // validated after resolution.
+  static void SetValidateOnlyChangedRewrittenAST(AnalyzerOptions& options,
+                                                 bool only_changed) {
+    options.data_->validate_only_changed_rewritten_ast = only_changed;
+  }
+
+  static bool GetValidateOnlyChangedRewrittenAST(
+      const AnalyzerOptions& options) {
+    return options.data_->validate_only_changed_rewritten_ast;
+  }
+
+  // If true, ResolverStats::resolved_node_count() counts the nodes of the
+  // resolved AST. This walks the whole tree, so it is off by default.
+  static void SetRecordResolvedNodeCount(AnalyzerOptions& options,
+                                         bool record) {
+    options.data_->record_resolved_node_count = record;
+  }
+
+  static bool GetRecordResolvedNodeCount(const AnalyzerOptions& options) {
+    return options.data_->record_resolved_node_count;
+  }
 };
 
 }  // namespace zetasql
@@ -0,0 +1,125 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/common/resolver_stats.h"
+
+#include <cstdint>
+#include <string>
+
+#include "zetasql/common/timer_util.h"
+#include "zetasql/public/proto/logging.pb.h"
+#include "absl/base/attributes.h"
+#include "absl/strings/string_view.h"
+
+namespace zetasql::internal {
+
+namespace {
+
+ABSL_CONST_INIT thread_local ResolverStats* current_resolver_stats = nullptr;
+
+}  // namespace
+
+absl::string_view CatalogLookupKindName(CatalogLookupKind kind) {
+  switch (kind) {
+    case CatalogLookupKind::kTable:
+      return "Table";
+    case CatalogLookupKind::kFunction:
+      return "Function";
+    case CatalogLookupKind::kTableValuedFunction:
+      return "TableValuedFunction";
+    case CatalogLookupKind::kProcedure:
+      return "Procedure";
+    case CatalogLookupKind::kType:
+      return "Type";
+    case CatalogLookupKind::kConstant:
+      return "Constant";
+    case CatalogLookupKind::kModel:
+      return "Model";
+    case CatalogLookupKind::kConnection:
+      return "Connection";
+    case CatalogLookupKind::kSequence:
+      return "Sequence";
+  }
+  return "Unknown";
+}
+
+ResolverStats::Scope::Scope(ResolverStats* stats)
+    : previous_(current_resolver_stats) {
+  current_resolver_stats = stats;
+}
+
+ResolverStats::Scope::~Scope() { current_resolver_stats = previous_; }
+
+ResolverStats::ScopedCatalogLookup::ScopedCatalogLookup(
+    CatalogLookupKind kind) {
+  ResolverStats* stats = Current();
+  if (stats == nullptr) return;
+  CatalogLookupDetails& details =
+      stats->catalog_lookups_[static_cast<int>(kind)];
+  ++details.count;
+  timer_.emplace(&details.timed_value);
+}
+
+ResolverStats* ResolverStats::Current() { return current_resolver_stats; }
+
+int64_t ResolverStats::catalog_lookup_count() const {
+  int64_t count = 0;
+  for (const CatalogLookupDetails& details : catalog_lookups_) {
+    count += details.count;
+  }
+  return count;
+}
+
+TimedValue ResolverStats::catalog_timed_value() const {
+  TimedValue timed_value;
+  for (const CatalogLookupDetails& details : catalog_lookups_) {
+    timed_value.Accumulate(details.timed_value);
+  }
+  return timed_value;
+}
+
+void ResolverStats::AccumulateAll(const ResolverStats& rhs) {
+  for (int i = 0; i < kNumCatalogLookupKinds; ++i) {
+    catalog_lookups_[i].AccumulateAll(rhs.catalog_lookups_[i]);
+  }
+  function_signature_match_attempts_ += rhs.function_signature_match_attempts_;
+  name_scope_lookups_ += rhs.name_scope_lookups_;
+  resolved_node_count_ += rhs.resolved_node_count_;
+  arena_bytes_ += rhs.arena_bytes_;
+}
+
+AnalyzerLogEntry::ResolverStats ResolverStats::ToProto() const {
+  AnalyzerLogEntry::ResolverStats proto;
+  for (int i = 0; i < kNumCatalogLookupKinds; ++i) {
+    const CatalogLookupDetails& details = catalog_lookups_[i];
+    if (details.count == 0) continue;
+    AnalyzerLogEntry::ResolverStats::CatalogLookupEntry* entry =
+        proto.add_catalog_lookups();
+    entry->set_object_kind(
+        std::string(CatalogLookupKindName(static_cast<CatalogLookupKind>(i))));
+    entry->set_count(details.count);
+    *entry->mutable_execution_stats() =
+        details.timed_value.ToExecutionStatsProto();
+  }
+  proto.set_function_signature_match_attempts(
+      function_signature_match_attempts_);
+  proto.set_name_scope_lookups(name_scope_lookups_);
+  proto.set_resolved_node_count(resolved_node_count_);
+  proto.set_arena_bytes(arena_bytes_);
+  return proto;
+}
+
+}  // namespace zetasql::internal
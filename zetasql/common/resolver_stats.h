@@ -0,0 +1,159 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef ZETASQL_COMMON_RESOLVER_STATS_H_
+#define ZETASQL_COMMON_RESOLVER_STATS_H_
+
+#include <array>
+#include <cstdint>
+#include <optional>
+
+#include "zetasql/common/timer_util.h"
+#include "zetasql/public/proto/logging.pb.h"
+#include "absl/strings/string_view.h"
+
+namespace zetasql::internal {
+
+// The kinds of Catalog lookups made by the resolver.
+enum class CatalogLookupKind {
+  kTable,
+  kFunction,
+  kTableValuedFunction,
+  kProcedure,
+  kType,
+  kConstant,
+  kModel,
+  kConnection,
+  kSequence,
+};
+inline constexpr int kNumCatalogLookupKinds =
+    static_cast<int>(CatalogLookupKind::kSequence) + 1;
+
+// Returns the name of the Catalog object kind looked up, e.g. "Table".
+absl::string_view CatalogLookupKindName(CatalogLookupKind kind);
+
+// Counters for the hot operations inside the resolver: Catalog lookups,
+// function signature matching and name scope lookups, plus the size of the
+// resolver output.  Used to find out why a particular query is expensive to
+// analyze.
+//
+// The resolver doesn't have a ResolverStats threaded through it.  Instead, the
+// analyzer installs one for the current thread with a ResolverStats::Scope
+// while it runs the resolver, and the instrumented code calls the static
+// Record*() functions, which do nothing if no ResolverStats is installed.
+class ResolverStats {
+ public:
+  struct CatalogLookupDetails {
+    int64_t count = 0;
+    // Time spent in the Catalog, which is engine code rather than ZetaSQL.
+    TimedValue timed_value;
+
+    void AccumulateAll(const CatalogLookupDetails& rhs) {
+      count += rhs.count;
+      timed_value.Accumulate(rhs.timed_value);
+    }
+  };
+
+  // Installs <stats> as the ResolverStats of the current thread for the
+  // lifetime of this object.  Scopes can be nested, for re-entrant calls to
+  // the analyzer; the innermost one is used.
+  class Scope {
+   public:
+    explicit Scope(ResolverStats* stats);
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+    ~Scope();
+
+   private:
+    ResolverStats* previous_;
+  };
+
+  // Counts one Catalog lookup, and times it until EndTiming() is called or
+  // this object goes out of scope.
+  // Example:
+  //   ResolverStats::ScopedCatalogLookup lookup(CatalogLookupKind::kTable);
+  //   const absl::Status status =
+  //       catalog_->FindTable(path, &table, find_options);
+  //   lookup.EndTiming();
+  class ScopedCatalogLookup {
+   public:
+    explicit ScopedCatalogLookup(CatalogLookupKind kind);
+    ScopedCatalogLookup(const ScopedCatalogLookup&) = delete;
+    ScopedCatalogLookup& operator=(const ScopedCatalogLookup&) = delete;
+
+    void EndTiming() { timer_.reset(); }
+
+   private:
+    // Only engaged if a ResolverStats is installed.
+    std::optional<ScopedTimer> timer_;
+  };
+
+  static void RecordFunctionSignatureMatchAttempt() {
+    if (ResolverStats* stats = Current(); stats != nullptr) {
+      ++stats->function_signature_match_attempts_;
+    }
+  }
+  static void RecordNameScopeLookup() {
+    if (ResolverStats* stats = Current(); stats != nullptr) {
+      ++stats->name_scope_lookups_;
+    }
+  }
+
+  const CatalogLookupDetails& catalog_lookup_details(
+      CatalogLookupKind kind) const {
+    return catalog_lookups_[static_cast<int>(kind)];
+  }
+
+  // Totals over all kinds of Catalog lookups.
+  int64_t catalog_lookup_count() const;
+  TimedValue catalog_timed_value() const;
+
+  // Number of attempts to match a call against a single function signature.
+  int64_t function_signature_match_attempts() const {
+    return function_signature_match_attempts_;
+  }
+
+  // Number of names looked up in NameScopes.
+  int64_t name_scope_lookups() const { return name_scope_lookups_; }
+
+  // Number of nodes in the resolved ASTs produced. Only recorded if
+  // InternalAnalyzerOptions::GetRecordResolvedNodeCount().
+  int64_t resolved_node_count() const { return resolved_node_count_; }
+  void add_resolved_node_count(int64_t count) {
+    resolved_node_count_ += count;
+  }
+
+  // Bytes allocated in the analyzer arena while resolving.
+  int64_t arena_bytes() const { return arena_bytes_; }
+  void add_arena_bytes(int64_t bytes) { arena_bytes_ += bytes; }
+
+  void AccumulateAll(const ResolverStats& rhs);
+
+  AnalyzerLogEntry::ResolverStats ToProto() const;
+
+ private:
+  static ResolverStats* Current();
+
+  std::array<CatalogLookupDetails, kNumCatalogLookupKinds> catalog_lookups_;
+  int64_t function_signature_match_attempts_ = 0;
+  int64_t name_scope_lookups_ = 0;
+  int64_t resolved_node_count_ = 0;
+  int64_t arena_bytes_ = 0;
+};
+
+}  // namespace zetasql::internal
+
+#endif  // ZETASQL_COMMON_RESOLVER_STATS_H_
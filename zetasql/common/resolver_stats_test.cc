@@ -0,0 +1,108 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/common/resolver_stats.h"
+
+#include "zetasql/public/proto/logging.pb.h"
+#include "gtest/gtest.h"
+
+namespace zetasql::internal {
+
+namespace {
+
+void DoLookups() {
+  {
+    ResolverStats::ScopedCatalogLookup lookup(CatalogLookupKind::kTable);
+  }
+  ResolverStats::ScopedCatalogLookup lookup(CatalogLookupKind::kFunction);
+  lookup.EndTiming();
+  ResolverStats::RecordFunctionSignatureMatchAttempt();
+  ResolverStats::RecordNameScopeLookup();
+  ResolverStats::RecordNameScopeLookup();
+}
+
+}  // namespace
+
+TEST(ResolverStats, NothingRecordedWithoutScope) {
+  ResolverStats stats;
+  DoLookups();
+  EXPECT_EQ(stats.catalog_lookup_count(), 0);
+  EXPECT_EQ(stats.function_signature_match_attempts(), 0);
+  EXPECT_EQ(stats.name_scope_lookups(), 0);
+}
+
+TEST(ResolverStats, RecordsInScope) {
+  ResolverStats stats;
+  {
+    ResolverStats::Scope scope(&stats);
+    DoLookups();
+  }
+  DoLookups();
+
+  EXPECT_EQ(stats.catalog_lookup_details(CatalogLookupKind::kTable).count, 1);
+  EXPECT_EQ(stats.catalog_lookup_details(CatalogLookupKind::kFunction).count,
+            1);
+  EXPECT_EQ(stats.catalog_lookup_details(CatalogLookupKind::kType).count, 0);
+  EXPECT_EQ(stats.catalog_lookup_count(), 2);
+  EXPECT_EQ(stats.function_signature_match_attempts(), 1);
+  EXPECT_EQ(stats.name_scope_lookups(), 2);
+}
+
+TEST(ResolverStats, NestedScopes) {
+  ResolverStats outer;
+  ResolverStats inner;
+  {
+    ResolverStats::Scope outer_scope(&outer);
+    {
+      ResolverStats::Scope inner_scope(&inner);
+      DoLookups();
+    }
+    ResolverStats::RecordNameScopeLookup();
+  }
+  EXPECT_EQ(inner.name_scope_lookups(), 2);
+  EXPECT_EQ(inner.catalog_lookup_count(), 2);
+  EXPECT_EQ(outer.name_scope_lookups(), 1);
+  EXPECT_EQ(outer.catalog_lookup_count(), 0);
+}
+
+TEST(ResolverStats, AccumulateAllAndToProto) {
+  ResolverStats stats;
+  {
+    ResolverStats::Scope scope(&stats);
+    DoLookups();
+  }
+  stats.add_resolved_node_count(10);
+  stats.add_arena_bytes(100);
+
+  ResolverStats total;
+  total.AccumulateAll(stats);
+  total.AccumulateAll(stats);
+  EXPECT_EQ(total.catalog_lookup_count(), 4);
+  EXPECT_EQ(total.resolved_node_count(), 20);
+
+  const AnalyzerLogEntry::ResolverStats proto = total.ToProto();
+  ASSERT_EQ(proto.catalog_lookups_size(), 2);
+  EXPECT_EQ(proto.catalog_lookups(0).object_kind(), "Table");
+  EXPECT_EQ(proto.catalog_lookups(0).count(), 2);
+  EXPECT_EQ(proto.catalog_lookups(1).object_kind(), "Function");
+  EXPECT_EQ(proto.catalog_lookups(1).count(), 2);
+  EXPECT_EQ(proto.function_signature_match_attempts(), 2);
+  EXPECT_EQ(proto.name_scope_lookups(), 4);
+  EXPECT_EQ(proto.resolved_node_count(), 20);
+  EXPECT_EQ(proto.arena_bytes(), 200);
+}
+
+}  // namespace zetasql::internal
@@ -103,6 +103,13 @@ class TimedValue {
         std::max(stack_peak_used_bytes_, timer.stack_peak_used_bytes_);
   }
 
+  // Removes the wall and cpu time of <nested>, which must have been measured
+  // within the spans accumulated here, so that the two don't double count.
+  void Exclude(const TimedValue& nested) {
+    wall_time_ = std::max(wall_time_ - nested.wall_time_, absl::ZeroDuration());
+    cpu_time_ = std::max(cpu_time_ - nested.cpu_time_, absl::ZeroDuration());
+  }
+
   bool HasAnyRecordedTiming() const {
     if (wall_time_ > absl::ZeroDuration()) {
       return true;
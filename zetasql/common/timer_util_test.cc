@@ -122,6 +122,18 @@ TEST(TimedValue, AccumulateTimedValue) {
   EXPECT_EQ(v2.elapsed_duration(), absl::Nanoseconds(30));
 }
 
+TEST(TimedValue, Exclude) {
+  TimedValue outer;
+  outer.Accumulate(absl::Nanoseconds(30));
+  TimedValue nested;
+  nested.Accumulate(absl::Nanoseconds(10));
+
+  outer.Exclude(nested);
+  EXPECT_EQ(outer.elapsed_duration(), absl::Nanoseconds(20));
+  nested.Exclude(outer);
+  EXPECT_EQ(nested.elapsed_duration(), absl::ZeroDuration());
+}
+
 // We just want to make sure it's somewhere in the ballpark.
 TEST(TimedValue, AccumulateTimerApproxCorrect) {
   for (int i = 0; i < 10; ++i) {
@@ -80,6 +80,11 @@ ABSL_FLAG(bool, zetasql_run_codebased_tests, true,
           "Run the code based compliance tests.");
 ABSL_FLAG(bool, zetasql_run_filebased_tests, true,
           "Run the file based compliance tests.");
+ABSL_FLAG(int32_t, zetasql_compliance_reference_driver_threads, 1,
+          "Number of threads that compute reference driver results for the "
+          "code based compliance tests ahead of the test thread. Each thread "
+          "has its own ReferenceDriver, set up once per test process. 1 runs "
+          "every statement on the test thread.");
 
 using zetasql::test_values::kIgnoresOrder;
 
@@ -259,6 +264,11 @@ static std::vector<QueryParamsWithResult> WrapFeatureCollation(
 // 'code_based_test_driver->IsReferenceImplementation()' is true.
 static TestDriver* code_based_test_driver = nullptr;
 static ReferenceDriver* code_based_reference_driver = nullptr;
+// Set up like 'code_based_reference_driver', for
+// ComplianceCodebasedTests::PrefetchReferenceResults(). Empty unless
+// --zetasql_compliance_reference_driver_threads is greater than 1.
+static std::vector<ReferenceDriver*>* code_based_reference_worker_drivers =
+    new std::vector<ReferenceDriver*>();
 
 bool CodebasedTestsEnvironment::skip_codebased_tests() {
   return !absl::GetFlag(FLAGS_zetasql_run_codebased_tests);
@@ -416,11 +426,26 @@ void CodebasedTestsEnvironment::SetUp() {
   code_based_reference_driver = new ReferenceDriver(
       code_based_test_driver->GetSupportedLanguageOptions());
   ZETASQL_EXPECT_OK(code_based_reference_driver->CreateDatabase(test_db));
+
+  const int num_worker_drivers =
+      absl::GetFlag(FLAGS_zetasql_compliance_reference_driver_threads);
+  if (num_worker_drivers > 1) {
+    for (int i = 0; i < num_worker_drivers; ++i) {
+      ReferenceDriver* worker_driver = new ReferenceDriver(
+          code_based_test_driver->GetSupportedLanguageOptions());
+      ZETASQL_EXPECT_OK(worker_driver->CreateDatabase(test_db));
+      code_based_reference_worker_drivers->push_back(worker_driver);
+    }
+  }
 }
 
 void CodebasedTestsEnvironment::TearDown() {
   delete code_based_test_driver;
   delete code_based_reference_driver;
+  for (ReferenceDriver* worker_driver : *code_based_reference_worker_drivers) {
+    delete worker_driver;
+  }
+  code_based_reference_worker_drivers->clear();
 }
 
 ComplianceCodebasedTests::ComplianceCodebasedTests()
@@ -501,14 +526,21 @@ void ComplianceCodebasedTests::RunFunctionTestsPrefix(
 template <typename FCT>
 void ComplianceCodebasedTests::RunFunctionTestsCustom(
     const std::vector<FunctionTestCall>& function_tests, FCT get_sql_string) {
+  std::vector<std::pair<std::string, QueryParamsWithResult>> statements;
+  statements.reserve(function_tests.size());
   for (const auto& params : function_tests) {
     std::string pattern = get_sql_string(params);
-    std::string sql = absl::StrCat("SELECT ", pattern, " AS ", kColA);
     QueryParamsWithResult new_params = params.params;
     ConvertResultsToSingletons(&new_params);
-    SetNamePrefix(params.function_name);
-    auto label = MakeScopedLabel(GetTypeLabels(params.params));
-    RunStatementOnFeatures(sql, new_params);
+    statements.emplace_back(absl::StrCat("SELECT ", pattern, " AS ", kColA),
+                            std::move(new_params));
+  }
+  PrefetchReferenceResults(statements);
+
+  for (int i = 0; i < function_tests.size(); ++i) {
+    SetNamePrefix(function_tests[i].function_name);
+    auto label = MakeScopedLabel(GetTypeLabels(function_tests[i].params));
+    RunStatementOnFeatures(statements[i].first, statements[i].second);
   }
 }
 
@@ -554,15 +586,25 @@ static std::string AddPrefixForSafeFunctionCalls(
 
 void ComplianceCodebasedTests::RunFunctionCalls(
     const std::vector<FunctionTestCall>& function_calls) {
-  for (const auto& call : AddSafeFunctionCalls(function_calls)) {
-    std::string sql = absl::Substitute(
-        "SELECT $0($1) AS $2", call.function_name,
-        ParametersWithSeparator(call.params.num_params(), ", "), kColA);
+  const std::vector<FunctionTestCall> calls =
+      AddSafeFunctionCalls(function_calls);
+  std::vector<std::pair<std::string, QueryParamsWithResult>> statements;
+  statements.reserve(calls.size());
+  for (const auto& call : calls) {
     QueryParamsWithResult new_params = call.params;
     ConvertResultsToSingletons(&new_params);
-    SetNamePrefix(AddPrefixForSafeFunctionCalls(call.function_name));
-    auto label = MakeScopedLabel(GetTypeLabels(call.params));
-    RunStatementOnFeatures(sql, new_params);
+    statements.emplace_back(
+        absl::Substitute(
+            "SELECT $0($1) AS $2", call.function_name,
+            ParametersWithSeparator(call.params.num_params(), ", "), kColA),
+        std::move(new_params));
+  }
+  PrefetchReferenceResults(statements);
+
+  for (int i = 0; i < calls.size(); ++i) {
+    SetNamePrefix(AddPrefixForSafeFunctionCalls(calls[i].function_name));
+    auto label = MakeScopedLabel(GetTypeLabels(calls[i].params));
+    RunStatementOnFeatures(statements[i].first, statements[i].second);
   }
 }
 
@@ -617,31 +659,92 @@ template <typename FCT>
 void ComplianceCodebasedTests::RunStatementTestsCustom(
     const std::vector<QueryParamsWithResult>& statement_tests,
     FCT get_sql_string) {
+  std::vector<std::pair<std::string, QueryParamsWithResult>> statements;
+  statements.reserve(statement_tests.size());
   for (const auto& params : statement_tests) {
     std::string pattern = get_sql_string(params);
-    std::string sql = absl::StrCat("SELECT ", pattern, " AS ", kColA);
     QueryParamsWithResult new_params = params;
     ConvertResultsToSingletons(&new_params);
+    statements.emplace_back(absl::StrCat("SELECT ", pattern, " AS ", kColA),
+                            std::move(new_params));
+  }
+  PrefetchReferenceResults(statements);
+
+  for (int i = 0; i < statement_tests.size(); ++i) {
+    const QueryParamsWithResult& params = statement_tests[i];
     SetResultTypeName(params.result().type()->TypeName(PRODUCT_INTERNAL));
     auto label = MakeScopedLabel(GetTypeLabels(params));
-    RunStatementOnFeatures(sql, new_params);
+    RunStatementOnFeatures(statements[i].first, statements[i].second);
   }
 }
 
-void ComplianceCodebasedTests::RunStatementOnFeatures(
-    absl::string_view sql, const QueryParamsWithResult& params) {
-  if (!DriverCanRunTests()) {
-    return;
+// Returns true if <type> is or contains a proto or enum type.
+static bool TypeContainsProtoOrEnum(const Type* type) {
+  if (type->IsProto() || type->IsEnum()) return true;
+  if (type->IsArray()) {
+    return TypeContainsProtoOrEnum(type->AsArray()->element_type());
+  }
+  if (type->IsStruct()) {
+    for (const StructField& field : type->AsStruct()->fields()) {
+      if (TypeContainsProtoOrEnum(field.type)) return true;
+    }
   }
+  return false;
+}
 
+// Returns the parameters of <params>, named @p0, @p1, etc.
+static std::map<std::string, Value> MakeParameterMap(
+    const QueryParamsWithResult& params) {
   std::map<std::string, Value> param_map;
   for (int i = 0; i < params.num_params(); i++) {
     std::string param_name = absl::StrCat("p", i);
     param_map[param_name] = params.param(i);
   }
+  return param_map;
+}
+
+void ComplianceCodebasedTests::PrefetchReferenceResults(
+    const std::vector<std::pair<std::string, QueryParamsWithResult>>&
+        statements) {
+  if (code_based_reference_worker_drivers->empty() || !DriverCanRunTests()) {
+    return;
+  }
+  std::vector<ReferenceStatement> reference_statements;
+  reference_statements.reserve(statements.size());
+  for (const auto& [sql, params] : statements) {
+    // Each worker driver loads its own copy of the test protos, so proto and
+    // enum values it returns would not compare equal to the expected ones.
+    bool uses_proto_or_enum = TypeContainsProtoOrEnum(params.result().type());
+    for (int i = 0; i < params.num_params(); ++i) {
+      uses_proto_or_enum |= TypeContainsProtoOrEnum(params.param(i).type());
+    }
+    if (uses_proto_or_enum) continue;
+
+    ReferenceStatement& statement = reference_statements.emplace_back();
+    statement.sql = sql;
+    statement.parameters = MakeParameterMap(params);
+    // This matches the language options that RunSQLOnFeaturesAndValidateResult
+    // sets on the reference driver.
+    if (IsTestingReferenceImpl()) {
+      LanguageOptions language_options;
+      language_options.SetEnabledLanguageFeatures(params.required_features());
+      statement.language_options = language_options;
+    }
+  }
+  SQLTestBase::PrefetchReferenceResults(std::move(reference_statements),
+                                        *code_based_reference_worker_drivers);
+}
+
+void ComplianceCodebasedTests::RunStatementOnFeatures(
+    absl::string_view sql, const QueryParamsWithResult& params) {
+  if (!DriverCanRunTests()) {
+    return;
+  }
+
   RunSQLOnFeaturesAndValidateResult(
-      sql, param_map, params.required_features(), params.prohibited_features(),
-      params.result(), params.status(), params.float_margin());
+      sql, MakeParameterMap(params), params.required_features(),
+      params.prohibited_features(), params.result(), params.status(),
+      params.float_margin());
 }
 
 std::vector<QueryParamsWithResult>
@@ -26,6 +26,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "zetasql/base/logging.h"
@@ -180,6 +181,15 @@ class ComplianceCodebasedTests : public SQLTestBase {
   void RunStatementOnFeatures(absl::string_view sql,
                               const QueryParamsWithResult& params);
 
+  // Computes reference driver results for <statements> (SQL text and
+  // parameters) on worker threads, when
+  // --zetasql_compliance_reference_driver_threads asks for more than one, so
+  // that RunStatementOnFeatures() does not have to run them on the reference
+  // driver itself. See SQLTestBase::PrefetchReferenceResults().
+  void PrefetchReferenceResults(
+      const std::vector<std::pair<std::string, QueryParamsWithResult>>&
+          statements);
+
   // Default TestDatabase used by many tests.
   static TestDatabase GetDefaultTestDatabase();
 
@@ -20,7 +20,9 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstdint>
+#include <functional>
 #include <iosfwd>
 #include <iostream>
 #include <map>
@@ -30,6 +32,7 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <thread>  // NOLINT(build/c++11)
 #include <unordered_map>
 #include <utility>
 #include <variant>
@@ -82,6 +85,9 @@
 #include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/strip.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "file_based_test_driver/file_based_test_driver.h"
 #include "zetasql/base/file_util.h"  
 #include "zetasql/base/map_util.h"
@@ -141,6 +147,10 @@ ABSL_FLAG(bool, zetasql_compliance_extract_labels_using_all_rewrites, false,
 ABSL_FLAG(bool, zetasql_compliance_print_array_orderedness, false,
           "When true, includes the 'known order:', 'unknown order:' prefix "
           "on array values with two or more elements.");
+ABSL_FLAG(int32_t, zetasql_compliance_report_slowest_statements, 0,
+          "When positive, the compliance report lists this many statements "
+          "with the longest execution times, and the total execution time of "
+          "all statements.");
 
 namespace zetasql {
 
@@ -291,7 +301,8 @@ class Stats {
                                  const absl::btree_set<std::string>& by_set);
 
   // Record the runtime duration of a executed statement.
-  void RecordStatementExecutionTime(absl::Duration elapsed);
+  void RecordStatementExecutionTime(absl::string_view full_name,
+                                    absl::Duration elapsed);
 
   // Record a failure that is not resolved by adding a known error entry.
   void RecordFailure(absl::string_view error_string) {
@@ -412,6 +423,12 @@ class Stats {
   int num_known_errors_ = 0;
 
   bool file_based_statements_ = false;
+
+  absl::Duration total_execution_time_;
+  // The slowest statements seen so far, with their execution times, at most
+  // --zetasql_compliance_report_slowest_statements of them. Kept as a heap
+  // with the fastest of them on top.
+  std::vector<std::pair<absl::Duration, std::string>> slowest_statements_;
 };
 
 Stats::Stats()
@@ -485,7 +502,25 @@ void Stats::RecordKnownErrorStatement(
   RecordProperty(location, by);
 }
 
-void Stats::RecordStatementExecutionTime(absl::Duration elapsed) {
+void Stats::RecordStatementExecutionTime(absl::string_view full_name,
+                                         absl::Duration elapsed) {
+  total_execution_time_ += elapsed;
+  const int max_slowest_statements =
+      absl::GetFlag(FLAGS_zetasql_compliance_report_slowest_statements);
+  if (max_slowest_statements <= 0) return;
+
+  // std::greater makes this a min-heap, so the front is the fastest statement
+  // that is kept.
+  auto cmp = std::greater<std::pair<absl::Duration, std::string>>();
+  if (slowest_statements_.size() <
+      static_cast<size_t>(max_slowest_statements)) {
+    slowest_statements_.emplace_back(elapsed, full_name);
+    std::push_heap(slowest_statements_.begin(), slowest_statements_.end(), cmp);
+  } else if (elapsed > slowest_statements_.front().first) {
+    std::pop_heap(slowest_statements_.begin(), slowest_statements_.end(), cmp);
+    slowest_statements_.back() = {elapsed, std::string(full_name)};
+    std::push_heap(slowest_statements_.begin(), slowest_statements_.end(), cmp);
+  }
 }
 
 void Stats::LogGoogletestProperties() const {
@@ -558,6 +593,23 @@ void Stats::LogReport() const {
              "To Be Removed From Known Errors Statements", "\n");
   LogBatches(to_be_upgraded_, "To Be Upgraded Statements", "\n");
 
+  if (absl::GetFlag(FLAGS_zetasql_compliance_report_slowest_statements) > 0) {
+    std::vector<std::pair<absl::Duration, std::string>> slowest =
+        slowest_statements_;
+    std::sort(slowest.begin(), slowest.end(),
+              std::greater<std::pair<absl::Duration, std::string>>());
+    std::vector<std::string> lines;
+    lines.reserve(slowest.size());
+    for (const auto& [elapsed, full_name] : slowest) {
+      lines.push_back(absl::StrCat(absl::FormatDuration(elapsed), "  ",
+                                   full_name));
+    }
+    LogBatches(lines,
+               absl::StrCat("Slowest Statements (total execution time ",
+                            absl::FormatDuration(total_execution_time_), ")"),
+               "\n");
+  }
+
   ABSL_LOG(INFO) << "\n==== RELATED KNOWN ERROR FILES ====\n"
             << absl::StrJoin(known_error_files, "\n")
             << "\n==== END RELATED KNOWN ERROR FILES ====\n";
@@ -1447,10 +1499,9 @@ void SQLTestBase::RunSQLOnFeaturesAndValidateResult(
     TypeFactory type_factory;
     sql_ = sql;  // To supply a const std::string&
     ReferenceDriver::ExecuteStatementAuxOutput aux_output;
-    absl::StatusOr<Value> reference_result =
-        reference_driver()->ExecuteStatementForReferenceDriver(
-            sql_, params, GetExecuteStatementOptions(), &type_factory,
-            aux_output);
+    absl::Duration elapsed;
+    absl::StatusOr<Value> reference_result = ExecuteStatementOnReferenceDriver(
+        sql_, params, &type_factory, aux_output, &elapsed);
     if (aux_output.uses_unsupported_type.value_or(false)) {
       stats_->RecordComplianceTestsLabelsProto(
           full_name_, sql_, parameters_, location_,
@@ -1575,6 +1626,7 @@ SQLTestBase::TestResults SQLTestBase::ExecuteTestCase() {
   // Time the statement execution time to gather some simple performance
   // metrics.
   absl::Time start_time = absl::Now();
+  std::optional<absl::Duration> elapsed;
   absl::StatusOr<ComplianceTestCaseResult> result;
   std::optional<bool> is_deterministic_output = std::nullopt;
   if (IsTestingReferenceImpl()) {
@@ -1586,9 +1638,9 @@ SQLTestBase::TestResults SQLTestBase::ExecuteTestCase() {
     } else {
       is_deterministic_output = true;
       ReferenceDriver::ExecuteStatementAuxOutput aux_output;
-      result = reference_driver()->ExecuteStatementForReferenceDriver(
-          sql_, parameters_, GetExecuteStatementOptions(),
-          execute_statement_type_factory(), aux_output);
+      result = ExecuteStatementOnReferenceDriver(
+          sql_, parameters_, execute_statement_type_factory(), aux_output,
+          &elapsed.emplace());
       is_deterministic_output = aux_output.is_deterministic_output;
     }
   } else {
@@ -1600,10 +1652,131 @@ SQLTestBase::TestResults SQLTestBase::ExecuteTestCase() {
                                           execute_statement_type_factory());
     }
   }
-  stats_->RecordStatementExecutionTime(absl::Now() - start_time);
+  stats_->RecordStatementExecutionTime(
+      full_name_, elapsed.value_or(absl::Now() - start_time));
   return TestResults{result, is_deterministic_output};
 }
 
+absl::StatusOr<Value> SQLTestBase::ExecuteStatementOnReferenceDriver(
+    absl::string_view sql, const std::map<std::string, Value>& parameters,
+    TypeFactory* type_factory,
+    ReferenceDriver::ExecuteStatementAuxOutput& aux_output,
+    absl::Duration* elapsed) {
+  const int index = FindPrefetchedReferenceResult(sql, parameters);
+  if (index >= 0) {
+    PrefetchedReferenceResult& prefetched =
+        prefetched_reference_results_[index];
+    next_prefetched_reference_result_ = index + 1;
+    ++num_prefetched_reference_results_used_;
+    aux_output = std::move(prefetched.aux_output);
+    *elapsed = prefetched.elapsed;
+    return std::move(prefetched.result);
+  }
+
+  const absl::Time start_time = absl::Now();
+  absl::StatusOr<Value> result =
+      reference_driver()->ExecuteStatementForReferenceDriver(
+          sql, parameters, GetExecuteStatementOptions(), type_factory,
+          aux_output);
+  *elapsed = absl::Now() - start_time;
+  return result;
+}
+
+int SQLTestBase::FindPrefetchedReferenceResult(
+    absl::string_view sql, const std::map<std::string, Value>& parameters) {
+  if (next_prefetched_reference_result_ >=
+      prefetched_reference_results_.size()) {
+    return -1;
+  }
+  const LanguageOptions language_options =
+      reference_driver()->language_options();
+  const ReferenceDriver::ExecuteStatementOptions execute_options =
+      GetExecuteStatementOptions();
+  for (int i = next_prefetched_reference_result_;
+       i < prefetched_reference_results_.size(); ++i) {
+    const PrefetchedReferenceResult& prefetched =
+        prefetched_reference_results_[i];
+    const ReferenceStatement& statement = prefetched.statement;
+    if (statement.sql != sql ||
+        prefetched.execute_options.primary_key_mode !=
+            execute_options.primary_key_mode ||
+        *statement.language_options != language_options ||
+        statement.parameters.size() != parameters.size()) {
+      continue;
+    }
+    // Values are compared with Equals() rather than SqlEquals(), so NULLs and
+    // NaNs match and doubles must match exactly.
+    bool same_parameters = true;
+    for (auto it1 = statement.parameters.begin(), it2 = parameters.begin();
+         it1 != statement.parameters.end(); ++it1, ++it2) {
+      if (it1->first != it2->first || !it1->second.Equals(it2->second)) {
+        same_parameters = false;
+        break;
+      }
+    }
+    if (same_parameters) return i;
+  }
+  return -1;
+}
+
+void SQLTestBase::PrefetchReferenceResults(
+    std::vector<ReferenceStatement> statements,
+    absl::Span<ReferenceDriver* const> worker_drivers) {
+  prefetched_reference_results_.clear();
+  next_prefetched_reference_result_ = 0;
+  prefetch_type_factories_.clear();
+  if (worker_drivers.size() < 2 || statements.empty()) return;
+  if (IsTestingReferenceImpl()) {
+    for (const auto& [label, label_info] : label_info_map_) {
+      if (label_info.mode == KnownErrorMode::CRASHES_DO_NOT_RUN) return;
+    }
+  }
+
+  prefetched_reference_results_.resize(statements.size());
+  for (int i = 0; i < statements.size(); ++i) {
+    prefetched_reference_results_[i].statement = std::move(statements[i]);
+  }
+  const ReferenceDriver::ExecuteStatementOptions execute_options =
+      GetExecuteStatementOptions();
+
+  // Workers take the next statement from a shared counter, so that a few slow
+  // statements do not hold up the others. Each result is written to its own
+  // slot, and only by the worker that took it.
+  std::atomic<int> next_statement = 0;
+  std::vector<std::thread> threads;
+  threads.reserve(worker_drivers.size());
+  for (ReferenceDriver* worker_driver : worker_drivers) {
+    TypeFactory* type_factory =
+        prefetch_type_factories_.emplace_back(std::make_unique<TypeFactory>())
+            .get();
+    threads.emplace_back([this, worker_driver, type_factory, &execute_options,
+                          &next_statement]() {
+      const LanguageOptions default_language_options =
+          worker_driver->language_options();
+      for (int i = next_statement++; i < prefetched_reference_results_.size();
+           i = next_statement++) {
+        PrefetchedReferenceResult& prefetched =
+            prefetched_reference_results_[i];
+        ReferenceStatement& statement = prefetched.statement;
+        worker_driver->SetLanguageOptions(
+            statement.language_options.value_or(default_language_options));
+        statement.language_options = worker_driver->language_options();
+        prefetched.execute_options = execute_options;
+
+        const absl::Time start_time = absl::Now();
+        prefetched.result = worker_driver->ExecuteStatementForReferenceDriver(
+            statement.sql, statement.parameters, execute_options,
+            type_factory, prefetched.aux_output);
+        prefetched.elapsed = absl::Now() - start_time;
+      }
+      worker_driver->SetLanguageOptions(default_language_options);
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
 void SQLTestBase::RunSQLTests(absl::string_view filename) {
   // The current test is a file-based test.
   stats_->StartFileBasedStatements();
@@ -96,6 +96,8 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
+#include "absl/types/span.h"
 #include "file_based_test_driver/file_based_test_driver.h"  
 #include "file_based_test_driver/run_test_case_result.h"
 #include "file_based_test_driver/test_case_options.h"
@@ -539,6 +541,12 @@ class SQLTestBase : public ::testing::TestWithParam<std::string> {
   void TESTONLY_SetTestFileOptions(
       std::unique_ptr<FilebasedSQLTestFileOptions> test_file_options);
 
+  // Returns how many statements used a result kept by
+  // PrefetchReferenceResults() instead of running on reference_driver().
+  int TESTONLY_num_prefetched_reference_results_used() const {
+    return num_prefetched_reference_results_used_;
+  }
+
   void ClearParameters() { parameters_.clear(); }
 
   // Return true if we are testing the reference implementation.
@@ -630,6 +638,35 @@ class SQLTestBase : public ::testing::TestWithParam<std::string> {
       const absl::StatusOr<ComplianceTestCaseResult>& expected_result,
       const FloatMargin& expected_float_margin);
 
+  // A statement for PrefetchReferenceResults() to run on the reference driver.
+  struct ReferenceStatement {
+    std::string sql;
+    std::map<std::string, Value> parameters;
+    // If set, the statement runs with these language options. Otherwise it
+    // runs with the options the worker driver already has.
+    std::optional<LanguageOptions> language_options;
+  };
+
+  // Runs <statements> on <worker_drivers>, with one thread per driver, and
+  // keeps the results. When the test later runs one of these statements on
+  // reference_driver(), it uses the kept result and does not run the statement
+  // again. Each worker driver must have the same database and the same
+  // default language options as reference_driver().
+  //
+  // A kept result is only used if the SQL, the parameters, the language
+  // options and the execute options all match exactly. Prefetching a statement
+  // that is later skipped, or run with different options, therefore does not
+  // change any test outcome. Results are used in the order of <statements>.
+  // Calling this again drops any results that were not used.
+  //
+  // This does nothing if there are fewer than two <worker_drivers>. It also
+  // does nothing when testing the reference implementation while a known
+  // error file has CRASHES_DO_NOT_RUN entries, because those statements must
+  // not run at all.
+  void PrefetchReferenceResults(
+      std::vector<ReferenceStatement> statements,
+      absl::Span<ReferenceDriver* const> worker_drivers);
+
  private:
   // Accesses ValidateFirstColumnPrimaryKey
   friend class CodebasedTestsEnvironment;
@@ -742,6 +779,24 @@ class SQLTestBase : public ::testing::TestWithParam<std::string> {
   // Known Error mode for the current statement.
   KnownErrorMode known_error_mode_ = KnownErrorMode::NONE;
 
+  // A result computed by PrefetchReferenceResults().
+  struct PrefetchedReferenceResult {
+    // <statement.language_options> is always set, to the options the
+    // statement actually ran with.
+    ReferenceStatement statement;
+    ReferenceDriver::ExecuteStatementOptions execute_options;
+    absl::StatusOr<Value> result;
+    ReferenceDriver::ExecuteStatementAuxOutput aux_output;
+    absl::Duration elapsed;
+  };
+  std::vector<PrefetchedReferenceResult> prefetched_reference_results_;
+  // Results before this index have been used or skipped.
+  int next_prefetched_reference_result_ = 0;
+  int num_prefetched_reference_results_used_ = 0;
+  // Own the types of the values in <prefetched_reference_results_>, one per
+  // worker thread.
+  std::vector<std::unique_ptr<TypeFactory>> prefetch_type_factories_;
+
   // Set of labels in known_error files that affect current statement.
   absl::btree_set<std::string> by_set_;
 
@@ -890,6 +945,22 @@ class SQLTestBase : public ::testing::TestWithParam<std::string> {
   // depending on <script_mode_>.
   TestResults ExecuteTestCase();
 
+  // Runs <sql> on reference_driver(), unless PrefetchReferenceResults() has
+  // already computed a result for it. Sets <elapsed> to the time the
+  // evaluation took, including when it ran on a worker thread.
+  absl::StatusOr<Value> ExecuteStatementOnReferenceDriver(
+      absl::string_view sql, const std::map<std::string, Value>& parameters,
+      TypeFactory* type_factory,
+      ReferenceDriver::ExecuteStatementAuxOutput& aux_output,
+      absl::Duration* elapsed);
+
+  // Returns the index of the first result in prefetched_reference_results_,
+  // at or after next_prefetched_reference_result_, that was computed for
+  // <sql> and <parameters> with the current options of reference_driver().
+  // Returns -1 if there is none.
+  int FindPrefetchedReferenceResult(
+      absl::string_view sql, const std::map<std::string, Value>& parameters);
+
   // NOTE: This implementation is specific to testing the reference
   // implementation.
   // TODO: This should be pulled out to a separate subclass
@@ -0,0 +1,193 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/compliance/sql_test_base.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "zetasql/base/testing/status_matchers.h"
+#include "zetasql/compliance/known_error.pb.h"
+#include "zetasql/compliance/test_driver.h"
+#include "zetasql/public/language_options.h"
+#include "zetasql/public/options.pb.h"
+#include "zetasql/public/value.h"
+#include "zetasql/reference_impl/reference_driver.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+
+namespace zetasql {
+
+// A small set of code-based function statements, with parameters named the
+// way ComplianceCodebasedTests names them. One of them returns an error.
+struct FunctionStatement {
+  std::string sql;
+  std::map<std::string, Value> params;
+};
+
+static std::vector<FunctionStatement> GetFunctionStatements() {
+  return {
+      {"SELECT @p0 + @p1", {{"p0", Value::Int64(1)}, {"p1", Value::Int64(2)}}},
+      {"SELECT CONCAT(@p0, @p1)",
+       {{"p0", Value::String("a")}, {"p1", Value::String("b")}}},
+      {"SELECT DIV(@p0, @p1)",
+       {{"p0", Value::Int64(1)}, {"p1", Value::Int64(0)}}},
+      {"SELECT LENGTH(@p0)", {{"p0", Value::NullString()}}},
+      {"SELECT @p0 * 2.5", {{"p0", Value::Double(4)}}},
+  };
+}
+
+class SqlTestBaseTest : public SQLTestBase {
+ protected:
+  static constexpr int kNumWorkerDrivers = 3;
+
+  SqlTestBaseTest() : SQLTestBase(&test_driver_, &reference_driver_) {
+    for (int i = 0; i < kNumWorkerDrivers; ++i) {
+      worker_driver_owners_.push_back(
+          std::make_unique<ReferenceDriver>(LanguageOptions()));
+      worker_drivers_.push_back(worker_driver_owners_.back().get());
+    }
+  }
+
+  const std::string GetTestSuiteName() override { return "SqlTestBaseTest"; }
+
+  void SetUp() override {
+    SQLTestBase::SetUp();
+    for (ReferenceDriver* worker_driver : worker_drivers_) {
+      ZETASQL_ASSERT_OK(worker_driver->CreateDatabase(TestDatabase{}));
+    }
+  }
+
+  // Prefetches <statements> on the worker drivers.
+  void Prefetch(std::vector<ReferenceStatement> statements) {
+    PrefetchReferenceResults(std::move(statements), worker_drivers_);
+  }
+
+  static std::vector<ReferenceStatement> ToReferenceStatements(
+      const std::vector<FunctionStatement>& statements) {
+    std::vector<ReferenceStatement> reference_statements;
+    for (const FunctionStatement& statement : statements) {
+      reference_statements.push_back({statement.sql, statement.params});
+    }
+    return reference_statements;
+  }
+
+  // Runs each statement on the test thread, recording the result and the
+  // known error mode it was reported with.
+  void RunSerially(
+      const std::vector<FunctionStatement>& statements,
+      std::vector<absl::StatusOr<ComplianceTestCaseResult>>* results,
+      std::vector<KnownErrorMode>* known_error_modes) {
+    for (const FunctionStatement& statement : statements) {
+      results->push_back(RunSQL(statement.sql, statement.params));
+      known_error_modes->push_back(known_error_mode());
+    }
+  }
+
+  // Runs each statement again and checks that it reports what RunSerially()
+  // recorded for it.
+  void ExpectSameAsSerial(
+      const std::vector<FunctionStatement>& statements,
+      const std::vector<absl::StatusOr<ComplianceTestCaseResult>>& results,
+      const std::vector<KnownErrorMode>& known_error_modes) {
+    for (int i = 0; i < statements.size(); ++i) {
+      EXPECT_THAT(RunSQL(statements[i].sql, statements[i].params),
+                  ReturnsCheckOnly(results[i]))
+          << statements[i].sql;
+      EXPECT_EQ(known_error_mode(), known_error_modes[i]) << statements[i].sql;
+    }
+  }
+
+  absl::Status AddKnownError(const FunctionStatement& statement,
+                             KnownErrorMode mode) {
+    KnownErrorEntry entry;
+    entry.set_mode(mode);
+    entry.set_reason("Test");
+    entry.add_label(
+        GenerateCodeBasedStatementName(statement.sql, statement.params));
+    return AddKnownErrorEntry(entry);
+  }
+
+ private:
+  ReferenceDriver test_driver_{LanguageOptions()};
+  ReferenceDriver reference_driver_{LanguageOptions()};
+  std::vector<std::unique_ptr<ReferenceDriver>> worker_driver_owners_;
+  std::vector<ReferenceDriver*> worker_drivers_;
+};
+
+TEST_F(SqlTestBaseTest, PrefetchedResultsMatchSerialRun) {
+  const std::vector<FunctionStatement> statements = GetFunctionStatements();
+  ZETASQL_ASSERT_OK(AddKnownError(statements[2], KnownErrorMode::ALLOW_ERROR));
+
+  std::vector<absl::StatusOr<ComplianceTestCaseResult>> results;
+  std::vector<KnownErrorMode> known_error_modes;
+  RunSerially(statements, &results, &known_error_modes);
+  EXPECT_EQ(TESTONLY_num_prefetched_reference_results_used(), 0);
+  EXPECT_EQ(known_error_modes[2], KnownErrorMode::ALLOW_ERROR);
+  EXPECT_FALSE(results[2].ok());
+
+  Prefetch(ToReferenceStatements(statements));
+  ExpectSameAsSerial(statements, results, known_error_modes);
+  EXPECT_EQ(TESTONLY_num_prefetched_reference_results_used(),
+            static_cast<int>(statements.size()));
+}
+
+TEST_F(SqlTestBaseTest, MismatchedPrefetchFallsBackToTestThread) {
+  const std::vector<FunctionStatement> statements = GetFunctionStatements();
+  std::vector<absl::StatusOr<ComplianceTestCaseResult>> results;
+  std::vector<KnownErrorMode> known_error_modes;
+  RunSerially(statements, &results, &known_error_modes);
+
+  // Prefetch a different parameter for the first statement, different
+  // language options for the second, and nothing for the third. Only the last
+  // two prefetched results can be used.
+  std::vector<ReferenceStatement> reference_statements;
+  reference_statements.push_back(
+      {statements[0].sql, {{"p0", Value::Int64(1)}, {"p1", Value::Int64(3)}}});
+  LanguageOptions external_language_options;
+  external_language_options.set_product_mode(PRODUCT_EXTERNAL);
+  reference_statements.push_back(
+      {statements[1].sql, statements[1].params, external_language_options});
+  for (int i = 3; i < statements.size(); ++i) {
+    reference_statements.push_back({statements[i].sql, statements[i].params});
+  }
+  Prefetch(std::move(reference_statements));
+
+  ExpectSameAsSerial(statements, results, known_error_modes);
+  EXPECT_EQ(TESTONLY_num_prefetched_reference_results_used(), 2);
+}
+
+TEST_F(SqlTestBaseTest, CrashesDoNotRunDisablesPrefetch) {
+  const std::vector<FunctionStatement> statements = GetFunctionStatements();
+  ZETASQL_ASSERT_OK(
+      AddKnownError(statements[1], KnownErrorMode::CRASHES_DO_NOT_RUN));
+
+  std::vector<absl::StatusOr<ComplianceTestCaseResult>> results;
+  std::vector<KnownErrorMode> known_error_modes;
+  RunSerially(statements, &results, &known_error_modes);
+  EXPECT_EQ(known_error_modes[1], KnownErrorMode::CRASHES_DO_NOT_RUN);
+  EXPECT_EQ(results[1].status().code(), absl::StatusCode::kCancelled);
+
+  Prefetch(ToReferenceStatements(statements));
+  ExpectSameAsSerial(statements, results, known_error_modes);
+  EXPECT_EQ(TESTONLY_num_prefetched_reference_results_used(), 0);
+}
+
+}  // namespace zetasql
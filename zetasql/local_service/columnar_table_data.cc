@@ -0,0 +1,311 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/local_service/columnar_table_data.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "google/protobuf/io/coded_stream.h"
+#include "zetasql/local_service/local_service.pb.h"
+#include "zetasql/public/evaluator_table_iterator.h"
+#include "zetasql/public/type.h"
+#include "zetasql/public/type.pb.h"
+#include "zetasql/public/types/timestamp_util.h"
+#include "zetasql/public/value.h"
+#include "zetasql/public/value.pb.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "zetasql/base/ret_check.h"
+#include "zetasql/base/status_builder.h"
+#include "zetasql/base/status_macros.h"
+
+namespace zetasql {
+namespace local_service {
+
+using ::google::protobuf::io::CodedOutputStream;
+
+static size_t SignedVarintSize(int64_t value) {
+  // The ZigZag encoding used by sint64.
+  return CodedOutputStream::VarintSize64((static_cast<uint64_t>(value) << 1) ^
+                                         static_cast<uint64_t>(value >> 63));
+}
+
+static bool IsNull(const ColumnarTableData::Column& column, int64_t row) {
+  const std::string& null_bitmap = column.null_bitmap();
+  return row / 8 < static_cast<int64_t>(null_bitmap.size()) &&
+         (null_bitmap[row / 8] >> (row % 8)) & 1;
+}
+
+ColumnarTableDataWriter::ColumnarTableDataWriter(
+    std::vector<const Type*> column_types, ColumnarTableData* data)
+    : column_types_(std::move(column_types)),
+      data_(data),
+      dictionaries_(column_types_.size()) {
+  data_->Clear();
+  data_->set_row_count(0);
+  for (int i = 0; i < column_types_.size(); ++i) {
+    data_->add_column();
+  }
+}
+
+absl::Status ColumnarTableDataWriter::AppendRow(absl::Span<const Value> row) {
+  ZETASQL_RET_CHECK_EQ(row.size(), column_types_.size());
+  for (int i = 0; i < row.size(); ++i) {
+    ZETASQL_RETURN_IF_ERROR(AppendValue(i, row[i]));
+  }
+  data_->set_row_count(data_->row_count() + 1);
+  return absl::OkStatus();
+}
+
+absl::Status ColumnarTableDataWriter::AppendRow(
+    const EvaluatorTableIterator& iterator) {
+  ZETASQL_RET_CHECK_EQ(iterator.NumColumns(), column_types_.size());
+  for (int i = 0; i < iterator.NumColumns(); ++i) {
+    ZETASQL_RETURN_IF_ERROR(AppendValue(i, iterator.GetValue(i)));
+  }
+  data_->set_row_count(data_->row_count() + 1);
+  return absl::OkStatus();
+}
+
+void ColumnarTableDataWriter::Clear() {
+  for (ColumnarTableData::Column& column : *data_->mutable_column()) {
+    column.Clear();
+  }
+  data_->set_row_count(0);
+  for (auto& dictionary : dictionaries_) {
+    dictionary.clear();
+  }
+  approximate_byte_size_ = 0;
+}
+
+absl::Status ColumnarTableDataWriter::AppendValue(int column_index,
+                                                  const Value& value) {
+  const Type* type = column_types_[column_index];
+  ZETASQL_RET_CHECK_EQ(value.type_kind(), type->kind());
+  ColumnarTableData::Column* column = data_->mutable_column(column_index);
+
+  if (value.is_null()) {
+    const int64_t row = data_->row_count();
+    std::string* null_bitmap = column->mutable_null_bitmap();
+    if (static_cast<int64_t>(null_bitmap->size()) <= row / 8) {
+      approximate_byte_size_ += row / 8 + 1 - null_bitmap->size();
+      null_bitmap->resize(row / 8 + 1, '\0');
+    }
+    (*null_bitmap)[row / 8] |= static_cast<char>(1 << (row % 8));
+    return absl::OkStatus();
+  }
+
+  switch (type->kind()) {
+    case TYPE_BOOL:
+      column->add_bool_values(value.bool_value());
+      approximate_byte_size_ += 1;
+      break;
+    case TYPE_INT32:
+    case TYPE_INT64:
+    case TYPE_DATE: {
+      const int64_t int64_value = value.ToInt64();
+      column->add_int64_values(int64_value);
+      approximate_byte_size_ += SignedVarintSize(int64_value);
+      break;
+    }
+    case TYPE_UINT32:
+    case TYPE_UINT64: {
+      const uint64_t uint64_value = value.ToUint64();
+      column->add_uint64_values(uint64_value);
+      approximate_byte_size_ += CodedOutputStream::VarintSize64(uint64_value);
+      break;
+    }
+    case TYPE_FLOAT:
+      column->add_float_values(value.float_value());
+      approximate_byte_size_ += sizeof(float);
+      break;
+    case TYPE_DOUBLE:
+      column->add_double_values(value.double_value());
+      approximate_byte_size_ += sizeof(double);
+      break;
+    case TYPE_STRING:
+    case TYPE_BYTES: {
+      const std::string& string_value = type->kind() == TYPE_STRING
+                                            ? value.string_value()
+                                            : value.bytes_value();
+      auto& dictionary = dictionaries_[column_index];
+      auto it = dictionary.find(string_value);
+      if (it == dictionary.end()) {
+        // The key points at the dictionary's copy, which outlives <value>.
+        std::string* entry = column->add_dictionary();
+        *entry = string_value;
+        it = dictionary.emplace(*entry, column->dictionary_size() - 1).first;
+        approximate_byte_size_ +=
+            1 + CodedOutputStream::VarintSize64(entry->size()) + entry->size();
+      }
+      column->add_dictionary_indices(it->second);
+      approximate_byte_size_ += CodedOutputStream::VarintSize32(it->second);
+      break;
+    }
+    default: {
+      ValueProto* value_proto = column->add_values();
+      ZETASQL_RETURN_IF_ERROR(value.Serialize(value_proto));
+      const size_t value_size = value_proto->ByteSizeLong();
+      approximate_byte_size_ +=
+          1 + CodedOutputStream::VarintSize64(value_size) + value_size;
+      break;
+    }
+  }
+  return absl::OkStatus();
+}
+
+// Returns the number of non-NULL values stored in <column> for <type>.
+static int NumStoredValues(const ColumnarTableData::Column& column,
+                           const Type* type) {
+  switch (type->kind()) {
+    case TYPE_BOOL:
+      return column.bool_values_size();
+    case TYPE_INT32:
+    case TYPE_INT64:
+    case TYPE_DATE:
+      return column.int64_values_size();
+    case TYPE_UINT32:
+    case TYPE_UINT64:
+      return column.uint64_values_size();
+    case TYPE_FLOAT:
+      return column.float_values_size();
+    case TYPE_DOUBLE:
+      return column.double_values_size();
+    case TYPE_STRING:
+    case TYPE_BYTES:
+      return column.dictionary_indices_size();
+    default:
+      return column.values_size();
+  }
+}
+
+// Returns the <index>th stored value of <column>, which has type <type>.
+static absl::StatusOr<Value> GetStoredValue(
+    const ColumnarTableData::Column& column, const Type* type, int index) {
+  switch (type->kind()) {
+    case TYPE_BOOL:
+      return Value::Bool(column.bool_values(index));
+    case TYPE_INT32: {
+      const int64_t value = column.int64_values(index);
+      if (value < std::numeric_limits<int32_t>::min() ||
+          value > std::numeric_limits<int32_t>::max()) {
+        return zetasql_base::InvalidArgumentErrorBuilder()
+               << "INT32 value out of range: " << value;
+      }
+      return Value::Int32(static_cast<int32_t>(value));
+    }
+    case TYPE_INT64:
+      return Value::Int64(column.int64_values(index));
+    case TYPE_DATE: {
+      const int64_t value = column.int64_values(index);
+      if (value < types::kDateMin || value > types::kDateMax) {
+        return zetasql_base::InvalidArgumentErrorBuilder()
+               << "DATE value out of range: " << value;
+      }
+      return Value::Date(static_cast<int32_t>(value));
+    }
+    case TYPE_UINT32: {
+      const uint64_t value = column.uint64_values(index);
+      if (value > std::numeric_limits<uint32_t>::max()) {
+        return zetasql_base::InvalidArgumentErrorBuilder()
+               << "UINT32 value out of range: " << value;
+      }
+      return Value::Uint32(static_cast<uint32_t>(value));
+    }
+    case TYPE_UINT64:
+      return Value::Uint64(column.uint64_values(index));
+    case TYPE_FLOAT:
+      return Value::Float(column.float_values(index));
+    case TYPE_DOUBLE:
+      return Value::Double(column.double_values(index));
+    case TYPE_STRING:
+    case TYPE_BYTES: {
+      const int32_t dictionary_index = column.dictionary_indices(index);
+      if (dictionary_index < 0 || dictionary_index >= column.dictionary_size()) {
+        return zetasql_base::InvalidArgumentErrorBuilder()
+               << "Dictionary index out of range: " << dictionary_index;
+      }
+      const std::string& entry = column.dictionary(dictionary_index);
+      return type->kind() == TYPE_STRING ? Value::String(entry)
+                                         : Value::Bytes(entry);
+    }
+    default:
+      return Value::Deserialize(column.values(index), type);
+  }
+}
+
+absl::StatusOr<std::vector<std::vector<Value>>> DeserializeColumnarTableData(
+    const ColumnarTableData& data,
+    absl::Span<const Type* const> column_types) {
+  if (data.column_size() != column_types.size()) {
+    return zetasql_base::InvalidArgumentErrorBuilder()
+           << "Expected " << column_types.size()
+           << " columns in columnar table data, found " << data.column_size();
+  }
+  // Every row has a value or a NULL bit in each column, so checking this up
+  // front keeps a bad row count from allocating too much.
+  const int64_t row_count = data.row_count();
+  int64_t max_row_count = column_types.empty() ? 0 : row_count;
+  for (int i = 0; i < column_types.size(); ++i) {
+    max_row_count = std::min<int64_t>(
+        max_row_count, NumStoredValues(data.column(i), column_types[i]) +
+                           8 * data.column(i).null_bitmap().size());
+  }
+  if (row_count < 0 || row_count > max_row_count) {
+    return zetasql_base::InvalidArgumentErrorBuilder()
+           << "Invalid row count in columnar table data: " << row_count;
+  }
+
+  std::vector<std::vector<Value>> rows(row_count);
+  for (std::vector<Value>& row : rows) {
+    row.reserve(column_types.size());
+  }
+  for (int i = 0; i < column_types.size(); ++i) {
+    const ColumnarTableData::Column& column = data.column(i);
+    const Type* type = column_types[i];
+    const int num_stored_values = NumStoredValues(column, type);
+    int next_value = 0;
+    for (int64_t row = 0; row < row_count; ++row) {
+      if (IsNull(column, row)) {
+        rows[row].push_back(Value::Null(type));
+        continue;
+      }
+      if (next_value == num_stored_values) {
+        return zetasql_base::InvalidArgumentErrorBuilder()
+               << "Too few values for column " << i
+               << " in columnar table data";
+      }
+      ZETASQL_ASSIGN_OR_RETURN(Value value,
+                       GetStoredValue(column, type, next_value++));
+      rows[row].push_back(std::move(value));
+    }
+    if (next_value != num_stored_values) {
+      return zetasql_base::InvalidArgumentErrorBuilder()
+             << "Too many values for column " << i << " in columnar table data";
+    }
+  }
+  return rows;
+}
+
+}  // namespace local_service
+}  // namespace zetasql
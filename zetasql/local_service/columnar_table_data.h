@@ -0,0 +1,78 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef ZETASQL_LOCAL_SERVICE_COLUMNAR_TABLE_DATA_H_
+#define ZETASQL_LOCAL_SERVICE_COLUMNAR_TABLE_DATA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "zetasql/local_service/local_service.pb.h"
+#include "zetasql/public/evaluator_table_iterator.h"
+#include "zetasql/public/type.h"
+#include "zetasql/public/value.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+
+namespace zetasql {
+namespace local_service {
+
+// Appends rows to a ColumnarTableData.
+class ColumnarTableDataWriter {
+ public:
+  // Clears <data> and starts writing rows with <column_types> into it. The
+  // types and <data> must outlive the writer.
+  ColumnarTableDataWriter(std::vector<const Type*> column_types,
+                          ColumnarTableData* data);
+  ColumnarTableDataWriter(const ColumnarTableDataWriter&) = delete;
+  ColumnarTableDataWriter& operator=(const ColumnarTableDataWriter&) = delete;
+
+  // Appends a row with one value per column.
+  absl::Status AppendRow(absl::Span<const Value> row);
+
+  // Appends the current row of <iterator>.
+  absl::Status AppendRow(const EvaluatorTableIterator& iterator);
+
+  // Clears the written rows, but keeps the columns.
+  void Clear();
+
+  // The serialized size of the rows written so far, give or take a few bytes
+  // per column. Cheaper than data->ByteSizeLong().
+  size_t ApproximateByteSize() const { return approximate_byte_size_; }
+
+ private:
+  absl::Status AppendValue(int column_index, const Value& value);
+
+  const std::vector<const Type*> column_types_;
+  ColumnarTableData* data_;
+  // For each column, the index of each string in its dictionary. The keys
+  // point into the dictionary entries, which do not move when it grows.
+  std::vector<absl::flat_hash_map<absl::string_view, int32_t>> dictionaries_;
+  size_t approximate_byte_size_ = 0;
+};
+
+// Decodes <data>, whose columns have <column_types>, into rows.
+absl::StatusOr<std::vector<std::vector<Value>>> DeserializeColumnarTableData(
+    const ColumnarTableData& data, absl::Span<const Type* const> column_types);
+
+}  // namespace local_service
+}  // namespace zetasql
+
+#endif  // ZETASQL_LOCAL_SERVICE_COLUMNAR_TABLE_DATA_H_
@@ -0,0 +1,139 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/local_service/columnar_table_data.h"
+
+#include <vector>
+
+#include "zetasql/base/testing/status_matchers.h"
+#include "zetasql/local_service/local_service.pb.h"
+#include "zetasql/public/type.h"
+#include "zetasql/public/value.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+
+namespace zetasql {
+namespace local_service {
+namespace {
+
+using ::zetasql_base::testing::StatusIs;
+
+TEST(ColumnarTableDataTest, RoundTrip) {
+  const std::vector<const Type*> types = {
+      types::BoolType(),   types::Int32Type(),  types::Int64Type(),
+      types::Uint32Type(), types::Uint64Type(), types::FloatType(),
+      types::DoubleType(), types::DateType(),   types::StringType(),
+      types::BytesType(),  types::Int64ArrayType()};
+  std::vector<std::vector<Value>> rows;
+  for (int i = 0; i < 20; ++i) {
+    std::vector<Value> row = {
+        Value::Bool(i % 2 == 0),
+        Value::Int32(-i),
+        Value::Int64(int64_t{1} << (i * 3)),
+        Value::Uint32(i),
+        Value::Uint64(~uint64_t{0} - i),
+        Value::Float(i / 4.0f),
+        Value::Double(-i / 3.0),
+        Value::Date(i * 100),
+        Value::String(i % 3 == 0 ? "foo" : "bar"),
+        Value::Bytes(absl::string_view(i % 2 == 0 ? "\x01" : "")),
+        values::Int64Array({int64_t{i}, int64_t{i} + 1})};
+    // Sprinkle NULLs over the columns.
+    row[i % row.size()] = Value::Null(types[i % row.size()]);
+    rows.push_back(std::move(row));
+  }
+
+  ColumnarTableData data;
+  ColumnarTableDataWriter writer(types, &data);
+  for (const std::vector<Value>& row : rows) {
+    ZETASQL_ASSERT_OK(writer.AppendRow(row));
+  }
+  EXPECT_EQ(data.row_count(), rows.size());
+  // Strings are dictionary coded.
+  EXPECT_EQ(data.column(8).dictionary_size(), 2);
+  EXPECT_EQ(data.column(8).dictionary_indices_size(), 18);
+  // The estimate is close to the real size.
+  EXPECT_NEAR(writer.ApproximateByteSize(), data.ByteSizeLong(),
+              10 * types.size() + 10);
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::vector<std::vector<Value>> decoded,
+                       DeserializeColumnarTableData(data, types));
+  ASSERT_EQ(decoded.size(), rows.size());
+  for (int i = 0; i < rows.size(); ++i) {
+    ASSERT_EQ(decoded[i].size(), rows[i].size());
+    for (int j = 0; j < rows[i].size(); ++j) {
+      EXPECT_EQ(decoded[i][j], rows[i][j]) << i << ", " << j;
+    }
+  }
+
+  writer.Clear();
+  EXPECT_EQ(data.row_count(), 0);
+  EXPECT_EQ(data.column_size(), types.size());
+  EXPECT_EQ(writer.ApproximateByteSize(), 0);
+  ZETASQL_ASSERT_OK(writer.AppendRow(rows[1]));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(decoded, DeserializeColumnarTableData(data, types));
+  ASSERT_EQ(decoded.size(), 1);
+  EXPECT_EQ(decoded[0], rows[1]);
+}
+
+TEST(ColumnarTableDataTest, WrongRowSize) {
+  ColumnarTableData data;
+  ColumnarTableDataWriter writer({types::Int64Type()}, &data);
+  EXPECT_FALSE(writer.AppendRow({Value::Int64(1), Value::Int64(2)}).ok());
+  EXPECT_FALSE(writer.AppendRow({Value::String("a")}).ok());
+}
+
+TEST(ColumnarTableDataTest, InvalidData) {
+  const std::vector<const Type*> types = {types::Int32Type()};
+  ColumnarTableData data;
+  data.set_row_count(2);
+  ColumnarTableData::Column* column = data.add_column();
+  column->add_int64_values(1);
+
+  // Too few values.
+  EXPECT_THAT(DeserializeColumnarTableData(data, types),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  // Too many values.
+  column->add_int64_values(2);
+  column->add_int64_values(3);
+  EXPECT_THAT(DeserializeColumnarTableData(data, types),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  // Out of range for INT32.
+  column->clear_int64_values();
+  column->add_int64_values(1);
+  column->add_int64_values(int64_t{1} << 40);
+  EXPECT_THAT(DeserializeColumnarTableData(data, types),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  // Huge row count.
+  data.set_row_count(int64_t{1} << 50);
+  EXPECT_THAT(DeserializeColumnarTableData(data, types),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  // Wrong number of columns.
+  data.set_row_count(0);
+  data.add_column();
+  EXPECT_THAT(DeserializeColumnarTableData(data, types),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace local_service
+}  // namespace zetasql
@@ -28,6 +28,7 @@
 #include "google/protobuf/descriptor.pb.h"
 #include "zetasql/common/errors.h"
 #include "zetasql/common/proto_helper.h"
+#include "zetasql/local_service/columnar_table_data.h"
 #include "zetasql/local_service/local_service.pb.h"
 #include "zetasql/local_service/state.h"
 #include "zetasql/parser/parse_tree_serializer.h"
@@ -45,19 +46,36 @@
 #include "zetasql/public/table_from_proto.h"
 #include "zetasql/public/type.h"
 #include "zetasql/public/type.pb.h"
+#include "zetasql/public/types/type_deserializer.h"
 #include "zetasql/public/value.h"
 #include "zetasql/public/value.pb.h"
 #include "zetasql/resolved_ast/resolved_ast.h"
 #include "zetasql/resolved_ast/sql_builder.h"
+#include "absl/base/thread_annotations.h"
 #include "absl/cleanup/cleanup.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/flags/flag.h"
 #include "absl/functional/bind_front.h"
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "absl/types/optional.h"
 #include "zetasql/base/map_util.h"
 #include "zetasql/base/ret_check.h"
+#include "zetasql/base/status_builder.h"
 #include "zetasql/base/status_macros.h"
 
+ABSL_FLAG(absl::Duration, zetasql_local_service_prepared_statement_idle_timeout,
+          absl::ZeroDuration(),
+          "If set, prepared expressions, queries and modifies that are not "
+          "used for between this long and twice this long are unprepared, as "
+          "if the client had unprepared them.");
+
 namespace zetasql {
 namespace local_service {
 
@@ -158,12 +176,14 @@ class RegisteredDescriptorPoolState : public GenericState {
   RegisteredDescriptorPoolState& operator=(
       const RegisteredDescriptorPoolState&) = delete;
 
-  static absl::StatusOr<std::unique_ptr<RegisteredDescriptorPoolState>> Create(
-      const google::protobuf::FileDescriptorSet& fdset) {
-    auto pool = std::make_unique<google::protobuf::DescriptorPool>();
-    ZETASQL_RETURN_IF_ERROR(AddFileDescriptorSetToPool(&fdset, pool.get()));
-
-    return absl::WrapUnique(new RegisteredDescriptorPoolState(std::move(pool)));
+  // The pool may be shared with other states; see
+  // RegisteredDescriptorPoolPool::GetOrCreatePool(). <pool> must have been
+  // built from <serialized_file_descriptor_set>.
+  static std::unique_ptr<RegisteredDescriptorPoolState> Create(
+      std::shared_ptr<const google::protobuf::DescriptorPool> pool,
+      std::shared_ptr<const std::string> serialized_file_descriptor_set) {
+    return absl::WrapUnique(new RegisteredDescriptorPoolState(
+        std::move(pool), std::move(serialized_file_descriptor_set)));
   }
 
   const google::protobuf::DescriptorPool* pool() {
@@ -174,15 +194,28 @@ class RegisteredDescriptorPoolState : public GenericState {
     }
   }
 
+  // The FileDescriptorSet that pool() was built from, serialized, or null for
+  // the builtin pool.
+  const std::shared_ptr<const std::string>& serialized_file_descriptor_set()
+      const {
+    return serialized_file_descriptor_set_;
+  }
+
  private:
   friend class RegisteredDescriptorPoolPool;
   class builtin_descriptor_pool_t {};
   explicit RegisteredDescriptorPoolState(builtin_descriptor_pool_t)
       : is_builtin_(true) {}
-  explicit RegisteredDescriptorPoolState(
-      std::unique_ptr<const google::protobuf::DescriptorPool> pool)
-      : pool_(std::move(pool)), is_builtin_(false) {}
-  const std::unique_ptr<const google::protobuf::DescriptorPool> pool_ = nullptr;
+  RegisteredDescriptorPoolState(
+      std::shared_ptr<const google::protobuf::DescriptorPool> pool,
+      std::shared_ptr<const std::string> serialized_file_descriptor_set)
+      : pool_(std::move(pool)),
+        serialized_file_descriptor_set_(
+            std::move(serialized_file_descriptor_set)),
+        is_builtin_(false) {}
+  const std::shared_ptr<const google::protobuf::DescriptorPool> pool_ = nullptr;
+  const std::shared_ptr<const std::string> serialized_file_descriptor_set_ =
+      nullptr;
   const bool is_builtin_ = false;
 };
 
@@ -201,10 +234,387 @@ class RegisteredDescriptorPoolPool
     return builtin_pool_;
   }
 
+  // Returns a new state for a DescriptorPool built from <fdset>. Clients tend
+  // to send the same descriptors with every request and registration, so pools
+  // are looked up by content and shared for as long as anyone holds on to
+  // them.
+  absl::StatusOr<std::unique_ptr<RegisteredDescriptorPoolState>>
+  GetOrCreatePool(const google::protobuf::FileDescriptorSet& fdset) {
+    // FileDescriptorSet has no map fields, so equal sets serialize equally.
+    std::string key = fdset.SerializeAsString();
+    {
+      absl::MutexLock lock(&pool_cache_mutex_);
+      auto it = pool_cache_.find(key);
+      if (it != pool_cache_.end()) {
+        if (std::shared_ptr<const google::protobuf::DescriptorPool> pool =
+                it->second.pool.lock()) {
+          return RegisteredDescriptorPoolState::Create(
+              std::move(pool), it->second.serialized_file_descriptor_set);
+        }
+      }
+    }
+
+    // Build the pool without holding the lock; it can take a while.
+    ZETASQL_ASSIGN_OR_RETURN(std::shared_ptr<const google::protobuf::DescriptorPool> pool,
+                     BuildDescriptorPool(fdset));
+
+    absl::MutexLock lock(&pool_cache_mutex_);
+    auto it = pool_cache_.find(key);
+    if (it != pool_cache_.end()) {
+      if (std::shared_ptr<const google::protobuf::DescriptorPool> other =
+              it->second.pool.lock()) {
+        // Another thread built the same pool in the meantime.
+        return RegisteredDescriptorPoolState::Create(
+            std::move(other), it->second.serialized_file_descriptor_set);
+      }
+      pool_cache_.erase(it);
+    }
+    auto serialized_file_descriptor_set =
+        std::make_shared<const std::string>(std::move(key));
+    pool_cache_.emplace(*serialized_file_descriptor_set,
+                        CachedPool{serialized_file_descriptor_set, pool});
+    if (pool_cache_.size() >= sweep_pool_cache_at_size_) {
+      // Drop the entries of pools that are gone, amortized over insertions.
+      for (auto it = pool_cache_.begin(); it != pool_cache_.end();) {
+        if (it->second.pool.expired()) {
+          pool_cache_.erase(it++);
+        } else {
+          ++it;
+        }
+      }
+      sweep_pool_cache_at_size_ =
+          std::max<size_t>(kMinSweepPoolCacheAtSize, 2 * pool_cache_.size());
+    }
+    return RegisteredDescriptorPoolState::Create(
+        std::move(pool), std::move(serialized_file_descriptor_set));
+  }
+
+  // Returns a new state for a DescriptorPool built from the same descriptors
+  // as <state>, which is not shared with any other state.
+  static absl::StatusOr<std::unique_ptr<RegisteredDescriptorPoolState>>
+  CreatePrivateCopy(const RegisteredDescriptorPoolState& state) {
+    ZETASQL_RET_CHECK(state.serialized_file_descriptor_set() != nullptr);
+    google::protobuf::FileDescriptorSet fdset;
+    ZETASQL_RET_CHECK(fdset.ParseFromString(*state.serialized_file_descriptor_set()));
+    ZETASQL_ASSIGN_OR_RETURN(std::shared_ptr<const google::protobuf::DescriptorPool> pool,
+                     BuildDescriptorPool(fdset));
+    return RegisteredDescriptorPoolState::Create(
+        std::move(pool), state.serialized_file_descriptor_set());
+  }
+
  private:
+  static constexpr size_t kMinSweepPoolCacheAtSize = 16;
+
+  struct CachedPool {
+    // Owns the key of the entry.
+    std::shared_ptr<const std::string> serialized_file_descriptor_set;
+    std::weak_ptr<const google::protobuf::DescriptorPool> pool;
+  };
+
+  static absl::StatusOr<std::shared_ptr<const google::protobuf::DescriptorPool>>
+  BuildDescriptorPool(const google::protobuf::FileDescriptorSet& fdset) {
+    auto pool = std::make_shared<google::protobuf::DescriptorPool>();
+    ZETASQL_RETURN_IF_ERROR(AddFileDescriptorSetToPool(&fdset, pool.get()));
+    return pool;
+  }
+
   std::shared_ptr<RegisteredDescriptorPoolState> builtin_pool_;
+
+  absl::Mutex pool_cache_mutex_;
+  // Keyed by the serialized FileDescriptorSet.
+  absl::flat_hash_map<absl::string_view, CachedPool> pool_cache_
+      ABSL_GUARDED_BY(pool_cache_mutex_);
+  size_t sweep_pool_cache_at_size_ ABSL_GUARDED_BY(pool_cache_mutex_) =
+      kMinSweepPoolCacheAtSize;
+};
+
+class RegisteredCatalogState : public GenericState {
+ public:
+  RegisteredCatalogState() = delete;
+  RegisteredCatalogState(const RegisteredCatalogState&) = delete;
+  RegisteredCatalogState& operator=(const RegisteredCatalogState&) = delete;
+
+  static absl::StatusOr<std::unique_ptr<RegisteredCatalogState>> Create(
+      const SimpleCatalogProto& proto,
+      const google::protobuf::Map<std::string, TableContent>& tables_contents,
+      std::vector<std::shared_ptr<RegisteredDescriptorPoolState>> pool_states,
+      absl::flat_hash_set<int64_t> owned_descriptor_pool_ids = {}) {
+    std::vector<const google::protobuf::DescriptorPool*> pools;
+    for (const auto& pool_state : pool_states) {
+      pools.push_back(pool_state->pool());
+    }
+    // The top-level tables and functions are kept apart from the rest of the
+    // catalog, so that Update() can reuse them.
+    SimpleCatalogProto base_proto = proto;
+    base_proto.clear_table();
+    base_proto.clear_custom_function();
+    auto shared_pool_states =
+        std::make_shared<const PoolStates>(std::move(pool_states));
+    auto state = absl::WrapUnique(new RegisteredCatalogState(
+        std::move(base_proto), pools, shared_pool_states,
+        std::make_shared<TypeFactory>(),
+        std::move(owned_descriptor_pool_ids)));
+
+    const TypeDeserializer type_deserializer(state->type_factory_.get(),
+                                             pools);
+    ZETASQL_RETURN_IF_ERROR(state->AddTables(proto.table(), tables_contents,
+                                     type_deserializer, shared_pool_states));
+    ZETASQL_RETURN_IF_ERROR(state->AddFunctions(
+        proto.custom_function(), type_deserializer, shared_pool_states));
+    ZETASQL_RETURN_IF_ERROR(state->BuildCatalog());
+    return state;
+  }
+
+  // Returns a copy of this catalog with the changes in <request> applied.
+  // This state is left as is, since prepared statements may still be using it.
+  // Unchanged tables and functions are shared with the copy rather than
+  // deserialized again. <pool_states> are the pools listed in the request, and
+  // <owned_descriptor_pool_ids> the ones that were registered for it. The copy
+  // only keeps the pools of the base catalog and of its remaining tables and
+  // functions alive, so pools listed by earlier requests are released once
+  // everything added with them is dropped.
+  absl::StatusOr<std::unique_ptr<RegisteredCatalogState>> Update(
+      const UpdateRegisteredCatalogRequest& request,
+      const std::vector<std::shared_ptr<RegisteredDescriptorPoolState>>&
+          pool_states,
+      const absl::flat_hash_set<int64_t>& owned_descriptor_pool_ids) const {
+    auto state = absl::WrapUnique(new RegisteredCatalogState(
+        base_proto_, base_pools_, base_pool_states_, type_factory_,
+        owned_descriptor_pool_ids_));
+    state->tables_ = tables_;
+    state->table_memory_usage_ = table_memory_usage_;
+    state->table_pool_states_ = table_pool_states_;
+    state->functions_ = functions_;
+    state->function_pool_states_ = function_pool_states_;
+
+    for (const std::string& name : request.drop_table()) {
+      const std::string lower_name = absl::AsciiStrToLower(name);
+      if (state->tables_.erase(lower_name) == 0) {
+        return MakeSqlError() << "Unknown table '" << name
+                              << "' in registered catalog";
+      }
+      state->table_memory_usage_.erase(lower_name);
+      state->table_pool_states_.erase(lower_name);
+    }
+    for (const std::string& name : request.drop_function()) {
+      const std::string lower_name = absl::AsciiStrToLower(name);
+      if (state->functions_.erase(lower_name) == 0) {
+        return MakeSqlError() << "Unknown function '" << name
+                              << "' in registered catalog";
+      }
+      state->function_pool_states_.erase(lower_name);
+    }
+
+    std::vector<const google::protobuf::DescriptorPool*> pools;
+    for (const auto& pool_state : pool_states) {
+      pools.push_back(pool_state->pool());
+    }
+    auto request_pool_states = std::make_shared<const PoolStates>(pool_states);
+    state->owned_descriptor_pool_ids_.insert(owned_descriptor_pool_ids.begin(),
+                                             owned_descriptor_pool_ids.end());
+
+    const TypeDeserializer type_deserializer(type_factory_.get(), pools);
+    ZETASQL_RETURN_IF_ERROR(state->AddTables(request.add_table(),
+                                     request.table_content(),
+                                     type_deserializer, request_pool_states));
+    ZETASQL_RETURN_IF_ERROR(state->AddFunctions(
+        request.add_function(), type_deserializer, request_pool_states));
+    ZETASQL_RETURN_IF_ERROR(state->BuildCatalog());
+    return state;
+  }
+
+  // Ideally, this would be const, however, the zetasql analyzer API
+  // requires this be mutable (even though it does ever mutate anything).
+  SimpleCatalog* GetCatalog() {
+    return catalog_.get();
+  }
+
+  const absl::flat_hash_set<int64_t>& owned_descriptor_pool_ids() const {
+    return owned_descriptor_pool_ids_;
+  }
+
+  // The catalog proto and the contents of the tables.
+  int64_t ApproximateMemoryUsage() const override {
+    return approximate_memory_usage_;
+  }
+
+ private:
+  using PoolStates =
+      std::vector<std::shared_ptr<RegisteredDescriptorPoolState>>;
+
+  RegisteredCatalogState(
+      SimpleCatalogProto base_proto,
+      std::vector<const google::protobuf::DescriptorPool*> base_pools,
+      std::shared_ptr<const PoolStates> base_pool_states,
+      std::shared_ptr<TypeFactory> type_factory,
+      absl::flat_hash_set<int64_t> owned_descriptor_pool_ids)
+      : base_proto_(std::move(base_proto)),
+        base_pools_(std::move(base_pools)),
+        base_pool_states_(std::move(base_pool_states)),
+        type_factory_(std::move(type_factory)),
+        owned_descriptor_pool_ids_(std::move(owned_descriptor_pool_ids)) {}
+
+  // <pool_states> are the pools that <type_deserializer> uses.
+  absl::Status AddTables(
+      const RepeatedPtrField<SimpleTableProto>& table_protos,
+      const google::protobuf::Map<std::string, TableContent>& tables_contents,
+      const TypeDeserializer& type_deserializer,
+      const std::shared_ptr<const PoolStates>& pool_states) {
+    for (const SimpleTableProto& table_proto : table_protos) {
+      const std::string& name = table_proto.has_name_in_catalog()
+                                    ? table_proto.name_in_catalog()
+                                    : table_proto.name();
+      int64_t memory_usage = 0;
+      ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<SimpleTable> table,
+                       DeserializeTable(name, table_proto, tables_contents,
+                                        type_deserializer, &memory_usage));
+      const std::string lower_name = absl::AsciiStrToLower(name);
+      if (!tables_.emplace(lower_name, std::move(table)).second) {
+        return ::zetasql_base::InvalidArgumentErrorBuilder()
+               << "Duplicate table '" << name << "' in serialized catalog";
+      }
+      table_memory_usage_[lower_name] = memory_usage;
+      table_pool_states_[lower_name] = pool_states;
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status AddFunctions(
+      const RepeatedPtrField<FunctionProto>& function_protos,
+      const TypeDeserializer& type_deserializer,
+      const std::shared_ptr<const PoolStates>& pool_states) {
+    for (const FunctionProto& function_proto : function_protos) {
+      ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<Function> function,
+                       Function::Deserialize(function_proto, type_deserializer));
+      const std::string name = function->Name();
+      const std::string lower_name = absl::AsciiStrToLower(name);
+      if (!functions_.emplace(lower_name, std::move(function)).second) {
+        return ::zetasql_base::InvalidArgumentErrorBuilder()
+               << "Duplicate function '" << name << "' in serialized catalog";
+      }
+      function_pool_states_[lower_name] = pool_states;
+    }
+    return absl::OkStatus();
+  }
+
+  // Builds <catalog_> from <base_proto_>, <tables_> and <functions_>.
+  absl::Status BuildCatalog() {
+    approximate_memory_usage_ = base_proto_.SpaceUsedLong();
+    for (const auto& [name, memory_usage] : table_memory_usage_) {
+      approximate_memory_usage_ += memory_usage;
+    }
+    ZETASQL_ASSIGN_OR_RETURN(catalog_,
+                     SimpleCatalog::Deserialize(base_proto_, base_pools_));
+    for (const auto& [name, table] : tables_) {
+      if (!catalog_->AddTableIfNotPresent(name, table.get())) {
+        return ::zetasql_base::InvalidArgumentErrorBuilder()
+               << "Duplicate table '" << name << "' in serialized catalog";
+      }
+    }
+    for (const auto& [name, function] : functions_) {
+      if (!catalog_->AddFunctionIfNotPresent(function->Name(),
+                                             function.get())) {
+        return ::zetasql_base::InvalidArgumentErrorBuilder()
+               << "Duplicate function '" << function->Name()
+               << "' in serialized catalog";
+      }
+    }
+    return absl::OkStatus();
+  }
+
+  static int64_t ContentMemoryUsage(
+      const std::vector<std::vector<Value>>& content) {
+    int64_t memory_usage = 0;
+    for (const std::vector<Value>& row : content) {
+      memory_usage += sizeof(row);
+      for (const Value& value : row) {
+        memory_usage += value.physical_byte_size();
+      }
+    }
+    return memory_usage;
+  }
+
+  // Sets <memory_usage> to the approximate size of the table contents.
+  static absl::StatusOr<std::unique_ptr<SimpleTable>> DeserializeTable(
+      const std::string& name, const SimpleTableProto& proto,
+      const google::protobuf::Map<std::string, TableContent>& tables_contents,
+      const TypeDeserializer& type_deserializer, int64_t* memory_usage) {
+    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<SimpleTable> table,
+                     SimpleTable::Deserialize(proto, type_deserializer));
+
+    const TableContent* table_content = zetasql_base::FindOrNull(tables_contents, name);
+    if (table_content == nullptr) {
+      return table;
+    }
+    if (table_content->has_columnar_table_data()) {
+      if (table_content->has_table_data()) {
+        return zetasql_base::InvalidArgumentErrorBuilder()
+               << "Both table_data and columnar_table_data are set for table "
+               << name;
+      }
+      std::vector<const Type*> column_types;
+      column_types.reserve(table->NumColumns());
+      for (int i = 0; i < table->NumColumns(); i++) {
+        column_types.push_back(table->GetColumn(i)->GetType());
+      }
+      ZETASQL_ASSIGN_OR_RETURN(
+          std::vector<std::vector<Value>> content,
+          DeserializeColumnarTableData(table_content->columnar_table_data(),
+                                       column_types));
+      *memory_usage = ContentMemoryUsage(content);
+      table->SetContents(std::move(content));
+      return table;
+    }
+    if (!table_content->has_table_data()) {
+      return table;
+    }
+
+    const TableData& table_data = table_content->table_data();
+
+    std::vector<std::vector<Value>> content;
+    for (const auto& row : table_data.row()) {
+      std::vector<Value> zetasql_row;
+      for (int i = 0; i < row.cell_size(); i++) {
+        ZETASQL_ASSIGN_OR_RETURN(
+            auto zetasql_value,
+            Value::Deserialize(row.cell(i), table->GetColumn(i)->GetType()));
+        zetasql_row.push_back(zetasql_value);
+      }
+      content.push_back(std::move(zetasql_row));
+    }
+    *memory_usage = ContentMemoryUsage(content);
+    table->SetContents(std::move(content));
+
+    return table;
+  }
+
+  // The catalog proto without its top-level tables and functions, and the
+  // pools it was deserialized with.
+  const SimpleCatalogProto base_proto_;
+  const std::vector<const google::protobuf::DescriptorPool*> base_pools_;
+  // Keeps <base_pools_> alive.
+  const std::shared_ptr<const PoolStates> base_pool_states_;
+  // Owns the types of <tables_> and <functions_>, and is shared with every
+  // updated copy of this catalog.
+  const std::shared_ptr<TypeFactory> type_factory_;
+  // Keyed by lower case name.
+  absl::flat_hash_map<std::string, std::shared_ptr<const SimpleTable>> tables_;
+  // The approximate size of the contents of <tables_>.
+  absl::flat_hash_map<std::string, int64_t> table_memory_usage_;
+  // Keeps the pools that each of <tables_> was deserialized with alive.
+  absl::flat_hash_map<std::string, std::shared_ptr<const PoolStates>>
+      table_pool_states_;
+  absl::flat_hash_map<std::string, std::shared_ptr<const Function>> functions_;
+  // Keeps the pools that each of <functions_> was deserialized with alive.
+  absl::flat_hash_map<std::string, std::shared_ptr<const PoolStates>>
+      function_pool_states_;
+  absl::flat_hash_set<int64_t> owned_descriptor_pool_ids_;
+  std::unique_ptr<SimpleCatalog> catalog_;
+  int64_t approximate_memory_usage_ = 0;
 };
 
+class RegisteredCatalogPool : public SharedStatePool<RegisteredCatalogState> {};
+
 class InternalPreparedExpressionState : public GenericState {
  public:
   InternalPreparedExpressionState() = delete;
@@ -217,7 +627,7 @@ class InternalPreparedExpressionState : public GenericState {
   CreateAndPrepareExpression(
       const std::string& sql, const AnalyzerOptionsProto& options_proto,
       const std::vector<const google::protobuf::DescriptorPool*>& pools,
-      SimpleCatalog* catalog,
+      std::shared_ptr<RegisteredCatalogState> catalog_state,
       absl::flat_hash_set<int64_t> owned_descriptor_pool_ids = {},
       std::optional<int64_t> owned_catalog_id = std::nullopt) {
     auto type_factory = std::make_unique<TypeFactory>();
@@ -229,10 +639,15 @@ class InternalPreparedExpressionState : public GenericState {
     evaluator_options.type_factory = type_factory.get();
     evaluator_options.default_time_zone = options->default_time_zone();
     auto exp = std::make_unique<PreparedExpression>(sql, evaluator_options);
-    ZETASQL_RETURN_IF_ERROR(exp->Prepare(*options, catalog));
+    ZETASQL_RETURN_IF_ERROR(exp->Prepare(
+        *options,
+        catalog_state != nullptr ? catalog_state->GetCatalog() : nullptr));
+    const int64_t approximate_memory_usage =
+        sql.size() + options_proto.SpaceUsedLong();
     return absl::WrapUnique(new InternalPreparedExpressionState(
-        std::move(type_factory), std::move(options), std::move(exp),
-        std::move(owned_descriptor_pool_ids), owned_catalog_id));
+        std::move(catalog_state), std::move(type_factory), std::move(options),
+        std::move(exp), std::move(owned_descriptor_pool_ids), owned_catalog_id,
+        approximate_memory_usage));
   }
 
   const PreparedExpression* GetExpression() const { return expression_.get(); }
@@ -245,19 +660,30 @@ class InternalPreparedExpressionState : public GenericState {
 
   std::optional<int64_t> owned_catalog_id() const { return owned_catalog_id_; }
 
+  // The SQL and options it was prepared from. The plan is not counted.
+  int64_t ApproximateMemoryUsage() const override {
+    return approximate_memory_usage_;
+  }
+
  private:
   InternalPreparedExpressionState(
+      std::shared_ptr<RegisteredCatalogState> catalog_state,
       std::unique_ptr<const TypeFactory> factory,
       std::unique_ptr<const AnalyzerOptions> options,
       std::unique_ptr<const PreparedExpression> expression,
       absl::flat_hash_set<int64_t> owned_descriptor_pool_ids,
-      std::optional<int64_t> owned_catalog_id)
-      : factory_(std::move(factory)),
+      std::optional<int64_t> owned_catalog_id,
+      int64_t approximate_memory_usage)
+      : catalog_state_(std::move(catalog_state)),
+        factory_(std::move(factory)),
         options_(std::move(options)),
         expression_(std::move(expression)),
         owned_descriptor_pool_ids_(std::move(owned_descriptor_pool_ids)),
-        owned_catalog_id_(owned_catalog_id) {}
+        owned_catalog_id_(owned_catalog_id),
+        approximate_memory_usage_(approximate_memory_usage) {}
 
+  // Keeps the catalog alive, even if it is updated or unregistered.
+  const std::shared_ptr<RegisteredCatalogState> catalog_state_;
   const std::unique_ptr<const TypeFactory> factory_;
   const std::unique_ptr<const AnalyzerOptions> options_;
   const std::unique_ptr<const PreparedExpression> expression_;
@@ -265,6 +691,7 @@ class InternalPreparedExpressionState : public GenericState {
   // be deleted when this object is deleted.
   const absl::flat_hash_set<int64_t> owned_descriptor_pool_ids_;
   const std::optional<int64_t> owned_catalog_id_;
+  const int64_t approximate_memory_usage_;
 };
 
 class PreparedExpressionPool
@@ -281,7 +708,7 @@ class InternalPreparedQueryState : public GenericState {
   CreateAndPrepareQuery(
       const std::string& sql, const AnalyzerOptionsProto& options_proto,
       const std::vector<const google::protobuf::DescriptorPool*>& pools,
-      SimpleCatalog* catalog,
+      std::shared_ptr<RegisteredCatalogState> catalog_state,
       absl::flat_hash_set<int64_t> owned_descriptor_pool_ids = {},
       std::optional<int64_t> owned_catalog_id = std::nullopt) {
     auto type_factory = std::make_unique<TypeFactory>();
@@ -293,10 +720,15 @@ class InternalPreparedQueryState : public GenericState {
     evaluator_options.type_factory = type_factory.get();
     evaluator_options.default_time_zone = options->default_time_zone();
     auto query = std::make_unique<PreparedQuery>(sql, evaluator_options);
-    ZETASQL_RETURN_IF_ERROR(query->Prepare(*options, catalog));
+    ZETASQL_RETURN_IF_ERROR(query->Prepare(
+        *options,
+        catalog_state != nullptr ? catalog_state->GetCatalog() : nullptr));
+    const int64_t approximate_memory_usage =
+        sql.size() + options_proto.SpaceUsedLong();
     return absl::WrapUnique(new InternalPreparedQueryState(
-        std::move(type_factory), std::move(options), std::move(query),
-        std::move(owned_descriptor_pool_ids), owned_catalog_id));
+        std::move(catalog_state), std::move(type_factory), std::move(options),
+        std::move(query), std::move(owned_descriptor_pool_ids), owned_catalog_id,
+        approximate_memory_usage));
   }
 
   const PreparedQuery* GetQuery() const { return query_.get(); }
@@ -309,19 +741,30 @@ class InternalPreparedQueryState : public GenericState {
 
   std::optional<int64_t> owned_catalog_id() const { return owned_catalog_id_; }
 
+  // The SQL and options it was prepared from. The plan is not counted.
+  int64_t ApproximateMemoryUsage() const override {
+    return approximate_memory_usage_;
+  }
+
  private:
   InternalPreparedQueryState(
+      std::shared_ptr<RegisteredCatalogState> catalog_state,
       std::unique_ptr<const TypeFactory> factory,
       std::unique_ptr<const AnalyzerOptions> options,
       std::unique_ptr<const PreparedQuery> query,
       absl::flat_hash_set<int64_t> owned_descriptor_pool_ids,
-      std::optional<int64_t> owned_catalog_id)
-      : factory_(std::move(factory)),
+      std::optional<int64_t> owned_catalog_id,
+      int64_t approximate_memory_usage)
+      : catalog_state_(std::move(catalog_state)),
+        factory_(std::move(factory)),
         options_(std::move(options)),
         query_(std::move(query)),
         owned_descriptor_pool_ids_(std::move(owned_descriptor_pool_ids)),
-        owned_catalog_id_(owned_catalog_id) {}
+        owned_catalog_id_(owned_catalog_id),
+        approximate_memory_usage_(approximate_memory_usage) {}
 
+  // Keeps the catalog alive, even if it is updated or unregistered.
+  const std::shared_ptr<RegisteredCatalogState> catalog_state_;
   const std::unique_ptr<const TypeFactory> factory_;
   const std::unique_ptr<const AnalyzerOptions> options_;
   const std::unique_ptr<const PreparedQuery> query_;
@@ -329,6 +772,7 @@ class InternalPreparedQueryState : public GenericState {
   // be deleted when this object is deleted.
   const absl::flat_hash_set<int64_t> owned_descriptor_pool_ids_;
   const std::optional<int64_t> owned_catalog_id_;
+  const int64_t approximate_memory_usage_;
 };
 
 class PreparedQueryPool : public SharedStatePool<InternalPreparedQueryState> {};
@@ -344,7 +788,7 @@ class InternalPreparedModifyState : public GenericState {
   CreateAndPrepareModify(
       const std::string& sql, const AnalyzerOptionsProto& options_proto,
       const std::vector<const google::protobuf::DescriptorPool*>& pools,
-      SimpleCatalog* catalog,
+      std::shared_ptr<RegisteredCatalogState> catalog_state,
       absl::flat_hash_set<int64_t> owned_descriptor_pool_ids = {},
       std::optional<int64_t> owned_catalog_id = std::nullopt) {
     auto type_factory = std::make_unique<TypeFactory>();
@@ -356,10 +800,15 @@ class InternalPreparedModifyState : public GenericState {
     evaluator_options.type_factory = type_factory.get();
     evaluator_options.default_time_zone = options->default_time_zone();
     auto modify = std::make_unique<PreparedModify>(sql, evaluator_options);
-    ZETASQL_RETURN_IF_ERROR(modify->Prepare(*options, catalog));
+    ZETASQL_RETURN_IF_ERROR(modify->Prepare(
+        *options,
+        catalog_state != nullptr ? catalog_state->GetCatalog() : nullptr));
+    const int64_t approximate_memory_usage =
+        sql.size() + options_proto.SpaceUsedLong();
     return absl::WrapUnique(new InternalPreparedModifyState(
-        std::move(type_factory), std::move(options), std::move(modify),
-        std::move(owned_descriptor_pool_ids), owned_catalog_id));
+        std::move(catalog_state), std::move(type_factory), std::move(options),
+        std::move(modify), std::move(owned_descriptor_pool_ids), owned_catalog_id,
+        approximate_memory_usage));
   }
 
   PreparedModify* GetModify() { return modify_.get(); }
@@ -372,19 +821,30 @@ class InternalPreparedModifyState : public GenericState {
 
   std::optional<int64_t> owned_catalog_id() const { return owned_catalog_id_; }
 
+  // The SQL and options it was prepared from. The plan is not counted.
+  int64_t ApproximateMemoryUsage() const override {
+    return approximate_memory_usage_;
+  }
+
  private:
   InternalPreparedModifyState(
+      std::shared_ptr<RegisteredCatalogState> catalog_state,
       std::unique_ptr<const TypeFactory> factory,
       std::unique_ptr<const AnalyzerOptions> options,
       std::unique_ptr<PreparedModify> modify,
       absl::flat_hash_set<int64_t> owned_descriptor_pool_ids,
-      std::optional<int64_t> owned_catalog_id)
-      : factory_(std::move(factory)),
+      std::optional<int64_t> owned_catalog_id,
+      int64_t approximate_memory_usage)
+      : catalog_state_(std::move(catalog_state)),
+        factory_(std::move(factory)),
         options_(std::move(options)),
         modify_(std::move(modify)),
         owned_descriptor_pool_ids_(std::move(owned_descriptor_pool_ids)),
-        owned_catalog_id_(owned_catalog_id) {}
+        owned_catalog_id_(owned_catalog_id),
+        approximate_memory_usage_(approximate_memory_usage) {}
 
+  // Keeps the catalog alive, even if it is updated or unregistered.
+  const std::shared_ptr<RegisteredCatalogState> catalog_state_;
   const std::unique_ptr<const TypeFactory> factory_;
   const std::unique_ptr<const AnalyzerOptions> options_;
   const std::unique_ptr<PreparedModify> modify_;
@@ -392,121 +852,70 @@ class InternalPreparedModifyState : public GenericState {
   // be deleted when this object is deleted.
   const absl::flat_hash_set<int64_t> owned_descriptor_pool_ids_;
   const std::optional<int64_t> owned_catalog_id_;
+  const int64_t approximate_memory_usage_;
 };
 
 class PreparedModifyPool : public SharedStatePool<InternalPreparedModifyState> {
 };
 
-class RegisteredCatalogState : public GenericState {
- public:
-  RegisteredCatalogState() = delete;
-  RegisteredCatalogState(const RegisteredCatalogState&) = delete;
-  RegisteredCatalogState& operator=(const RegisteredCatalogState&) = delete;
-
-  static absl::StatusOr<std::unique_ptr<RegisteredCatalogState>> Create(
-      const SimpleCatalogProto& proto,
-      const google::protobuf::Map<std::string, TableContent>& tables_contents,
-      const std::vector<const google::protobuf::DescriptorPool*>& pools,
-      absl::flat_hash_set<int64_t> owned_descriptor_pool_ids = {}) {
-    std::unique_ptr<SimpleCatalog> catalog;
-
-    if (tables_contents.empty()) {
-      // If there are is no table content to be set then there is no need
-      // to serialize the Tables independently and we can deserialize
-      // the Catalog proto as it is
-      ZETASQL_RETURN_IF_ERROR(SimpleCatalog::Deserialize(proto, pools, &catalog));
-    } else {
-      // Make a copy of the original immutable Catalog proto, which will be
-      // mutable and will allow us to manipulate the tables' contents
-      SimpleCatalogProto proto_copy = proto;
-      proto_copy.clear_table();
-
-      // Deserialize the Catalog proto with the tables
-      ZETASQL_RETURN_IF_ERROR(SimpleCatalog::Deserialize(proto_copy, pools, &catalog));
-
-      // Deserialize each individual Table proto, set its content if provided
-      // and then add the Table to the Catalog
-      const TypeDeserializer type_deserializer =
-          TypeDeserializer(catalog->type_factory(), pools);
-      for (const SimpleTableProto& table_proto : proto.table()) {
-        const std::string& name = table_proto.has_name_in_catalog()
-                                      ? table_proto.name_in_catalog()
-                                      : table_proto.name();
-        ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<SimpleTable> table,
-                         DeserializeTable(name, table_proto, tables_contents,
-                                          type_deserializer));
-
-        if (!catalog->AddOwnedTableIfNotPresent(name, std::move(table))) {
-          return ::zetasql_base::InvalidArgumentErrorBuilder()
-                 << "Duplicate table '" << name << "' in serialized catalog";
-        }
-      }
-    }
-
-    return absl::WrapUnique(new RegisteredCatalogState(
-        std::move(catalog), std::move(owned_descriptor_pool_ids)));
-  }
-
-  // Ideally, this would be const, however, the zetasql analyzer API
-  // requires this be mutable (even though it does ever mutate anything).
-  SimpleCatalog* GetCatalog() {
-    return catalog_.get();
-  }
-
-  const absl::flat_hash_set<int64_t>& owned_descriptor_pool_ids() const {
-    return owned_descriptor_pool_ids_;
-  }
+ZetaSqlLocalServiceImpl::ZetaSqlLocalServiceImpl()
+    : registered_descriptor_pools_(new RegisteredDescriptorPoolPool()),
+      registered_catalogs_(new RegisteredCatalogPool()),
+      prepared_expressions_(new PreparedExpressionPool()),
+      prepared_queries_(new PreparedQueryPool()),
+      prepared_modifies_(new PreparedModifyPool()),
+      prepared_statement_idle_timeout_(absl::GetFlag(
+          FLAGS_zetasql_local_service_prepared_statement_idle_timeout)),
+      next_idle_eviction_nanos_(
+          absl::ToUnixNanos(absl::Now() + prepared_statement_idle_timeout_)) {}
 
- private:
-  RegisteredCatalogState(std::unique_ptr<SimpleCatalog> catalog,
-                         absl::flat_hash_set<int64_t> owned_descriptor_pool_ids)
-      : catalog_(std::move(catalog)),
-        owned_descriptor_pool_ids_(std::move(owned_descriptor_pool_ids)) {}
+ZetaSqlLocalServiceImpl::~ZetaSqlLocalServiceImpl() = default;
 
-  static absl::StatusOr<std::unique_ptr<SimpleTable>> DeserializeTable(
-      const std::string& name, const SimpleTableProto& proto,
-      const google::protobuf::Map<std::string, TableContent>& tables_contents,
-      const TypeDeserializer& type_deserializer) {
-    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<SimpleTable> table,
-                     SimpleTable::Deserialize(proto, type_deserializer));
+size_t ZetaSqlLocalServiceImpl::EvictIdlePreparedStatements() {
+  return EvictIdleStates(*prepared_expressions_) +
+         EvictIdleStates(*prepared_queries_) +
+         EvictIdleStates(*prepared_modifies_);
+}
 
-    const TableContent* table_content = zetasql_base::FindOrNull(tables_contents, name);
-    if (table_content == nullptr || !table_content->has_table_data()) {
-      return table;
+template <typename InternalStateT>
+size_t ZetaSqlLocalServiceImpl::EvictIdleStates(
+    SharedStatePool<InternalStateT>& pool) {
+  std::vector<std::shared_ptr<InternalStateT>> idle_states =
+      pool.TakeIdleStates();
+  // Like UnprepareImpl(), but the states are already out of the pool.
+  for (const std::shared_ptr<InternalStateT>& state : idle_states) {
+    for (int64_t pool_id : state->owned_descriptor_pool_ids()) {
+      registered_descriptor_pools_->Delete(pool_id);
     }
-
-    const TableData& table_data = table_content->table_data();
-
-    std::vector<std::vector<Value>> content;
-    for (const auto& row : table_data.row()) {
-      std::vector<Value> zetasql_row;
-      for (int i = 0; i < row.cell_size(); i++) {
-        ZETASQL_ASSIGN_OR_RETURN(
-            auto zetasql_value,
-            Value::Deserialize(row.cell(i), table->GetColumn(i)->GetType()));
-        zetasql_row.push_back(zetasql_value);
-      }
-      content.push_back(std::move(zetasql_row));
+    if (state->owned_catalog_id().has_value()) {
+      registered_catalogs_->Delete(state->owned_catalog_id().value());
     }
-    table->SetContents(std::move(content));
-
-    return table;
   }
+  return idle_states.size();
+}
 
-  const std::unique_ptr<SimpleCatalog> catalog_;
-  const absl::flat_hash_set<int64_t> owned_descriptor_pool_ids_;
-};
-
-class RegisteredCatalogPool : public SharedStatePool<RegisteredCatalogState> {};
-
-ZetaSqlLocalServiceImpl::ZetaSqlLocalServiceImpl()
-    : registered_descriptor_pools_(new RegisteredDescriptorPoolPool()),
-      registered_catalogs_(new RegisteredCatalogPool()),
-      prepared_expressions_(new PreparedExpressionPool()),
-      prepared_queries_(new PreparedQueryPool()),
-      prepared_modifies_(new PreparedModifyPool()) {}
+void ZetaSqlLocalServiceImpl::MaybeEvictIdlePreparedStatements() {
+  if (prepared_statement_idle_timeout_ <= absl::ZeroDuration()) {
+    return;
+  }
+  const int64_t now = absl::GetCurrentTimeNanos();
+  int64_t next_eviction = next_idle_eviction_nanos_.load();
+  // Only the thread that moves the next eviction time forward evicts.
+  if (now < next_eviction ||
+      !next_idle_eviction_nanos_.compare_exchange_strong(
+          next_eviction,
+          now + absl::ToInt64Nanoseconds(prepared_statement_idle_timeout_))) {
+    return;
+  }
+  EvictIdlePreparedStatements();
+}
 
-ZetaSqlLocalServiceImpl::~ZetaSqlLocalServiceImpl() = default;
+int64_t ZetaSqlLocalServiceImpl::ApproximateMemoryUsage() const {
+  return registered_catalogs_->ApproximateMemoryUsage() +
+         prepared_expressions_->ApproximateMemoryUsage() +
+         prepared_queries_->ApproximateMemoryUsage() +
+         prepared_modifies_->ApproximateMemoryUsage();
+}
 
 void ZetaSqlLocalServiceImpl::CleanupCatalog(
     std::optional<int64_t>* catalog_id) {
@@ -559,8 +968,7 @@ absl::Status ZetaSqlLocalServiceImpl::CreateAndPrepare(
   ZETASQL_ASSIGN_OR_RETURN(
       internal_state,
       InternalPreparedExpressionState::CreateAndPrepareExpression(
-          sql, options, pools,
-          catalog_state != nullptr ? catalog_state->GetCatalog() : nullptr,
+          sql, options, pools, std::move(catalog_state),
           owned_descriptor_pool_ids, owned_catalog_id));
   return absl::OkStatus();
 }
@@ -621,8 +1029,7 @@ absl::Status ZetaSqlLocalServiceImpl::CreateAndPrepare(
   ZETASQL_ASSIGN_OR_RETURN(
       internal_state,
       InternalPreparedQueryState::CreateAndPrepareQuery(
-          sql, options, pools,
-          catalog_state != nullptr ? catalog_state->GetCatalog() : nullptr,
+          sql, options, pools, std::move(catalog_state),
           owned_descriptor_pool_ids, owned_catalog_id));
   return absl::OkStatus();
 }
@@ -680,8 +1087,7 @@ absl::Status ZetaSqlLocalServiceImpl::CreateAndPrepare(
   ZETASQL_ASSIGN_OR_RETURN(
       internal_state,
       InternalPreparedModifyState::CreateAndPrepareModify(
-          sql, options, pools,
-          catalog_state != nullptr ? catalog_state->GetCatalog() : nullptr,
+          sql, options, pools, std::move(catalog_state),
           owned_descriptor_pool_ids, owned_catalog_id));
   return absl::OkStatus();
 }
@@ -723,6 +1129,8 @@ absl::Status ZetaSqlLocalServiceImpl::PrepareImpl(
     const google::protobuf::Map<std::string, TableContent>& tables_contents,
     SharedStatePool<InternalStateT>& prepared_statements_pool,
     ResponseT* response) {
+  MaybeEvictIdlePreparedStatements();
+
   std::shared_ptr<RegisteredCatalogState> catalog_state;
   std::vector<const google::protobuf::DescriptorPool*> pools;
 
@@ -740,8 +1148,8 @@ absl::Status ZetaSqlLocalServiceImpl::PrepareImpl(
       descriptor_pool_states, owned_descriptor_pool_ids,
       *(response->mutable_prepared()->mutable_descriptor_pool_id_list())));
 
-  ZETASQL_RETURN_IF_ERROR(
-      GetCatalogState(request, tables_contents, pools, catalog_state));
+  ZETASQL_RETURN_IF_ERROR(GetCatalogState(request, tables_contents,
+                                  descriptor_pool_states, catalog_state));
 
   std::optional<int64_t> owned_catalog_id;
   auto catalog_cleanup = absl::MakeCleanup(absl::bind_front(
@@ -845,6 +1253,7 @@ absl::Status ZetaSqlLocalServiceImpl::Evaluate(const EvaluateRequest& request,
       return MakeSqlError() << "Prepared expression " << id << " unknown.";
     }
   } else {
+    MaybeEvictIdlePreparedStatements();
     ZETASQL_RETURN_IF_ERROR(GetDescriptorPools(request.descriptor_pool_list(),
                                        descriptor_pool_states, pools));
     ZETASQL_RETURN_IF_ERROR(RegisterNewDescriptorPools(
@@ -891,15 +1300,15 @@ absl::Status ZetaSqlLocalServiceImpl::EvaluateModify(
                       *prepared_modifies_, "modify", response);
 }
 
-template <typename RequestT, typename ResponseT, typename InternalStateT>
-absl::Status ZetaSqlLocalServiceImpl::EvaluateImpl(
+template <typename RequestT, typename ResponseStateT, typename InternalStateT>
+absl::Status ZetaSqlLocalServiceImpl::GetOrPrepareForEvaluate(
     const RequestT& request,
     const google::protobuf::Map<std::string, TableContent>& tables_contents,
     std::optional<int64_t>& prepared_statement_id_opt,
     SharedStatePool<InternalStateT>& prepared_statements_pool,
-    absl::string_view statement_type, ResponseT* response) {
-  std::shared_ptr<InternalStateT> internal_state;
-
+    absl::string_view statement_type,
+    std::shared_ptr<InternalStateT>& internal_state,
+    ResponseStateT* response_state) {
   std::vector<const google::protobuf::DescriptorPool*> pools;
   std::vector<std::shared_ptr<RegisteredDescriptorPoolState>>
       descriptor_pool_states;
@@ -930,8 +1339,8 @@ absl::Status ZetaSqlLocalServiceImpl::EvaluateImpl(
     ZETASQL_RETURN_IF_ERROR(GetDescriptorPools(request.descriptor_pool_list(),
                                        descriptor_pool_states, pools));
 
-    ZETASQL_RETURN_IF_ERROR(
-        GetCatalogState(request, tables_contents, pools, catalog_state));
+    ZETASQL_RETURN_IF_ERROR(GetCatalogState(request, tables_contents,
+                                    descriptor_pool_states, catalog_state));
 
     ZETASQL_RETURN_IF_ERROR(
         CreateAndPrepare(request.sql(), request.options(), catalog_state, pools,
@@ -940,27 +1349,42 @@ absl::Status ZetaSqlLocalServiceImpl::EvaluateImpl(
 
     ZETASQL_RETURN_IF_ERROR(RegisterPrepared(
         /*should_register_prepared=*/false, internal_state,
-        prepared_statements_pool, pools, response->mutable_prepared()));
+        prepared_statements_pool, pools, response_state));
   }
+  return absl::OkStatus();
+}
 
-  // When evaluating a prepared query or a prepared modify, the operation could
-  // return the Status as Unimplemented in case one of the tables being touched
-  // does not have its content set.
-  // Here we converting the Unimplemented error into Unimplemented
-  // which is more appropriate
-  absl::Status evaluate_status =
-      EvaluatePrepared(request, internal_state.get(), response);
-
+// When evaluating a prepared query or a prepared modify, the operation could
+// return the Status as Unimplemented in case one of the tables being touched
+// does not have its content set.
+// Here we converting the Unimplemented error into InvalidArgument
+// which is more appropriate
+static absl::Status ToEvaluateStatus(const absl::Status& evaluate_status) {
   if (evaluate_status.code() == absl::StatusCode::kUnimplemented) {
     return zetasql_base::InvalidArgumentErrorBuilder()
            << "One or more tables being queried do(es) not have"
            << " its/their content set. "
            << "[" << evaluate_status.message() << "]";
   }
-
   return evaluate_status;
 }
 
+template <typename RequestT, typename ResponseT, typename InternalStateT>
+absl::Status ZetaSqlLocalServiceImpl::EvaluateImpl(
+    const RequestT& request,
+    const google::protobuf::Map<std::string, TableContent>& tables_contents,
+    std::optional<int64_t>& prepared_statement_id_opt,
+    SharedStatePool<InternalStateT>& prepared_statements_pool,
+    absl::string_view statement_type, ResponseT* response) {
+  std::shared_ptr<InternalStateT> internal_state;
+  ZETASQL_RETURN_IF_ERROR(GetOrPrepareForEvaluate(
+      request, tables_contents, prepared_statement_id_opt,
+      prepared_statements_pool, statement_type, internal_state,
+      response->mutable_prepared()));
+  return ToEvaluateStatus(
+      EvaluatePrepared(request, internal_state.get(), response));
+}
+
 absl::Status ZetaSqlLocalServiceImpl::EvaluatePreparedExpression(
     const EvaluateRequest& request,
     InternalPreparedExpressionState* internal_state,
@@ -984,11 +1408,10 @@ absl::Status ZetaSqlLocalServiceImpl::EvaluatePreparedExpression(
   return absl::OkStatus();
 }
 
-template <>
-absl::Status ZetaSqlLocalServiceImpl::EvaluatePrepared(
-    const EvaluateQueryRequest& request,
-    InternalPreparedQueryState* internal_state,
-    EvaluateQueryResponse* response) {
+// Executes the query of <internal_state> with the parameters in <request>.
+static absl::StatusOr<std::unique_ptr<EvaluatorTableIterator>>
+ExecutePreparedQuery(const EvaluateQueryRequest& request,
+                     InternalPreparedQueryState* internal_state) {
   const AnalyzerOptions& analyzer_options =
       internal_state->GetAnalyzerOptions();
 
@@ -999,21 +1422,136 @@ absl::Status ZetaSqlLocalServiceImpl::EvaluatePrepared(
   PreparedQuery::QueryOptions options;
   options.parameters = std::move(params);
 
-  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<EvaluatorTableIterator> results_iterator,
-                   internal_state->GetQuery()->ExecuteAfterPrepare(options));
+  return internal_state->GetQuery()->ExecuteAfterPrepare(options);
+}
 
-  TableData* table_data = response->mutable_content()->mutable_table_data();
-  while (results_iterator->NextRow()) {
-    TableData::Row* row = table_data->add_row();
-    for (int i = 0; i < results_iterator->NumColumns(); i++) {
+// Appends the rows of a query result to a TableContent, in the format
+// requested by EvaluateQueryRequest.columnar_result.
+class QueryResultWriter {
+ public:
+  QueryResultWriter(const EvaluateQueryRequest& request,
+                    const EvaluatorTableIterator& results_iterator,
+                    TableContent* content) {
+    if (request.columnar_result()) {
+      std::vector<const Type*> column_types;
+      column_types.reserve(results_iterator.NumColumns());
+      for (int i = 0; i < results_iterator.NumColumns(); i++) {
+        column_types.push_back(results_iterator.GetColumnType(i));
+      }
+      columnar_writer_.emplace(std::move(column_types),
+                               content->mutable_columnar_table_data());
+    } else {
+      table_data_ = content->mutable_table_data();
+    }
+  }
+
+  // Appends the current row of <results_iterator>.
+  absl::Status AppendRow(const EvaluatorTableIterator& results_iterator) {
+    ++num_rows_;
+    if (columnar_writer_.has_value()) {
+      return columnar_writer_->AppendRow(results_iterator);
+    }
+    TableData::Row* row = table_data_->add_row();
+    for (int i = 0; i < results_iterator.NumColumns(); i++) {
       ValueProto* value = row->add_cell();
-      ZETASQL_RETURN_IF_ERROR(results_iterator->GetValue(i).Serialize(value));
+      ZETASQL_RETURN_IF_ERROR(results_iterator.GetValue(i).Serialize(value));
+    }
+    row_bytes_ += row->ByteSizeLong();
+    return absl::OkStatus();
+  }
+
+  // Removes the rows written so far.
+  void Clear() {
+    num_rows_ = 0;
+    if (columnar_writer_.has_value()) {
+      columnar_writer_->Clear();
+    } else {
+      table_data_->clear_row();
+      row_bytes_ = 0;
     }
   }
 
+  int64_t num_rows() const { return num_rows_; }
+
+  // The approximate serialized size of the rows written so far.
+  size_t ByteSize() const {
+    return columnar_writer_.has_value()
+               ? columnar_writer_->ApproximateByteSize()
+               : row_bytes_;
+  }
+
+ private:
+  TableData* table_data_ = nullptr;
+  std::optional<ColumnarTableDataWriter> columnar_writer_;
+  int64_t num_rows_ = 0;
+  size_t row_bytes_ = 0;
+};
+
+template <>
+absl::Status ZetaSqlLocalServiceImpl::EvaluatePrepared(
+    const EvaluateQueryRequest& request,
+    InternalPreparedQueryState* internal_state,
+    EvaluateQueryResponse* response) {
+  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<EvaluatorTableIterator> results_iterator,
+                   ExecutePreparedQuery(request, internal_state));
+
+  QueryResultWriter writer(request, *results_iterator,
+                           response->mutable_content());
+  while (results_iterator->NextRow()) {
+    ZETASQL_RETURN_IF_ERROR(writer.AppendRow(*results_iterator));
+  }
+
   return results_iterator->Status();
 }
 
+absl::Status ZetaSqlLocalServiceImpl::EvaluateQueryChunked(
+    const EvaluateQueryRequest& request,
+    absl::FunctionRef<absl::Status(const EvaluateQueryResponse&)>
+        emit_chunk) {
+  static constexpr int64_t kDefaultMaxChunkBytes = 1 << 20;
+  const int64_t max_chunk_bytes = request.max_chunk_bytes() > 0
+                                      ? request.max_chunk_bytes()
+                                      : kDefaultMaxChunkBytes;
+
+  std::optional<int64_t> prepared_query_id_opt =
+      request.has_prepared_query_id()
+          ? std::optional<int64_t>(request.prepared_query_id())
+          : std::nullopt;
+  EvaluateQueryResponse chunk;
+  std::shared_ptr<InternalPreparedQueryState> internal_state;
+  ZETASQL_RETURN_IF_ERROR(GetOrPrepareForEvaluate(
+      request, request.table_content(), prepared_query_id_opt,
+      *prepared_queries_, "query", internal_state, chunk.mutable_prepared()));
+
+  absl::StatusOr<std::unique_ptr<EvaluatorTableIterator>> results_iterator =
+      ExecutePreparedQuery(request, internal_state.get());
+  ZETASQL_RETURN_IF_ERROR(ToEvaluateStatus(results_iterator.status()));
+
+  // The rows are serialized straight into the chunk, which is reused after
+  // each emit so that only one chunk is in memory at a time.
+  QueryResultWriter writer(request, **results_iterator,
+                           chunk.mutable_content());
+  bool emitted = false;
+  while ((*results_iterator)->NextRow()) {
+    ZETASQL_RETURN_IF_ERROR(writer.AppendRow(**results_iterator));
+    if (writer.ByteSize() >= max_chunk_bytes) {
+      ZETASQL_RETURN_IF_ERROR(emit_chunk(chunk));
+      emitted = true;
+      chunk.clear_prepared();
+      writer.Clear();
+    }
+  }
+  ZETASQL_RETURN_IF_ERROR(ToEvaluateStatus((*results_iterator)->Status()));
+
+  // An empty result still gets one response. When the query was prepared by
+  // this request, that response carries the prepared state and with it the
+  // schema; with a prepared_query_id, the caller has it from PrepareQuery.
+  if (writer.num_rows() > 0 || !emitted) {
+    ZETASQL_RETURN_IF_ERROR(emit_chunk(chunk));
+  }
+  return absl::OkStatus();
+}
+
 template <>
 absl::Status ZetaSqlLocalServiceImpl::EvaluatePrepared(
     const EvaluateModifyRequest& request,
@@ -1112,7 +1650,7 @@ absl::Status ZetaSqlLocalServiceImpl::GetDescriptorPools(
     std::shared_ptr<RegisteredDescriptorPoolState> state;
     switch (definition.definition_case()) {
       case Definition::kFileDescriptorSet: {
-        ZETASQL_ASSIGN_OR_RETURN(state, RegisteredDescriptorPoolState::Create(
+        ZETASQL_ASSIGN_OR_RETURN(state, registered_descriptor_pools_->GetOrCreatePool(
                                     definition.file_descriptor_set()));
         break;
       }
@@ -1139,8 +1677,23 @@ absl::Status ZetaSqlLocalServiceImpl::GetDescriptorPools(
                 "definition type",
                 definition.DebugString()));
     }
-    descriptor_pool_states.push_back(state);
     ZETASQL_RET_CHECK_NE(state->pool(), nullptr);
+    // Types refer to their pool by its index in the list, so a list must not
+    // contain the same pool twice. Pools with the same descriptors are shared,
+    // whichever kind of definition they came from, so this gets a pool of its
+    // own.
+    if (std::find(descriptor_pools.begin(), descriptor_pools.end(),
+                  state->pool()) != descriptor_pools.end()) {
+      if (state->serialized_file_descriptor_set() == nullptr) {
+        return absl::Status(
+            absl::StatusCode::kInvalidArgument,
+            "Invalid DescriptorPoolList: the builtin pool is listed more than "
+            "once");
+      }
+      ZETASQL_ASSIGN_OR_RETURN(state,
+                       RegisteredDescriptorPoolPool::CreatePrivateCopy(*state));
+    }
+    descriptor_pool_states.push_back(state);
     descriptor_pools.push_back(state->pool());
   }
 
@@ -1151,7 +1704,8 @@ template <typename RequestProto>
 absl::Status ZetaSqlLocalServiceImpl::GetCatalogState(
     const RequestProto& request,
     const google::protobuf::Map<std::string, TableContent>& tables_contents,
-    const std::vector<const google::protobuf::DescriptorPool*>& pools,
+    const std::vector<std::shared_ptr<RegisteredDescriptorPoolState>>&
+        descriptor_pool_states,
     std::shared_ptr<RegisteredCatalogState>& state) {
   if (request.has_registered_catalog_id()) {
     // At the moment there is no support for updating the tables' contents
@@ -1168,7 +1722,8 @@ absl::Status ZetaSqlLocalServiceImpl::GetCatalogState(
   } else {
     ZETASQL_ASSIGN_OR_RETURN(state,
                      RegisteredCatalogState::Create(request.simple_catalog(),
-                                                    tables_contents, pools));
+                                                    tables_contents,
+                                                    descriptor_pool_states));
   }
   return absl::OkStatus();
 }
@@ -1182,7 +1737,8 @@ absl::Status ZetaSqlLocalServiceImpl::Analyze(const AnalyzeRequest& request,
 
   ZETASQL_RETURN_IF_ERROR(GetDescriptorPools(request.descriptor_pool_list(),
                                      descriptor_pool_states, pools));
-  ZETASQL_RETURN_IF_ERROR(GetCatalogState(request, {}, pools, catalog_state));
+  ZETASQL_RETURN_IF_ERROR(GetCatalogState(request, {}, descriptor_pool_states,
+                                          catalog_state));
   if (request.has_sql_expression()) {
     return AnalyzeExpressionImpl(request, pools, catalog_state->GetCatalog(),
                                  response);
@@ -1262,7 +1818,8 @@ absl::Status ZetaSqlLocalServiceImpl::BuildSql(const BuildSqlRequest& request,
 
   ZETASQL_RETURN_IF_ERROR(GetDescriptorPools(request.descriptor_pool_list(),
                                      descriptor_pool_states, pools));
-  ZETASQL_RETURN_IF_ERROR(GetCatalogState(request, {}, pools, catalog_state));
+  ZETASQL_RETURN_IF_ERROR(GetCatalogState(request, {}, descriptor_pool_states,
+                                          catalog_state));
   IdStringPool string_pool;
   ResolvedNode::RestoreParams restore_params(
       pools, catalog_state->GetCatalog(),
@@ -1434,8 +1991,8 @@ absl::Status ZetaSqlLocalServiceImpl::RegisterCatalog(
 
   ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<RegisteredCatalogState> state,
                    RegisteredCatalogState::Create(
-                       request.simple_catalog(), request.table_content(), pools,
-                       owned_descriptor_pool_ids));
+                       request.simple_catalog(), request.table_content(),
+                       descriptor_pool_states, owned_descriptor_pool_ids));
   int64_t id = registered_catalogs_->Register(std::move(state));
   ZETASQL_RET_CHECK_NE(-1, id) << "Failed to register catalog, this shouldn't happen.";
 
@@ -1447,6 +2004,45 @@ absl::Status ZetaSqlLocalServiceImpl::RegisterCatalog(
   return absl::OkStatus();
 }
 
+absl::Status ZetaSqlLocalServiceImpl::UpdateRegisteredCatalog(
+    const UpdateRegisteredCatalogRequest& request, RegisterResponse* response) {
+  const int64_t id = request.registered_catalog_id();
+  std::shared_ptr<RegisteredCatalogState> state = registered_catalogs_->Get(id);
+  if (state == nullptr) {
+    return MakeSqlError() << "Registered catalog " << id << " unknown.";
+  }
+
+  std::vector<std::shared_ptr<RegisteredDescriptorPoolState>>
+      descriptor_pool_states;
+  std::vector<const google::protobuf::DescriptorPool*> pools;
+  ZETASQL_RETURN_IF_ERROR(GetDescriptorPools(request.descriptor_pool_list(),
+                                     descriptor_pool_states, pools));
+
+  absl::flat_hash_set<int64_t> owned_descriptor_pool_ids;
+  // On error, make sure we don't leak any registered descriptor pools.
+  auto descriptor_pool_cleanup = absl::MakeCleanup(
+      absl::bind_front(&ZetaSqlLocalServiceImpl::CleanupDescriptorPools, this,
+                       &owned_descriptor_pool_ids));
+  ZETASQL_RETURN_IF_ERROR(RegisterNewDescriptorPools(
+      descriptor_pool_states, owned_descriptor_pool_ids,
+      *response->mutable_descriptor_pool_id_list()));
+
+  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<RegisteredCatalogState> updated_state,
+                   state->Update(request, descriptor_pool_states,
+                                 owned_descriptor_pool_ids));
+  if (!registered_catalogs_->Replace(id, state, std::move(updated_state))) {
+    return zetasql_base::AbortedErrorBuilder()
+           << "Registered catalog " << id
+           << " was updated or unregistered concurrently";
+  }
+
+  response->set_registered_id(id);
+  // No errors, the catalog now owns the new descriptor pools.
+  std::move(descriptor_pool_cleanup).Cancel();
+
+  return absl::OkStatus();
+}
+
 absl::Status ZetaSqlLocalServiceImpl::UnregisterCatalog(int64_t id) {
   std::shared_ptr<RegisteredCatalogState> state = registered_catalogs_->Get(id);
   if (state == nullptr) {
@@ -19,6 +19,7 @@
 
 #include <stddef.h>
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <optional>
@@ -35,7 +36,10 @@
 #include "zetasql/public/simple_catalog.h"
 #include "zetasql/public/simple_table.pb.h"
 #include <cstdint>
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
 #include "absl/strings/string_view.h"
+#include "absl/time/time.h"
 #include "zetasql/base/status.h"
 
 namespace zetasql {
@@ -55,6 +59,9 @@ class RegisteredDescriptorPoolState;
 // Implementation of ZetaSqlLocalService RPC service.
 class ZetaSqlLocalServiceImpl {
  public:
+  // Prepared statements that go unused for
+  // --zetasql_local_service_prepared_statement_idle_timeout are unprepared,
+  // if it is set.
   ZetaSqlLocalServiceImpl();
   ZetaSqlLocalServiceImpl(const ZetaSqlLocalServiceImpl&) = delete;
   ZetaSqlLocalServiceImpl& operator=(const ZetaSqlLocalServiceImpl&) =
@@ -77,6 +84,19 @@ class ZetaSqlLocalServiceImpl {
   absl::Status EvaluateQuery(const EvaluateQueryRequest& request,
                              EvaluateQueryResponse* response);
 
+  // Like EvaluateQuery(), but passes the result to <emit_chunk> as a series of
+  // responses that each hold about request.max_chunk_bytes() of rows. At
+  // least one response is emitted unless preparing the query fails. If the
+  // query is prepared by this request rather than given by prepared_query_id,
+  // only the first response sets prepared; otherwise none does. The next
+  // rows are only computed once <emit_chunk> returns, so a blocking
+  // <emit_chunk> throttles evaluation.
+  // If <emit_chunk> returns an error, evaluation stops with that error.
+  absl::Status EvaluateQueryChunked(
+      const EvaluateQueryRequest& request,
+      absl::FunctionRef<absl::Status(const EvaluateQueryResponse&)>
+          emit_chunk);
+
   absl::Status PrepareModify(const PrepareModifyRequest& request,
                              PrepareModifyResponse* response);
 
@@ -136,6 +156,10 @@ class ZetaSqlLocalServiceImpl {
   absl::Status RegisterCatalog(const RegisterCatalogRequest& request,
                                RegisterResponse* response);
 
+  absl::Status UpdateRegisteredCatalog(
+      const UpdateRegisteredCatalogRequest& request,
+      RegisterResponse* response);
+
   absl::Status UnregisterCatalog(int64_t id);
 
   absl::Status GetLanguageOptions(const LanguageOptionsRequest& request,
@@ -154,6 +178,14 @@ class ZetaSqlLocalServiceImpl {
                                ParseResponse* response,
                                ParserOptions& parser_options);
 
+  // Unprepares the prepared expressions, queries and modifies that have not
+  // been used since the previous call, and returns how many there were.
+  size_t EvictIdlePreparedStatements();
+
+  // Approximate number of bytes used by the registered catalogs and prepared
+  // statements.
+  int64_t ApproximateMemoryUsage() const;
+
  private:
   // Fetches the descriptor pools for the given descriptor_pool_list.
   // descriptor_pools is a view into pool_states_out, and is returned as a
@@ -181,7 +213,8 @@ class ZetaSqlLocalServiceImpl {
   absl::Status GetCatalogState(
       const RequestProto& request,
       const google::protobuf::Map<std::string, TableContent>& tables_contents,
-      const std::vector<const google::protobuf::DescriptorPool*>& pools,
+      const std::vector<std::shared_ptr<RegisteredDescriptorPoolState>>&
+          descriptor_pool_states,
       std::shared_ptr<RegisteredCatalogState>& state);
 
   std::unique_ptr<RegisteredDescriptorPoolPool> registered_descriptor_pools_;
@@ -190,6 +223,10 @@ class ZetaSqlLocalServiceImpl {
   std::unique_ptr<PreparedQueryPool> prepared_queries_;
   std::unique_ptr<PreparedModifyPool> prepared_modifies_;
 
+  const absl::Duration prepared_statement_idle_timeout_;
+  // When MaybeEvictIdlePreparedStatements() should evict next, in unix nanos.
+  std::atomic<int64_t> next_idle_eviction_nanos_;
+
   template <typename InternalStateT>
   absl::Status CreateAndPrepare(
       const std::string& sql, const AnalyzerOptionsProto& options,
@@ -214,11 +251,33 @@ class ZetaSqlLocalServiceImpl {
       SharedStatePool<InternalStateT>& prepared_statements_pool,
       ResponseT* response);
 
+  // Calls EvictIdlePreparedStatements() if the idle timeout passed since the
+  // previous call.
+  void MaybeEvictIdlePreparedStatements();
+
+  template <typename InternalStateT>
+  size_t EvictIdleStates(SharedStatePool<InternalStateT>& pool);
+
   template <typename InternalStateT>
   absl::Status UnprepareImpl(
       SharedStatePool<InternalStateT>& prepared_statements_pool, int64_t id,
       absl::string_view statement_type);
 
+  // Looks up the prepared statement with id <prepared_statement_id_opt> or,
+  // if it has no value, prepares the statement in <request> into
+  // <internal_state> without registering it and describes it in
+  // <response_state>.
+  template <typename RequestT, typename ResponseStateT,
+            typename InternalStateT>
+  absl::Status GetOrPrepareForEvaluate(
+      const RequestT& request,
+      const google::protobuf::Map<std::string, TableContent>& tables_contents,
+      std::optional<int64_t>& prepared_statement_id_opt,
+      SharedStatePool<InternalStateT>& prepared_statements_pool,
+      absl::string_view statement_type,
+      std::shared_ptr<InternalStateT>& internal_state,
+      ResponseStateT* response_state);
+
   template <typename RequestT, typename ResponseT, typename InternalStateT>
   absl::Status EvaluateImpl(
       const RequestT& request,
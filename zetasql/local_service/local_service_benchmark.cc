@@ -14,16 +14,41 @@
 // limitations under the License.
 //
 
+// Benchmarks for the local service RPCs. The SQL-level benchmarks run over
+// the query corpus in testdata/benchmark_queries.sql, against the Orders and
+// Customers tables defined below.
+
 #include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
 
 #include "zetasql/base/logging.h"
+#include "zetasql/base/path.h"
 #include "zetasql/base/testing/status_matchers.h"
+#include "zetasql/base/file_util.h"
+#include "zetasql/local_service/columnar_table_data.h"
 #include "zetasql/local_service/local_service.h"
 #include "zetasql/local_service/local_service.pb.h"
+#include "zetasql/proto/options.pb.h"
+#include "zetasql/proto/simple_catalog.pb.h"
+#include "zetasql/public/language_options.h"
+#include "zetasql/public/simple_table.pb.h"
+#include "zetasql/public/type.h"
+#include "zetasql/public/type.pb.h"
+#include "zetasql/public/value.h"
 #include "benchmark/benchmark.h"
 #include "gtest/gtest.h"
+#include "absl/base/const_init.h"
 #include "absl/base/internal/sysinfo.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "zetasql/base/status.h"
 
 namespace zetasql {
@@ -32,6 +57,145 @@ using ::absl::base_internal::NumCPUs;
 
 namespace local_service {
 
+namespace {
+
+constexpr int kNumCustomers = 100;
+constexpr const char* kStatuses[] = {"open", "shipped", "delivered",
+                                     "cancelled"};
+
+// Returns the queries in testdata/benchmark_queries.sql.
+const std::vector<std::string>& GetQueryCorpus() {
+  static const std::vector<std::string>* queries = [] {
+    std::string contents;
+    ZETASQL_CHECK_OK(internal::GetContents(
+        zetasql_base::JoinPath(getenv("TEST_SRCDIR"),
+                       "com_google_zetasql/zetasql/local_service/testdata/"
+                       "benchmark_queries.sql"),
+        &contents));
+    std::string text;
+    for (absl::string_view line : absl::StrSplit(contents, '\n')) {
+      if (!absl::StartsWith(line, "#")) {
+        absl::StrAppend(&text, line, "\n");
+      }
+    }
+    auto* queries = new std::vector<std::string>();
+    for (absl::string_view query : absl::StrSplit(text, ";\n")) {
+      query = absl::StripAsciiWhitespace(query);
+      if (!query.empty()) {
+        queries->emplace_back(query);
+      }
+    }
+    ABSL_CHECK(!queries->empty());
+    return queries;
+  }();
+  return *queries;
+}
+
+AnalyzerOptionsProto MaximumFeaturesAnalyzerOptions() {
+  LanguageOptions language_options;
+  language_options.EnableMaximumLanguageFeatures();
+  AnalyzerOptionsProto options;
+  language_options.Serialize(options.mutable_language_options());
+  return options;
+}
+
+void AddColumn(const std::string& name, TypeKind kind,
+               SimpleTableProto* table) {
+  SimpleColumnProto* column = table->add_column();
+  column->set_name(name);
+  column->mutable_type()->set_type_kind(kind);
+}
+
+// Returns a catalog with the builtin functions and the Orders and Customers
+// tables.
+SimpleCatalogProto MakeCatalog() {
+  SimpleCatalogProto catalog;
+  LanguageOptions language_options;
+  language_options.EnableMaximumLanguageFeatures();
+  language_options.Serialize(
+      catalog.mutable_builtin_function_options()->mutable_language_options());
+
+  SimpleTableProto* orders = catalog.add_table();
+  orders->set_name("Orders");
+  AddColumn("order_id", TYPE_INT64, orders);
+  AddColumn("customer", TYPE_STRING, orders);
+  AddColumn("amount", TYPE_DOUBLE, orders);
+  AddColumn("quantity", TYPE_INT64, orders);
+  AddColumn("status", TYPE_STRING, orders);
+
+  SimpleTableProto* customers = catalog.add_table();
+  customers->set_name("Customers");
+  AddColumn("name", TYPE_STRING, customers);
+  AddColumn("region", TYPE_STRING, customers);
+  return catalog;
+}
+
+std::vector<Value> MakeOrder(int64_t i) {
+  return {Value::Int64(i),
+          Value::String(absl::StrCat("customer", i % kNumCustomers)),
+          Value::Double((i % 1000) / 4.0), Value::Int64(i % 7),
+          Value::String(kStatuses[i % 4])};
+}
+
+// Sets the content of the Orders and Customers tables, with <num_orders>
+// orders, using the columnar encoding if <columnar> is true.
+void InsertTableContents(
+    int num_orders, bool columnar,
+    google::protobuf::Map<std::string, TableContent>* tables_contents) {
+  TableContent& orders = (*tables_contents)["Orders"];
+  if (columnar) {
+    ColumnarTableDataWriter writer(
+        {types::Int64Type(), types::StringType(), types::DoubleType(),
+         types::Int64Type(), types::StringType()},
+        orders.mutable_columnar_table_data());
+    for (int i = 0; i < num_orders; ++i) {
+      ZETASQL_CHECK_OK(writer.AppendRow(MakeOrder(i)));
+    }
+  } else {
+    TableData* table_data = orders.mutable_table_data();
+    for (int i = 0; i < num_orders; ++i) {
+      TableData::Row* row = table_data->add_row();
+      for (const Value& value : MakeOrder(i)) {
+        ZETASQL_CHECK_OK(value.Serialize(row->add_cell()));
+      }
+    }
+  }
+
+  TableData* customers = (*tables_contents)["Customers"].mutable_table_data();
+  for (int i = 0; i < kNumCustomers; ++i) {
+    TableData::Row* row = customers->add_row();
+    row->add_cell()->set_string_value(absl::StrCat("customer", i));
+    row->add_cell()->set_string_value(absl::StrCat("region", i % 5));
+  }
+}
+
+ZetaSqlLocalServiceImpl* GetService() {
+  static ZetaSqlLocalServiceImpl* service = new ZetaSqlLocalServiceImpl();
+  return service;
+}
+
+// Returns the id of a registered catalog whose Orders table has <num_orders>
+// rows. Catalogs are registered once per size and shared by all threads.
+int64_t GetRegisteredCatalog(int num_orders) {
+  static absl::Mutex mutex(absl::kConstInit);
+  static auto* catalog_ids = new absl::flat_hash_map<int, int64_t>();
+  absl::MutexLock lock(&mutex);
+  auto it = catalog_ids->find(num_orders);
+  if (it != catalog_ids->end()) {
+    return it->second;
+  }
+  RegisterCatalogRequest request;
+  *request.mutable_simple_catalog() = MakeCatalog();
+  InsertTableContents(num_orders, /*columnar=*/false,
+                      request.mutable_table_content());
+  RegisterResponse response;
+  ZETASQL_CHECK_OK(GetService()->RegisterCatalog(request, &response));
+  catalog_ids->emplace(num_orders, response.registered_id());
+  return response.registered_id();
+}
+
+}  // namespace
+
 static void BM_EvaluatePrepared(::benchmark::State& state) {
   static ZetaSqlLocalServiceImpl* service = new ZetaSqlLocalServiceImpl();
   // use static initialization to share the prepared expression across threads
@@ -54,5 +218,175 @@ static void BM_EvaluatePrepared(::benchmark::State& state) {
 }
 BENCHMARK(BM_EvaluatePrepared)->ThreadRange(1, NumCPUs());
 
+// Returns a wide numeric result, with row encoding if <columnar> is 0 and
+// columnar encoding otherwise.
+static void BM_EvaluateQueryWideNumericResult(::benchmark::State& state) {
+  static ZetaSqlLocalServiceImpl* service = new ZetaSqlLocalServiceImpl();
+  std::string sql = "SELECT ";
+  for (int i = 0; i < 16; ++i) {
+    absl::StrAppend(&sql, i == 0 ? "" : ", ", "x * ", i, " AS i", i, ", x / ",
+                    i + 1, " AS d", i);
+  }
+  absl::StrAppend(&sql, " FROM UNNEST(GENERATE_ARRAY(1, 10000)) AS x");
+
+  EvaluateQueryRequest request;
+  request.set_sql(sql);
+  request.set_columnar_result(state.range(0) != 0);
+
+  int64_t bytes = 0;
+  for (auto s : state) {
+    // EvaluateQuery() appends to the response, so each call needs its own.
+    EvaluateQueryResponse response;
+    ZETASQL_ASSERT_OK(service->EvaluateQuery(request, &response));
+    bytes += response.content().ByteSizeLong();
+  }
+  state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_EvaluateQueryWideNumericResult)->Arg(0)->Arg(1);
+
+// Parses every query in the corpus.
+static void BM_ParseCorpus(::benchmark::State& state) {
+  const std::vector<std::string>& queries = GetQueryCorpus();
+  ParseRequest request;
+  *request.mutable_options() =
+      MaximumFeaturesAnalyzerOptions().language_options();
+  ParseResponse response;
+  for (auto s : state) {
+    for (const std::string& query : queries) {
+      request.set_sql_statement(query);
+      ZETASQL_ASSERT_OK(GetService()->Parse(request, &response));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+BENCHMARK(BM_ParseCorpus)->ThreadRange(1, NumCPUs());
+
+// Formats every query in the corpus.
+static void BM_FormatSqlCorpus(::benchmark::State& state) {
+  const std::vector<std::string>& queries = GetQueryCorpus();
+  FormatSqlRequest request;
+  FormatSqlResponse response;
+  for (auto s : state) {
+    for (const std::string& query : queries) {
+      request.set_sql(query);
+      ZETASQL_ASSERT_OK(GetService()->FormatSql(request, &response));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+BENCHMARK(BM_FormatSqlCorpus)->ThreadRange(1, NumCPUs());
+
+// Analyzes every query in the corpus against a registered catalog.
+static void BM_AnalyzeCorpus(::benchmark::State& state) {
+  const std::vector<std::string>& queries = GetQueryCorpus();
+  AnalyzeRequest request;
+  *request.mutable_options() = MaximumFeaturesAnalyzerOptions();
+  request.set_registered_catalog_id(GetRegisteredCatalog(/*num_orders=*/0));
+  AnalyzeResponse response;
+  for (auto s : state) {
+    for (const std::string& query : queries) {
+      request.set_sql_statement(query);
+      ZETASQL_ASSERT_OK(GetService()->Analyze(request, &response));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+BENCHMARK(BM_AnalyzeCorpus)->ThreadRange(1, NumCPUs());
+
+// Prepares and unprepares every query in the corpus against a registered
+// catalog.
+static void BM_PrepareQueryCorpus(::benchmark::State& state) {
+  const std::vector<std::string>& queries = GetQueryCorpus();
+  PrepareQueryRequest request;
+  *request.mutable_options() = MaximumFeaturesAnalyzerOptions();
+  request.set_registered_catalog_id(GetRegisteredCatalog(/*num_orders=*/0));
+  PrepareQueryResponse response;
+  for (auto s : state) {
+    for (const std::string& query : queries) {
+      request.set_sql(query);
+      ZETASQL_ASSERT_OK(GetService()->PrepareQuery(request, &response));
+      ZETASQL_ASSERT_OK(
+          GetService()->UnprepareQuery(response.prepared().prepared_query_id()));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+BENCHMARK(BM_PrepareQueryCorpus)->ThreadRange(1, NumCPUs());
+
+// Evaluates every query in the corpus, prepared once up front, against a
+// registered catalog with state.range(0) orders.
+static void BM_EvaluatePreparedQueryCorpus(::benchmark::State& state) {
+  const std::vector<std::string>& queries = GetQueryCorpus();
+  const int64_t catalog_id = GetRegisteredCatalog(state.range(0));
+
+  std::vector<EvaluateQueryRequest> requests;
+  for (const std::string& query : queries) {
+    PrepareQueryRequest prepare_request;
+    prepare_request.set_sql(query);
+    *prepare_request.mutable_options() = MaximumFeaturesAnalyzerOptions();
+    prepare_request.set_registered_catalog_id(catalog_id);
+    PrepareQueryResponse prepare_response;
+    ZETASQL_ASSERT_OK(GetService()->PrepareQuery(prepare_request, &prepare_response));
+    requests.emplace_back().set_prepared_query_id(
+        prepare_response.prepared().prepared_query_id());
+  }
+
+  int64_t bytes = 0;
+  for (auto s : state) {
+    for (const EvaluateQueryRequest& request : requests) {
+      // EvaluateQuery() appends to the response, so each call needs its own.
+      EvaluateQueryResponse response;
+      ZETASQL_ASSERT_OK(GetService()->EvaluateQuery(request, &response));
+      bytes += response.content().ByteSizeLong();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+  state.SetBytesProcessed(bytes);
+
+  for (const EvaluateQueryRequest& request : requests) {
+    ZETASQL_ASSERT_OK(GetService()->UnprepareQuery(request.prepared_query_id()));
+  }
+}
+BENCHMARK(BM_EvaluatePreparedQueryCorpus)
+    ->Arg(10)
+    ->Arg(1000)
+    ->ThreadRange(1, NumCPUs());
+
+// Evaluates a query over state.range(0) orders sent as table_content with an
+// inline catalog, which measures ingesting the table content. The content
+// uses the columnar encoding if state.range(1) is 1.
+static void BM_EvaluateQueryTableContent(::benchmark::State& state) {
+  EvaluateQueryRequest request;
+  request.set_sql("SELECT COUNT(*), SUM(amount) FROM Orders");
+  *request.mutable_simple_catalog() = MakeCatalog();
+  InsertTableContents(state.range(0), state.range(1) != 0,
+                      request.mutable_table_content());
+
+  for (auto s : state) {
+    EvaluateQueryResponse response;
+    ZETASQL_ASSERT_OK(GetService()->EvaluateQuery(request, &response));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(state.iterations() * request.ByteSizeLong());
+}
+BENCHMARK(BM_EvaluateQueryTableContent)
+    ->ArgsProduct({{100, 10000, 100000}, {0, 1}});
+
+// Registers and unregisters a catalog with state.range(0) orders.
+static void BM_RegisterCatalog(::benchmark::State& state) {
+  RegisterCatalogRequest request;
+  *request.mutable_simple_catalog() = MakeCatalog();
+  InsertTableContents(state.range(0), /*columnar=*/true,
+                      request.mutable_table_content());
+
+  RegisterResponse response;
+  for (auto s : state) {
+    ZETASQL_ASSERT_OK(GetService()->RegisterCatalog(request, &response));
+    ZETASQL_ASSERT_OK(GetService()->UnregisterCatalog(response.registered_id()));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_RegisterCatalog)->Arg(0)->Arg(10000);
+
 }  // namespace local_service
 }  // namespace zetasql
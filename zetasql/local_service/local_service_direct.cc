@@ -0,0 +1,129 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/local_service/local_service_direct.h"
+
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "google/protobuf/empty.pb.h"
+#include "google/protobuf/message_lite.h"
+#include "zetasql/local_service/local_service.grpc.pb.h"
+#include "zetasql/local_service/local_service.pb.h"
+#include "zetasql/local_service/local_service_grpc.h"
+#include "zetasql/proto/options.pb.h"
+#include "zetasql/public/simple_table.pb.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+
+namespace zetasql {
+namespace local_service {
+
+namespace {
+
+template <typename RequestT, typename ResponseT>
+DirectCallDispatcher::Method MakeMethod(
+    absl::string_view name,
+    grpc::Status (ZetaSqlLocalServiceGrpcImpl::*rpc)(grpc::ServerContext*,
+                                                       const RequestT*,
+                                                       ResponseT*)) {
+  return {
+      absl::StrCat(ZetaSqlLocalService::service_full_name(), "/", name),
+      [rpc](ZetaSqlLocalServiceGrpcImpl* service,
+            absl::string_view serialized_request,
+            std::unique_ptr<google::protobuf::MessageLite>* response) {
+        RequestT request;
+        if (serialized_request.size() > std::numeric_limits<int>::max() ||
+            !request.ParseFromArray(
+                serialized_request.data(),
+                static_cast<int>(serialized_request.size()))) {
+          return grpc::Status(grpc::INVALID_ARGUMENT,
+                              "Failed to parse the request");
+        }
+        auto typed_response = std::make_unique<ResponseT>();
+        // The unary RPCs do not use the server context.
+        grpc::Status status = (service->*rpc)(
+            /*context=*/nullptr, &request, typed_response.get());
+        if (status.ok()) {
+          *response = std::move(typed_response);
+        }
+        return status;
+      }};
+}
+
+// The unary RPCs of ZetaSqlLocalService. The streaming RPCs are only served
+// through gRPC.
+std::vector<DirectCallDispatcher::Method> UnaryMethods() {
+  using Impl = ZetaSqlLocalServiceGrpcImpl;
+  return {
+      MakeMethod("Prepare", &Impl::Prepare),
+      MakeMethod("Evaluate", &Impl::Evaluate),
+      MakeMethod("Unprepare", &Impl::Unprepare),
+      MakeMethod("PrepareQuery", &Impl::PrepareQuery),
+      MakeMethod("UnprepareQuery", &Impl::UnprepareQuery),
+      MakeMethod("EvaluateQuery", &Impl::EvaluateQuery),
+      MakeMethod("PrepareModify", &Impl::PrepareModify),
+      MakeMethod("UnprepareModify", &Impl::UnprepareModify),
+      MakeMethod("EvaluateModify", &Impl::EvaluateModify),
+      MakeMethod("GetTableFromProto", &Impl::GetTableFromProto),
+      MakeMethod("RegisterCatalog", &Impl::RegisterCatalog),
+      MakeMethod("UpdateRegisteredCatalog", &Impl::UpdateRegisteredCatalog),
+      MakeMethod("Analyze", &Impl::Analyze),
+      MakeMethod("BuildSql", &Impl::BuildSql),
+      MakeMethod("ExtractTableNamesFromStatement",
+                 &Impl::ExtractTableNamesFromStatement),
+      MakeMethod("ExtractTableNamesFromNextStatement",
+                 &Impl::ExtractTableNamesFromNextStatement),
+      MakeMethod("FormatSql", &Impl::FormatSql),
+      MakeMethod("LenientFormatSql", &Impl::LenientFormatSql),
+      MakeMethod("UnregisterCatalog", &Impl::UnregisterCatalog),
+      MakeMethod("GetBuiltinFunctions", &Impl::GetBuiltinFunctions),
+      MakeMethod("GetLanguageOptions", &Impl::GetLanguageOptions),
+      MakeMethod("GetAnalyzerOptions", &Impl::GetAnalyzerOptions),
+      MakeMethod("Parse", &Impl::Parse),
+  };
+}
+
+}  // namespace
+
+DirectCallDispatcher::DirectCallDispatcher(
+    ZetaSqlLocalServiceGrpcImpl* service)
+    : service_(service), methods_(UnaryMethods()) {}
+
+int DirectCallDispatcher::FindMethod(
+    absl::string_view full_method_name) const {
+  for (int i = 0; i < methods_.size(); ++i) {
+    if (methods_[i].full_name == full_method_name) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+grpc::Status DirectCallDispatcher::Call(
+    int method_id, absl::string_view serialized_request,
+    std::unique_ptr<google::protobuf::MessageLite>* response) const {
+  if (method_id < 0 || method_id >= methods_.size()) {
+    return grpc::Status(grpc::UNIMPLEMENTED,
+                        absl::StrCat("Unknown method id: ", method_id));
+  }
+  return methods_[method_id].rpc(service_, serialized_request, response);
+}
+
+}  // namespace local_service
+}  // namespace zetasql
@@ -0,0 +1,74 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef ZETASQL_LOCAL_SERVICE_LOCAL_SERVICE_DIRECT_H_
+#define ZETASQL_LOCAL_SERVICE_LOCAL_SERVICE_DIRECT_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "google/protobuf/message_lite.h"
+#include "zetasql/local_service/local_service_grpc.h"
+#include "absl/strings/string_view.h"
+
+namespace zetasql {
+namespace local_service {
+
+// Calls the unary RPCs of a ZetaSqlLocalServiceGrpcImpl on serialized
+// requests, without going through a gRPC channel. The JNI channel uses this
+// to serve unary calls from buffers it shares with the JVM, with the same
+// request and response messages as the gRPC service.
+class DirectCallDispatcher {
+ public:
+  // <service> must outlive the dispatcher.
+  explicit DirectCallDispatcher(ZetaSqlLocalServiceGrpcImpl* service);
+  DirectCallDispatcher(const DirectCallDispatcher&) = delete;
+  DirectCallDispatcher& operator=(const DirectCallDispatcher&) = delete;
+
+  // Returns the id of the unary RPC named <full_method_name>, e.g.
+  // "zetasql.local_service.ZetaSqlLocalService/Evaluate", or -1 if there is
+  // no such unary RPC.
+  int FindMethod(absl::string_view full_method_name) const;
+
+  // Calls the RPC with id <method_id> on <serialized_request>. On success,
+  // sets <response> to the response message.
+  grpc::Status Call(
+      int method_id, absl::string_view serialized_request,
+      std::unique_ptr<google::protobuf::MessageLite>* response) const;
+
+  // Signature of the wrappers around the RPCs of the service.
+  using Rpc = std::function<grpc::Status(
+      ZetaSqlLocalServiceGrpcImpl* service,
+      absl::string_view serialized_request,
+      std::unique_ptr<google::protobuf::MessageLite>* response)>;
+
+  struct Method {
+    std::string full_name;
+    Rpc rpc;
+  };
+
+ private:
+  ZetaSqlLocalServiceGrpcImpl* service_;
+  // Indexed by method id.
+  const std::vector<Method> methods_;
+};
+
+}  // namespace local_service
+}  // namespace zetasql
+
+#endif  // ZETASQL_LOCAL_SERVICE_LOCAL_SERVICE_DIRECT_H_
@@ -0,0 +1,113 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/local_service/local_service_direct.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "google/protobuf/empty.pb.h"
+#include "google/protobuf/message_lite.h"
+#include "zetasql/local_service/local_service.pb.h"
+#include "zetasql/local_service/local_service_grpc.h"
+#include "zetasql/public/type.pb.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace zetasql::local_service {
+
+namespace {
+
+constexpr char kServiceName[] = "zetasql.local_service.ZetaSqlLocalService/";
+
+class DirectCallDispatcherTest : public testing::Test {
+ protected:
+  grpc::Status Evaluate(const EvaluateRequest& request,
+                        EvaluateResponse* response) {
+    const int method_id =
+        dispatcher_.FindMethod(std::string(kServiceName) + "Evaluate");
+    std::unique_ptr<google::protobuf::MessageLite> result;
+    grpc::Status status = dispatcher_.Call(
+        method_id, request.SerializeAsString(), &result);
+    if (status.ok()) {
+      response->CheckTypeAndMergeFrom(*result);
+    }
+    return status;
+  }
+
+  ZetaSqlLocalServiceGrpcImpl service_;
+  DirectCallDispatcher dispatcher_{&service_};
+};
+
+TEST_F(DirectCallDispatcherTest, FindMethod) {
+  EXPECT_GE(dispatcher_.FindMethod(std::string(kServiceName) + "Evaluate"), 0);
+  EXPECT_GE(dispatcher_.FindMethod(std::string(kServiceName) + "Parse"), 0);
+  EXPECT_NE(dispatcher_.FindMethod(std::string(kServiceName) + "Evaluate"),
+            dispatcher_.FindMethod(std::string(kServiceName) + "Parse"));
+
+  // Streaming RPCs are not served directly.
+  EXPECT_EQ(
+      dispatcher_.FindMethod(std::string(kServiceName) + "EvaluateStream"),
+      -1);
+  EXPECT_EQ(dispatcher_.FindMethod(std::string(kServiceName) +
+                                   "EvaluateQueryChunked"),
+            -1);
+  EXPECT_EQ(dispatcher_.FindMethod("Evaluate"), -1);
+}
+
+TEST_F(DirectCallDispatcherTest, Evaluate) {
+  EvaluateRequest request;
+  request.set_sql("1 + 1");
+  EvaluateResponse response;
+  ASSERT_TRUE(Evaluate(request, &response).ok());
+  EXPECT_EQ(response.prepared().output_type().type_kind(), TYPE_INT64);
+  EXPECT_EQ(response.value().int64_value(), 2);
+
+  // The prepared expression is registered with the service.
+  const int64_t id = response.prepared().prepared_expression_id();
+  EvaluateRequest prepared_request;
+  prepared_request.set_prepared_expression_id(id);
+  response.Clear();
+  ASSERT_TRUE(Evaluate(prepared_request, &response).ok());
+  EXPECT_EQ(response.value().int64_value(), 2);
+
+  UnprepareRequest unprepare_request;
+  unprepare_request.set_prepared_expression_id(id);
+  google::protobuf::Empty unused;
+  EXPECT_TRUE(service_.Unprepare(nullptr, &unprepare_request, &unused).ok());
+}
+
+TEST_F(DirectCallDispatcherTest, Errors) {
+  EvaluateRequest request;
+  request.set_sql("foo");
+  EvaluateResponse response;
+  EXPECT_EQ(Evaluate(request, &response).error_code(),
+            grpc::INVALID_ARGUMENT);
+
+  std::unique_ptr<google::protobuf::MessageLite> result;
+  const int method_id =
+      dispatcher_.FindMethod(std::string(kServiceName) + "Evaluate");
+  EXPECT_EQ(dispatcher_.Call(method_id, "\xff\xff", &result).error_code(),
+            grpc::INVALID_ARGUMENT);
+  EXPECT_EQ(dispatcher_.Call(-1, "", &result).error_code(),
+            grpc::UNIMPLEMENTED);
+  EXPECT_EQ(result, nullptr);
+}
+
+}  // namespace
+
+}  // namespace zetasql::local_service
@@ -16,8 +16,30 @@
 
 #include "zetasql/local_service/local_service_grpc.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+
+#include "google/protobuf/io/coded_stream.h"
+#include "absl/flags/flag.h"
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
 #include "zetasql/base/status.h"
 
+ABSL_FLAG(int32_t, zetasql_local_service_batch_evaluation_threads, 0,
+          "Number of threads used to evaluate the requests of a batch sent "
+          "to EvaluateStream, EvaluateQueryStream or EvaluateModifyStream, "
+          "including the thread serving the stream. 0 means the number of "
+          "cores.");
+
 namespace zetasql {
 namespace local_service {
 
@@ -82,6 +104,183 @@ grpc::Status ToGrpcStatus(absl::Status status) {
 
 }  // namespace
 
+// A fixed set of threads that help with ParallelFor() loops. The calling
+// thread also works on its own loop, so loops never wait for a busy pool to
+// start or finish them.
+class ZetaSqlLocalServiceGrpcImpl::WorkerPool {
+ public:
+  explicit WorkerPool(int num_threads) {
+    threads_.reserve(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+      threads_.emplace_back([this] { Work(); });
+    }
+  }
+
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  ~WorkerPool() {
+    {
+      absl::MutexLock lock(&mutex_);
+      done_ = true;
+    }
+    for (std::thread& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  // Calls <fn>(i) for each i in [0, <n>), in parallel, and returns once all
+  // calls have returned.
+  //
+  // Only waits for helpers that started before the calling thread ran out of
+  // work. Helpers still queued behind other loops then have nothing left to
+  // do, and return without calling <fn> when they start.
+  void ParallelFor(int n, absl::FunctionRef<void(int)> fn) {
+    // Shared with the queued helpers, which can outlive this call.
+    auto loop = std::make_shared<Loop>(n, fn);
+    const int num_helpers =
+        std::min(static_cast<int>(threads_.size()), n - 1);
+    {
+      absl::MutexLock lock(&mutex_);
+      for (int i = 0; i < num_helpers; ++i) {
+        tasks_.push_back([loop] {
+          {
+            absl::MutexLock lock(&loop->mutex);
+            if (loop->finished) {
+              return;
+            }
+            ++loop->num_running_helpers;
+          }
+          loop->Run();
+          absl::MutexLock lock(&loop->mutex);
+          --loop->num_running_helpers;
+        });
+      }
+    }
+    loop->Run();
+
+    // Every index has been claimed, so only the helpers that are running
+    // can still be calling <fn>.
+    absl::MutexLock lock(&loop->mutex);
+    loop->finished = true;
+    loop->mutex.Await(absl::Condition(
+        +[](Loop* loop) ABSL_EXCLUSIVE_LOCKS_REQUIRED(loop->mutex) {
+          return loop->num_running_helpers == 0;
+        },
+        loop.get()));
+  }
+
+ private:
+  // The state of one ParallelFor() loop.
+  struct Loop {
+    Loop(int n, absl::FunctionRef<void(int)> fn) : n(n), fn(fn) {}
+
+    // Calls <fn> for indexes until all of them have been claimed.
+    void Run() {
+      for (int i = next_index++; i < n; i = next_index++) {
+        fn(i);
+      }
+    }
+
+    const int n;
+    // Only called while the ParallelFor() call is waiting for this loop.
+    const absl::FunctionRef<void(int)> fn;
+    std::atomic<int> next_index = 0;
+
+    absl::Mutex mutex;
+    // Set once the calling thread has run out of work. Helpers that start
+    // after that return right away.
+    bool finished ABSL_GUARDED_BY(mutex) = false;
+    int num_running_helpers ABSL_GUARDED_BY(mutex) = 0;
+  };
+
+  void Work() {
+    while (true) {
+      std::function<void()> task;
+      {
+        absl::MutexLock lock(&mutex_);
+        mutex_.Await(absl::Condition(
+            +[](WorkerPool* pool) ABSL_EXCLUSIVE_LOCKS_REQUIRED(pool->mutex_) {
+              return pool->done_ || !pool->tasks_.empty();
+            },
+            this));
+        if (tasks_.empty()) {
+          return;
+        }
+        task = std::move(tasks_.front());
+        tasks_.pop_front();
+      }
+      task();
+    }
+  }
+
+  absl::Mutex mutex_;
+  bool done_ ABSL_GUARDED_BY(mutex_) = false;
+  std::deque<std::function<void()>> tasks_ ABSL_GUARDED_BY(mutex_);
+  std::vector<std::thread> threads_;
+};
+
+ZetaSqlLocalServiceGrpcImpl::ZetaSqlLocalServiceGrpcImpl()
+    : ZetaSqlLocalServiceGrpcImpl(
+          absl::GetFlag(FLAGS_zetasql_local_service_batch_evaluation_threads)) {
+}
+
+ZetaSqlLocalServiceGrpcImpl::ZetaSqlLocalServiceGrpcImpl(
+    int batch_evaluation_threads) {
+  if (batch_evaluation_threads <= 0) {
+    batch_evaluation_threads =
+        std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  }
+  // The thread serving a stream is one of the evaluation threads.
+  worker_pool_ = std::make_unique<WorkerPool>(batch_evaluation_threads - 1);
+}
+
+ZetaSqlLocalServiceGrpcImpl::~ZetaSqlLocalServiceGrpcImpl() = default;
+
+template <typename RequestT, typename ResponseT, typename RequestBatchT,
+          typename ResponseBatchT>
+grpc::Status ZetaSqlLocalServiceGrpcImpl::EvaluateBatchStream(
+    absl::Status (ZetaSqlLocalServiceImpl::*evaluate)(const RequestT&,
+                                                        ResponseT*),
+    grpc::ServerReaderWriter<ResponseBatchT, RequestBatchT>* stream) {
+  RequestBatchT reqb;
+  while (stream->Read(&reqb)) {
+    const int num_requests = reqb.request_size();
+    std::vector<ResponseT> responses(num_requests);
+    std::vector<absl::Status> statuses(num_requests);
+    worker_pool_->ParallelFor(num_requests, [&](int i) {
+      statuses[i] = (service_.*evaluate)(reqb.request(i), &responses[i]);
+    });
+
+    ResponseBatchT respb;
+    size_t respb_bytes = 0;
+    for (int i = 0; i < num_requests; ++i) {
+      if (!statuses[i].ok()) {
+        return ToGrpcStatus(statuses[i]);
+      }
+      // The size of the response as a field of the batch.
+      const size_t response_bytes = responses[i].ByteSizeLong();
+      const size_t field_bytes =
+          1 +
+          google::protobuf::io::CodedOutputStream::VarintSize64(
+              response_bytes) +
+          response_bytes;
+      if (respb.response_size() > 0 &&
+          respb_bytes + field_bytes > GRPC_DEFAULT_MAX_RECV_MESSAGE_LENGTH) {
+        // The response would push us over the max message size. Send prior
+        // responses first.
+        stream->Write(respb, grpc::WriteOptions().set_corked());
+        respb.Clear();
+        respb_bytes = 0;
+      }
+      *respb.add_response() = std::move(responses[i]);
+      respb_bytes += field_bytes;
+    }
+    stream->Write(respb);
+  }
+  return grpc::Status();
+}
+
 grpc::Status ZetaSqlLocalServiceGrpcImpl::Prepare(
     grpc::ServerContext* context, const PrepareRequest* req,
     PrepareResponse* resp) {
@@ -104,28 +303,7 @@ grpc::Status ZetaSqlLocalServiceGrpcImpl::EvaluateStream(
     grpc::ServerContext* context,
     grpc::ServerReaderWriter<EvaluateResponseBatch, EvaluateRequestBatch>*
         stream) {
-  EvaluateRequestBatch reqb;
-  while (stream->Read(&reqb)) {
-    EvaluateResponseBatch respb;
-    for (const auto& req : reqb.request()) {
-      EvaluateResponse* resp = respb.add_response();
-      auto status = service_.Evaluate(req, resp);
-      if (!status.ok()) {
-        return ToGrpcStatus(status);
-      }
-      if (respb.response_size() > 1 &&
-          respb.ByteSizeLong() > GRPC_DEFAULT_MAX_RECV_MESSAGE_LENGTH) {
-        // The response pushed us over the max message size. Remove it from the
-        // batch, send prior responses, then add it back.
-        auto* last = respb.mutable_response()->ReleaseLast();
-        stream->Write(respb, grpc::WriteOptions().set_corked());
-        respb.Clear();
-        respb.mutable_response()->AddAllocated(last);
-      }
-    }
-    stream->Write(respb);
-  }
-  return grpc::Status();
+  return EvaluateBatchStream(&ZetaSqlLocalServiceImpl::Evaluate, stream);
 }
 
 grpc::Status ZetaSqlLocalServiceGrpcImpl::PrepareQuery(
@@ -150,28 +328,21 @@ grpc::Status ZetaSqlLocalServiceGrpcImpl::EvaluateQueryStream(
     grpc::ServerContext* context,
     grpc::ServerReaderWriter<EvaluateQueryBatchResponse,
                              EvaluateQueryBatchRequest>* stream) {
-  EvaluateQueryBatchRequest reqb;
-  while (stream->Read(&reqb)) {
-    EvaluateQueryBatchResponse respb;
-    for (const auto& req : reqb.request()) {
-      EvaluateQueryResponse* resp = respb.add_response();
-      auto status = service_.EvaluateQuery(req, resp);
-      if (!status.ok()) {
-        return ToGrpcStatus(status);
-      }
-      if (respb.response_size() > 1 &&
-          respb.ByteSizeLong() > GRPC_DEFAULT_MAX_RECV_MESSAGE_LENGTH) {
-        // The response pushed us over the max message size. Remove it from the
-        // batch, send prior responses, then add it back.
-        auto* last = respb.mutable_response()->ReleaseLast();
-        stream->Write(respb, grpc::WriteOptions().set_corked());
-        respb.Clear();
-        respb.mutable_response()->AddAllocated(last);
-      }
-    }
-    stream->Write(respb);
-  }
-  return grpc::Status();
+  return EvaluateBatchStream(&ZetaSqlLocalServiceImpl::EvaluateQuery, stream);
+}
+
+grpc::Status ZetaSqlLocalServiceGrpcImpl::EvaluateQueryChunked(
+    grpc::ServerContext* context, const EvaluateQueryRequest* req,
+    grpc::ServerWriter<EvaluateQueryResponse>* writer) {
+  // Write() blocks until the client has room for the chunk, which keeps
+  // evaluation from running ahead of the client.
+  return ToGrpcStatus(service_.EvaluateQueryChunked(
+      *req, [writer](const EvaluateQueryResponse& chunk) {
+        if (!writer->Write(chunk)) {
+          return absl::CancelledError("The client closed the stream");
+        }
+        return absl::OkStatus();
+      }));
 }
 
 grpc::Status ZetaSqlLocalServiceGrpcImpl::PrepareModify(
@@ -196,28 +367,7 @@ grpc::Status ZetaSqlLocalServiceGrpcImpl::EvaluateModifyStream(
     grpc::ServerContext* context,
     grpc::ServerReaderWriter<EvaluateModifyBatchResponse,
                              EvaluateModifyBatchRequest>* stream) {
-  EvaluateModifyBatchRequest reqb;
-  while (stream->Read(&reqb)) {
-    EvaluateModifyBatchResponse respb;
-    for (const auto& req : reqb.request()) {
-      EvaluateModifyResponse* resp = respb.add_response();
-      auto status = service_.EvaluateModify(req, resp);
-      if (!status.ok()) {
-        return ToGrpcStatus(status);
-      }
-      if (respb.response_size() > 1 &&
-          respb.ByteSizeLong() > GRPC_DEFAULT_MAX_RECV_MESSAGE_LENGTH) {
-        // The response pushed us over the max message size. Remove it from the
-        // batch, send prior responses, then add it back.
-        auto* last = respb.mutable_response()->ReleaseLast();
-        stream->Write(respb, grpc::WriteOptions().set_corked());
-        respb.Clear();
-        respb.mutable_response()->AddAllocated(last);
-      }
-    }
-    stream->Write(respb);
-  }
-  return grpc::Status();
+  return EvaluateBatchStream(&ZetaSqlLocalServiceImpl::EvaluateModify, stream);
 }
 
 grpc::Status ZetaSqlLocalServiceGrpcImpl::GetTableFromProto(
@@ -270,6 +420,12 @@ grpc::Status ZetaSqlLocalServiceGrpcImpl::RegisterCatalog(
   return ToGrpcStatus(service_.RegisterCatalog(*req, resp));
 }
 
+grpc::Status ZetaSqlLocalServiceGrpcImpl::UpdateRegisteredCatalog(
+    grpc::ServerContext* context, const UpdateRegisteredCatalogRequest* req,
+    RegisterResponse* resp) {
+  return ToGrpcStatus(service_.UpdateRegisteredCatalog(*req, resp));
+}
+
 grpc::Status ZetaSqlLocalServiceGrpcImpl::UnregisterCatalog(
     grpc::ServerContext* context, const UnregisterRequest* req,
     google::protobuf::Empty* unused) {
@@ -17,12 +17,15 @@
 #ifndef ZETASQL_LOCAL_SERVICE_LOCAL_SERVICE_GRPC_H_
 #define ZETASQL_LOCAL_SERVICE_LOCAL_SERVICE_GRPC_H_
 
+#include <memory>
+
 #include "zetasql/local_service/local_service.grpc.pb.h"
 #include "zetasql/local_service/local_service.h"
 #include "zetasql/local_service/local_service.pb.h"
 #include "zetasql/proto/options.pb.h"
 #include "zetasql/public/parse_resume_location.pb.h"
 #include "zetasql/public/simple_table.pb.h"
+#include "absl/status/status.h"
 
 namespace zetasql {
 namespace local_service {
@@ -31,6 +34,18 @@ namespace local_service {
 class ZetaSqlLocalServiceGrpcImpl
     : public ZetaSqlLocalService::Service {
  public:
+  // The requests of each batch received by EvaluateStream,
+  // EvaluateQueryStream and EvaluateModifyStream are evaluated in parallel
+  // on up to <batch_evaluation_threads> threads, counting the thread serving
+  // the stream. The default constructor uses
+  // --zetasql_local_service_batch_evaluation_threads.
+  ZetaSqlLocalServiceGrpcImpl();
+  explicit ZetaSqlLocalServiceGrpcImpl(int batch_evaluation_threads);
+  ZetaSqlLocalServiceGrpcImpl(const ZetaSqlLocalServiceGrpcImpl&) = delete;
+  ZetaSqlLocalServiceGrpcImpl& operator=(const ZetaSqlLocalServiceGrpcImpl&) =
+      delete;
+  ~ZetaSqlLocalServiceGrpcImpl() override;
+
   grpc::Status Prepare(grpc::ServerContext* context, const PrepareRequest* req,
                        PrepareResponse* resp) override;
 
@@ -64,6 +79,10 @@ class ZetaSqlLocalServiceGrpcImpl
       grpc::ServerReaderWriter<EvaluateQueryBatchResponse,
                                EvaluateQueryBatchRequest>* stream) override;
 
+  grpc::Status EvaluateQueryChunked(
+      grpc::ServerContext* context, const EvaluateQueryRequest* req,
+      grpc::ServerWriter<EvaluateQueryResponse>* writer) override;
+
   grpc::Status PrepareModify(grpc::ServerContext* context,
                              const PrepareModifyRequest* req,
                              PrepareModifyResponse* resp) override;
@@ -114,6 +133,10 @@ class ZetaSqlLocalServiceGrpcImpl
                                const RegisterCatalogRequest* req,
                                RegisterResponse* resp) override;
 
+  grpc::Status UpdateRegisteredCatalog(
+      grpc::ServerContext* context, const UpdateRegisteredCatalogRequest* req,
+      RegisterResponse* resp) override;
+
   grpc::Status UnregisterCatalog(grpc::ServerContext* context,
                                  const UnregisterRequest* req,
                                  google::protobuf::Empty* unused) override;
@@ -136,7 +159,21 @@ class ZetaSqlLocalServiceGrpcImpl
                      ParseResponse* resp) override;
 
  private:
+  class WorkerPool;
+
+  // Reads request batches from <stream> and writes the responses, computed
+  // with <evaluate> on the worker pool, in request order. Responses are split
+  // across several response batches when needed to stay under the maximum
+  // message size.
+  template <typename RequestT, typename ResponseT, typename RequestBatchT,
+            typename ResponseBatchT>
+  grpc::Status EvaluateBatchStream(
+      absl::Status (ZetaSqlLocalServiceImpl::*evaluate)(const RequestT&,
+                                                          ResponseT*),
+      grpc::ServerReaderWriter<ResponseBatchT, RequestBatchT>* stream);
+
   ZetaSqlLocalServiceImpl service_;
+  std::unique_ptr<WorkerPool> worker_pool_;
 };
 
 }  // namespace local_service
@@ -0,0 +1,153 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Benchmarks for the gRPC transport of the local service, over an in-process
+// channel. Compare with local_service_benchmark for the cost of the transport.
+
+#include <grpcpp/server.h>
+#include <grpcpp/server_builder.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "zetasql/base/logging.h"
+#include "zetasql/local_service/local_service.grpc.pb.h"
+#include "zetasql/local_service/local_service.pb.h"
+#include "zetasql/local_service/local_service_grpc.h"
+#include "benchmark/benchmark.h"
+#include "absl/base/internal/sysinfo.h"
+#include "absl/strings/str_cat.h"
+
+namespace zetasql {
+
+using ::absl::base_internal::NumCPUs;
+
+namespace local_service {
+
+namespace {
+
+// Returns a stub connected to a server that lives for the whole benchmark.
+ZetaSqlLocalService::Stub* GetStub() {
+  static ZetaSqlLocalService::Stub* stub = [] {
+    static ZetaSqlLocalServiceGrpcImpl* service =
+        new ZetaSqlLocalServiceGrpcImpl();
+    grpc::ServerBuilder builder;
+    builder.RegisterService(service);
+    static grpc::Server* server = builder.BuildAndStart().release();
+    return ZetaSqlLocalService::NewStub(
+               server->InProcessChannel(grpc::ChannelArguments()))
+        .release();
+  }();
+  return stub;
+}
+
+int64_t GetPreparedExpressionId() {
+  static int64_t prepared_expression_id = [] {
+    EvaluateRequest request;
+    request.set_sql("1");
+    EvaluateResponse response;
+    grpc::ClientContext context;
+    grpc::Status status = GetStub()->Evaluate(&context, request, &response);
+    ABSL_CHECK(status.ok()) << status.error_message();
+    return response.prepared().prepared_expression_id();
+  }();
+  return prepared_expression_id;
+}
+
+}  // namespace
+
+static void BM_GrpcEvaluatePrepared(::benchmark::State& state) {
+  EvaluateRequest request;
+  request.set_prepared_expression_id(GetPreparedExpressionId());
+  EvaluateResponse response;
+  for (auto s : state) {
+    grpc::ClientContext context;
+    grpc::Status status = GetStub()->Evaluate(&context, request, &response);
+    ABSL_CHECK(status.ok()) << status.error_message();
+  }
+}
+BENCHMARK(BM_GrpcEvaluatePrepared)->ThreadRange(1, NumCPUs());
+
+// Sends batches of state.range(0) prepared evaluations over one stream.
+static void BM_GrpcEvaluateStreamPrepared(::benchmark::State& state) {
+  EvaluateRequestBatch batch_request;
+  for (int i = 0; i < state.range(0); ++i) {
+    batch_request.add_request()->set_prepared_expression_id(
+        GetPreparedExpressionId());
+  }
+
+  grpc::ClientContext context;
+  auto stream = GetStub()->EvaluateStream(&context);
+  EvaluateResponseBatch batch_response;
+  for (auto s : state) {
+    ABSL_CHECK(stream->Write(batch_request));
+    ABSL_CHECK(stream->Read(&batch_response));
+  }
+  stream->WritesDone();
+  grpc::Status status = stream->Finish();
+  ABSL_CHECK(status.ok()) << status.error_message();
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GrpcEvaluateStreamPrepared)
+    ->Arg(1)
+    ->Arg(64)
+    ->ThreadRange(1, NumCPUs());
+
+// Returns state.range(0) rows from a unary EvaluateQuery.
+static void BM_GrpcEvaluateQuery(::benchmark::State& state) {
+  EvaluateQueryRequest request;
+  request.set_sql(absl::StrCat(
+      "SELECT x, CAST(x AS STRING) AS s FROM UNNEST(GENERATE_ARRAY(1, ",
+      state.range(0), ")) AS x"));
+  EvaluateQueryResponse response;
+  int64_t bytes = 0;
+  for (auto s : state) {
+    grpc::ClientContext context;
+    grpc::Status status =
+        GetStub()->EvaluateQuery(&context, request, &response);
+    ABSL_CHECK(status.ok()) << status.error_message();
+    bytes += response.ByteSizeLong();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_GrpcEvaluateQuery)->Arg(10)->Arg(100000);
+
+// Returns state.range(0) rows from EvaluateQueryChunked.
+static void BM_GrpcEvaluateQueryChunked(::benchmark::State& state) {
+  EvaluateQueryRequest request;
+  request.set_sql(absl::StrCat(
+      "SELECT x, CAST(x AS STRING) AS s FROM UNNEST(GENERATE_ARRAY(1, ",
+      state.range(0), ")) AS x"));
+  EvaluateQueryResponse response;
+  int64_t bytes = 0;
+  for (auto s : state) {
+    grpc::ClientContext context;
+    auto reader = GetStub()->EvaluateQueryChunked(&context, request);
+    while (reader->Read(&response)) {
+      bytes += response.ByteSizeLong();
+    }
+    grpc::Status status = reader->Finish();
+    ABSL_CHECK(status.ok()) << status.error_message();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_GrpcEvaluateQueryChunked)->Arg(10)->Arg(100000);
+
+}  // namespace local_service
+}  // namespace zetasql
@@ -30,6 +30,7 @@
 #include "zetasql/public/value.pb.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/strings/str_cat.h"
 
 namespace zetasql::local_service {
 
@@ -122,6 +123,75 @@ TEST_F(ZetaSqlLocalServiceGrpcImplTest, EvaluateStreamPreparedBigResponse) {
   EXPECT_OK_GRPC(stream->Finish());
 }
 
+TEST(ZetaSqlLocalServiceGrpcImplParallelTest, EvaluateStreamInOrder) {
+  ZetaSqlLocalServiceGrpcImpl service(/*batch_evaluation_threads=*/4);
+  grpc::ServerBuilder builder;
+  builder.RegisterService(&service);
+  std::unique_ptr<grpc::Server> server = builder.BuildAndStart();
+
+  grpc::ChannelArguments channel_args;
+  std::unique_ptr<ZetaSqlLocalService::Stub> stub(
+      ZetaSqlLocalService::NewStub(server->InProcessChannel(channel_args)));
+
+  grpc::ClientContext context;
+  std::unique_ptr<
+      grpc::ClientReaderWriter<EvaluateRequestBatch, EvaluateResponseBatch>>
+      stream = stub->EvaluateStream(&context);
+
+  const int request_count = 500;
+  EvaluateRequestBatch batch_request;
+  for (int i = 0; i < request_count; i++) {
+    batch_request.add_request()->set_sql(absl::StrCat(i, " * 2"));
+  }
+  ASSERT_TRUE(stream->Write(batch_request));
+
+  EvaluateResponseBatch batch_response;
+  ASSERT_TRUE(stream->Read(&batch_response));
+  ASSERT_EQ(batch_response.response_size(), request_count);
+  for (int i = 0; i < request_count; i++) {
+    EXPECT_EQ(batch_response.response(i).value().int64_value(), i * 2);
+  }
+
+  // A failing request fails the stream.
+  batch_request.mutable_request(request_count / 2)->set_sql("1 +");
+  ASSERT_TRUE(stream->Write(batch_request));
+  EXPECT_FALSE(stream->Read(&batch_response));
+  EXPECT_FALSE(stream->Finish().ok());
+
+  server->Shutdown();
+}
+
+TEST_F(ZetaSqlLocalServiceGrpcImplTest, EvaluateQueryChunkedBigResult) {
+  grpc::ChannelArguments channel_args;
+  channel_args.SetMaxReceiveMessageSize(GRPC_DEFAULT_MAX_RECV_MESSAGE_LENGTH);
+  std::unique_ptr<ZetaSqlLocalService::Stub> stub(
+      ZetaSqlLocalService::NewStub(
+          server_->InProcessChannel(channel_args)));
+
+  // The result is twice the maximum message size.
+  const int row_count = 8;
+  EvaluateQueryRequest request;
+  request.set_sql(
+      "SELECT REPEAT('a', 1024*1024) AS s "
+      "FROM UNNEST(GENERATE_ARRAY(1, 8))");
+
+  grpc::ClientContext context;
+  std::unique_ptr<grpc::ClientReader<EvaluateQueryResponse>> reader =
+      stub->EvaluateQueryChunked(&context, request);
+
+  EvaluateQueryResponse response;
+  int response_count = 0;
+  int rows = 0;
+  while (reader->Read(&response)) {
+    EXPECT_EQ(response.has_prepared(), response_count == 0);
+    ++response_count;
+    rows += response.content().table_data().row_size();
+  }
+  EXPECT_OK_GRPC(reader->Finish());
+  EXPECT_EQ(rows, row_count);
+  EXPECT_GT(response_count, 1);
+}
+
 }  // namespace
 
 }  // namespace zetasql::local_service
@@ -25,26 +25,53 @@
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <memory>
+#include <string>
 
+#include "google/protobuf/message_lite.h"
+#include "zetasql/local_service/local_service_direct.h"
 #include "zetasql/local_service/local_service_grpc.h"
+#include "absl/strings/string_view.h"
 
 namespace zetasql {
 namespace local_service {
 namespace {
 
+// Shared by the socket and direct transports, so that ids returned by one
+// can be used with the other.
+static ZetaSqlLocalServiceGrpcImpl* GetService() {
+  static ZetaSqlLocalServiceGrpcImpl* service =
+      new ZetaSqlLocalServiceGrpcImpl();
+  return service;
+}
+
 static grpc::Server* GetServer() {
   static grpc::Server* server = []() {
-    // The service must remain for the lifetime of the server.
-    static ZetaSqlLocalServiceGrpcImpl* service =
-        new ZetaSqlLocalServiceGrpcImpl();
     grpc::ServerBuilder builder;
-    builder.RegisterService(service);
+    builder.RegisterService(GetService());
     return builder.BuildAndStart().release();
   }();
   return server;
 }
 
+static const DirectCallDispatcher* GetDispatcher() {
+  static const DirectCallDispatcher* dispatcher =
+      new DirectCallDispatcher(GetService());
+  return dispatcher;
+}
+
+// Direct calls write their result at the start of the caller's buffer: the
+// grpc::StatusCode as a native-endian int32, then the serialized response, or
+// the error message if the call failed.
+constexpr int64_t kDirectResultHeaderSize = sizeof(int32_t);
+
+// The result of the last direct call on this thread, if it did not fit in the
+// caller's buffer.
+static thread_local std::string pending_direct_result;
+
 static void ErrnoSocketException(JNIEnv* env) {
   char buf[128];
 #if __USE_GNU
@@ -61,6 +88,27 @@ static void ErrnoSocketException(JNIEnv* env) {
   env->ThrowNew(e, outstr);
 }
 
+static void ThrowIllegalArgumentException(JNIEnv* env, const char* message) {
+  jclass e = env->FindClass("java/lang/IllegalArgumentException");
+  if (e == nullptr) {
+    return;
+  }
+  env->ThrowNew(e, message);
+}
+
+// Returns the address of direct ByteBuffer <buffer> and sets <capacity>, or
+// throws and returns nullptr if it is not a direct buffer large enough for the
+// result header.
+static char* GetDirectBuffer(JNIEnv* env, jobject buffer, int64_t* capacity) {
+  char* data = static_cast<char*>(env->GetDirectBufferAddress(buffer));
+  *capacity = env->GetDirectBufferCapacity(buffer);
+  if (data == nullptr || *capacity < kDirectResultHeaderSize) {
+    ThrowIllegalArgumentException(env, "Expected a direct ByteBuffer");
+    return nullptr;
+  }
+  return data;
+}
+
 static int GetSocketFd(JNIEnv* env) {
   int sv[2];
   if (socketpair(AF_UNIX, SOCK_STREAM, 0, sv) < 0) {
@@ -174,6 +222,80 @@ jobject GetSocketChannel(JNIEnv* env) {
   return sc;
 }
 
+jint GetDirectMethodId(JNIEnv* env, jclass clazz, jstring full_method_name) {
+  const char* name = env->GetStringUTFChars(full_method_name, nullptr);
+  if (name == nullptr) {
+    return -1;
+  }
+  const int method_id = GetDispatcher()->FindMethod(name);
+  env->ReleaseStringUTFChars(full_method_name, name);
+  return method_id;
+}
+
+jint CallDirect(JNIEnv* env, jclass clazz, jint method_id, jobject buffer,
+                jint request_size) {
+  int64_t capacity;
+  char* data = GetDirectBuffer(env, buffer, &capacity);
+  if (data == nullptr) {
+    return -1;
+  }
+  if (request_size < 0 || request_size > capacity) {
+    ThrowIllegalArgumentException(env, "Invalid request size");
+    return -1;
+  }
+
+  // The request is parsed before the result overwrites it.
+  std::unique_ptr<google::protobuf::MessageLite> response;
+  grpc::Status status = GetDispatcher()->Call(
+      method_id, absl::string_view(data, request_size), &response);
+  size_t result_size = 0;
+  if (status.ok()) {
+    result_size = response->ByteSizeLong();
+    if (result_size > std::numeric_limits<jint>::max()) {
+      status = grpc::Status(grpc::RESOURCE_EXHAUSTED, "Response too large");
+    }
+  }
+
+  char* result = data + kDirectResultHeaderSize;
+  const size_t result_capacity = capacity - kDirectResultHeaderSize;
+  const int32_t code = status.error_code();
+  memcpy(data, &code, sizeof(code));
+  if (status.ok()) {
+    if (result_size <= result_capacity) {
+      response->SerializeWithCachedSizesToArray(
+          reinterpret_cast<uint8_t*>(result));
+    } else {
+      pending_direct_result.clear();
+      response->AppendToString(&pending_direct_result);
+    }
+  } else {
+    const std::string& message = status.error_message();
+    result_size = message.size();
+    if (result_size <= result_capacity) {
+      memcpy(result, message.data(), result_size);
+    } else {
+      pending_direct_result = message;
+    }
+  }
+  return static_cast<jint>(result_size);
+}
+
+void TakeDirectResult(JNIEnv* env, jclass clazz, jobject buffer) {
+  int64_t capacity;
+  char* data = GetDirectBuffer(env, buffer, &capacity);
+  if (data == nullptr) {
+    return;
+  }
+  if (pending_direct_result.size() > capacity - kDirectResultHeaderSize) {
+    ThrowIllegalArgumentException(env, "Buffer too small for the result");
+    return;
+  }
+  memcpy(data + kDirectResultHeaderSize, pending_direct_result.data(),
+         pending_direct_result.size());
+  // Releases the memory, since results this large are rare.
+  std::string().swap(pending_direct_result);
+}
+
 extern "C" JNIEXPORT jint JNICALL JNI_OnLoad_zetasql_local_service(JavaVM* vm,
                                                            void* reserved) {
   JNIEnv* env = nullptr;
@@ -209,6 +331,12 @@ extern "C" JNIEXPORT jint JNICALL JNI_OnLoad_zetasql_local_service(JavaVM* vm,
   static JNINativeMethod methods[] = {
       {(char*)"getSocketChannel", (char*)"()Ljava/nio/channels/SocketChannel;",
        (void*)GetSocketChannel},
+      {(char*)"getDirectMethodId", (char*)"(Ljava/lang/String;)I",
+       (void*)GetDirectMethodId},
+      {(char*)"callDirect", (char*)"(ILjava/nio/ByteBuffer;I)I",
+       (void*)CallDirect},
+      {(char*)"takeDirectResult", (char*)"(Ljava/nio/ByteBuffer;)V",
+       (void*)TakeDirectResult},
   };
   if (env->RegisterNatives(clazz, methods,
                            sizeof(methods) / sizeof(JNINativeMethod)) !=
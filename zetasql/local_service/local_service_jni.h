@@ -26,6 +26,24 @@ namespace local_service {
 // and connects the other end to the local_service gRPC server.
 jobject GetSocketChannel(JNIEnv* env);
 
+// Returns the id used by CallDirect for the unary RPC named
+// <full_method_name>, or -1 if it must be called through the socket channel.
+jint GetDirectMethodId(JNIEnv* env, jclass clazz, jstring full_method_name);
+
+// Calls the RPC with id <method_id> on the request serialized in the first
+// <request_size> bytes of direct ByteBuffer <buffer>, without copying it out
+// of the buffer. Writes the grpc::StatusCode as a native-endian int32 at the
+// start of <buffer>, followed by the serialized response or the error
+// message, and returns the size of the latter. If it does not fit in
+// <buffer>, it must be retrieved with TakeDirectResult before the next call
+// on this thread.
+jint CallDirect(JNIEnv* env, jclass clazz, jint method_id, jobject buffer,
+                jint request_size);
+
+// Writes the result of the last CallDirect on this thread that did not fit in
+// its buffer to <buffer>, after the status code.
+void TakeDirectResult(JNIEnv* env, jclass clazz, jobject buffer);
+
 }  // namespace local_service
 }  // namespace zetasql
 
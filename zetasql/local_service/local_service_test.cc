@@ -33,9 +33,12 @@
 #include "zetasql/common/testing/proto_matchers.h"
 #include "zetasql/base/testing/status_matchers.h"
 #include "zetasql/common/testing/testing_proto_util.h"
+#include "zetasql/local_service/columnar_table_data.h"
 #include "zetasql/proto/function.pb.h"
 #include "zetasql/proto/simple_catalog.pb.h"
 #include "zetasql/public/formatter_options.pb.h"
+#include "zetasql/public/function.h"
+#include "zetasql/public/function_signature.h"
 #include "zetasql/public/functions/date_time_util.h"
 #include "zetasql/public/parse_resume_location.pb.h"
 #include "zetasql/public/simple_catalog.h"
@@ -49,6 +52,8 @@
 #include "zetasql/testdata/test_schema.pb.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "zetasql/base/status.h"
@@ -125,6 +130,18 @@ class ZetaSqlLocalServiceImplTest : public ::testing::Test {
     return service_.EvaluateQuery(request, response);
   }
 
+  // Returns the chunks emitted by EvaluateQueryChunked().
+  absl::StatusOr<std::vector<EvaluateQueryResponse>> EvaluateQueryChunked(
+      const EvaluateQueryRequest& request) {
+    std::vector<EvaluateQueryResponse> chunks;
+    ZETASQL_RETURN_IF_ERROR(service_.EvaluateQueryChunked(
+        request, [&chunks](const EvaluateQueryResponse& chunk) {
+          chunks.push_back(chunk);
+          return absl::OkStatus();
+        }));
+    return chunks;
+  }
+
   absl::Status EvaluateModify(const EvaluateModifyRequest& request,
                               EvaluateModifyResponse* response) {
     return service_.EvaluateModify(request, response);
@@ -171,10 +188,22 @@ class ZetaSqlLocalServiceImplTest : public ::testing::Test {
     return service_.RegisterCatalog(request, response);
   }
 
+  absl::Status UpdateRegisteredCatalog(
+      const UpdateRegisteredCatalogRequest& request,
+      RegisterResponse* response) {
+    return service_.UpdateRegisteredCatalog(request, response);
+  }
+
   absl::Status UnregisterCatalog(int64_t id) {
     return service_.UnregisterCatalog(id);
   }
 
+  size_t NumRegisteredDescriptorPools() {
+    return service_.NumRegisteredDescriptorPools();
+  }
+
+  size_t NumRegisteredCatalogs() { return service_.NumRegisteredCatalogs(); }
+
   size_t NumSavedPreparedExpression() {
     return service_.NumSavedPreparedExpression();
   }
@@ -1474,6 +1503,194 @@ TEST_F(ZetaSqlLocalServiceImplTest,
               StatusIs(absl::StatusCode::kInvalidArgument));
 }
 
+TEST_F(ZetaSqlLocalServiceImplTest,
+       RegisterCatalogWithSameDescriptorPoolTwice) {
+  int64_t catalog_ids[2];
+  int64_t kitchen_sink_pool_ids[2];
+  for (int i = 0; i < 2; ++i) {
+    RegisterCatalogRequest request;
+    request.mutable_simple_catalog()->set_file_descriptor_set_index(0);
+    AddKitchenSinkDescriptorPool(request.mutable_descriptor_pool_list());
+    // The same descriptors twice in one list still make two pools.
+    AddKitchenSinkDescriptorPool(request.mutable_descriptor_pool_list());
+
+    RegisterResponse response;
+    ZETASQL_ASSERT_OK(RegisterCatalog(request, &response));
+    catalog_ids[i] = response.registered_id();
+    ASSERT_EQ(response.descriptor_pool_id_list().registered_ids_size(), 2);
+    kitchen_sink_pool_ids[i] =
+        response.descriptor_pool_id_list().registered_ids(0);
+  }
+  // Each registration owns its own ids, even if the pools are shared.
+  EXPECT_NE(kitchen_sink_pool_ids[0], kitchen_sink_pool_ids[1]);
+
+  // The second catalog keeps working after the first one is gone.
+  ZETASQL_ASSERT_OK(UnregisterCatalog(catalog_ids[0]));
+  AnalyzeRequest analyze_request;
+  AddRegisteredDescriptorPool(analyze_request.mutable_descriptor_pool_list(),
+                              kitchen_sink_pool_ids[1]);
+  analyze_request.set_registered_catalog_id(catalog_ids[1]);
+  analyze_request.set_sql_statement(
+      R"(select new zetasql_test__.KitchenSinkPB(1 as int64_key_1, 2 as int64_key_2))");
+  AnalyzeResponse analyze_response;
+  ZETASQL_ASSERT_OK(Analyze(analyze_request, &analyze_response));
+  EXPECT_EQ(GetOutputType(analyze_response.resolved_statement())
+                .proto_type()
+                .proto_name(),
+            "zetasql_test__.KitchenSinkPB");
+  ZETASQL_ASSERT_OK(UnregisterCatalog(catalog_ids[1]));
+}
+
+TEST_F(ZetaSqlLocalServiceImplTest, AnalyzeWithSharedDescriptorPoolTwice) {
+  int64_t catalog_ids[2];
+  int64_t kitchen_sink_pool_ids[2];
+  for (int i = 0; i < 2; ++i) {
+    RegisterCatalogRequest request;
+    request.mutable_simple_catalog();
+    AddKitchenSinkDescriptorPool(request.mutable_descriptor_pool_list());
+    RegisterResponse response;
+    ZETASQL_ASSERT_OK(RegisterCatalog(request, &response));
+    catalog_ids[i] = response.registered_id();
+    ASSERT_EQ(response.descriptor_pool_id_list().registered_ids_size(), 1);
+    kitchen_sink_pool_ids[i] =
+        response.descriptor_pool_id_list().registered_ids(0);
+  }
+
+  // Both registered ids share one pool, as does a set of the same
+  // descriptors, but each entry of a list still needs a pool of its own.
+  AnalyzeRequest request;
+  AddRegisteredDescriptorPool(request.mutable_descriptor_pool_list(),
+                              kitchen_sink_pool_ids[0]);
+  AddRegisteredDescriptorPool(request.mutable_descriptor_pool_list(),
+                              kitchen_sink_pool_ids[1]);
+  AddKitchenSinkDescriptorPool(request.mutable_descriptor_pool_list());
+  request.set_registered_catalog_id(catalog_ids[0]);
+  request.set_sql_statement(
+      R"(select new zetasql_test__.KitchenSinkPB(1 as int64_key_1, 2 as int64_key_2))");
+  AnalyzeResponse response;
+  ZETASQL_ASSERT_OK(Analyze(request, &response));
+  EXPECT_EQ(GetOutputType(response.resolved_statement())
+                .proto_type()
+                .proto_name(),
+            "zetasql_test__.KitchenSinkPB");
+
+  ZETASQL_ASSERT_OK(UnregisterCatalog(catalog_ids[0]));
+  ZETASQL_ASSERT_OK(UnregisterCatalog(catalog_ids[1]));
+}
+
+TEST_F(ZetaSqlLocalServiceImplTest, AnalyzeWithBuiltinDescriptorPoolTwice) {
+  AnalyzeRequest request;
+  AddBuiltin(request.mutable_descriptor_pool_list());
+  AddBuiltin(request.mutable_descriptor_pool_list());
+  request.set_sql_statement("select 1");
+  AnalyzeResponse response;
+  EXPECT_THAT(Analyze(request, &response),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_F(ZetaSqlLocalServiceImplTest, UpdateRegisteredCatalog) {
+  RegisterCatalogRequest catalog_request;
+  catalog_request.mutable_simple_catalog()->mutable_builtin_function_options();
+  AddTestTable(catalog_request.mutable_simple_catalog()->add_table(),
+               "TestTable");
+  InsertTestTableContent(catalog_request.mutable_table_content(), "TestTable");
+  RegisterResponse catalog_response;
+  ZETASQL_ASSERT_OK(RegisterCatalog(catalog_request, &catalog_response));
+  const int64_t catalog_id = catalog_response.registered_id();
+
+  // Prepared before the update, so it keeps seeing TestTable.
+  PrepareQueryRequest prepare_request;
+  prepare_request.set_sql("SELECT column_int FROM TestTable");
+  prepare_request.set_registered_catalog_id(catalog_id);
+  PrepareQueryResponse prepare_response;
+  ZETASQL_ASSERT_OK(PrepareQuery(prepare_request, &prepare_response));
+  const int64_t prepared_query_id =
+      prepare_response.prepared().prepared_query_id();
+
+  UpdateRegisteredCatalogRequest update_request;
+  update_request.set_registered_catalog_id(catalog_id);
+  update_request.add_drop_table("testtable");
+  AddTestTable(update_request.add_add_table(), "OtherTable");
+  InsertTestTableContent(update_request.mutable_table_content(), "OtherTable");
+  const FunctionSignature signature{
+      types::Int64Type(), {types::Int64Type()}, /*context_id=*/-1};
+  Function function("plus_one", "test", Function::SCALAR, {signature},
+                    FunctionOptions());
+  FileDescriptorSetMap file_descriptor_set_map;
+  ZETASQL_ASSERT_OK(function.Serialize(&file_descriptor_set_map,
+                               update_request.add_add_function()));
+  RegisterResponse update_response;
+  ZETASQL_ASSERT_OK(UpdateRegisteredCatalog(update_request, &update_response));
+  EXPECT_EQ(update_response.registered_id(), catalog_id);
+
+  EvaluateQueryRequest evaluate_request;
+  evaluate_request.set_registered_catalog_id(catalog_id);
+  evaluate_request.set_sql("SELECT column_int FROM OtherTable");
+  EvaluateQueryResponse evaluate_response;
+  ZETASQL_ASSERT_OK(EvaluateQuery(evaluate_request, &evaluate_response));
+  EXPECT_EQ(evaluate_response.content().table_data().row_size(), 2);
+
+  evaluate_request.set_sql("SELECT column_int FROM TestTable");
+  EXPECT_FALSE(EvaluateQuery(evaluate_request, &evaluate_response).ok());
+
+  AnalyzeRequest analyze_request;
+  analyze_request.set_registered_catalog_id(catalog_id);
+  analyze_request.set_sql_statement(
+      "SELECT plus_one(column_int) FROM OtherTable");
+  AnalyzeResponse analyze_response;
+  ZETASQL_EXPECT_OK(Analyze(analyze_request, &analyze_response));
+
+  EvaluateQueryRequest prepared_request;
+  prepared_request.set_prepared_query_id(prepared_query_id);
+  ZETASQL_ASSERT_OK(EvaluateQuery(prepared_request, &evaluate_response));
+  EXPECT_EQ(evaluate_response.content().table_data().row_size(), 2);
+
+  // Drop the function again.
+  update_request.Clear();
+  update_request.set_registered_catalog_id(catalog_id);
+  update_request.add_drop_function("PLUS_ONE");
+  ZETASQL_ASSERT_OK(UpdateRegisteredCatalog(update_request, &update_response));
+  EXPECT_FALSE(Analyze(analyze_request, &analyze_response).ok());
+
+  ZETASQL_EXPECT_OK(UnprepareQuery(prepared_query_id));
+  ZETASQL_EXPECT_OK(UnregisterCatalog(catalog_id));
+}
+
+TEST_F(ZetaSqlLocalServiceImplTest, UpdateRegisteredCatalogErrors) {
+  UpdateRegisteredCatalogRequest update_request;
+  RegisterResponse update_response;
+  update_request.set_registered_catalog_id(12345);
+  EXPECT_THAT(UpdateRegisteredCatalog(update_request, &update_response),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  RegisterCatalogRequest catalog_request;
+  AddTestTable(catalog_request.mutable_simple_catalog()->add_table(),
+               "TestTable");
+  RegisterResponse catalog_response;
+  ZETASQL_ASSERT_OK(RegisterCatalog(catalog_request, &catalog_response));
+  const int64_t catalog_id = catalog_response.registered_id();
+  update_request.set_registered_catalog_id(catalog_id);
+
+  update_request.add_drop_table("NoSuchTable");
+  EXPECT_THAT(UpdateRegisteredCatalog(update_request, &update_response),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  update_request.clear_drop_table();
+  AddTestTable(update_request.add_add_table(), "TestTable");
+  EXPECT_THAT(UpdateRegisteredCatalog(update_request, &update_response),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  // Descriptor pools registered for a failed update are released.
+  update_request.clear_add_table();
+  update_request.add_drop_function("no_such_function");
+  AddKitchenSinkDescriptorPool(update_request.mutable_descriptor_pool_list());
+  EXPECT_THAT(UpdateRegisteredCatalog(update_request, &update_response),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_EQ(1, NumRegisteredDescriptorPools());
+
+  ZETASQL_EXPECT_OK(UnregisterCatalog(catalog_id));
+}
+
 void ExpectTypeIsDate(const TypeProto& type) {
   EXPECT_EQ(type.type_kind(), TYPE_DATE);
 }
@@ -1577,6 +1794,51 @@ TEST_F(ZetaSqlLocalServiceImplTest,
   EXPECT_EQ(0, NumSavedPreparedExpression());
 }
 
+TEST_F(ZetaSqlLocalServiceImplTest, EvictIdlePreparedStatements) {
+  EXPECT_EQ(service_.ApproximateMemoryUsage(), 0);
+
+  PrepareQueryRequest query_request;
+  query_request.set_sql("SELECT column_int FROM TestTable");
+  AddTestTable(query_request.mutable_simple_catalog()->add_table(),
+               "TestTable");
+  InsertTestTableContent(query_request.mutable_table_content(), "TestTable");
+  PrepareQueryResponse query_response;
+  ZETASQL_ASSERT_OK(PrepareQuery(query_request, &query_response));
+
+  PrepareRequest expression_request;
+  expression_request.set_sql("1 + 2");
+  PrepareResponse expression_response;
+  ZETASQL_ASSERT_OK(Prepare(expression_request, &expression_response));
+  EXPECT_EQ(NumSavedPreparedQueries(), 1);
+  EXPECT_EQ(NumSavedPreparedExpression(), 1);
+  EXPECT_EQ(NumRegisteredCatalogs(), 1);
+  const int64_t memory_usage = service_.ApproximateMemoryUsage();
+  EXPECT_GT(memory_usage, 0);
+
+  // Both were prepared since the last eviction.
+  EXPECT_EQ(service_.EvictIdlePreparedStatements(), 0);
+
+  EvaluateRequest evaluate_request;
+  evaluate_request.set_prepared_expression_id(
+      expression_response.prepared().prepared_expression_id());
+  EvaluateResponse evaluate_response;
+  ZETASQL_ASSERT_OK(Evaluate(evaluate_request, &evaluate_response));
+
+  // The query is unprepared along with the catalog it registered.
+  EXPECT_EQ(service_.EvictIdlePreparedStatements(), 1);
+  EXPECT_EQ(NumSavedPreparedQueries(), 0);
+  EXPECT_EQ(NumSavedPreparedExpression(), 1);
+  EXPECT_EQ(NumRegisteredCatalogs(), 0);
+  EXPECT_LT(service_.ApproximateMemoryUsage(), memory_usage);
+  EXPECT_FALSE(
+      UnprepareQuery(query_response.prepared().prepared_query_id()).ok());
+
+  EXPECT_EQ(service_.EvictIdlePreparedStatements(), 1);
+  EXPECT_EQ(NumSavedPreparedExpression(), 0);
+  EXPECT_EQ(service_.ApproximateMemoryUsage(), 0);
+  EXPECT_FALSE(Evaluate(evaluate_request, &evaluate_response).ok());
+}
+
 TEST_F(ZetaSqlLocalServiceImplTest, EvaluateWithDescriptorPoolList) {
   EvaluateRequest evaluate_request;
   evaluate_request.set_sql(R"(DATE "2020-10-20")");
@@ -2988,6 +3250,61 @@ TEST_F(ZetaSqlLocalServiceImplTest, EvaluateQueryWithSql) {
   ExpectValueIsString(row_0.cell(0), "apple");
 }
 
+TEST_F(ZetaSqlLocalServiceImplTest, EvaluateQueryChunked) {
+  EvaluateQueryRequest request;
+  request.set_sql(
+      "SELECT x, REPEAT('a', 100) AS s FROM UNNEST(GENERATE_ARRAY(1, 10)) AS x "
+      "ORDER BY x");
+  // Three rows per chunk.
+  request.set_max_chunk_bytes(250);
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::vector<EvaluateQueryResponse> chunks,
+                       EvaluateQueryChunked(request));
+  ASSERT_EQ(chunks.size(), 4);
+  ASSERT_EQ(chunks[0].prepared().columns_size(), 2);
+  EXPECT_EQ(chunks[0].prepared().columns(0).name(), "x");
+  EXPECT_EQ(chunks[0].prepared().columns(1).name(), "s");
+  int64_t expected_x = 1;
+  for (int i = 0; i < chunks.size(); ++i) {
+    EXPECT_EQ(chunks[i].has_prepared(), i == 0);
+    EXPECT_EQ(chunks[i].content().table_data().row_size(), i < 3 ? 3 : 1);
+    for (const TableData::Row& row : chunks[i].content().table_data().row()) {
+      ASSERT_EQ(row.cell_size(), 2);
+      EXPECT_EQ(row.cell(0).int64_value(), expected_x++);
+    }
+  }
+  EXPECT_EQ(expected_x, 11);
+  // Nothing is left registered.
+  EXPECT_EQ(0, NumSavedPreparedQueries());
+}
+
+TEST_F(ZetaSqlLocalServiceImplTest, EvaluateQueryChunkedEmptyResult) {
+  EvaluateQueryRequest request;
+  request.set_sql("SELECT 1 AS x FROM UNNEST([])");
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::vector<EvaluateQueryResponse> chunks,
+                       EvaluateQueryChunked(request));
+  ASSERT_EQ(chunks.size(), 1);
+  EXPECT_EQ(chunks[0].prepared().columns_size(), 1);
+  EXPECT_EQ(chunks[0].content().table_data().row_size(), 0);
+}
+
+TEST_F(ZetaSqlLocalServiceImplTest, EvaluateQueryChunkedStopsOnEmitError) {
+  EvaluateQueryRequest request;
+  request.set_sql("SELECT x FROM UNNEST(GENERATE_ARRAY(1, 100)) AS x");
+  request.set_max_chunk_bytes(1);
+
+  int emitted = 0;
+  EXPECT_THAT(service_.EvaluateQueryChunked(
+                  request,
+                  [&emitted](const EvaluateQueryResponse& chunk) {
+                    ++emitted;
+                    return absl::CancelledError("stop");
+                  }),
+              StatusIs(absl::StatusCode::kCancelled));
+  EXPECT_EQ(emitted, 1);
+}
+
 TEST_F(ZetaSqlLocalServiceImplTest, EvaluateQueryWithSqlWithParam) {
   // Evaluate Query
   EvaluateQueryRequest evaluate_request;
@@ -3205,6 +3522,71 @@ TEST_F(ZetaSqlLocalServiceImplTest, EvaluateQueryWithFullCatalogTableData) {
   ExpectValueIsInt32(row_0.cell(0), 123);
 }
 
+TEST_F(ZetaSqlLocalServiceImplTest, EvaluateQueryWithColumnarTableData) {
+  EvaluateQueryRequest evaluate_request;
+  evaluate_request.set_sql(
+      "SELECT column_str, column_int FROM TestTable WHERE column_bool "
+      "ORDER BY column_int");
+  evaluate_request.mutable_simple_catalog()->mutable_builtin_function_options();
+  AddTestTable(evaluate_request.mutable_simple_catalog()->add_table(),
+               "TestTable");
+  TableContent& table_content =
+      (*evaluate_request.mutable_table_content())["TestTable"];
+  ColumnarTableDataWriter writer(
+      {types::StringType(), types::BoolType(), types::Int32Type()},
+      table_content.mutable_columnar_table_data());
+  ZETASQL_ASSERT_OK(writer.AppendRow(
+      {Value::String("a"), Value::Bool(true), Value::Int32(3)}));
+  ZETASQL_ASSERT_OK(writer.AppendRow(
+      {Value::String("b"), Value::Bool(false), Value::Int32(2)}));
+  ZETASQL_ASSERT_OK(writer.AppendRow(
+      {Value::NullString(), Value::Bool(true), Value::Int32(1)}));
+  evaluate_request.set_columnar_result(true);
+
+  EvaluateQueryResponse evaluate_response;
+  ZETASQL_ASSERT_OK(EvaluateQuery(evaluate_request, &evaluate_response));
+  ASSERT_TRUE(evaluate_response.content().has_columnar_table_data());
+  EXPECT_FALSE(evaluate_response.content().has_table_data());
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::vector<std::vector<Value>> rows,
+      DeserializeColumnarTableData(
+          evaluate_response.content().columnar_table_data(),
+          {types::StringType(), types::Int32Type()}));
+  ASSERT_EQ(rows.size(), 2);
+  EXPECT_EQ(rows[0], std::vector<Value>({Value::NullString(), Value::Int32(1)}));
+  EXPECT_EQ(rows[1], std::vector<Value>({Value::String("a"), Value::Int32(3)}));
+
+  // Setting both encodings is an error.
+  table_content.mutable_table_data();
+  EXPECT_THAT(EvaluateQuery(evaluate_request, &evaluate_response),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_F(ZetaSqlLocalServiceImplTest, EvaluateQueryChunkedColumnar) {
+  EvaluateQueryRequest request;
+  request.set_sql(
+      "SELECT x FROM UNNEST(GENERATE_ARRAY(1, 1000)) AS x ORDER BY x");
+  request.set_columnar_result(true);
+  request.set_max_chunk_bytes(500);
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::vector<EvaluateQueryResponse> chunks,
+                       EvaluateQueryChunked(request));
+  ASSERT_GT(chunks.size(), 1);
+  int64_t expected_x = 1;
+  for (const EvaluateQueryResponse& chunk : chunks) {
+    ASSERT_TRUE(chunk.content().has_columnar_table_data());
+    EXPECT_LE(chunk.content().columnar_table_data().ByteSizeLong(), 520);
+    ZETASQL_ASSERT_OK_AND_ASSIGN(
+        std::vector<std::vector<Value>> rows,
+        DeserializeColumnarTableData(chunk.content().columnar_table_data(),
+                                     {types::Int64Type()}));
+    for (const std::vector<Value>& row : rows) {
+      EXPECT_EQ(row[0].int64_value(), expected_x++);
+    }
+  }
+  EXPECT_EQ(expected_x, 1001);
+}
+
 TEST_F(ZetaSqlLocalServiceImplTest,
        EvaluateQueryWithDescriptorPoolListProtoWithFullCatalogTableData) {
   // Evaluate Query
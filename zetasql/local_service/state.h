@@ -19,14 +19,16 @@
 
 #include <stddef.h>
 
+#include <atomic>
 #include <cstdint>
-#include <map>
 #include <memory>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/synchronization/mutex.h"
-#include "zetasql/base/map_util.h"
 
 namespace zetasql {
 namespace local_service {
@@ -35,10 +37,13 @@ class GenericState;
 
 // Pool of saved states that can be shared by multiple statements.
 // The state class T must extend GenericState and must be thread safe.
+//
+// The states are spread over shards by id, each with its own lock, so that
+// concurrent lookups of different states rarely contend.
 template<class T>
 class SharedStatePool {
  public:
-  SharedStatePool() : next_id_(0) {}
+  SharedStatePool() = default;
   SharedStatePool(const SharedStatePool&) = delete;
   SharedStatePool& operator=(const SharedStatePool&) = delete;
 
@@ -49,12 +54,11 @@ class SharedStatePool {
       return -1;
     }
 
-    absl::MutexLock lock(&mutex_);
-    int64_t id = next_id_++;
+    int64_t id = next_id_.fetch_add(1, std::memory_order_relaxed);
     if (!state->SetId(id)) {
       return -1;
     }
-    saved_states_[id] = state;
+    Add(id, std::move(state));
     return id;
   }
 
@@ -69,52 +73,156 @@ class SharedStatePool {
       return -1;
     }
 
-    absl::MutexLock lock(&mutex_);
-    int64_t id = next_id_++;
+    int64_t id = next_id_.fetch_add(1, std::memory_order_relaxed);
     if (!state->SetId(id)) {
       return -1;
     }
-    saved_states_[id].reset(state);
+    Add(id, std::shared_ptr<T>(state));
     return id;
   }
 
   bool Has(int64_t id) const {
-    absl::MutexLock lock(&mutex_);
-    return zetasql_base::ContainsKey(saved_states_, id);
+    const Shard& shard = GetShard(id);
+    absl::ReaderMutexLock lock(&shard.mutex);
+    return shard.states.contains(id);
   }
 
   // Get a state object with given id, ownership is shared by the pool and all
   // threads that currently hold the state object.
   std::shared_ptr<T> Get(int64_t id) {
-    absl::MutexLock lock(&mutex_);
-    std::shared_ptr<T>* result = zetasql_base::FindOrNull(saved_states_, id);
-    if (result == nullptr) {
+    const Shard& shard = GetShard(id);
+    absl::ReaderMutexLock lock(&shard.mutex);
+    auto it = shard.states.find(id);
+    if (it == shard.states.end()) {
       return nullptr;
-    } else {
-      return *result;
     }
+    MarkUsed(*it->second);
+    return it->second;
+  }
+
+  // Registers <state> under <id> in place of <expected>. Threads that hold
+  // <expected> keep it until they release it. Will return false if <id> is no
+  // longer registered to <expected>, or if <state> is null or already
+  // registered.
+  bool Replace(int64_t id, const std::shared_ptr<T>& expected,
+               std::shared_ptr<T> state) {
+    if (state == nullptr) {
+      return false;
+    }
+
+    Shard& shard = GetShard(id);
+    absl::MutexLock lock(&shard.mutex);
+    auto it = shard.states.find(id);
+    if (it == shard.states.end() || it->second != expected ||
+        !state->SetId(id)) {
+      return false;
+    }
+    MarkUsed(*state);
+    memory_usage_.fetch_add(
+        state->ApproximateMemoryUsage() - expected->ApproximateMemoryUsage(),
+        std::memory_order_relaxed);
+    it->second = std::move(state);
+    return true;
   }
 
   // Removes a state object from the pool. The state will be deleted immediately
   // if not held by any other threads, or after all threads releasing it.
   bool Delete(int64_t id) {
-    absl::MutexLock lock(&mutex_);
-    if (!zetasql_base::ContainsKey(saved_states_, id)) {
-      return false;
+    std::shared_ptr<T> state;
+    {
+      Shard& shard = GetShard(id);
+      absl::MutexLock lock(&shard.mutex);
+      auto it = shard.states.find(id);
+      if (it == shard.states.end()) {
+        return false;
+      }
+      state = std::move(it->second);
+      shard.states.erase(it);
     }
-    saved_states_.erase(id);
+    memory_usage_.fetch_sub(state->ApproximateMemoryUsage(),
+                            std::memory_order_relaxed);
+    // <state> may be deleted here, outside of the lock.
     return true;
   }
 
+  // Removes and returns the states that were neither registered nor returned
+  // by Get since the previous call, and starts a new idle period. Calling this
+  // every T evicts the states that have been idle for between T and 2T.
+  std::vector<std::shared_ptr<T>> TakeIdleStates() {
+    const int64_t period =
+        idle_period_.fetch_add(1, std::memory_order_relaxed);
+    std::vector<std::shared_ptr<T>> idle_states;
+    for (Shard& shard : shards_) {
+      absl::MutexLock lock(&shard.mutex);
+      for (auto it = shard.states.begin(); it != shard.states.end();) {
+        if (it->second->last_used_period_.load(std::memory_order_relaxed) <
+            period) {
+          idle_states.push_back(std::move(it->second));
+          shard.states.erase(it++);
+        } else {
+          ++it;
+        }
+      }
+    }
+    for (const std::shared_ptr<T>& state : idle_states) {
+      memory_usage_.fetch_sub(state->ApproximateMemoryUsage(),
+                              std::memory_order_relaxed);
+    }
+    return idle_states;
+  }
+
   size_t NumSavedStates() {
-    absl::MutexLock lock(&mutex_);
-    return saved_states_.size();
+    size_t num_states = 0;
+    for (const Shard& shard : shards_) {
+      absl::ReaderMutexLock lock(&shard.mutex);
+      num_states += shard.states.size();
+    }
+    return num_states;
+  }
+
+  // The sum of the GenericState::ApproximateMemoryUsage() of the saved states.
+  int64_t ApproximateMemoryUsage() const {
+    return memory_usage_.load(std::memory_order_relaxed);
   }
 
  private:
-  mutable absl::Mutex mutex_;
-  int64_t next_id_ ABSL_GUARDED_BY(mutex_);
-  std::map<int64_t, std::shared_ptr<T>> saved_states_ ABSL_GUARDED_BY(mutex_);
+  // A power of two, so that picking the shard is cheap.
+  static constexpr int kNumShards = 16;
+
+  // Aligned so that the locks of different shards do not share a cache line.
+  struct alignas(64) Shard {
+    mutable absl::Mutex mutex;
+    absl::flat_hash_map<int64_t, std::shared_ptr<T>> states
+        ABSL_GUARDED_BY(mutex);
+  };
+
+  Shard& GetShard(int64_t id) { return shards_[id & (kNumShards - 1)]; }
+  const Shard& GetShard(int64_t id) const {
+    return shards_[id & (kNumShards - 1)];
+  }
+
+  void Add(int64_t id, std::shared_ptr<T> state) {
+    MarkUsed(*state);
+    memory_usage_.fetch_add(state->ApproximateMemoryUsage(),
+                            std::memory_order_relaxed);
+    Shard& shard = GetShard(id);
+    absl::MutexLock lock(&shard.mutex);
+    shard.states[id] = std::move(state);
+  }
+
+  void MarkUsed(const T& state) const {
+    const int64_t period = idle_period_.load(std::memory_order_relaxed);
+    // Only write when the period changed, to keep the cache line shared
+    // between the threads that read the state.
+    if (state.last_used_period_.load(std::memory_order_relaxed) != period) {
+      state.last_used_period_.store(period, std::memory_order_relaxed);
+    }
+  }
+
+  std::atomic<int64_t> next_id_{0};
+  std::atomic<int64_t> idle_period_{0};
+  std::atomic<int64_t> memory_usage_{0};
+  Shard shards_[kNumShards];
 
   static_assert(
       std::is_base_of<GenericState, T>::value,
@@ -127,19 +235,23 @@ class GenericState {
   GenericState() = default;
   virtual ~GenericState() = default;
 
-  int64_t GetId() const { return id_; }
-  bool IsRegistered() { return id_ != -1; }
+  int64_t GetId() const { return id_.load(std::memory_order_relaxed); }
+  bool IsRegistered() { return GetId() != -1; }
+
+  // Approximate number of bytes used by this state, for the accounting of the
+  // pool it is registered in. Must not change while the state is registered.
+  virtual int64_t ApproximateMemoryUsage() const { return 0; }
 
  private:
-  int64_t id_ = -1;
+  std::atomic<int64_t> id_{-1};
+  // The idle period of the pool in which the state was last used.
+  mutable std::atomic<int64_t> last_used_period_{0};
 
   // Should only be called by SharedStatePool.
   bool SetId(int64_t id) {
-    if (id_ == -1) {
-      id_ = id;
-      return true;
-    }
-    return false;
+    int64_t unregistered = -1;
+    return id_.compare_exchange_strong(unregistered, id,
+                                       std::memory_order_relaxed);
   }
 
   template<class T> friend class SharedStatePool;
@@ -0,0 +1,91 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Contention benchmarks for SharedStatePool, which is locked by every
+// evaluation of a prepared statement.
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "zetasql/base/logging.h"
+#include "zetasql/local_service/state.h"
+#include "benchmark/benchmark.h"
+#include "absl/base/internal/sysinfo.h"
+
+namespace zetasql {
+
+using ::absl::base_internal::NumCPUs;
+
+namespace local_service {
+
+namespace {
+
+class BenchmarkState : public GenericState {};
+
+// Returns a pool with at least <num_states> registered states, and sets <ids>
+// to the ids of <num_states> of them.
+SharedStatePool<BenchmarkState>* GetPool(int num_states,
+                                         std::vector<int64_t>* ids) {
+  static SharedStatePool<BenchmarkState>* pool =
+      new SharedStatePool<BenchmarkState>();
+  static std::vector<int64_t>* all_ids = new std::vector<int64_t>();
+  while (all_ids->size() < num_states) {
+    all_ids->push_back(pool->Register(std::make_shared<BenchmarkState>()));
+  }
+  ids->assign(all_ids->begin(), all_ids->begin() + num_states);
+  return pool;
+}
+
+}  // namespace
+
+// Threads look up state.range(0) states, like concurrent evaluations of as
+// many prepared statements.
+static void BM_SharedStatePoolGet(::benchmark::State& state) {
+  static SharedStatePool<BenchmarkState>* pool;
+  static std::vector<int64_t>* ids = new std::vector<int64_t>();
+  if (state.thread_index() == 0) {
+    pool = GetPool(state.range(0), ids);
+  }
+  // Start each thread at a different state.
+  size_t next = state.thread_index();
+  for (auto s : state) {
+    std::shared_ptr<BenchmarkState> found =
+        pool->Get((*ids)[next++ % ids->size()]);
+    ::benchmark::DoNotOptimize(found);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SharedStatePoolGet)
+    ->Arg(1)
+    ->Arg(1024)
+    ->ThreadRange(1, NumCPUs());
+
+// Threads register and delete states while others look them up.
+static void BM_SharedStatePoolRegisterDelete(::benchmark::State& state) {
+  static SharedStatePool<BenchmarkState>* pool =
+      new SharedStatePool<BenchmarkState>();
+  for (auto s : state) {
+    const int64_t id = pool->Register(std::make_shared<BenchmarkState>());
+    ::benchmark::DoNotOptimize(pool->Get(id));
+    ABSL_CHECK(pool->Delete(id));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SharedStatePoolRegisterDelete)->ThreadRange(1, NumCPUs());
+
+}  // namespace local_service
+}  // namespace zetasql
@@ -0,0 +1,142 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/local_service/state.h"
+
+#include <cstdint>
+#include <memory>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/synchronization/mutex.h"
+
+namespace zetasql {
+namespace local_service {
+namespace {
+
+using ::testing::UnorderedElementsAre;
+
+class TestState : public GenericState {
+ public:
+  explicit TestState(int64_t memory_usage = 0) : memory_usage_(memory_usage) {}
+
+  int64_t ApproximateMemoryUsage() const override { return memory_usage_; }
+
+ private:
+  const int64_t memory_usage_;
+};
+
+TEST(SharedStatePoolTest, RegisterGetDelete) {
+  SharedStatePool<TestState> pool;
+  auto state = std::make_shared<TestState>();
+  const int64_t id = pool.Register(state);
+  ASSERT_NE(id, -1);
+  EXPECT_EQ(state->GetId(), id);
+  EXPECT_TRUE(pool.Has(id));
+  EXPECT_EQ(pool.Get(id), state);
+  EXPECT_EQ(pool.NumSavedStates(), 1);
+
+  // A state can only be registered once.
+  EXPECT_EQ(pool.Register(state), -1);
+  EXPECT_EQ(pool.Register(std::shared_ptr<TestState>()), -1);
+
+  EXPECT_TRUE(pool.Delete(id));
+  EXPECT_FALSE(pool.Has(id));
+  EXPECT_EQ(pool.Get(id), nullptr);
+  EXPECT_FALSE(pool.Delete(id));
+  EXPECT_EQ(pool.NumSavedStates(), 0);
+}
+
+TEST(SharedStatePoolTest, Replace) {
+  SharedStatePool<TestState> pool;
+  auto state = std::make_shared<TestState>(10);
+  const int64_t id = pool.Register(state);
+  auto replacement = std::make_shared<TestState>(15);
+  EXPECT_FALSE(pool.Replace(id, replacement, std::make_shared<TestState>()));
+  EXPECT_TRUE(pool.Replace(id, state, replacement));
+  EXPECT_EQ(replacement->GetId(), id);
+  EXPECT_EQ(pool.Get(id), replacement);
+  EXPECT_EQ(pool.ApproximateMemoryUsage(), 15);
+  // <replacement> is registered now.
+  EXPECT_FALSE(pool.Replace(id, replacement, replacement));
+}
+
+TEST(SharedStatePoolTest, ApproximateMemoryUsage) {
+  SharedStatePool<TestState> pool;
+  const int64_t id1 = pool.Register(std::make_shared<TestState>(100));
+  const int64_t id2 = pool.Register(new TestState(20));
+  EXPECT_EQ(pool.ApproximateMemoryUsage(), 120);
+  pool.Delete(id1);
+  EXPECT_EQ(pool.ApproximateMemoryUsage(), 20);
+  pool.Delete(id2);
+  EXPECT_EQ(pool.ApproximateMemoryUsage(), 0);
+}
+
+TEST(SharedStatePoolTest, TakeIdleStates) {
+  SharedStatePool<TestState> pool;
+  auto used = std::make_shared<TestState>(1);
+  auto idle = std::make_shared<TestState>(2);
+  const int64_t used_id = pool.Register(used);
+  pool.Register(idle);
+
+  // Both were registered in the first period.
+  EXPECT_TRUE(pool.TakeIdleStates().empty());
+
+  pool.Get(used_id);
+  EXPECT_THAT(pool.TakeIdleStates(), UnorderedElementsAre(idle));
+  EXPECT_EQ(pool.NumSavedStates(), 1);
+  EXPECT_EQ(pool.ApproximateMemoryUsage(), 1);
+
+  auto registered = std::make_shared<TestState>(4);
+  pool.Register(registered);
+  EXPECT_THAT(pool.TakeIdleStates(), UnorderedElementsAre(used));
+  EXPECT_THAT(pool.TakeIdleStates(), UnorderedElementsAre(registered));
+  EXPECT_EQ(pool.NumSavedStates(), 0);
+  EXPECT_EQ(pool.ApproximateMemoryUsage(), 0);
+}
+
+TEST(SharedStatePoolTest, ConcurrentRegisterAndGet) {
+  constexpr int kNumThreads = 8;
+  constexpr int kNumStatesPerThread = 200;
+  SharedStatePool<TestState> pool;
+  absl::Mutex mutex;
+  absl::flat_hash_set<int64_t> ids;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&] {
+      for (int j = 0; j < kNumStatesPerThread; ++j) {
+        auto state = std::make_shared<TestState>(1);
+        const int64_t id = pool.Register(state);
+        ASSERT_NE(id, -1);
+        ASSERT_EQ(pool.Get(id), state);
+        absl::MutexLock lock(&mutex);
+        ASSERT_TRUE(ids.insert(id).second);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(pool.NumSavedStates(), kNumThreads * kNumStatesPerThread);
+  EXPECT_EQ(pool.ApproximateMemoryUsage(), kNumThreads * kNumStatesPerThread);
+}
+
+}  // namespace
+}  // namespace local_service
+}  // namespace zetasql
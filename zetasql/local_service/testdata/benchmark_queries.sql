@@ -0,0 +1,89 @@
+# Queries used by local_service_benchmark. They run against the tables
+#   Orders(order_id INT64, customer STRING, amount DOUBLE, quantity INT64,
+#          status STRING)
+#   Customers(name STRING, region STRING)
+# Statements are separated by a semicolon at the end of a line. Lines starting
+# with '#' are ignored.
+#
+# Keep the existing queries stable so that results stay comparable across
+# versions; add new ones at the end.
+
+# Point lookup.
+SELECT order_id, amount FROM Orders WHERE order_id = 42;
+
+# Filter and projection with expressions.
+SELECT order_id, amount * quantity AS total, UPPER(status) AS status
+FROM Orders
+WHERE amount > 10.5 AND status IN ('open', 'shipped');
+
+# Aggregation.
+SELECT customer, COUNT(*) AS orders, SUM(amount) AS amount,
+       AVG(quantity) AS avg_quantity
+FROM Orders
+GROUP BY customer
+HAVING COUNT(*) > 1
+ORDER BY amount DESC
+LIMIT 10;
+
+# Join.
+SELECT c.region, SUM(o.amount) AS amount
+FROM Orders AS o JOIN Customers AS c ON o.customer = c.name
+GROUP BY c.region;
+
+# Window functions.
+SELECT order_id, customer,
+       ROW_NUMBER() OVER (PARTITION BY customer ORDER BY amount DESC) AS position,
+       SUM(amount) OVER (PARTITION BY customer ORDER BY order_id
+                         ROWS BETWEEN 2 PRECEDING AND CURRENT ROW) AS running
+FROM Orders;
+
+# Subqueries.
+SELECT name, region
+FROM Customers AS c
+WHERE EXISTS (SELECT 1 FROM Orders AS o
+              WHERE o.customer = c.name AND o.amount > 100)
+  AND region IN (SELECT region FROM Customers GROUP BY region
+                 HAVING COUNT(*) > 2);
+
+# WITH clause and set operation.
+WITH big AS (SELECT customer FROM Orders WHERE amount > 100),
+     small AS (SELECT customer FROM Orders WHERE amount < 10)
+SELECT customer FROM big
+UNION DISTINCT
+SELECT customer FROM small;
+
+# String functions.
+SELECT CONCAT(customer, '-', CAST(order_id AS STRING)) AS key,
+       REGEXP_CONTAINS(status, r'^(open|new)$') AS is_open,
+       SUBSTR(customer, 1, 3) AS prefix,
+       LENGTH(TRIM(status)) AS status_length
+FROM Orders;
+
+# Conditional expressions.
+SELECT order_id,
+       CASE WHEN amount > 100 THEN 'large'
+            WHEN amount > 10 THEN 'medium'
+            ELSE 'small' END AS size,
+       IF(quantity IS NULL, 0, quantity) AS quantity,
+       COALESCE(status, 'unknown') AS status
+FROM Orders;
+
+# Arrays and UNNEST.
+SELECT customer, ARRAY_AGG(order_id ORDER BY order_id) AS order_ids
+FROM Orders, UNNEST([1, 2, 3]) AS x
+WHERE x <= quantity
+GROUP BY customer;
+
+# Struct construction.
+SELECT STRUCT(order_id AS id, amount, STRUCT(customer, status) AS detail) AS s
+FROM Orders
+ORDER BY order_id
+LIMIT 100;
+
+# Wide projection.
+SELECT order_id + 1 AS c1, order_id + 2 AS c2, order_id + 3 AS c3,
+       order_id + 4 AS c4, order_id + 5 AS c5, order_id + 6 AS c6,
+       amount / 2 AS c7, amount / 3 AS c8, amount / 4 AS c9,
+       quantity * 2 AS c10, quantity * 3 AS c11, quantity * 4 AS c12,
+       LOWER(customer) AS c13, UPPER(customer) AS c14, status AS c15
+FROM Orders;
@@ -0,0 +1,200 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/parser/incremental_parser.h"
+
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "zetasql/base/arena.h"
+#include "zetasql/parser/ast_node.h"
+#include "zetasql/parser/parser.h"
+#include "zetasql/public/parse_location.h"
+#include "zetasql/public/parse_resume_location.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+
+namespace zetasql {
+
+namespace {
+
+// Arena block size used for the ASTs of individual statements.  Statements in
+// an editor buffer are usually small, so this is smaller than the default
+// used by ParserOptions::CreateDefaultArenasIfNotSet().
+constexpr int kStatementArenaBlockSize = 4 * 1024;
+
+ParseLocationPoint ShiftPoint(const ParseLocationPoint& point, int delta) {
+  if (!point.IsValid()) return point;
+  return ParseLocationPoint::FromByteOffset(point.filename(),
+                                            point.GetByteOffset() + delta);
+}
+
+// Moves the parse locations of every node in the tree rooted at <root> by
+// <delta> bytes.  Non-recursive, so it is safe for deep trees.
+void ShiftParseLocations(ASTNode* root, int delta) {
+  std::vector<ASTNode*> stack = {root};
+  while (!stack.empty()) {
+    ASTNode* node = stack.back();
+    stack.pop_back();
+    const ParseLocationRange& range = node->GetParseLocationRange();
+    const ParseLocationPoint start = ShiftPoint(range.start(), delta);
+    const ParseLocationPoint end = ShiftPoint(range.end(), delta);
+    node->set_start_location(start);
+    node->set_end_location(end);
+    for (int i = 0; i < node->num_children(); ++i) {
+      stack.push_back(node->mutable_child(i));
+    }
+  }
+}
+
+}  // namespace
+
+IncrementalParser::IncrementalParser(absl::string_view filename,
+                                     std::string input,
+                                     LanguageOptions language_options)
+    : filename_(filename),
+      input_(std::move(input)),
+      language_options_(std::move(language_options)),
+      id_string_pool_(std::make_shared<IdStringPool>()) {}
+
+absl::StatusOr<std::unique_ptr<IncrementalParser>> IncrementalParser::Create(
+    absl::string_view filename, std::string input,
+    LanguageOptions language_options) {
+  if (input.size() > std::numeric_limits<int>::max()) {
+    return absl::InvalidArgumentError(
+        "Input is too large for IncrementalParser");
+  }
+  // Using `new` to access the private constructor.
+  std::unique_ptr<IncrementalParser> parser(new IncrementalParser(
+      filename, std::move(input), std::move(language_options)));
+  parser->ParseFrom(/*byte_offset=*/0, /*reusable_statements=*/{},
+                    /*reusable_statements_reach_end=*/false);
+  return parser;
+}
+
+absl::Status IncrementalParser::ApplyEdit(int byte_offset, int old_length,
+                                          absl::string_view new_text) {
+  if (byte_offset < 0 || old_length < 0 ||
+      byte_offset > static_cast<int>(input_.size()) ||
+      old_length > static_cast<int>(input_.size()) - byte_offset) {
+    return absl::OutOfRangeError(absl::StrCat(
+        "Edit of ", old_length, " bytes at offset ", byte_offset,
+        " is outside of the input of size ", input_.size()));
+  }
+  if (input_.size() - old_length + new_text.size() >
+      std::numeric_limits<int>::max()) {
+    return absl::InvalidArgumentError(
+        "Input is too large for IncrementalParser");
+  }
+  const int old_edit_end = byte_offset + old_length;
+  const int delta = static_cast<int>(new_text.size()) - old_length;
+  input_.replace(byte_offset, old_length, new_text.data(), new_text.size());
+
+  // Find the statement containing the byte just before the edit, and restart
+  // parsing one statement earlier than that.  The statement before the edited
+  // one is reparsed because whether it ends the input, and where its
+  // terminating semicolon is, can depend on the edited text.
+  size_t first_reparsed = 0;
+  while (first_reparsed + 1 < statements_.size() &&
+         statements_[first_reparsed + 1].start_byte_offset < byte_offset) {
+    ++first_reparsed;
+  }
+  if (first_reparsed > 0) --first_reparsed;
+  // Read before the loop below, which may shift and move this statement when
+  // the edit is at its start.
+  const int restart_byte_offset =
+      statements_.empty() ? 0 : statements_[first_reparsed].start_byte_offset;
+
+  // Statements that start at or after the end of the edited range can be
+  // reused once parsing gets back in sync with them.  Shift them to their
+  // positions in the edited buffer.
+  std::vector<Statement> reusable_statements;
+  for (size_t i = first_reparsed; i < statements_.size(); ++i) {
+    Statement& statement = statements_[i];
+    if (statement.start_byte_offset < old_edit_end) continue;
+    statement.start_byte_offset += delta;
+    statement.end_byte_offset += delta;
+    if (delta != 0) {
+      // We own the ParserOutput, so it is safe to modify the tree in place.
+      ShiftParseLocations(
+          const_cast<ASTStatement*>(statement.parser_output->statement()),
+          delta);
+    }
+    reusable_statements.push_back(std::move(statement));
+  }
+  const bool reusable_statements_reach_end =
+      parse_status_.ok() && !reusable_statements.empty();
+
+  statements_.resize(first_reparsed);
+  ParseFrom(restart_byte_offset, std::move(reusable_statements),
+            reusable_statements_reach_end);
+  return absl::OkStatus();
+}
+
+void IncrementalParser::ParseFrom(int byte_offset,
+                                  std::vector<Statement> reusable_statements,
+                                  bool reusable_statements_reach_end) {
+  parse_status_ = absl::OkStatus();
+  num_statements_parsed_by_last_update_ = 0;
+
+  ParseResumeLocation resume_location =
+      ParseResumeLocation::FromStringView(filename_, input_);
+  resume_location.set_byte_position(byte_offset);
+  size_t next_reusable = 0;
+  bool at_end_of_input = false;
+  while (!at_end_of_input) {
+    const int position = resume_location.byte_position();
+    while (next_reusable < reusable_statements.size() &&
+           reusable_statements[next_reusable].start_byte_offset < position) {
+      ++next_reusable;
+    }
+    if (next_reusable < reusable_statements.size() &&
+        reusable_statements[next_reusable].start_byte_offset == position) {
+      // Back in sync with the previous parse; reuse the rest of it.
+      for (size_t i = next_reusable; i < reusable_statements.size(); ++i) {
+        statements_.push_back(std::move(reusable_statements[i]));
+      }
+      reusable_statements.clear();
+      if (reusable_statements_reach_end) return;
+      // The previous parse stopped at a syntax error after the reused
+      // statements, so continue parsing from there.
+      resume_location.set_byte_position(statements_.back().end_byte_offset);
+      continue;
+    }
+
+    ParserOptions parser_options(
+        id_string_pool_,
+        std::make_shared<zetasql_base::UnsafeArena>(kStatementArenaBlockSize),
+        language_options_);
+    std::unique_ptr<ParserOutput> parser_output;
+    parse_status_ = ParseNextStatement(&resume_location, parser_options,
+                                       &parser_output, &at_end_of_input);
+    ++num_statements_parsed_by_last_update_;
+    if (!parse_status_.ok()) return;
+    statements_.push_back(Statement{
+        .start_byte_offset = position,
+        .end_byte_offset = resume_location.byte_position(),
+        .parser_output = std::move(parser_output)});
+  }
+}
+
+}  // namespace zetasql
@@ -0,0 +1,128 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef ZETASQL_PARSER_INCREMENTAL_PARSER_H_
+#define ZETASQL_PARSER_INCREMENTAL_PARSER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "zetasql/parser/parser.h"
+#include "zetasql/public/id_string.h"
+#include "zetasql/public/language_options.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+
+namespace zetasql {
+
+// Keeps the parse of a buffer containing multiple statements up to date as the
+// buffer is edited, for editor-style workloads that reparse on every
+// keystroke.
+//
+// The buffer is split into statements exactly as a loop over
+// ParseNextStatement() would split it.  Each statement is held in its own
+// ParserOutput.  On ApplyEdit(), only the statements overlapping the edit
+// (plus the one before it, whose end-of-input detection and terminating
+// semicolon may depend on the edited text) are re-tokenized and reparsed.
+// Reparsing continues until a reparsed statement ends exactly where an old
+// statement after the edit starts; from there on, the old ParserOutputs are
+// reused with their parse locations shifted by the size difference of the
+// edit.
+//
+// All statements share one IdStringPool, so identifiers in reused and
+// reparsed statements come from the same pool.  Every statement gets its own
+// arena, so the memory for replaced statements is released.
+//
+// Parse locations in the warnings() of reused ParserOutputs are not shifted.
+//
+// Not thread-safe.
+class IncrementalParser {
+ public:
+  // A successfully parsed statement and the byte range of the buffer it was
+  // parsed from.  The range runs from the resume position where parsing of
+  // the statement started up to the resume position of the next statement
+  // (or the end of the buffer, for the last statement), so consecutive
+  // statements have adjacent ranges.
+  struct Statement {
+    int start_byte_offset = 0;
+    int end_byte_offset = 0;
+    std::unique_ptr<ParserOutput> parser_output;
+  };
+
+  // Parses all of <input>.  Only invalid arguments result in an error; a
+  // syntax error in <input> is reported through parse_status().
+  //
+  // <filename> is used in parse locations, as in ParseResumeLocation.
+  static absl::StatusOr<std::unique_ptr<IncrementalParser>> Create(
+      absl::string_view filename, std::string input,
+      LanguageOptions language_options = LanguageOptions());
+
+  IncrementalParser(const IncrementalParser&) = delete;
+  IncrementalParser& operator=(const IncrementalParser&) = delete;
+
+  // Replaces the <old_length> bytes starting at <byte_offset> with
+  // <new_text> and updates the parse.  Returns an error only if the edit
+  // range is outside of the current buffer.
+  absl::Status ApplyEdit(int byte_offset, int old_length,
+                         absl::string_view new_text);
+
+  // The current contents of the buffer.
+  absl::string_view input() const { return input_; }
+
+  // The statements parsed from the beginning of the buffer, in order.  If
+  // parse_status() is an error, this covers the statements preceding the
+  // first statement that failed to parse.
+  const std::vector<Statement>& statements() const { return statements_; }
+
+  // OK if the whole buffer was parsed, otherwise the syntax error for the
+  // first statement that could not be parsed.
+  const absl::Status& parse_status() const { return parse_status_; }
+
+  // The number of statements that were parsed by the last call to Create()
+  // or ApplyEdit(), as opposed to reused.  Mostly useful for testing.
+  int num_statements_parsed_by_last_update() const {
+    return num_statements_parsed_by_last_update_;
+  }
+
+ private:
+  IncrementalParser(absl::string_view filename, std::string input,
+                    LanguageOptions language_options);
+
+  // Parses statements starting at <byte_offset>, appending them to
+  // statements_.  <reusable_statements> are statements from a previous parse
+  // that follow the edited text, already shifted to positions in the current
+  // buffer; once a parsed statement ends where one of them starts, that
+  // statement and all following ones are reused.
+  // <reusable_statements_reach_end> tells whether the last of them ended at
+  // the end of the buffer.
+  void ParseFrom(int byte_offset, std::vector<Statement> reusable_statements,
+                 bool reusable_statements_reach_end);
+
+  const std::string filename_;
+  std::string input_;
+  const LanguageOptions language_options_;
+  const std::shared_ptr<IdStringPool> id_string_pool_;
+
+  std::vector<Statement> statements_;
+  absl::Status parse_status_;
+  int num_statements_parsed_by_last_update_ = 0;
+};
+
+}  // namespace zetasql
+
+#endif  // ZETASQL_PARSER_INCREMENTAL_PARSER_H_
@@ -0,0 +1,184 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/parser/incremental_parser.h"
+
+#include <memory>
+#include <string>
+
+#include "zetasql/base/testing/status_matchers.h"
+#include "zetasql/parser/parser.h"
+#include "zetasql/public/parse_resume_location.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+
+namespace zetasql {
+namespace {
+
+using ::zetasql_base::testing::StatusIs;
+
+// Checks that <parser> holds exactly what parsing its whole input from
+// scratch with ParseNextStatement() produces, including parse locations.
+void ExpectMatchesFullParse(const IncrementalParser& parser) {
+  ParseResumeLocation resume_location =
+      ParseResumeLocation::FromStringView("file", parser.input());
+  bool at_end_of_input = false;
+  int index = 0;
+  absl::Status status;
+  while (!at_end_of_input) {
+    const int start = resume_location.byte_position();
+    std::unique_ptr<ParserOutput> parser_output;
+    status = ParseNextStatement(&resume_location, ParserOptions(),
+                                &parser_output, &at_end_of_input);
+    if (!status.ok()) break;
+    ASSERT_LT(index, parser.statements().size());
+    const IncrementalParser::Statement& statement = parser.statements()[index];
+    EXPECT_EQ(statement.start_byte_offset, start);
+    EXPECT_EQ(statement.end_byte_offset, resume_location.byte_position());
+    EXPECT_EQ(statement.parser_output->statement()->DebugString(),
+              parser_output->statement()->DebugString());
+    ++index;
+  }
+  EXPECT_EQ(index, parser.statements().size());
+  EXPECT_EQ(status, parser.parse_status());
+}
+
+TEST(IncrementalParserTest, InitialParse) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<IncrementalParser> parser,
+      IncrementalParser::Create("file", "SELECT 1;\nSELECT 2;\nSELECT 3"));
+  EXPECT_EQ(parser->statements().size(), 3);
+  EXPECT_EQ(parser->num_statements_parsed_by_last_update(), 3);
+  ZETASQL_EXPECT_OK(parser->parse_status());
+  ExpectMatchesFullParse(*parser);
+}
+
+TEST(IncrementalParserTest, EditReparsesOnlyNeighboringStatements) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<IncrementalParser> parser,
+      IncrementalParser::Create(
+          "file", "SELECT 1;\nSELECT 2;\nSELECT 3;\nSELECT 4;\nSELECT 5"));
+
+  // "SELECT 3" -> "SELECT 345".  Statements 2 and 3 are reparsed, statements
+  // 4 and 5 are reused with shifted locations.
+  ZETASQL_ASSERT_OK(parser->ApplyEdit(28, 0, "45"));
+  EXPECT_EQ(parser->input(),
+            "SELECT 1;\nSELECT 2;\nSELECT 345;\nSELECT 4;\nSELECT 5");
+  EXPECT_EQ(parser->num_statements_parsed_by_last_update(), 2);
+  ExpectMatchesFullParse(*parser);
+
+  // Edit the first statement.  Only it is reparsed.
+  ZETASQL_ASSERT_OK(parser->ApplyEdit(7, 1, "a + b"));
+  EXPECT_EQ(parser->input(),
+            "SELECT a + b;\nSELECT 2;\nSELECT 345;\nSELECT 4;\nSELECT 5");
+  EXPECT_EQ(parser->num_statements_parsed_by_last_update(), 1);
+  ExpectMatchesFullParse(*parser);
+}
+
+TEST(IncrementalParserTest, EditAtEndOfInput) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<IncrementalParser> parser,
+                       IncrementalParser::Create("file", "SELECT 1;\nSELECT 2"));
+  ZETASQL_ASSERT_OK(parser->ApplyEdit(18, 0, ";\nSELECT 3"));
+  EXPECT_EQ(parser->statements().size(), 3);
+  ExpectMatchesFullParse(*parser);
+
+  // Removing the last statement makes the previous one end the input.
+  ZETASQL_ASSERT_OK(parser->ApplyEdit(18, 10, ""));
+  EXPECT_EQ(parser->input(), "SELECT 1;\nSELECT 2");
+  EXPECT_EQ(parser->statements().size(), 2);
+  ExpectMatchesFullParse(*parser);
+}
+
+TEST(IncrementalParserTest, EditAtStartOfInput) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<IncrementalParser> parser,
+                       IncrementalParser::Create("file", "SELECT 1;\nSELECT 2"));
+  ZETASQL_ASSERT_OK(parser->ApplyEdit(0, 0, "SELECT 0;\n"));
+  EXPECT_EQ(parser->input(), "SELECT 0;\nSELECT 1;\nSELECT 2");
+  EXPECT_EQ(parser->statements().size(), 3);
+  ExpectMatchesFullParse(*parser);
+
+  ZETASQL_ASSERT_OK(parser->ApplyEdit(0, 6, "select"));
+  EXPECT_EQ(parser->input(), "select 0;\nSELECT 1;\nSELECT 2");
+  EXPECT_EQ(parser->statements().size(), 3);
+  ExpectMatchesFullParse(*parser);
+}
+
+TEST(IncrementalParserTest, MergingAndSplittingStatements) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<IncrementalParser> parser,
+      IncrementalParser::Create("file", "SELECT 1;\nSELECT 2;\nSELECT 3"));
+
+  // Deleting a semicolon makes a syntax error, after which nothing is parsed.
+  ZETASQL_ASSERT_OK(parser->ApplyEdit(8, 1, ""));
+  EXPECT_THAT(parser->parse_status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_EQ(parser->statements().size(), 0);
+  ExpectMatchesFullParse(*parser);
+
+  // Putting it back parses everything again.
+  ZETASQL_ASSERT_OK(parser->ApplyEdit(8, 0, ";"));
+  ZETASQL_EXPECT_OK(parser->parse_status());
+  EXPECT_EQ(parser->statements().size(), 3);
+  ExpectMatchesFullParse(*parser);
+
+  // Opening a string literal swallows the following statements.
+  ZETASQL_ASSERT_OK(parser->ApplyEdit(17, 1, "'"));
+  EXPECT_THAT(parser->parse_status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  ExpectMatchesFullParse(*parser);
+
+  ZETASQL_ASSERT_OK(parser->ApplyEdit(17, 1, "2"));
+  ZETASQL_EXPECT_OK(parser->parse_status());
+  ExpectMatchesFullParse(*parser);
+}
+
+TEST(IncrementalParserTest, EditAfterSyntaxError) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<IncrementalParser> parser,
+      IncrementalParser::Create("file", "SELECT 1;\nSELECT 2;\nSELECT FROM"));
+  EXPECT_THAT(parser->parse_status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_EQ(parser->statements().size(), 2);
+
+  // An edit before the error reuses the statements following it and then
+  // reports the error again.
+  ZETASQL_ASSERT_OK(parser->ApplyEdit(7, 1, "11"));
+  EXPECT_THAT(parser->parse_status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  ExpectMatchesFullParse(*parser);
+
+  ZETASQL_ASSERT_OK(parser->ApplyEdit(28, 4, "3"));
+  ZETASQL_EXPECT_OK(parser->parse_status());
+  EXPECT_EQ(parser->statements().size(), 3);
+  ExpectMatchesFullParse(*parser);
+}
+
+TEST(IncrementalParserTest, EditOutOfRange) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<IncrementalParser> parser,
+                       IncrementalParser::Create("file", "SELECT 1"));
+  EXPECT_THAT(parser->ApplyEdit(9, 0, "x"),
+              StatusIs(absl::StatusCode::kOutOfRange));
+  EXPECT_THAT(parser->ApplyEdit(4, 5, "x"),
+              StatusIs(absl::StatusCode::kOutOfRange));
+  EXPECT_THAT(parser->ApplyEdit(-1, 0, "x"),
+              StatusIs(absl::StatusCode::kOutOfRange));
+  EXPECT_EQ(parser->input(), "SELECT 1");
+}
+
+}  // namespace
+}  // namespace zetasql
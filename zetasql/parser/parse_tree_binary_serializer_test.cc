@@ -0,0 +1,169 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/parser/parse_tree_binary_serializer.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "zetasql/base/testing/status_matchers.h"
+#include "zetasql/parser/ast_node.h"
+#include "zetasql/parser/parse_tree.h"
+#include "zetasql/parser/parse_tree_serializer.h"
+#include "zetasql/parser/parser.h"
+#include "zetasql/public/error_helpers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+
+namespace zetasql {
+namespace {
+
+using ::zetasql_base::testing::StatusIs;
+
+// Checks that the trees rooted at <expected> and <actual> have the same
+// shape and parse locations in every node.
+void ExpectSameLocations(const ASTNode* expected, const ASTNode* actual) {
+  ASSERT_EQ(expected->node_kind(), actual->node_kind());
+  EXPECT_EQ(expected->GetParseLocationRange(), actual->GetParseLocationRange())
+      << expected->GetNodeKindString();
+  ASSERT_EQ(expected->num_children(), actual->num_children());
+  for (int i = 0; i < expected->num_children(); ++i) {
+    ExpectSameLocations(expected->child(i), actual->child(i));
+  }
+}
+
+void ExpectSameTree(const ASTNode* expected, const ASTNode* actual) {
+  ASSERT_NE(actual, nullptr);
+  EXPECT_EQ(expected->DebugString(), actual->DebugString());
+  EXPECT_EQ(Unparse(expected), Unparse(actual));
+  ExpectSameLocations(expected, actual);
+}
+
+TEST(ParseTreeBinarySerializerTest, Statements) {
+  const std::vector<std::string> statements = {
+      "SELECT 1",
+      "SELECT a.b, `quoted id`, 'str', b'bytes', 1.5, NULL, TRUE "
+      "FROM t1 AS x LEFT JOIN t2 USING (k) "
+      "WHERE x.y > 5 AND NOT z GROUP BY 1 ORDER BY 2 DESC LIMIT 10",
+      "SELECT * EXCEPT (a) FROM t WINDOW w AS (PARTITION BY a ORDER BY b "
+      "ROWS BETWEEN 2 PRECEDING AND CURRENT ROW)",
+      "SELECT CAST(x AS STRUCT<a INT64, b ARRAY<STRING>>) FROM t "
+      "UNION ALL SELECT ARRAY_AGG(DISTINCT y IGNORE NULLS) FROM u",
+      "CREATE OR REPLACE TEMP FUNCTION f(x INT64) RETURNS INT64 AS (x + 1)",
+      "CREATE TABLE IF NOT EXISTS t (a INT64 NOT NULL, b STRING) "
+      "OPTIONS (description = 'd')",
+      "INSERT INTO t (a, b) VALUES (1, 'x'), (2, 'y')",
+      "MERGE t USING s ON t.a = s.a WHEN MATCHED THEN DELETE "
+      "WHEN NOT MATCHED THEN INSERT ROW",
+      "DROP TABLE IF EXISTS a.b.c",
+  };
+  for (const std::string& sql : statements) {
+    SCOPED_TRACE(sql);
+    std::unique_ptr<ParserOutput> parser_output;
+    ZETASQL_ASSERT_OK(ParseStatement(sql, ParserOptions(), &parser_output));
+
+    std::string serialized;
+    ZETASQL_ASSERT_OK(ParseTreeBinarySerializer::Serialize(
+        parser_output->statement(), &serialized));
+    ZETASQL_ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<ParserOutput> deserialized,
+        ParseTreeBinarySerializer::Deserialize(serialized, ParserOptions()));
+    ExpectSameTree(parser_output->statement(), deserialized->statement());
+  }
+}
+
+TEST(ParseTreeBinarySerializerTest, ExpressionTypeAndScript) {
+  std::unique_ptr<ParserOutput> parser_output;
+  std::string serialized;
+
+  ZETASQL_ASSERT_OK(ParseExpression("CASE WHEN a IN (1, 2) THEN -b ELSE c.d END",
+                            ParserOptions(), &parser_output));
+  ZETASQL_ASSERT_OK(ParseTreeBinarySerializer::Serialize(parser_output->expression(),
+                                                 &serialized));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<ParserOutput> deserialized,
+      ParseTreeBinarySerializer::Deserialize(serialized, ParserOptions()));
+  ExpectSameTree(parser_output->expression(), deserialized->expression());
+
+  serialized.clear();
+  ZETASQL_ASSERT_OK(ParseType("ARRAY<STRUCT<x INT64, y STRING>>", ParserOptions(),
+                      &parser_output));
+  ZETASQL_ASSERT_OK(
+      ParseTreeBinarySerializer::Serialize(parser_output->type(), &serialized));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      deserialized,
+      ParseTreeBinarySerializer::Deserialize(serialized, ParserOptions()));
+  ExpectSameTree(parser_output->type(), deserialized->type());
+
+  serialized.clear();
+  ZETASQL_ASSERT_OK(ParseScript(
+      "DECLARE x INT64 DEFAULT 1;\nIF x > 0 THEN\n  SELECT x;\nEND IF;",
+      ParserOptions(), ERROR_MESSAGE_WITH_PAYLOAD,
+      /*keep_error_location_payload=*/false, &parser_output));
+  ZETASQL_ASSERT_OK(
+      ParseTreeBinarySerializer::Serialize(parser_output->script(), &serialized));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      deserialized,
+      ParseTreeBinarySerializer::Deserialize(serialized, ParserOptions()));
+  ExpectSameTree(parser_output->script(), deserialized->script());
+}
+
+TEST(ParseTreeBinarySerializerTest, SmallerThanProto) {
+  std::unique_ptr<ParserOutput> parser_output;
+  ZETASQL_ASSERT_OK(ParseStatement(
+      "SELECT a, b, c, a + b * c FROM t WHERE a = b AND b = c",
+      ParserOptions(), &parser_output));
+
+  std::string serialized;
+  ZETASQL_ASSERT_OK(ParseTreeBinarySerializer::Serialize(parser_output->statement(),
+                                                 &serialized));
+  AnyASTStatementProto proto;
+  ZETASQL_ASSERT_OK(ParseTreeSerializer::Serialize(parser_output->statement(), &proto));
+  EXPECT_LT(serialized.size(), proto.ByteSizeLong());
+}
+
+TEST(ParseTreeBinarySerializerTest, InvalidInput) {
+  EXPECT_THAT(ParseTreeBinarySerializer::Deserialize("", ParserOptions()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(
+      ParseTreeBinarySerializer::Deserialize("not a tree", ParserOptions()),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+
+  std::unique_ptr<ParserOutput> parser_output;
+  ZETASQL_ASSERT_OK(ParseStatement("SELECT x FROM t WHERE y = 'z'", ParserOptions(),
+                           &parser_output));
+  std::string serialized;
+  ZETASQL_ASSERT_OK(ParseTreeBinarySerializer::Serialize(parser_output->statement(),
+                                                 &serialized));
+
+  // Every truncation of a valid buffer is rejected.
+  for (int size = 0; size < serialized.size(); ++size) {
+    EXPECT_THAT(ParseTreeBinarySerializer::Deserialize(
+                    absl::string_view(serialized).substr(0, size),
+                    ParserOptions()),
+                StatusIs(absl::StatusCode::kInvalidArgument))
+        << size;
+  }
+  EXPECT_THAT(
+      ParseTreeBinarySerializer::Deserialize(serialized + "x", ParserOptions()),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace zetasql
@@ -0,0 +1,126 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Benchmarks for the tokenizer and parser over synthetic corpora that are
+// representative of machine-generated SQL: long IN-lists, huge string
+// literals, wide SELECT lists and heavily commented queries.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "zetasql/base/logging.h"
+#include "zetasql/parser/parser.h"
+#include "zetasql/public/parse_resume_location.h"
+#include "zetasql/public/parse_tokens.h"
+#include "benchmark/benchmark.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+
+namespace zetasql {
+namespace {
+
+// SELECT * FROM t WHERE x IN (0, 1, ..., <num_elements>-1)
+std::string MakeLongInList(int num_elements) {
+  std::vector<std::string> elements;
+  elements.reserve(num_elements);
+  for (int i = 0; i < num_elements; ++i) {
+    elements.push_back(absl::StrCat(i));
+  }
+  return absl::StrCat("SELECT * FROM t WHERE x IN (",
+                      absl::StrJoin(elements, ", "), ")");
+}
+
+// SELECT '<literal>' where the literal is <size> bytes of mostly plain text,
+// with an escape sequence every 1000 bytes.
+std::string MakeLargeStringLiteral(int size) {
+  std::string literal;
+  literal.reserve(size);
+  while (literal.size() < static_cast<size_t>(size)) {
+    literal.append(998, 'a');
+    literal.append("\\n");
+  }
+  literal.resize(size);
+  if (literal.back() == '\\') literal.back() = 'a';
+  return absl::StrCat("SELECT '", literal, "' AS s");
+}
+
+// SELECT with <num_columns> qualified columns, aliases and comments.
+std::string MakeWideSelect(int num_columns) {
+  std::string sql = "SELECT\n";
+  for (int i = 0; i < num_columns; ++i) {
+    absl::StrAppend(&sql, i == 0 ? "  " : ",\n  ", "some_table.column_", i,
+                    " AS alias_", i, "  -- column ", i, "\n  /* block */");
+  }
+  absl::StrAppend(&sql, "\nFROM some_dataset.some_table");
+  return sql;
+}
+
+void RunGetParseTokens(benchmark::State& state, const std::string& sql) {
+  ParseTokenOptions options;
+  for (auto s : state) {
+    ParseResumeLocation location = ParseResumeLocation::FromStringView(sql);
+    std::vector<ParseToken> tokens;
+    ZETASQL_CHECK_OK(GetParseTokens(options, &location, &tokens));
+    benchmark::DoNotOptimize(tokens);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          sql.size());
+}
+
+void RunParseStatement(benchmark::State& state, const std::string& sql) {
+  for (auto s : state) {
+    std::unique_ptr<ParserOutput> parser_output;
+    ZETASQL_CHECK_OK(ParseStatement(sql, ParserOptions(), &parser_output));
+    benchmark::DoNotOptimize(parser_output);
+  }
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          sql.size());
+}
+
+void BM_GetParseTokensLongInList(benchmark::State& state) {
+  RunGetParseTokens(state, MakeLongInList(state.range(0)));
+}
+BENCHMARK(BM_GetParseTokensLongInList)->Range(16, 16 << 10);
+
+void BM_GetParseTokensLargeStringLiteral(benchmark::State& state) {
+  RunGetParseTokens(state, MakeLargeStringLiteral(state.range(0)));
+}
+BENCHMARK(BM_GetParseTokensLargeStringLiteral)->Range(1 << 10, 4 << 20);
+
+void BM_GetParseTokensWideSelect(benchmark::State& state) {
+  RunGetParseTokens(state, MakeWideSelect(state.range(0)));
+}
+BENCHMARK(BM_GetParseTokensWideSelect)->Range(16, 4 << 10);
+
+void BM_ParseStatementLongInList(benchmark::State& state) {
+  RunParseStatement(state, MakeLongInList(state.range(0)));
+}
+BENCHMARK(BM_ParseStatementLongInList)->Range(16, 16 << 10);
+
+void BM_ParseStatementLargeStringLiteral(benchmark::State& state) {
+  RunParseStatement(state, MakeLargeStringLiteral(state.range(0)));
+}
+BENCHMARK(BM_ParseStatementLargeStringLiteral)->Range(1 << 10, 4 << 20);
+
+void BM_ParseStatementWideSelect(benchmark::State& state) {
+  RunParseStatement(state, MakeWideSelect(state.range(0)));
+}
+BENCHMARK(BM_ParseStatementWideSelect)->Range(16, 4 << 10);
+
+}  // namespace
+}  // namespace zetasql
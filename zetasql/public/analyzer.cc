@@ -16,6 +16,8 @@
 
 #include "zetasql/public/analyzer.h"
 
+#include <cstdint>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <thread>
@@ -23,6 +25,7 @@
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "zetasql/base/arena.h"
 #include "zetasql/base/logging.h"
@@ -35,6 +38,7 @@
 #include "zetasql/analyzer/rewrite_resolved_ast.h"
 #include "zetasql/common/errors.h"
 #include "zetasql/common/internal_analyzer_options.h"
+#include "zetasql/common/resolver_stats.h"
 #include "zetasql/common/status_payload_utils.h"
 #include "zetasql/common/timer_util.h"
 #include "zetasql/parser/parse_tree.h"
@@ -56,6 +60,8 @@
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/synchronization/blocking_counter.h"
+#include "absl/types/span.h"
 #include "zetasql/base/map_util.h"
 #include "zetasql/base/source_location.h"
 #include "zetasql/base/ret_check.h"
@@ -94,11 +100,21 @@ static absl::Status FinishAnalyzeStatementImpl(
     std::unique_ptr<const ResolvedStatement>* resolved_statement) {
   ZETASQL_VLOG(5) << "Parsed AST:\n" << ast_statement.DebugString();
   {
+    internal::ResolverStats& resolver_stats =
+        analyzer_runtime_info->resolver_stats();
+    internal::ResolverStats::Scope resolver_stats_scope(&resolver_stats);
+    const int64_t arena_bytes_before =
+        options.arena()->status().bytes_allocated();
     internal::ScopedTimer scoped_resolver_timer =
         internal::MakeScopedTimerStarted(
             &analyzer_runtime_info->resolver_timed_value());
     ZETASQL_RETURN_IF_ERROR(
         resolver->ResolveStatement(sql, &ast_statement, resolved_statement));
+    resolver_stats.add_arena_bytes(options.arena()->status().bytes_allocated() -
+                                   arena_bytes_before);
+    if (InternalAnalyzerOptions::GetRecordResolvedNodeCount(options)) {
+      RecordResolvedNodeCount(resolved_statement->get(), &resolver_stats);
+    }
   }
   ZETASQL_VLOG(3) << "Resolved AST:\n" << (*resolved_statement)->DebugString();
 
@@ -106,8 +122,11 @@ static absl::Status FinishAnalyzeStatementImpl(
     internal::ScopedTimer scoped_validator_timer =
         internal::MakeScopedTimerStarted(
             &analyzer_runtime_info->validator_timed_value());
-    ValidatorOptions validator_options{.allowed_hints_and_options =
-                                           options.allowed_hints_and_options()};
+    ValidatorOptions validator_options{
+        .allowed_hints_and_options = options.allowed_hints_and_options(),
+        .structural_validation_only =
+            InternalAnalyzerOptions::GetValidateResolvedASTStructureOnly(
+                options)};
     Validator validator(options.language(), validator_options);
     ZETASQL_RETURN_IF_ERROR(
         validator.ValidateResolvedStatement(resolved_statement->get()));
@@ -249,6 +268,11 @@ static absl::Status AnalyzeStatementHelper(
             &analyzer_runtime_info.overall_timed_value());
 
     ZETASQL_RET_CHECK(options.AllArenasAreInitialized());
+    // Install a scope even when not allocating in the arena, so that nested
+    // analyses of an opted-in caller don't allocate in its arena.
+    ResolvedNode::ArenaScope arena_scope(
+        options.allocate_resolved_ast_in_arena() ? options.arena().get()
+                                                 : nullptr);
     std::unique_ptr<const ResolvedStatement> resolved_statement;
     Resolver resolver(catalog, type_factory, &options);
     absl::Status status = FinishAnalyzeStatementImpl(
@@ -363,6 +387,133 @@ absl::Status AnalyzeStatementFromParserAST(
   return absl::OkStatus();
 }
 
+namespace {
+
+// One statement of the script being analyzed by AnalyzeStatementsInParallel().
+struct ParallelAnalysisStatement {
+  // Per-statement copy of the caller's options, with private arenas.
+  std::unique_ptr<AnalyzerOptions> options;
+  std::unique_ptr<ParserOutput> parser_output;
+  bool is_ddl = false;
+
+  // Results, written by the analysis task.
+  absl::Status status;
+  std::unique_ptr<const AnalyzerOutput> output;
+};
+
+}  // namespace
+
+static void AnalyzeParallelAnalysisStatement(
+    absl::string_view sql, Catalog* catalog, TypeFactory* type_factory,
+    ParallelAnalysisStatement* statement) {
+  const AnalyzerOptions& options = *statement->options;
+  statement->status = ConvertInternalErrorLocationAndAdjustErrorString(
+      options.error_message_mode(), options.attach_error_location_payload(),
+      sql,
+      AnalyzeStatementFromParserOutputOwnedOnSuccess(
+          &statement->parser_output, options, sql, catalog, type_factory,
+          &statement->output));
+}
+
+// Analyzes <statements> concurrently using <schedule> (or serially, if
+// <schedule> is unset), and waits for all of them to finish.
+static void AnalyzeParallelAnalysisStatements(
+    absl::string_view sql, Catalog* catalog, TypeFactory* type_factory,
+    const std::function<void(std::function<void()>)>& schedule,
+    absl::Span<const std::unique_ptr<ParallelAnalysisStatement>> statements) {
+  if (!schedule || statements.size() == 1) {
+    for (const auto& statement : statements) {
+      AnalyzeParallelAnalysisStatement(sql, catalog, type_factory,
+                                       statement.get());
+    }
+    return;
+  }
+  absl::BlockingCounter pending(static_cast<int>(statements.size()));
+  for (const auto& statement : statements) {
+    ParallelAnalysisStatement* statement_ptr = statement.get();
+    schedule([sql, catalog, type_factory, statement_ptr, &pending] {
+      AnalyzeParallelAnalysisStatement(sql, catalog, type_factory,
+                                       statement_ptr);
+      pending.DecrementCount();
+    });
+  }
+  pending.Wait();
+}
+
+absl::Status AnalyzeStatementsInParallel(
+    absl::string_view sql, const AnalyzerOptions& options_in,
+    const ParallelStatementAnalysisOptions& parallel_options, Catalog* catalog,
+    TypeFactory* type_factory,
+    std::vector<std::unique_ptr<const AnalyzerOutput>>* outputs) {
+  outputs->clear();
+  ZETASQL_RETURN_IF_ERROR(ValidateAnalyzerOptions(options_in));
+
+  // Split the script serially.  Each statement is parsed into its own arenas
+  // so that the statements can then be resolved on different threads.
+  std::vector<std::unique_ptr<ParallelAnalysisStatement>> statements;
+  absl::Status parse_status;
+  ParseResumeLocation resume_location = ParseResumeLocation::FromStringView(sql);
+  bool at_end_of_input = false;
+  while (!at_end_of_input) {
+    auto statement = std::make_unique<ParallelAnalysisStatement>();
+    statement->options = std::make_unique<AnalyzerOptions>(options_in);
+    statement->options->set_arena(nullptr);
+    statement->options->set_id_string_pool(nullptr);
+    statement->options->mutable_find_options()->set_cycle_detector(nullptr);
+    statement->options->CreateDefaultArenasIfNotSet();
+
+    if (parallel_options.apply_ddl_statement) {
+      StatementProperties properties;
+      ZETASQL_RETURN_IF_ERROR(GetNextStatementProperties(
+          resume_location, options_in.language(), &properties));
+      statement->is_ddl =
+          properties.statement_category == StatementProperties::DDL;
+    }
+
+    parse_status = ParseNextStatement(&resume_location,
+                                      statement->options->GetParserOptions(),
+                                      &statement->parser_output,
+                                      &at_end_of_input);
+    if (!parse_status.ok()) {
+      parse_status = ConvertInternalErrorLocationAndAdjustErrorString(
+          options_in.error_message_mode(),
+          options_in.attach_error_location_payload(), sql,
+          UnsupportedStatementErrorOrStatus(parse_status, resume_location,
+                                            options_in));
+      break;
+    }
+    ZETASQL_RET_CHECK(statement->parser_output != nullptr);
+    statements.push_back(std::move(statement));
+  }
+
+  // Analyze the statements in groups that each end with a DDL statement, so
+  // that every DDL statement has been applied before any later statement is
+  // resolved.
+  const absl::Span<const std::unique_ptr<ParallelAnalysisStatement>>
+      all_statements(statements);
+  size_t group_begin = 0;
+  while (group_begin < all_statements.size()) {
+    size_t group_end = group_begin;
+    while (group_end < all_statements.size() &&
+           !all_statements[group_end++]->is_ddl) {
+    }
+    AnalyzeParallelAnalysisStatements(
+        sql, catalog, type_factory, parallel_options.schedule,
+        all_statements.subspan(group_begin, group_end - group_begin));
+
+    for (size_t i = group_begin; i < group_end; ++i) {
+      ParallelAnalysisStatement& statement = *all_statements[i];
+      ZETASQL_RETURN_IF_ERROR(statement.status);
+      outputs->push_back(std::move(statement.output));
+      if (statement.is_ddl) {
+        ZETASQL_RETURN_IF_ERROR(parallel_options.apply_ddl_statement(*outputs->back()));
+      }
+    }
+    group_begin = group_end;
+  }
+  return parse_status;
+}
+
 absl::Status AnalyzeExpression(absl::string_view sql,
                                const AnalyzerOptions& options, Catalog* catalog,
                                TypeFactory* type_factory,
@@ -680,7 +831,10 @@ absl::StatusOr<std::unique_ptr<const AnalyzerOutput>> RewriteForAnonymization(
               &runtime_info.validator_timed_value());
       ValidatorOptions validator_options{
           .allowed_hints_and_options =
-              analyzer_options.allowed_hints_and_options()};
+              analyzer_options.allowed_hints_and_options(),
+          .structural_validation_only =
+              InternalAnalyzerOptions::GetValidateResolvedASTStructureOnly(
+                  analyzer_options)};
       Validator validator(analyzer_options.language(), validator_options);
       ZETASQL_RET_CHECK(anonymized_output.node->Is<ResolvedStatement>());
       ZETASQL_RETURN_IF_ERROR(validator.ValidateResolvedStatement(
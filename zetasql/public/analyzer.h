@@ -17,6 +17,7 @@
 #ifndef ZETASQL_PUBLIC_ANALYZER_H_
 #define ZETASQL_PUBLIC_ANALYZER_H_
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <set>
@@ -77,6 +78,44 @@ absl::Status AnalyzeNextStatement(
     std::unique_ptr<const AnalyzerOutput>* output,
     bool* at_end_of_input);
 
+// Options controlling AnalyzeStatementsInParallel().
+struct ParallelStatementAnalysisOptions {
+  // Runs <task> asynchronously, typically by handing it to a caller-owned
+  // thread pool.  Must be safe to call from the calling thread.  If unset,
+  // statements are analyzed serially on the calling thread.
+  std::function<void(std::function<void()> task)> schedule;
+
+  // If set, invoked on the calling thread, in script order, with the output
+  // of each successfully analyzed DDL statement (CREATE, DROP, ALTER, ...)
+  // before any later statement is analyzed.  This lets the caller apply
+  // catalog changes that later statements may depend on.  DDL statements are
+  // barriers: only the statements between two DDL statements are analyzed
+  // concurrently.  If unset, all statements are treated as independent.
+  std::function<absl::Status(const AnalyzerOutput& ddl_output)>
+      apply_ddl_statement;
+};
+
+// Analyzes all statements in <sql>, like calling AnalyzeNextStatement() in a
+// loop, but analyzes independent statements concurrently using
+// <parallel_options.schedule>.  Statement boundaries are found by parsing
+// serially, so the script is split exactly as AnalyzeNextStatement() would
+// split it.
+//
+// <catalog> and <type_factory> are shared by all statements and so must be
+// safe for concurrent use (SimpleCatalog and TypeFactory are).  Each
+// statement gets its own arena and IdStringPool; arena(), id_string_pool()
+// and find_options().cycle_detector() in <options_in> are ignored.
+//
+// On success, <*outputs> holds one AnalyzerOutput per statement, in script
+// order.  On failure, returns the error for the earliest failing statement,
+// with its location relative to <sql>, and <*outputs> holds the outputs of
+// the statements preceding it.
+absl::Status AnalyzeStatementsInParallel(
+    absl::string_view sql, const AnalyzerOptions& options_in,
+    const ParallelStatementAnalysisOptions& parallel_options, Catalog* catalog,
+    TypeFactory* type_factory,
+    std::vector<std::unique_ptr<const AnalyzerOutput>>* outputs);
+
 // Same as AnalyzeStatement(), but analyze from the parsed AST contained in a
 // ParserOutput instead of raw SQL string. For projects which are allowed to use
 // the parser directly, using this may save double parsing. If the
@@ -36,6 +36,15 @@
 
 ABSL_FLAG(bool, zetasql_validate_resolved_ast, true,
           "Run validator on resolved AST before returning it.");
+ABSL_FLAG(bool, zetasql_validate_resolved_ast_structure_only, false,
+          "If validating the resolved AST, only check its structure, which "
+          "is much cheaper than full validation.");
+ABSL_FLAG(bool, zetasql_validate_only_changed_rewritten_ast, false,
+          "If validating the resolved AST, skip validating it again after "
+          "rewriting when no rewriter changed it.");
+ABSL_FLAG(bool, zetasql_record_resolved_node_count, false,
+          "Count the nodes of every resolved AST for the resolver stats in "
+          "AnalyzerLogEntry, which walks the whole tree.");
 
 namespace zetasql {
 
@@ -293,9 +302,16 @@ absl::Status AllowedHintsAndOptions::Serialize(
 AnalyzerOptions::AnalyzerOptions() : AnalyzerOptions(LanguageOptions()) {}
 
 AnalyzerOptions::AnalyzerOptions(const LanguageOptions& language_options)
-    : data_(new Data{.language_options = language_options,
-                     .validate_resolved_ast = absl::GetFlag(
-                         FLAGS_zetasql_validate_resolved_ast)}) {
+    : data_(new Data{
+          .language_options = language_options,
+          .validate_resolved_ast =
+              absl::GetFlag(FLAGS_zetasql_validate_resolved_ast),
+          .validate_resolved_ast_structure_only = absl::GetFlag(
+              FLAGS_zetasql_validate_resolved_ast_structure_only),
+          .validate_only_changed_rewritten_ast = absl::GetFlag(
+              FLAGS_zetasql_validate_only_changed_rewritten_ast),
+          .record_resolved_node_count = absl::GetFlag(
+              FLAGS_zetasql_record_resolved_node_count)}) {
   ZETASQL_CHECK_OK(FindTimeZoneByName("America/Los_Angeles",  // Crash OK
                               &data_->default_timezone));
 }
@@ -548,6 +548,23 @@ class AnalyzerOptions {
   }
   std::shared_ptr<zetasql_base::UnsafeArena> arena() const { return data_->arena; }
 
+  // If true, the nodes of the resolved AST are allocated in arena() rather
+  // than one at a time on the heap, and their memory is released with the
+  // arena.  This makes analyzing large statements cheaper.  The public node
+  // API is unchanged, and the returned AnalyzerOutput keeps the arena alive.
+  //
+  // Resolved nodes created during analysis by engine code, e.g. in Catalog
+  // lookups or Rewriters, are also allocated in the arena, so they must not
+  // be kept beyond the lifetime of the AnalyzerOutput.  Nodes created outside
+  // of analysis, e.g. by copying the output tree, are allocated on the heap.
+  // Default is false.
+  void set_allocate_resolved_ast_in_arena(bool value) {
+    data_->allocate_resolved_ast_in_arena = value;
+  }
+  bool allocate_resolved_ast_in_arena() const {
+    return data_->allocate_resolved_ast_in_arena;
+  }
+
   // Creates default-sized id_string_pool() and arena().
   // WARNING: After calling this, calling Analyze functions concurrently with
   // the same AnalyzerOptions is no longer allowed.
@@ -834,6 +851,9 @@ class AnalyzerOptions {
     // The arena will also be referenced in AnalyzerOutput to keep it alive.
     std::shared_ptr<zetasql_base::UnsafeArena> arena;
 
+    // If true, resolved AST nodes are also allocated in <arena>.
+    bool allocate_resolved_ast_in_arena = false;
+
     // Allocate all IdStrings in the resolved AST in this pool.
     // The pool will also be referenced in AnalyzerOutput to keep it alive.
     std::shared_ptr<IdStringPool> id_string_pool;
@@ -906,6 +926,21 @@ class AnalyzerOptions {
     // value.
     bool validate_resolved_ast = false;
 
+    // If validating, only validate the structure of the resolved AST.
+    // Initialized with the <zetasql_validate_resolved_ast_structure_only>
+    // global flag value.
+    bool validate_resolved_ast_structure_only = false;
+
+    // If validating, skip validating the resolved AST again after rewriting
+    // when no rewriter changed it. Initialized with the
+    // <zetasql_validate_only_changed_rewritten_ast> global flag value.
+    bool validate_only_changed_rewritten_ast = false;
+
+    // If true, the resolver stats include the number of nodes in the resolved
+    // AST, which takes a walk over the whole tree. Initialized with the
+    // <zetasql_record_resolved_node_count> global flag value.
+    bool record_resolved_node_count = false;
+
     // If true, columns that were never referenced in the query will be pruned
     // from column_lists of all ResolvedScans.  This allows using the
     // column_list on ResolvedTableScan for column-level ACL checking. If false,
@@ -24,6 +24,7 @@
 #include <vector>
 
 #include "zetasql/base/enum_utils.h"
+#include "zetasql/common/resolver_stats.h"
 #include "zetasql/common/timer_util.h"
 #include "zetasql/public/proto/logging.pb.h"
 #include "absl/strings/str_format.h"
@@ -99,6 +100,7 @@ void AnalyzerRuntimeInfo::AccumulateAll(const AnalyzerRuntimeInfo& rhs) {
 
   impl_->overall_timed_value.Accumulate(rhs.impl_->overall_timed_value);
   resolver_timed_value().Accumulate(rhs.impl_->resolver_timed_value);
+  resolver_stats().AccumulateAll(rhs.impl_->resolver_stats);
 
   for (ResolvedASTRewrite rewriter :
        zetasql_base::EnumerateEnumValues<ResolvedASTRewrite>()) {
@@ -147,6 +149,7 @@ std::string AnalyzerRuntimeInfo::DebugString(
       R"(Sum Total    : %s
   Parser     : %s
   Resolver   : %s
+    Catalog  : %s %d lookups
   Validator  : %s
   Rewriters  : %s
      %s)",
@@ -154,6 +157,8 @@ std::string AnalyzerRuntimeInfo::DebugString(
       print_latency(
           parser_runtime_info().parser_timed_value().elapsed_duration()),
       print_latency(resolver_timed_value().elapsed_duration()),
+      print_latency(resolver_stats().catalog_timed_value().elapsed_duration()),
+      resolver_stats().catalog_lookup_count(),
       print_latency(validator_timed_value().elapsed_duration()),
       print_latency(rewriters_timed_value().elapsed_duration()), rewriter_str);
 }
@@ -169,7 +174,21 @@ AnalyzerLogEntry AnalyzerRuntimeInfo::log_entry() const {
     stage.set_key(op);
     *stage.mutable_value() = time.ToExecutionStatsProto();
   };
-  add_timing(AnalyzerLogEntry::RESOLVER, resolver_timed_value());
+  const internal::TimedValue catalog_timed_value =
+      resolver_stats().catalog_timed_value();
+  internal::TimedValue resolver_only_timed_value = resolver_timed_value();
+  resolver_only_timed_value.Exclude(catalog_timed_value);
+  add_timing(AnalyzerLogEntry::RESOLVER, resolver_only_timed_value);
+  if (resolver_stats().catalog_lookup_count() > 0) {
+    add_timing(AnalyzerLogEntry::CATALOG_RESOLVER, catalog_timed_value);
+  }
+  if (rewriters_timed_value().HasAnyRecordedTiming()) {
+    add_timing(AnalyzerLogEntry::REWRITER, rewriters_timed_value());
+  }
+  if (validator_timed_value().HasAnyRecordedTiming()) {
+    add_timing(AnalyzerLogEntry::VALIDATOR, validator_timed_value());
+  }
+  *entry.mutable_resolver_stats() = resolver_stats().ToProto();
   return entry;
 }
 }  // namespace zetasql
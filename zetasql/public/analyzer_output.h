@@ -23,6 +23,7 @@
 #include <vector>
 
 #include "zetasql/base/arena.h"
+#include "zetasql/common/resolver_stats.h"
 #include "zetasql/common/timer_util.h"
 #include "zetasql/parser/parser.h"
 #include "zetasql/public/analyzer_options.h"
@@ -43,7 +44,7 @@ namespace zetasql {
 // Logically this separates Analysis into the following non-overlapping spans:
 //  - Parser                                                [parser_elapsed]
 //  - Resolver                                              [resolver_elapsed]
-//    - Catalog Calls (not tracked yet)
+//    - Catalog Calls                                       [resolver_stats]
 //    - re-entrant calls to Analyzer (not tracked separately)
 //  - Rewriters                                             [rewriters_elapsed]
 //    - Pass 1
@@ -151,8 +152,15 @@ class AnalyzerRuntimeInfo {
     return impl_->validator_timed_value;
   }
 
+  // Catalog lookups and other counters collected while resolving.
+  internal::ResolverStats& resolver_stats() const {
+    return impl_->resolver_stats;
+  }
+
   void AccumulateAll(const AnalyzerRuntimeInfo& rhs);
 
+  // In the returned entry, time spent in Catalog lookups is reported as
+  // CATALOG_RESOLVER and excluded from RESOLVER.
   AnalyzerLogEntry log_entry() const;
 
   // Print a human readable representation of this object.
@@ -171,6 +179,7 @@ class AnalyzerRuntimeInfo {
     // Be sure to update AccumulateAll if new fields are added.
     ParserRuntimeInfo parser_runtime_info;
     internal::TimedValue resolver_timed_value;
+    internal::ResolverStats resolver_stats;
     absl::flat_hash_map<ResolvedASTRewrite, RewriterDetails> rewriters_details;
     internal::TimedValue rewriters_timed_value;
     internal::TimedValue validator_timed_value;
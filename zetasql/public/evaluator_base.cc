@@ -549,6 +549,7 @@ absl::Status Evaluator::PrepareLocked(const AnalyzerOptions& options,
   AlgebrizerOptions algebrizer_options;
   algebrizer_options.consolidate_proto_field_accesses = true;
   algebrizer_options.allow_hash_join = true;
+  algebrizer_options.eliminate_common_subexpressions = true;
   algebrizer_options.allow_order_by_limit_operator = true;
   algebrizer_options.push_down_filters = true;
   algebrizer_options.inline_with_entries = true;
@@ -84,6 +84,7 @@ using ::testing::ElementsAre;
 using ::testing::Eq;
 using ::testing::HasSubstr;
 using ::testing::IsEmpty;
+using ::testing::Not;
 using ::testing::UnorderedElementsAre;
 using ::zetasql_base::testing::IsOkAndHolds;
 using ::zetasql_base::testing::StatusIs;
@@ -2270,6 +2271,80 @@ TEST(PreparedQuery, FromTable) {
   ZETASQL_EXPECT_OK(iter->Status());
 }
 
+TEST(PreparedQuery, CommonSubexpressionsEvaluatedOnce) {
+  SimpleTable test_table(
+      "TestTable", {{"a", types::Int64Type()}, {"b", types::StringType()}});
+  test_table.SetContents({{Int64(0), String("foo")}, {Int64(4), String("bar")}});
+
+  SimpleCatalog catalog("TestCatalog");
+  catalog.AddTable(test_table.Name(), &test_table);
+
+  // CONCAT(b, 'x') is evaluated once per row. DIV(100, a) is only evaluated
+  // under IF, so it must not be computed up front, where it would fail for
+  // a = 0.
+  PreparedQuery query(
+      "select concat(b, 'x') as c1, length(concat(b, 'x')) as c2, "
+      "if(a = 0, 0, div(100, a)) as c3, if(a = 0, 1, div(100, a)) as c4 "
+      "from TestTable",
+      EvaluatorOptions());
+  ZETASQL_ASSERT_OK(query.Prepare(AnalyzerOptions(), &catalog));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::string explain, query.ExplainAfterPrepare());
+  EXPECT_THAT(explain, HasSubstr("$cse"));
+  EXPECT_THAT(explain, Not(HasSubstr("$cse.2")));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<EvaluatorTableIterator> iter,
+                       query.Execute());
+  ASSERT_TRUE(iter->NextRow());
+  EXPECT_EQ(String("foox"), iter->GetValue(0));
+  EXPECT_EQ(Int64(4), iter->GetValue(1));
+  EXPECT_EQ(Int64(0), iter->GetValue(2));
+  EXPECT_EQ(Int64(1), iter->GetValue(3));
+
+  ASSERT_TRUE(iter->NextRow());
+  EXPECT_EQ(String("barx"), iter->GetValue(0));
+  EXPECT_EQ(Int64(4), iter->GetValue(1));
+  EXPECT_EQ(Int64(25), iter->GetValue(2));
+  EXPECT_EQ(Int64(25), iter->GetValue(3));
+
+  EXPECT_FALSE(iter->NextRow());
+  ZETASQL_EXPECT_OK(iter->Status());
+}
+
+TEST(PreparedQuery, CommonSubexpressionsInNestedProjections) {
+  SimpleTable test_table("TestTable", {{"b", types::StringType()}});
+  test_table.SetContents({{String("foo")}, {String("bar")}});
+
+  SimpleCatalog catalog("TestCatalog");
+  catalog.AddTable(test_table.Name(), &test_table);
+
+  // The subquery's projection has its own repeated subexpression. CONCAT(b,
+  // 'x') must still be shared by the outer projection after it.
+  PreparedQuery query(
+      "select concat(b, 'x') as c1, "
+      "(select length(upper(s)) + length(upper(s)) from unnest([b]) s) as c2, "
+      "length(concat(b, 'x')) as c3 from TestTable",
+      EvaluatorOptions());
+  ZETASQL_ASSERT_OK(query.Prepare(AnalyzerOptions(), &catalog));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::string explain, query.ExplainAfterPrepare());
+  int num_concat_calls = 0;
+  for (size_t pos = explain.find("Concat("); pos != std::string::npos;
+       pos = explain.find("Concat(", pos + 1)) {
+    ++num_concat_calls;
+  }
+  EXPECT_EQ(num_concat_calls, 1) << explain;
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<EvaluatorTableIterator> iter,
+                       query.Execute());
+  for (const char* expected : {"foox", "barx"}) {
+    ASSERT_TRUE(iter->NextRow());
+    EXPECT_EQ(String(expected), iter->GetValue(0));
+    EXPECT_EQ(Int64(6), iter->GetValue(1));
+    EXPECT_EQ(Int64(4), iter->GetValue(2));
+  }
+  EXPECT_FALSE(iter->NextRow());
+  ZETASQL_EXPECT_OK(iter->Status());
+}
+
 TEST(PreparedQuery, PrepareExecuteMissingQueryParameter) {
   SimpleTable test_table(
       "TestTable", {{"col", types::Int64Type()}});
@@ -0,0 +1,233 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Compares formatting and parsing with a precompiled DateTimeFormatter or
+// DateTimeParser against the FormatTimestampToString() and
+// ParseStringToTimestamp() functions, which scan the format for every value.
+// Also measures MakeTimeZone(), which resolves time zone arguments.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "zetasql/base/logging.h"
+#include "zetasql/public/functions/date_time_util.h"
+#include "zetasql/public/functions/parse_date_time.h"
+#include "benchmark/benchmark.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/civil_time.h"
+#include "absl/time/time.h"
+#include "zetasql/base/status.h"
+
+namespace zetasql {
+namespace functions {
+namespace {
+
+constexpr FormatDateTimestampOptions kFormatOptions = {.expand_Q = true,
+                                                       .expand_J = true};
+
+// Indexed by state.range(0).  The first two are ISO layouts, which are
+// formatted and parsed without the general implementations.
+const char* const kFormats[] = {
+    "%Y-%m-%d",
+    "%Y-%m-%d %H:%M:%S",
+    "%Y-%m-%d %H:%M:%E6S%Ez",
+    "%A, %B %d, %Y %I:%M %p",
+    "%F %T %Z",
+};
+
+absl::TimeZone GetTimeZone() {
+  absl::TimeZone timezone;
+  ZETASQL_CHECK_OK(MakeTimeZone("America/Los_Angeles", &timezone));
+  return timezone;
+}
+
+// Returns 1024 timestamps a little over a day apart.
+const std::vector<absl::Time>& GetTimestamps() {
+  static const std::vector<absl::Time>* timestamps = [] {
+    auto* timestamps = new std::vector<absl::Time>();
+    absl::Time timestamp = absl::FromCivil(
+        absl::CivilSecond(2020, 1, 1, 0, 0, 0), absl::UTCTimeZone());
+    for (int i = 0; i < 1024; ++i) {
+      timestamps->push_back(timestamp);
+      timestamp += absl::Hours(25) + absl::Seconds(7) + absl::Microseconds(13);
+    }
+    return timestamps;
+  }();
+  return *timestamps;
+}
+
+// Returns GetTimestamps() formatted with <format>.
+std::vector<std::string> GetTimestampStrings(absl::string_view format) {
+  const absl::TimeZone timezone = GetTimeZone();
+  std::vector<std::string> strings;
+  for (absl::Time timestamp : GetTimestamps()) {
+    std::string formatted;
+    ZETASQL_CHECK_OK(FormatTimestampToString(format, timestamp, timezone,
+                                     kFormatOptions, &formatted));
+    strings.push_back(formatted);
+  }
+  return strings;
+}
+
+void BM_FormatTimestampToString(benchmark::State& state) {
+  const absl::string_view format = kFormats[state.range(0)];
+  const absl::TimeZone timezone = GetTimeZone();
+  const std::vector<absl::Time>& timestamps = GetTimestamps();
+  std::string out;
+  size_t i = 0;
+  for (auto s : state) {
+    ZETASQL_CHECK_OK(FormatTimestampToString(format, timestamps[i++ % 1024],
+                                     timezone, kFormatOptions, &out));
+    benchmark::DoNotOptimize(out);
+  }
+  state.SetLabel(std::string(format));
+}
+BENCHMARK(BM_FormatTimestampToString)->DenseRange(0, 4);
+
+void BM_DateTimeFormatter(benchmark::State& state) {
+  const absl::string_view format = kFormats[state.range(0)];
+  const DateTimeFormatter formatter(format, DateTimeFormatTarget::kTimestamp,
+                                    kFormatOptions);
+  const absl::TimeZone timezone = GetTimeZone();
+  const std::vector<absl::Time>& timestamps = GetTimestamps();
+  std::string out;
+  size_t i = 0;
+  for (auto s : state) {
+    ZETASQL_CHECK_OK(
+        formatter.FormatTimestamp(timestamps[i++ % 1024], timezone, &out));
+    benchmark::DoNotOptimize(out);
+  }
+  state.SetLabel(std::string(format));
+}
+BENCHMARK(BM_DateTimeFormatter)->DenseRange(0, 4);
+
+void BM_ParseStringToTimestamp(benchmark::State& state) {
+  const absl::string_view format = kFormats[state.range(0)];
+  const absl::TimeZone timezone = GetTimeZone();
+  const std::vector<std::string> strings = GetTimestampStrings(format);
+  absl::Time timestamp;
+  size_t i = 0;
+  for (auto s : state) {
+    ZETASQL_CHECK_OK(ParseStringToTimestamp(format, strings[i++ % 1024], timezone,
+                                    /*parse_version2=*/true, &timestamp));
+    benchmark::DoNotOptimize(timestamp);
+  }
+  state.SetLabel(std::string(format));
+}
+// %Z cannot be parsed.
+BENCHMARK(BM_ParseStringToTimestamp)->DenseRange(0, 3);
+
+void BM_DateTimeParser(benchmark::State& state) {
+  const absl::string_view format = kFormats[state.range(0)];
+  const DateTimeParser parser(format, DateTimeFormatTarget::kTimestamp,
+                              /*parse_version2=*/true);
+  const absl::TimeZone timezone = GetTimeZone();
+  const std::vector<std::string> strings = GetTimestampStrings(format);
+  absl::Time timestamp;
+  size_t i = 0;
+  for (auto s : state) {
+    ZETASQL_CHECK_OK(
+        parser.ParseTimestamp(strings[i++ % 1024], timezone, &timestamp));
+    benchmark::DoNotOptimize(timestamp);
+  }
+  state.SetLabel(std::string(format));
+}
+BENCHMARK(BM_DateTimeParser)->DenseRange(0, 3);
+
+// FORMAT_DATE and PARSE_DATE, which also sanitize or validate the format for
+// every value when not precompiled.
+void BM_FormatDateToString(benchmark::State& state) {
+  int32_t date = 18262;  // 2020-01-01
+  std::string out;
+  for (auto s : state) {
+    ZETASQL_CHECK_OK(
+        FormatDateToString("%Y-%m-%d", date++ % 20000, kFormatOptions, &out));
+    benchmark::DoNotOptimize(out);
+  }
+}
+BENCHMARK(BM_FormatDateToString);
+
+void BM_DateTimeFormatterDate(benchmark::State& state) {
+  const DateTimeFormatter formatter("%Y-%m-%d", DateTimeFormatTarget::kDate,
+                                    kFormatOptions);
+  int32_t date = 18262;
+  std::string out;
+  for (auto s : state) {
+    ZETASQL_CHECK_OK(formatter.FormatDate(date++ % 20000, &out));
+    benchmark::DoNotOptimize(out);
+  }
+}
+BENCHMARK(BM_DateTimeFormatterDate);
+
+void BM_ParseStringToDate(benchmark::State& state) {
+  const std::vector<std::string> strings = GetTimestampStrings("%Y-%m-%d");
+  int32_t date;
+  size_t i = 0;
+  for (auto s : state) {
+    ZETASQL_CHECK_OK(ParseStringToDate("%Y-%m-%d", strings[i++ % 1024],
+                               /*parse_version2=*/true, &date));
+    benchmark::DoNotOptimize(date);
+  }
+}
+BENCHMARK(BM_ParseStringToDate);
+
+void BM_DateTimeParserDate(benchmark::State& state) {
+  const DateTimeParser parser("%Y-%m-%d", DateTimeFormatTarget::kDate,
+                              /*parse_version2=*/true);
+  const std::vector<std::string> strings = GetTimestampStrings("%Y-%m-%d");
+  int32_t date;
+  size_t i = 0;
+  for (auto s : state) {
+    ZETASQL_CHECK_OK(parser.ParseDate(strings[i++ % 1024], &date));
+    benchmark::DoNotOptimize(date);
+  }
+}
+BENCHMARK(BM_DateTimeParserDate);
+
+// Time zone strings like those in a per-row time zone column, indexed by
+// state.range(0).  MakeTimeZone() caches both valid and invalid strings.
+const std::vector<std::vector<std::string>>& GetTimeZoneStrings() {
+  static const auto* timezone_strings =
+      new std::vector<std::vector<std::string>>{
+          {"America/Los_Angeles"},
+          {"+05:30"},
+          {"Invalid/Zone"},
+          {"America/Los_Angeles", "Europe/Berlin", "-08:00", "Asia/Tokyo"},
+      };
+  return *timezone_strings;
+}
+
+void BM_MakeTimeZone(benchmark::State& state) {
+  const std::vector<std::string>& timezone_strings =
+      GetTimeZoneStrings()[state.range(0)];
+  absl::TimeZone timezone;
+  size_t i = 0;
+  for (auto s : state) {
+    absl::Status status = MakeTimeZone(
+        timezone_strings[i++ % timezone_strings.size()], &timezone);
+    benchmark::DoNotOptimize(status);
+    benchmark::DoNotOptimize(timezone);
+  }
+  state.SetLabel(absl::StrJoin(timezone_strings, ","));
+}
+BENCHMARK(BM_MakeTimeZone)->DenseRange(0, 3)->ThreadRange(1, 8);
+
+}  // namespace
+}  // namespace functions
+}  // namespace zetasql
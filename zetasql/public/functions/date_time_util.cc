@@ -34,6 +34,8 @@
 #include "zetasql/public/interval_value.h"
 #include "zetasql/public/time_zone_util.h"
 #include "zetasql/public/types/timestamp_util.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/numeric/int128.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -43,6 +45,7 @@
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/strip.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/time/civil_time.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
@@ -2151,6 +2154,160 @@ absl::Status FormatTimeToString(absl::string_view format_string,
   return absl::OkStatus();
 }
 
+DateTimeFormatter::DateTimeFormatter(
+    absl::string_view format_string, DateTimeFormatTarget target,
+    const FormatDateTimestampOptions& format_options)
+    : format_string_(format_string),
+      target_(target),
+      expand_quarter_(format_options.expand_Q),
+      expand_iso_dayofyear_(format_options.expand_J) {
+  switch (target_) {
+    case DateTimeFormatTarget::kDate:
+      SanitizeDateFormat(format_string, &sanitized_format_string_);
+      break;
+    case DateTimeFormatTarget::kDatetime:
+      SanitizeDatetimeFormat(format_string, &sanitized_format_string_);
+      break;
+    case DateTimeFormatTarget::kTime:
+      SanitizeTimeFormat(format_string, &sanitized_format_string_);
+      expand_quarter_ = false;
+      expand_iso_dayofyear_ = false;
+      break;
+    case DateTimeFormatTarget::kTimestamp:
+      sanitized_format_string_ = std::string(format_string);
+      break;
+  }
+  // Scans "%?" pairs the same way as ExpandPercentZQJ().
+  const absl::string_view format = sanitized_format_string_;
+  for (size_t index = format.find('%');
+       index != absl::string_view::npos && index + 1 < format.size();
+       index = format.find('%', index + 2)) {
+    const char element = format[index + 1];
+    if (element == 'Z' || (expand_quarter_ && element == 'Q') ||
+        (expand_iso_dayofyear_ && element == 'J')) {
+      needs_expansion_ = true;
+      break;
+    }
+  }
+  iso_layout_ = internal_functions::GetIsoDateTimeLayout(format);
+}
+
+absl::Status DateTimeFormatter::FormatDate(int32_t date,
+                                           std::string* out) const {
+  ABSL_DCHECK(target_ == DateTimeFormatTarget::kDate);
+  if (!IsValidDate(date)) {
+    return MakeEvalError() << "Invalid date value: " << date;
+  }
+  return Format(MakeTime(static_cast<int64_t>(date) * kNaiveNumMicrosPerDay,
+                         kMicroseconds),
+                absl::UTCTimeZone(), out);
+}
+
+absl::Status DateTimeFormatter::FormatDatetime(const DatetimeValue& datetime,
+                                               std::string* out) const {
+  ABSL_DCHECK(target_ == DateTimeFormatTarget::kDatetime);
+  if (!datetime.IsValid()) {
+    return MakeEvalError() << "Invalid datetime value: "
+                           << datetime.DebugString();
+  }
+  absl::Time datetime_in_utc =
+      absl::UTCTimeZone().At(datetime.ConvertToCivilSecond()).pre;
+  datetime_in_utc += absl::Nanoseconds(datetime.Nanoseconds());
+  return Format(datetime_in_utc, absl::UTCTimeZone(), out);
+}
+
+absl::Status DateTimeFormatter::FormatTime(const TimeValue& time,
+                                           std::string* out) const {
+  ABSL_DCHECK(target_ == DateTimeFormatTarget::kTime);
+  if (!time.IsValid()) {
+    return MakeEvalError() << "Invalid time value: " << time.DebugString();
+  }
+  absl::Time time_in_epoch_day =
+      absl::UTCTimeZone()
+          .At(absl::CivilSecond(1970, 1, 1, time.Hour(), time.Minute(),
+                                time.Second()))
+          .pre;
+  time_in_epoch_day += absl::Nanoseconds(time.Nanoseconds());
+  return Format(time_in_epoch_day, absl::UTCTimeZone(), out);
+}
+
+absl::Status DateTimeFormatter::FormatTimestamp(absl::Time timestamp,
+                                                absl::TimeZone timezone,
+                                                std::string* out) const {
+  ABSL_DCHECK(target_ == DateTimeFormatTarget::kTimestamp);
+  return Format(timestamp, timezone, out);
+}
+
+absl::Status DateTimeFormatter::Format(absl::Time base_time,
+                                       absl::TimeZone timezone,
+                                       std::string* out) const {
+  if (needs_expansion_) {
+    return FormatTimestampToStringInternal(
+        sanitized_format_string_, base_time, timezone,
+        {.truncate_tz = false,
+         .expand_quarter = expand_quarter_,
+         .expand_iso_dayofyear = expand_iso_dayofyear_},
+        out);
+  }
+  if (!IsValidTime(base_time)) {
+    return MakeEvalError() << "Invalid timestamp value: "
+                           << absl::ToUnixMicros(base_time);
+  }
+  if (iso_layout_ != internal_functions::IsoDateTimeLayout::kNone &&
+      FormatIsoLayout(base_time, timezone, out)) {
+    return absl::OkStatus();
+  }
+  // Without %Z, %Q or %J, ExpandPercentZQJ() would return the format as is.
+  *out = absl::FormatTime(
+      sanitized_format_string_, base_time,
+      internal_functions::GetNormalizedTimeZone(base_time, timezone));
+  return absl::OkStatus();
+}
+
+// Writes the <width> low order decimal digits of non-negative <value> to
+// <out>, and returns the position after them.
+static char* WriteDigits(int value, int width, char* out) {
+  for (char* digit = out + width - 1; digit >= out; --digit) {
+    *digit = static_cast<char>('0' + value % 10);
+    value /= 10;
+  }
+  return out + width;
+}
+
+bool DateTimeFormatter::FormatIsoLayout(absl::Time base_time,
+                                        absl::TimeZone timezone,
+                                        std::string* out) const {
+  using internal_functions::IsoDateTimeLayout;
+  const absl::TimeZone::CivilInfo info = timezone.At(base_time);
+  // Drops the seconds of the offset, like GetNormalizedTimeZone().
+  const absl::CivilSecond civil = info.cs - info.offset % 60;
+
+  char buffer[sizeof("YYYY-MM-DD HH:MM:SS")];
+  char* end = buffer;
+  if (iso_layout_ != IsoDateTimeLayout::kTime) {
+    if (civil.year() < 1000 || civil.year() > 9999) {
+      return false;
+    }
+    end = WriteDigits(static_cast<int>(civil.year()), 4, end);
+    *end++ = '-';
+    end = WriteDigits(civil.month(), 2, end);
+    *end++ = '-';
+    end = WriteDigits(civil.day(), 2, end);
+    if (iso_layout_ == IsoDateTimeLayout::kDate) {
+      out->assign(buffer, end - buffer);
+      return true;
+    }
+    *end++ = iso_layout_ == IsoDateTimeLayout::kDateTTime ? 'T' : ' ';
+  }
+  end = WriteDigits(civil.hour(), 2, end);
+  *end++ = ':';
+  end = WriteDigits(civil.minute(), 2, end);
+  *end++ = ':';
+  end = WriteDigits(civil.second(), 2, end);
+  out->assign(buffer, end - buffer);
+  return true;
+}
+
 absl::Status FormatTimestampToString(
     absl::string_view format_str, absl::Time timestamp, absl::TimeZone timezone,
     const FormatDateTimestampOptions& format_options, std::string* out) {
@@ -2253,13 +2410,9 @@ absl::Status ConvertTimestampToString(absl::Time input, TimestampScale scale,
   return ConvertTimestampToString(input, scale, timezone, output);
 }
 
-absl::Status MakeTimeZone(absl::string_view timezone_string,
-                          absl::TimeZone* timezone) {
-  // An empty time zone is an error.  There is no inherent default.
-  if (timezone_string.empty()) {
-    return MakeEvalError() << "Invalid empty time zone";
-  }
-
+// Resolves <timezone_string>, which is not empty, without the cache.
+static absl::Status MakeTimeZoneUncached(absl::string_view timezone_string,
+                                         absl::TimeZone* timezone) {
   // First try to parse the time zone as of the canonical form (+HH:MM) since
   // that is not supported by the time library.
   char timezone_sign;
@@ -2280,6 +2433,73 @@ absl::Status MakeTimeZone(absl::string_view timezone_string,
   return FindTimeZoneByName(timezone_string, timezone);
 }
 
+namespace {
+
+// Process-wide cache of the time zones resolved by MakeTimeZone().  Time zone
+// arguments usually take very few distinct values, so this avoids parsing the
+// offset form or looking up the name for every row.  Invalid time zones are
+// not cached, so that a stream of distinct invalid strings cannot fill it.
+class TimeZoneCache {
+ public:
+  // The cache is cleared when it reaches this size, so that it stays bounded
+  // however many distinct time zones are used.
+  static constexpr size_t kMaxEntries = 4096;
+
+  static TimeZoneCache& Get() {
+    static TimeZoneCache* cache = new TimeZoneCache();
+    return *cache;
+  }
+
+  absl::StatusOr<absl::TimeZone> Find(absl::string_view timezone_string) {
+    {
+      absl::ReaderMutexLock lock(&mutex_);
+      auto it = cache_.find(timezone_string);
+      if (it != cache_.end()) return it->second;
+    }
+    absl::TimeZone timezone;
+    ZETASQL_RETURN_IF_ERROR(MakeTimeZoneUncached(timezone_string, &timezone));
+    absl::MutexLock lock(&mutex_);
+    if (cache_.size() >= kMaxEntries) {
+      cache_.clear();
+    }
+    cache_.try_emplace(timezone_string, timezone);
+    return timezone;
+  }
+
+ private:
+  absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, absl::TimeZone> cache_
+      ABSL_GUARDED_BY(mutex_);
+};
+
+// The last time zone string resolved by this thread, and its result.
+struct LastTimeZone {
+  std::string timezone_string;
+  absl::StatusOr<absl::TimeZone> resolved;
+};
+
+}  // namespace
+
+absl::Status MakeTimeZone(absl::string_view timezone_string,
+                          absl::TimeZone* timezone) {
+  // An empty time zone is an error.  There is no inherent default.
+  if (timezone_string.empty()) {
+    return MakeEvalError() << "Invalid empty time zone";
+  }
+
+  // Consecutive rows usually have the same time zone, so check the previous
+  // result of this thread before locking the shared cache.
+  thread_local LastTimeZone last;
+  if (last.timezone_string != timezone_string) {
+    last.resolved = TimeZoneCache::Get().Find(timezone_string);
+    last.timezone_string.assign(timezone_string.data(),
+                                timezone_string.size());
+  }
+  if (!last.resolved.ok()) return last.resolved.status();
+  *timezone = *last.resolved;
+  return absl::OkStatus();
+}
+
 absl::Status ConvertStringToDate(absl::string_view str, int32_t* date) {
   int year = 0, month = 0, day = 0, idx = 0;
   if (!ParseStringToDateParts(str, &idx, &year, &month, &day) ||
@@ -4733,6 +4953,22 @@ absl::TimeZone GetNormalizedTimeZone(absl::Time base_time,
     return absl::FixedTimeZone(timezone_offset - seconds_offset);
   return timezone;
 }
+
+IsoDateTimeLayout GetIsoDateTimeLayout(absl::string_view format_string) {
+  if (format_string == "%Y-%m-%d" || format_string == "%F") {
+    return IsoDateTimeLayout::kDate;
+  }
+  if (format_string == "%Y-%m-%d %H:%M:%S" || format_string == "%F %T") {
+    return IsoDateTimeLayout::kDateSpaceTime;
+  }
+  if (format_string == "%Y-%m-%dT%H:%M:%S" || format_string == "%FT%T") {
+    return IsoDateTimeLayout::kDateTTime;
+  }
+  if (format_string == "%H:%M:%S" || format_string == "%T") {
+    return IsoDateTimeLayout::kTime;
+  }
+  return IsoDateTimeLayout::kNone;
+}
 }  // namespace internal_functions
 }  // namespace functions
 }  // namespace zetasql
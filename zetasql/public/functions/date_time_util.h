@@ -106,6 +106,9 @@ ABSL_MUST_USE_RESULT bool IsValidTime(absl::Time time);
 // Named time zones are loaded from the system's zoneinfo directory (typically
 // /usr/share/zoneinfo, /usr/share/lib/zoneinfo, etc.).  As per the base/time
 // library, time zone names are case sensitive.
+//
+// Valid time zones are cached process-wide, so repeated calls with the same
+// <timezone_string> are cheap.  Thread-safe.
 absl::Status MakeTimeZone(absl::string_view timezone_string,
                           absl::TimeZone* timezone);
 
@@ -1246,7 +1249,78 @@ void GetSignHourAndMinuteTimeZoneOffset(const absl::TimeZone::CivilInfo& info,
 absl::TimeZone GetNormalizedTimeZone(absl::Time base_time,
                                      absl::TimeZone timezone);
 
+// The ISO 8601 layouts that DateTimeFormatter and DateTimeParser handle
+// without going through absl::FormatTime() or the general parser.
+enum class IsoDateTimeLayout {
+  kNone,
+  kDate,           // "%Y-%m-%d" or "%F"
+  kDateSpaceTime,  // "%Y-%m-%d %H:%M:%S" or "%F %T"
+  kDateTTime,      // "%Y-%m-%dT%H:%M:%S" or "%FT%T"
+  kTime,           // "%H:%M:%S" or "%T"
+};
+
+// Returns the layout that <format_string> spells exactly, or kNone.
+IsoDateTimeLayout GetIsoDateTimeLayout(absl::string_view format_string);
+
 }  // namespace internal_functions
+
+// The type of the values that a DateTimeFormatter formats or a DateTimeParser
+// parses.
+enum class DateTimeFormatTarget { kDate, kDatetime, kTime, kTimestamp };
+
+// A FORMAT_DATE, FORMAT_DATETIME, FORMAT_TIME or FORMAT_TIMESTAMP format
+// string that is sanitized and scanned once, so that formatting many values
+// with it does not repeat that work per value.  The results and errors are the
+// same as those of FormatDateToString(), FormatDatetimeToStringWithOptions(),
+// FormatTimeToString() and FormatTimestampToString() respectively.  Formats
+// that are one of the common ISO 8601 layouts are formatted directly instead
+// of through absl::FormatTime().
+class DateTimeFormatter {
+ public:
+  // <format_options> is ignored for kTime, which never expands %Q or %J.
+  DateTimeFormatter(absl::string_view format_string,
+                    DateTimeFormatTarget target,
+                    const FormatDateTimestampOptions& format_options);
+  DateTimeFormatter(const DateTimeFormatter&) = delete;
+  DateTimeFormatter& operator=(const DateTimeFormatter&) = delete;
+
+  // The format string that this formatter was created from.
+  const std::string& format_string() const { return format_string_; }
+  DateTimeFormatTarget target() const { return target_; }
+
+  // REQUIRES: target() is kDate.
+  absl::Status FormatDate(int32_t date, std::string* out) const;
+  // REQUIRES: target() is kDatetime.
+  absl::Status FormatDatetime(const DatetimeValue& datetime,
+                              std::string* out) const;
+  // REQUIRES: target() is kTime.
+  absl::Status FormatTime(const TimeValue& time, std::string* out) const;
+  // REQUIRES: target() is kTimestamp.
+  absl::Status FormatTimestamp(absl::Time timestamp, absl::TimeZone timezone,
+                               std::string* out) const;
+
+ private:
+  absl::Status Format(absl::Time base_time, absl::TimeZone timezone,
+                      std::string* out) const;
+
+  // Formats <base_time> in <iso_layout_> and returns true, or returns false
+  // if the layout cannot represent it (e.g. a year before 1000, which
+  // absl::FormatTime() does not pad to four digits).
+  bool FormatIsoLayout(absl::Time base_time, absl::TimeZone timezone,
+                       std::string* out) const;
+
+  const std::string format_string_;
+  const DateTimeFormatTarget target_;
+  // <format_string_> with the elements that do not apply to <target_>
+  // escaped.
+  std::string sanitized_format_string_;
+  bool expand_quarter_;
+  bool expand_iso_dayofyear_;
+  // True if <sanitized_format_string_> has elements that ExpandPercentZQJ()
+  // must rewrite before formatting.
+  bool needs_expansion_ = false;
+  internal_functions::IsoDateTimeLayout iso_layout_;
+};
 }  // namespace functions
 }  // namespace zetasql
 
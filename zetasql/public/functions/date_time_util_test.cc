@@ -0,0 +1,212 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/public/functions/date_time_util.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "zetasql/base/testing/status_matchers.h"
+#include "zetasql/public/civil_time.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/civil_time.h"
+#include "absl/time/time.h"
+
+namespace zetasql {
+namespace functions {
+namespace {
+
+const FormatDateTimestampOptions kExpandQandJ =
+    {.expand_Q = true, .expand_J = true};
+
+// MakeTimeZone() caches its results; repeated calls must return the same
+// time zones and errors as the first.
+TEST(MakeTimeZoneTest, Repeated) {
+  const absl::Time time = absl::FromCivil(
+      absl::CivilSecond(2022, 7, 1, 12, 0, 0), absl::UTCTimeZone());
+  for (int i = 0; i < 3; ++i) {
+    absl::TimeZone timezone;
+    ZETASQL_ASSERT_OK(MakeTimeZone("America/Los_Angeles", &timezone));
+    EXPECT_EQ(timezone.name(), "America/Los_Angeles");
+    EXPECT_EQ(timezone.At(time).offset, -7 * 60 * 60);
+
+    ZETASQL_ASSERT_OK(MakeTimeZone("+05:30", &timezone));
+    EXPECT_EQ(timezone.At(time).offset, (5 * 60 + 30) * 60);
+
+    absl::Status status = MakeTimeZone("Mars/Olympus_Mons", &timezone);
+    EXPECT_EQ(status.code(), absl::StatusCode::kOutOfRange);
+    EXPECT_THAT(status.message(),
+                ::testing::HasSubstr("Invalid time zone: Mars/Olympus_Mons"));
+
+    status = MakeTimeZone("+25:00", &timezone);
+    EXPECT_EQ(status.code(), absl::StatusCode::kOutOfRange);
+    EXPECT_THAT(status.message(),
+                ::testing::HasSubstr("Invalid time zone: +25:00"));
+
+    status = MakeTimeZone("", &timezone);
+    EXPECT_EQ(status.code(), absl::StatusCode::kOutOfRange);
+    EXPECT_THAT(status.message(),
+                ::testing::HasSubstr("Invalid empty time zone"));
+  }
+}
+
+// More distinct time zone strings than the cache holds, valid or not, are
+// still resolved correctly, including after the cache has been cleared.
+TEST(MakeTimeZoneTest, ManyDistinct) {
+  for (int i = 0; i < 10000; ++i) {
+    absl::TimeZone timezone;
+    EXPECT_FALSE(MakeTimeZone(absl::StrCat("Invalid/Zone", i), &timezone).ok());
+  }
+  const absl::Time time = absl::UnixEpoch();
+  for (int pass = 0; pass < 2; ++pass) {
+    for (absl::string_view prefix : {"", "UTC"}) {
+      for (absl::string_view separator : {":", ""}) {
+        for (int minutes = -12 * 60; minutes <= 14 * 60; ++minutes) {
+          const std::string offset = absl::StrFormat(
+              "%s%c%02d%s%02d", prefix, minutes < 0 ? '-' : '+',
+              std::abs(minutes) / 60, separator, std::abs(minutes) % 60);
+          absl::TimeZone timezone;
+          ZETASQL_ASSERT_OK(MakeTimeZone(offset, &timezone));
+          EXPECT_EQ(timezone.At(time).offset, minutes * 60) << offset;
+        }
+      }
+    }
+  }
+}
+
+TEST(MakeTimeZoneTest, Concurrent) {
+  constexpr int kNumThreads = 8;
+  const std::vector<std::string> names = {
+      "UTC", "America/Los_Angeles", "Asia/Kolkata", "-08:00", "Invalid/Zone"};
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&names] {
+      for (int j = 0; j < 1000; ++j) {
+        const std::string& name = names[j % names.size()];
+        absl::TimeZone timezone;
+        absl::Status status = MakeTimeZone(name, &timezone);
+        if (name == "Invalid/Zone") {
+          EXPECT_FALSE(status.ok());
+        } else {
+          ZETASQL_EXPECT_OK(status);
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+// DateTimeFormatter produces the same results and errors as the
+// Format*ToString() functions, including for the ISO layouts that it formats
+// directly.
+TEST(DateTimeFormatterTests, MatchesFormatFunctions) {
+  const std::vector<std::string> formats = {
+      "%Y-%m-%d", "%F", "%Y-%m-%d %H:%M:%S", "%F %T", "%Y-%m-%dT%H:%M:%S",
+      "%FT%T", "%H:%M:%S", "%T", "%F %T%Ez", "%c %Z", "%Q %J", "%%Z %%Q",
+      "%E6S", "", "%", "100%%"};
+  const std::vector<absl::Time> timestamps = {
+      absl::UnixEpoch(),
+      absl::FromCivil(absl::CivilSecond(2023, 7, 14, 12, 34, 56),
+                      absl::UTCTimeZone()) +
+          absl::Nanoseconds(123456789),
+      absl::FromCivil(absl::CivilSecond(999, 12, 31, 23, 59, 59),
+                      absl::UTCTimeZone()),
+      absl::FromCivil(absl::CivilSecond(1, 1, 1, 0, 0, 0),
+                      absl::UTCTimeZone()),
+      absl::FromCivil(absl::CivilSecond(9999, 12, 31, 23, 59, 59),
+                      absl::UTCTimeZone()),
+      // Before 1884, America/Los_Angeles has an offset of -07:52:58.
+      absl::FromCivil(absl::CivilSecond(1850, 3, 4, 5, 6, 7),
+                      absl::UTCTimeZone()),
+      // Out of range.
+      absl::FromCivil(absl::CivilSecond(10000, 1, 1, 0, 0, 0),
+                      absl::UTCTimeZone()),
+  };
+  absl::TimeZone los_angeles;
+  ZETASQL_ASSERT_OK(MakeTimeZone("America/Los_Angeles", &los_angeles));
+  absl::TimeZone kiritimati;
+  ZETASQL_ASSERT_OK(MakeTimeZone("Pacific/Kiritimati", &kiritimati));
+  for (const std::string& format : formats) {
+    const DateTimeFormatter timestamp_formatter(
+        format, DateTimeFormatTarget::kTimestamp, kExpandQandJ);
+    const DateTimeFormatter date_formatter(format, DateTimeFormatTarget::kDate,
+                                           kExpandQandJ);
+    const DateTimeFormatter datetime_formatter(
+        format, DateTimeFormatTarget::kDatetime, kExpandQandJ);
+    const DateTimeFormatter time_formatter(format, DateTimeFormatTarget::kTime,
+                                           kExpandQandJ);
+    for (absl::Time timestamp : timestamps) {
+      const std::string test_string =
+          absl::StrCat(format, " ", absl::FormatTime(timestamp));
+      for (absl::TimeZone timezone :
+           {absl::UTCTimeZone(), los_angeles, kiritimati}) {
+        std::string expected, actual;
+        EXPECT_EQ(timestamp_formatter.FormatTimestamp(timestamp, timezone,
+                                                      &actual),
+                  FormatTimestampToString(format, timestamp, timezone,
+                                          kExpandQandJ, &expected))
+            << test_string;
+        EXPECT_EQ(actual, expected) << test_string;
+      }
+
+      const absl::CivilSecond civil =
+          absl::ToCivilSecond(timestamp, absl::UTCTimeZone());
+      const int32_t date = static_cast<int32_t>(
+          absl::CivilDay(civil) - absl::CivilDay(1970, 1, 1));
+      std::string expected, actual;
+      EXPECT_EQ(date_formatter.FormatDate(date, &actual),
+                FormatDateToString(format, date, kExpandQandJ, &expected))
+          << test_string;
+      EXPECT_EQ(actual, expected) << test_string;
+
+      const DatetimeValue datetime = DatetimeValue::FromYMDHMSAndNanos(
+          static_cast<int32_t>(civil.year()), civil.month(), civil.day(),
+          civil.hour(), civil.minute(), civil.second(),
+          absl::ToInt64Nanoseconds(timestamp - absl::FromCivil(
+                                                   civil, absl::UTCTimeZone())));
+      expected.clear();
+      actual.clear();
+      EXPECT_EQ(datetime_formatter.FormatDatetime(datetime, &actual),
+                FormatDatetimeToStringWithOptions(format, datetime,
+                                                  kExpandQandJ, &expected))
+          << test_string;
+      EXPECT_EQ(actual, expected) << test_string;
+
+      const TimeValue time = TimeValue::FromHMSAndNanos(
+          civil.hour(), civil.minute(), civil.second(), datetime.Nanoseconds());
+      expected.clear();
+      actual.clear();
+      EXPECT_EQ(time_formatter.FormatTime(time, &actual),
+                FormatTimeToString(format, time, &expected))
+          << test_string;
+      EXPECT_EQ(actual, expected) << test_string;
+    }
+  }
+}
+
+}  // namespace
+}  // namespace functions
+}  // namespace zetasql
@@ -36,6 +36,7 @@
 #include "zetasql/public/type.h"
 #include <cstdint>
 #include "absl/base/optimization.h"
+#include "absl/strings/ascii.h"
 #include "absl/strings/str_format.h"
 #include "absl/time/time.h"
 #include "zetasql/base/mathutil.h"
@@ -1901,5 +1902,156 @@ absl::Status ParseStringToDatetime(absl::string_view format_string,
   return ConvertTimestampToDatetime(base_time, absl::UTCTimeZone(), datetime);
 }
 
+DateTimeParser::DateTimeParser(absl::string_view format_string,
+                               DateTimeFormatTarget target,
+                               bool parse_version2)
+    : format_string_(format_string),
+      target_(target),
+      parse_version2_(parse_version2 || target == DateTimeFormatTarget::kTime),
+      iso_layout_(internal_functions::GetIsoDateTimeLayout(format_string)) {
+  switch (target_) {
+    case DateTimeFormatTarget::kDate:
+      format_status_ = ValidateDateFormat(format_string);
+      break;
+    case DateTimeFormatTarget::kDatetime:
+      format_status_ = ValidateDatetimeFormat(format_string);
+      break;
+    case DateTimeFormatTarget::kTime:
+      format_status_ = ValidateTimeFormat(format_string);
+      break;
+    case DateTimeFormatTarget::kTimestamp:
+      break;
+  }
+}
+
+absl::Status DateTimeParser::ParseDate(absl::string_view date_string,
+                                       int32_t* date) const {
+  ABSL_DCHECK(target_ == DateTimeFormatTarget::kDate);
+  absl::Time base_time;
+  ZETASQL_RETURN_IF_ERROR(
+      Parse(date_string, absl::UTCTimeZone(), kMicroseconds, &base_time));
+  int64_t timestamp;
+  if (!ConvertTimeToTimestamp(base_time, &timestamp)) {
+    return MakeEvalError() << "Invalid result from parsing function";
+  }
+  return ExtractFromTimestamp(DATE, timestamp, kMicroseconds,
+                              absl::UTCTimeZone(), date);
+}
+
+absl::Status DateTimeParser::ParseDatetime(absl::string_view datetime_string,
+                                           TimestampScale scale,
+                                           DatetimeValue* datetime) const {
+  ABSL_DCHECK(target_ == DateTimeFormatTarget::kDatetime);
+  ABSL_CHECK(scale == kNanoseconds || scale == kMicroseconds);
+  absl::Time base_time;
+  ZETASQL_RETURN_IF_ERROR(
+      Parse(datetime_string, absl::UTCTimeZone(), scale, &base_time));
+  return ConvertTimestampToDatetime(base_time, absl::UTCTimeZone(), datetime);
+}
+
+absl::Status DateTimeParser::ParseTime(absl::string_view time_string,
+                                       TimestampScale scale,
+                                       TimeValue* time) const {
+  ABSL_DCHECK(target_ == DateTimeFormatTarget::kTime);
+  ABSL_CHECK(scale == kNanoseconds || scale == kMicroseconds);
+  absl::Time base_time;
+  ZETASQL_RETURN_IF_ERROR(Parse(time_string, absl::UTCTimeZone(), scale, &base_time));
+  return ConvertTimestampToTime(base_time, absl::UTCTimeZone(), scale, time);
+}
+
+absl::Status DateTimeParser::ParseTimestamp(absl::string_view timestamp_string,
+                                            absl::TimeZone default_timezone,
+                                            int64_t* timestamp) const {
+  ABSL_DCHECK(target_ == DateTimeFormatTarget::kTimestamp);
+  absl::Time base_time;
+  ZETASQL_RETURN_IF_ERROR(
+      Parse(timestamp_string, default_timezone, kMicroseconds, &base_time));
+  if (!ConvertTimeToTimestamp(base_time, timestamp)) {
+    return MakeEvalError() << "Invalid result from parsing function";
+  }
+  return absl::OkStatus();
+}
+
+absl::Status DateTimeParser::ParseTimestamp(absl::string_view timestamp_string,
+                                            absl::TimeZone default_timezone,
+                                            absl::Time* timestamp) const {
+  ABSL_DCHECK(target_ == DateTimeFormatTarget::kTimestamp);
+  return Parse(timestamp_string, default_timezone, kNanoseconds, timestamp);
+}
+
+absl::Status DateTimeParser::Parse(absl::string_view input,
+                                   absl::TimeZone timezone,
+                                   TimestampScale scale,
+                                   absl::Time* timestamp) const {
+  ZETASQL_RETURN_IF_ERROR(format_status_);
+  if (iso_layout_ != internal_functions::IsoDateTimeLayout::kNone &&
+      ParseIsoLayout(input, timezone, timestamp)) {
+    return absl::OkStatus();
+  }
+  return functions::ParseTime(format_string_, input, timezone, scale,
+                              parse_version2_, timestamp);
+}
+
+// Parses the <width> decimal digits at the start of <input> into <value>.
+// Returns false if they are not all digits.
+static bool ParseFixedWidthDigits(absl::string_view input, int width,
+                                  int* value) {
+  *value = 0;
+  for (int i = 0; i < width; ++i) {
+    if (!absl::ascii_isdigit(input[i])) return false;
+    *value = *value * 10 + (input[i] - '0');
+  }
+  return true;
+}
+
+bool DateTimeParser::ParseIsoLayout(absl::string_view input,
+                                    absl::TimeZone timezone,
+                                    absl::Time* timestamp) const {
+  using internal_functions::IsoDateTimeLayout;
+  // Unspecified fields default to 1970-01-01 00:00:00, like the general
+  // parser.
+  int year = 1970, month = 1, day = 1, hour = 0, minute = 0, second = 0;
+  absl::string_view time_part = input;
+  switch (iso_layout_) {
+    case IsoDateTimeLayout::kNone:
+      return false;
+    case IsoDateTimeLayout::kDate:
+      if (input.size() != sizeof("YYYY-MM-DD") - 1) return false;
+      break;
+    case IsoDateTimeLayout::kDateSpaceTime:
+    case IsoDateTimeLayout::kDateTTime:
+      if (input.size() != sizeof("YYYY-MM-DD HH:MM:SS") - 1 ||
+          input[10] != (iso_layout_ == IsoDateTimeLayout::kDateTTime ? 'T'
+                                                                      : ' ')) {
+        return false;
+      }
+      time_part = input.substr(11);
+      break;
+    case IsoDateTimeLayout::kTime:
+      if (input.size() != sizeof("HH:MM:SS") - 1) return false;
+      break;
+  }
+  if (iso_layout_ != IsoDateTimeLayout::kTime &&
+      (!ParseFixedWidthDigits(input, 4, &year) || input[4] != '-' ||
+       !ParseFixedWidthDigits(input.substr(5), 2, &month) || input[7] != '-' ||
+       !ParseFixedWidthDigits(input.substr(8), 2, &day))) {
+    return false;
+  }
+  if (iso_layout_ != IsoDateTimeLayout::kDate &&
+      (!ParseFixedWidthDigits(time_part, 2, &hour) || time_part[2] != ':' ||
+       !ParseFixedWidthDigits(time_part.substr(3), 2, &minute) ||
+       time_part[5] != ':' ||
+       !ParseFixedWidthDigits(time_part.substr(6), 2, &second))) {
+    return false;
+  }
+  // Leaves leap seconds and every error to the general parser.
+  if (second > 59) return false;
+  const absl::TimeConversion tc =
+      absl::ConvertDateTime(year, month, day, hour, minute, second, timezone);
+  if (tc.normalized || !IsValidTime(tc.pre)) return false;
+  *timestamp = tc.pre;
+  return true;
+}
+
 }  // namespace functions
 }  // namespace zetasql
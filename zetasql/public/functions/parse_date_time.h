@@ -155,6 +155,63 @@ absl::Status ParseStringToDatetime(absl::string_view format_string,
                                    TimestampScale scale, bool parse_version2,
                                    DatetimeValue* datetime);
 
+// A PARSE_DATE, PARSE_DATETIME, PARSE_TIME or PARSE_TIMESTAMP format string
+// that is validated and scanned once, so that parsing many strings with it
+// does not repeat that work per string.  The results and errors are the same
+// as those of ParseStringToDate(), ParseStringToDatetime(),
+// ParseStringToTime() and ParseStringToTimestamp() respectively.  Strings
+// that exactly match one of the common ISO 8601 layouts are parsed directly
+// instead of through the general parser.
+class DateTimeParser {
+ public:
+  // <parse_version2> is ignored for kTime, which always parses with version 2
+  // like ParseStringToTime().
+  DateTimeParser(absl::string_view format_string, DateTimeFormatTarget target,
+                 bool parse_version2);
+  DateTimeParser(const DateTimeParser&) = delete;
+  DateTimeParser& operator=(const DateTimeParser&) = delete;
+
+  // The format string that this parser was created from.
+  const std::string& format_string() const { return format_string_; }
+  DateTimeFormatTarget target() const { return target_; }
+
+  // REQUIRES: target() is kDate.
+  absl::Status ParseDate(absl::string_view date_string, int32_t* date) const;
+  // REQUIRES: target() is kDatetime.
+  absl::Status ParseDatetime(absl::string_view datetime_string,
+                             TimestampScale scale,
+                             DatetimeValue* datetime) const;
+  // REQUIRES: target() is kTime.
+  absl::Status ParseTime(absl::string_view time_string, TimestampScale scale,
+                         TimeValue* time) const;
+  // REQUIRES: target() is kTimestamp.
+  absl::Status ParseTimestamp(absl::string_view timestamp_string,
+                              absl::TimeZone default_timezone,
+                              int64_t* timestamp) const;
+  // Like above, but supports nanoseconds precision.
+  absl::Status ParseTimestamp(absl::string_view timestamp_string,
+                              absl::TimeZone default_timezone,
+                              absl::Time* timestamp) const;
+
+ private:
+  absl::Status Parse(absl::string_view input, absl::TimeZone timezone,
+                     TimestampScale scale, absl::Time* timestamp) const;
+
+  // Parses <input> in <iso_layout_> and returns true, or returns false if
+  // <input> does not match the layout exactly or does not denote a valid
+  // timestamp, so that the general parser handles it.
+  bool ParseIsoLayout(absl::string_view input, absl::TimeZone timezone,
+                      absl::Time* timestamp) const;
+
+  const std::string format_string_;
+  const DateTimeFormatTarget target_;
+  const bool parse_version2_;
+  // Error for format elements that do not apply to <target_>, returned for
+  // every string parsed.
+  absl::Status format_status_;
+  internal_functions::IsoDateTimeLayout iso_layout_;
+};
+
 }  // namespace functions
 }  // namespace zetasql
 
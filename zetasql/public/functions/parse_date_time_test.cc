@@ -33,6 +33,7 @@
 #include "zetasql/compliance/functions_testlib.h"
 #include "zetasql/public/functions/date_time_util.h"
 #include "zetasql/public/options.pb.h"
+#include "zetasql/public/strings.h"
 #include "zetasql/public/type.h"
 #include "zetasql/public/type.pb.h"
 #include "zetasql/public/value.h"
@@ -1860,6 +1861,181 @@ TEST(ParseFormatDateTimestampTests, ParseMeridianIndicatorTests) {
   }
 }
 
+// DateTimeParser produces the same results and errors as the ParseStringTo*()
+// functions on all the compliance test cases.
+TEST_P(ParseDateTimeTestWithParam, DateTimeParserMatchesParseFunctions) {
+  const FunctionTestCall& test = GetParam();
+  for (int i = 0; i < test.params.num_params(); ++i) {
+    if (test.params.param(i).is_null() ||
+        !test.params.param(i).type()->IsString()) {
+      return;
+    }
+  }
+  const std::string& format = test.params.param(0).string_value();
+  const std::string& input = test.params.param(1).string_value();
+  const std::string test_string = absl::Substitute(
+      "$0('$1', '$2')", test.function_name, format, input);
+  if (test.function_name == "parse_date") {
+    const DateTimeParser parser(format, DateTimeFormatTarget::kDate,
+                                /*parse_version2=*/true);
+    int32_t expected, actual;
+    const absl::Status expected_status =
+        ParseStringToDate(format, input, /*parse_version2=*/true, &expected);
+    ASSERT_EQ(parser.ParseDate(input, &actual), expected_status)
+        << test_string;
+    if (expected_status.ok()) EXPECT_EQ(actual, expected) << test_string;
+  } else if (test.function_name == "parse_datetime") {
+    const DateTimeParser parser(format, DateTimeFormatTarget::kDatetime,
+                                /*parse_version2=*/true);
+    for (TimestampScale scale : {kMicroseconds, kNanoseconds}) {
+      DatetimeValue expected, actual;
+      const absl::Status expected_status = ParseStringToDatetime(
+          format, input, scale, /*parse_version2=*/true, &expected);
+      ASSERT_EQ(parser.ParseDatetime(input, scale, &actual), expected_status)
+          << test_string;
+      if (expected_status.ok()) {
+        EXPECT_EQ(actual.DebugString(), expected.DebugString()) << test_string;
+      }
+    }
+  } else if (test.function_name == "parse_time") {
+    const DateTimeParser parser(format, DateTimeFormatTarget::kTime,
+                                /*parse_version2=*/true);
+    for (TimestampScale scale : {kMicroseconds, kNanoseconds}) {
+      TimeValue expected, actual;
+      const absl::Status expected_status =
+          ParseStringToTime(format, input, scale, &expected);
+      ASSERT_EQ(parser.ParseTime(input, scale, &actual), expected_status)
+          << test_string;
+      if (expected_status.ok()) {
+        EXPECT_EQ(actual.DebugString(), expected.DebugString()) << test_string;
+      }
+    }
+  } else if (test.function_name == "parse_timestamp") {
+    absl::TimeZone timezone;
+    if (!MakeTimeZone(test.params.num_params() == 3
+                          ? test.params.param(2).string_value()
+                          : "America/Los_Angeles",
+                      &timezone)
+             .ok()) {
+      return;
+    }
+    const DateTimeParser parser(format, DateTimeFormatTarget::kTimestamp,
+                                /*parse_version2=*/true);
+    int64_t expected_micros, actual_micros;
+    const absl::Status expected_micros_status = ParseStringToTimestamp(
+        format, input, timezone, /*parse_version2=*/true, &expected_micros);
+    ASSERT_EQ(parser.ParseTimestamp(input, timezone, &actual_micros),
+              expected_micros_status)
+        << test_string;
+    if (expected_micros_status.ok()) {
+      EXPECT_EQ(actual_micros, expected_micros) << test_string;
+    }
+    absl::Time expected, actual;
+    const absl::Status expected_status = ParseStringToTimestamp(
+        format, input, timezone, /*parse_version2=*/true, &expected);
+    ASSERT_EQ(parser.ParseTimestamp(input, timezone, &actual), expected_status)
+        << test_string;
+    if (expected_status.ok()) EXPECT_EQ(actual, expected) << test_string;
+  }
+}
+
+TEST(DateTimeParserTests, IsoLayouts) {
+  struct TestCase {
+    std::string format;
+    std::string input;
+  };
+  const std::vector<TestCase> test_cases = {
+      {"%Y-%m-%d", "2023-07-14"},
+      {"%F", "0001-01-01"},
+      {"%F", "9999-12-31"},
+      {"%F", "0000-01-01"},
+      {"%F", "2023-02-29"},
+      {"%F", "2024-02-29"},
+      {"%F", "2023-13-01"},
+      {"%F", " 2023-07-14"},
+      {"%F", "2023-7-14"},
+      {"%F", "2023/07/14"},
+      {"%F", "+023-07-14"},
+      {"%F", std::string("2023-07-14\0", 11)},
+      {"%Y-%m-%d %H:%M:%S", "2023-07-14 12:34:56"},
+      {"%F %T", "2023-07-14 23:59:60"},
+      {"%F %T", "2023-07-14 24:00:00"},
+      {"%F %T", "2023-07-14T12:34:56"},
+      {"%F %T", "2023-07-14  12:34:56"},
+      {"%FT%T", "2023-07-14T12:34:56"},
+      {"%Y-%m-%dT%H:%M:%S", "2023-07-14 12:34:56"},
+      {"%FT%T", "0001-01-01T00:00:00"},
+      {"%FT%T", "9999-12-31T23:59:59"},
+      {"%T", "12:34:56"},
+      {"%H:%M:%S", "12:34:5x"},
+      {"%T", "12:60:00"},
+  };
+  absl::TimeZone los_angeles;
+  ZETASQL_ASSERT_OK(MakeTimeZone("America/Los_Angeles", &los_angeles));
+  absl::TimeZone kiritimati;
+  ZETASQL_ASSERT_OK(MakeTimeZone("Pacific/Kiritimati", &kiritimati));
+  for (const TestCase& test_case : test_cases) {
+    const std::string test_string =
+        absl::StrCat(test_case.format, " ", ToStringLiteral(test_case.input));
+    for (absl::TimeZone timezone :
+         {absl::UTCTimeZone(), los_angeles, kiritimati}) {
+      const DateTimeParser parser(test_case.format,
+                                  DateTimeFormatTarget::kTimestamp,
+                                  /*parse_version2=*/true);
+      absl::Time expected, actual;
+      const absl::Status expected_status =
+          ParseStringToTimestamp(test_case.format, test_case.input, timezone,
+                                 /*parse_version2=*/true, &expected);
+      ASSERT_EQ(parser.ParseTimestamp(test_case.input, timezone, &actual),
+                expected_status)
+          << test_string;
+      if (expected_status.ok()) EXPECT_EQ(actual, expected) << test_string;
+    }
+    for (DateTimeFormatTarget target :
+         {DateTimeFormatTarget::kDate, DateTimeFormatTarget::kDatetime,
+          DateTimeFormatTarget::kTime}) {
+      const DateTimeParser parser(test_case.format, target,
+                                  /*parse_version2=*/true);
+      absl::Status expected_status, actual_status;
+      std::string expected, actual;
+      if (target == DateTimeFormatTarget::kDate) {
+        int32_t expected_date, actual_date;
+        expected_status = ParseStringToDate(test_case.format, test_case.input,
+                                            /*parse_version2=*/true,
+                                            &expected_date);
+        actual_status = parser.ParseDate(test_case.input, &actual_date);
+        if (expected_status.ok()) {
+          expected = absl::StrCat(expected_date);
+          actual = absl::StrCat(actual_date);
+        }
+      } else if (target == DateTimeFormatTarget::kDatetime) {
+        DatetimeValue expected_datetime, actual_datetime;
+        expected_status = ParseStringToDatetime(
+            test_case.format, test_case.input, kNanoseconds,
+            /*parse_version2=*/true, &expected_datetime);
+        actual_status = parser.ParseDatetime(test_case.input, kNanoseconds,
+                                             &actual_datetime);
+        if (expected_status.ok()) {
+          expected = expected_datetime.DebugString();
+          actual = actual_datetime.DebugString();
+        }
+      } else {
+        TimeValue expected_time, actual_time;
+        expected_status = ParseStringToTime(test_case.format, test_case.input,
+                                            kNanoseconds, &expected_time);
+        actual_status =
+            parser.ParseTime(test_case.input, kNanoseconds, &actual_time);
+        if (expected_status.ok()) {
+          expected = expected_time.DebugString();
+          actual = actual_time.DebugString();
+        }
+      }
+      EXPECT_EQ(actual_status, expected_status) << test_string;
+      EXPECT_EQ(actual, expected) << test_string;
+    }
+  }
+}
+
 }  // namespace
 }  // namespace functions
 }  // namespace zetasql
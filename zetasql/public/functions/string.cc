@@ -37,6 +37,7 @@
 #include "zetasql/base/logging.h"
 #include "zetasql/common/utf_util.h"
 #include "zetasql/public/functions/normalize_mode.pb.h"
+#include "zetasql/public/functions/string_internal.h"
 #include "zetasql/public/functions/util.h"
 #include "zetasql/public/strings.h"
 #include "zetasql/base/case.h"
@@ -74,6 +75,10 @@
 namespace zetasql {
 namespace functions {
 
+using string_internal::FindSubstring;
+using string_internal::IsAsciiBlock;
+using string_internal::kBlockSize;
+
 namespace {
 
 constexpr absl::string_view kBadUtf8 = "A string is not valid UTF-8.";
@@ -137,7 +142,7 @@ static bool GlobalStringReplace(absl::string_view s, absl::string_view oldsub,
 
   absl::string_view::size_type start_pos = 0;
   while (true) {
-    absl::string_view::size_type pos = s.find(oldsub, start_pos);
+    absl::string_view::size_type pos = FindSubstring(s, oldsub, start_pos);
     if (pos == absl::string_view::npos) {
       break;
     }
@@ -203,6 +208,8 @@ bool Utf8Trimmer::Initialize(absl::string_view to_trim, absl::Status* error) {
   }
   unicode_set_ = std::make_unique<icu::UnicodeSet>();
   has_explicit_replacement_char_ = false;
+  ascii_to_trim_.reset();
+  ascii_only_ = true;
   int32_t offset = 0;
   while (offset < str_length32) {
     UChar32 character;
@@ -212,6 +219,11 @@ bool Utf8Trimmer::Initialize(absl::string_view to_trim, absl::Status* error) {
     } else {
       unicode_set_->add(character);
     }
+    if (character < 0x80) {
+      ascii_to_trim_.set(character);
+    } else {
+      ascii_only_ = false;
+    }
     if (character == kUChar32ReplacementChar) {
       has_explicit_replacement_char_ = true;
     }
@@ -257,7 +269,19 @@ bool Utf8Trimmer::TrimLeft(absl::string_view str, absl::string_view* out,
     *out = str;
     return true;
   }
-  if (has_explicit_replacement_char_ && !IsWellFormedUTF8(str)) {
+  if (ascii_only_) {
+    // Any byte that is not ASCII stops the span, like the ill-formed or
+    // non-ASCII character it starts would for the icu::UnicodeSet.
+    size_t prefix_length = 0;
+    while (prefix_length < str.size() &&
+           IsAsciiToTrim(static_cast<uint8_t>(str[prefix_length]))) {
+      ++prefix_length;
+    }
+    *out = str.substr(prefix_length);
+    return true;
+  }
+  if (has_explicit_replacement_char_ &&
+      !string_internal::IsWellFormedUtf8(str)) {
     return internal::UpdateError(error, kBadUtf8);
   }
 
@@ -271,7 +295,17 @@ bool Utf8Trimmer::TrimRight(absl::string_view str, absl::string_view* out,
     *out = str;
     return true;
   }
-  if (has_explicit_replacement_char_ && !IsWellFormedUTF8(str)) {
+  if (ascii_only_) {
+    size_t suffix_start = str.size();
+    while (suffix_start > 0 &&
+           IsAsciiToTrim(static_cast<uint8_t>(str[suffix_start - 1]))) {
+      --suffix_start;
+    }
+    *out = str.substr(0, suffix_start);
+    return true;
+  }
+  if (has_explicit_replacement_char_ &&
+      !string_internal::IsWellFormedUtf8(str)) {
     return internal::UpdateError(error, kBadUtf8);
   }
 
@@ -411,18 +445,9 @@ bool LengthUtf8(absl::string_view str, int64_t* out, absl::Status* error) {
   if (!CheckAndCastStrLength(str, &str_length32, error)) {
     return false;
   }
-
-  int utf8_length = 0;
-  int32_t offset = 0;
-  while (offset < str_length32) {
-    UChar32 character;
-    U8_NEXT(str.data(), offset, str_length32, character);
-    if (character < 0) {
-      return internal::UpdateError(error, kBadUtf8);
-    }
-    utf8_length++;
+  if (!string_internal::CountCodePoints(str, out)) {
+    return internal::UpdateError(error, kBadUtf8);
   }
-  *out = utf8_length;
   return true;
 }
 
@@ -464,6 +489,20 @@ bool TrimSpacesUtf8(absl::string_view str, absl::string_view* out,
 
 bool LeftTrimSpacesUtf8(absl::string_view str, absl::string_view* out,
                         absl::Status* error) {
+  // Skip ASCII white space without icu, and stop at any other ASCII
+  // character.  Only a non-ASCII character needs the full White_Space set.
+  size_t prefix_length = 0;
+  while (prefix_length < str.size() &&
+         string_internal::IsAsciiWhiteSpace(
+             static_cast<uint8_t>(str[prefix_length]))) {
+    ++prefix_length;
+  }
+  if (prefix_length == str.size() ||
+      static_cast<uint8_t>(str[prefix_length]) < 0x80) {
+    *out = str.substr(prefix_length);
+    return true;
+  }
+  str.remove_prefix(prefix_length);
   icu::ErrorCode cannot_fail;
   const icu::UnicodeSet* whitespace_unicode_set = icu::UnicodeSet::fromUSet(
       u_getBinaryPropertySet(UCHAR_WHITE_SPACE, cannot_fail));
@@ -472,6 +511,17 @@ bool LeftTrimSpacesUtf8(absl::string_view str, absl::string_view* out,
 
 bool RightTrimSpacesUtf8(absl::string_view str, absl::string_view* out,
                          absl::Status* error) {
+  size_t suffix_start = str.size();
+  while (suffix_start > 0 &&
+         string_internal::IsAsciiWhiteSpace(
+             static_cast<uint8_t>(str[suffix_start - 1]))) {
+    --suffix_start;
+  }
+  if (suffix_start == 0 || static_cast<uint8_t>(str[suffix_start - 1]) < 0x80) {
+    *out = str.substr(0, suffix_start);
+    return true;
+  }
+  str = str.substr(0, suffix_start);
   icu::ErrorCode cannot_fail;
   const icu::UnicodeSet* whitespace_unicode_set = icu::UnicodeSet::fromUSet(
       u_getBinaryPropertySet(UCHAR_WHITE_SPACE, cannot_fail));
@@ -573,6 +623,24 @@ static bool ForwardN(absl::string_view str, int32_t str_length32,
                      int64_t num_code_points, int32_t* str_offset,
                      bool* hit_end, absl::Status* error) {
   int64_t i = 0;
+  while (num_code_points - i >= kBlockSize &&
+         str_length32 - *str_offset >= kBlockSize) {
+    // Each byte of an ASCII block is one code point.
+    if (IsAsciiBlock(str.data() + *str_offset)) {
+      *str_offset += kBlockSize;
+      i += kBlockSize;
+      continue;
+    }
+    // Otherwise decode the next kBlockSize code points one at a time.
+    for (const int64_t block_end = i + kBlockSize;
+         i < block_end && *str_offset < str_length32; ++i) {
+      UChar32 character;
+      U8_NEXT(str.data(), *str_offset, str_length32, character);
+      if (character < 0) {
+        return internal::UpdateError(error, kBadUtf8);
+      }
+    }
+  }
   for (; i < num_code_points && *str_offset < str_length32; ++i) {
     UChar32 character;
     U8_NEXT(str.data(), *str_offset, str_length32, character);
@@ -591,7 +659,23 @@ static bool ForwardN(absl::string_view str, int32_t str_length32,
 static bool BackN(absl::string_view str, int64_t num_code_points,
                   int32_t* str_offset, bool* hit_start, absl::Status* error) {
   int64_t i = 0;
-  for (; i<num_code_points&& * str_offset> 0; ++i) {
+  while (num_code_points - i >= kBlockSize && *str_offset >= kBlockSize) {
+    // Each byte of an ASCII block is one code point.
+    if (IsAsciiBlock(str.data() + *str_offset - kBlockSize)) {
+      *str_offset -= kBlockSize;
+      i += kBlockSize;
+      continue;
+    }
+    for (const int64_t block_end = i + kBlockSize;
+         i < block_end && *str_offset > 0; ++i) {
+      UChar32 character;
+      U8_PREV(str.data(), 0, *str_offset, character);
+      if (character < 0) {
+        return internal::UpdateError(error, kBadUtf8);
+      }
+    }
+  }
+  for (; i < num_code_points && *str_offset > 0; ++i) {
     UChar32 character;
     U8_PREV(str.data(), 0, *str_offset, character);
 
@@ -659,7 +743,8 @@ bool StrPositivePosUtf8(absl::string_view str, absl::string_view substr,
     }
 
     // Safe cast because str.length() <= int32max.
-    string_offset = static_cast<int32_t>(str.find(substr, string_offset));
+    string_offset =
+        static_cast<int32_t>(FindSubstring(str, substr, string_offset));
     if (string_offset == absl::string_view::npos) {
       *out = 0;
       return true;
@@ -872,8 +957,10 @@ static bool SubstrSuffixUtf8(absl::string_view str, int64_t pos, int64_t length,
   int32_t suffix_start_offset = suffix_end_offset;
 
   while (length > 0 && suffix_start_offset > 0) {
-    if (!BackN(str, 1, &suffix_start_offset, &unused, error)) {
-      return false;
+    UChar32 character;
+    U8_PREV(str.data(), 0, suffix_start_offset, character);
+    if (character < 0) {
+      return internal::UpdateError(error, kBadUtf8);
     }
     length--;
   }
@@ -990,6 +1077,11 @@ bool UpperUtf8(absl::string_view str, std::string* out, absl::Status* error) {
   if (!CheckAndCastStrLength(str, &str_length32, error)) {
     return false;
   }
+  if (string_internal::IsAscii(str)) {
+    out->resize(str.size());
+    string_internal::AsciiToUpper(str, out->data());
+    return true;
+  }
   out->clear();
   out->reserve(str.length());
 
@@ -1014,6 +1106,14 @@ bool LowerUtf8(absl::string_view str, std::string* out, absl::Status* error) {
   if (!CheckAndCastStrLength(str, &str_length32, error)) {
     return false;
   }
+  // Only all-ASCII strings are mapped without icu.  Lowercasing is context
+  // sensitive (a final sigma depends on the preceding letters), so a string
+  // cannot be split into ASCII and non-ASCII parts.
+  if (string_internal::IsAscii(str)) {
+    out->resize(str.size());
+    string_internal::AsciiToLower(str, out->data());
+    return true;
+  }
   out->clear();
   out->reserve(str.length());
 
@@ -1108,19 +1208,22 @@ bool SplitUtf8Impl(absl::string_view str, absl::string_view delimiter,
     return true;
   }
 
-  if (!IsWellFormedUTF8(delimiter)) {
+  if (!string_internal::IsWellFormedUtf8(delimiter)) {
     return internal::UpdateError(
         error, "Delimiter in SPLIT function is not a valid UTF-8 string");
   }
-  // If str is valid UTF8 string, then regular absl::StrSplit is guaranteed to
+  // If str is valid UTF8 string, then a byte-wise search is guaranteed to
   // produce correct results, since no valid UTF8 sequence is ever a prefix of
   // another valid UTF8 sequence (one of fundamental UTF8 design points).
-  // Special case empty StringView, because absl::StrSplit behaves differently
-  // on StringView() vs. StringView("", 0)
-  if (ABSL_PREDICT_FALSE(str.empty())) {
-    str = absl::string_view("", 0);
+  out->clear();
+  size_t start = 0;
+  while (true) {
+    const size_t pos = FindSubstring(str, delimiter, start);
+    if (pos == absl::string_view::npos) break;
+    out->emplace_back(str.substr(start, pos - start));
+    start = pos + delimiter.size();
   }
-  *out = absl::StrSplit(str, delimiter);
+  out->emplace_back(str.substr(start));
   return true;
 }
 
@@ -1669,16 +1772,30 @@ bool ReverseUtf8(absl::string_view input, std::string* out,
 
   int32_t offset = str_length32;  // start at the end
   while (offset > 0) {
-    int32_t prev_offset = offset;
-    UChar32 character;
-    U8_PREV(input.data(), 0, offset, character);
-    if (character < 0) {
-      return internal::UpdateError(
-          error, absl::Substitute("Argument to REVERSE is not a structurally "
-                                  "valid UTF-8 string: '$0'",
-                                  input));
+    // Copy the ASCII blocks before <offset> in reverse.
+    int32_t ascii_start = offset;
+    while (ascii_start >= kBlockSize &&
+           IsAsciiBlock(input.data() + ascii_start - kBlockSize)) {
+      ascii_start -= kBlockSize;
+    }
+    if (ascii_start < offset) {
+      out->append(std::make_reverse_iterator(input.begin() + offset),
+                  std::make_reverse_iterator(input.begin() + ascii_start));
+      offset = ascii_start;
+      continue;
+    }
+    for (int i = 0; i < kBlockSize && offset > 0; ++i) {
+      int32_t prev_offset = offset;
+      UChar32 character;
+      U8_PREV(input.data(), 0, offset, character);
+      if (character < 0) {
+        return internal::UpdateError(
+            error, absl::Substitute("Argument to REVERSE is not a structurally "
+                                    "valid UTF-8 string: '$0'",
+                                    input));
+      }
+      out->append(input.begin() + offset, input.begin() + prev_offset);
     }
-    out->append(input.begin() + offset, input.begin() + prev_offset);
   }
   return true;
 }
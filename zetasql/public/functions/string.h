@@ -165,6 +165,13 @@ class Utf8Trimmer {
   // ill-formed).  We do this conditionally, as it is more expensive, since
   // it requires two passes over the input.
   bool has_explicit_replacement_char_ = false;
+
+  bool IsAsciiToTrim(uint8_t c) const { return c < 0x80 && ascii_to_trim_[c]; }
+
+  // The ASCII characters to trim.  If all characters to trim are ASCII, these
+  // are checked byte by byte instead of with <unicode_set_>.
+  std::bitset<128> ascii_to_trim_;
+  bool ascii_only_ = false;
 };
 
 // This class allows for a more efficient implementation of TRIM(), LTRIM()
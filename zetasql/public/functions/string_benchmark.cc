@@ -0,0 +1,250 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Measures the UTF-8 string functions on ASCII text, mostly-ASCII text with
+// some accented letters, and text without ASCII letters, at several lengths.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "zetasql/base/logging.h"
+#include "zetasql/public/functions/string.h"
+#include "benchmark/benchmark.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+
+namespace zetasql {
+namespace functions {
+namespace {
+
+// Words that text is made of, indexed by state.range(0).
+const std::vector<std::vector<std::string>>& GetWords() {
+  static const auto* words = new std::vector<std::vector<std::string>>{
+      {"the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog"},
+      {"the", "café", "naïve", "fox", "jumps", "über", "lazy", "dog"},
+      {"быстрая", "лиса", "素早い", "狐", "ελαφρύ", "σκυλί", "ленивый", "犬"},
+  };
+  return *words;
+}
+
+const char* const kTextLabels[] = {"ascii", "mixed", "non-ascii"};
+
+// Returns about <size> bytes of space-separated words of kind <kind>, ending at
+// a word boundary.
+std::string MakeText(int kind, int size) {
+  const std::vector<std::string>& words = GetWords()[kind];
+  std::string text;
+  for (size_t i = 0; text.size() < size; ++i) {
+    if (!text.empty()) text.push_back(' ');
+    text += words[(i * 5) % words.size()];
+  }
+  return text;
+}
+
+// Runs <benchmark> for each kind of text, with 16, 256, and 4096 bytes.
+void TextArgs(benchmark::internal::Benchmark* benchmark) {
+  for (int kind = 0; kind < 3; ++kind) {
+    for (int size : {16, 256, 4096}) {
+      benchmark->Args({kind, size});
+    }
+  }
+}
+
+std::string GetText(benchmark::State& state) {
+  state.SetLabel(kTextLabels[state.range(0)]);
+  return MakeText(state.range(0), state.range(1));
+}
+
+void SetBytesProcessed(benchmark::State& state, absl::string_view text) {
+  state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                          text.size());
+}
+
+void BM_LengthUtf8(benchmark::State& state) {
+  const std::string text = GetText(state);
+  int64_t out;
+  absl::Status error;
+  for (auto s : state) {
+    ABSL_CHECK(LengthUtf8(text, &out, &error));
+    benchmark::DoNotOptimize(out);
+  }
+  SetBytesProcessed(state, text);
+}
+BENCHMARK(BM_LengthUtf8)->Apply(TextArgs);
+
+// SUBSTR(text, 1 + LENGTH(text) / 2, 10), which skips half of the text.
+void BM_SubstrWithLengthUtf8(benchmark::State& state) {
+  const std::string text = GetText(state);
+  int64_t length;
+  absl::Status error;
+  ABSL_CHECK(LengthUtf8(text, &length, &error));
+  absl::string_view out;
+  for (auto s : state) {
+    ABSL_CHECK(SubstrWithLengthUtf8(text, 1 + length / 2, 10, &out, &error));
+    benchmark::DoNotOptimize(out);
+  }
+  SetBytesProcessed(state, text);
+}
+BENCHMARK(BM_SubstrWithLengthUtf8)->Apply(TextArgs);
+
+// SUBSTR(text, -10, 5), which scans from the end of the text.
+void BM_SubstrWithLengthUtf8Negative(benchmark::State& state) {
+  const std::string text = GetText(state);
+  absl::string_view out;
+  absl::Status error;
+  for (auto s : state) {
+    ABSL_CHECK(SubstrWithLengthUtf8(text, -10, 5, &out, &error));
+    benchmark::DoNotOptimize(out);
+  }
+}
+BENCHMARK(BM_SubstrWithLengthUtf8Negative)->Apply(TextArgs);
+
+void BM_UpperUtf8(benchmark::State& state) {
+  const std::string text = GetText(state);
+  std::string out;
+  absl::Status error;
+  for (auto s : state) {
+    ABSL_CHECK(UpperUtf8(text, &out, &error));
+    benchmark::DoNotOptimize(out);
+  }
+  SetBytesProcessed(state, text);
+}
+BENCHMARK(BM_UpperUtf8)->Apply(TextArgs);
+
+void BM_LowerUtf8(benchmark::State& state) {
+  std::string text;
+  absl::Status error;
+  ABSL_CHECK(UpperUtf8(GetText(state), &text, &error));
+  std::string out;
+  for (auto s : state) {
+    ABSL_CHECK(LowerUtf8(text, &out, &error));
+    benchmark::DoNotOptimize(out);
+  }
+  SetBytesProcessed(state, text);
+}
+BENCHMARK(BM_LowerUtf8)->Apply(TextArgs);
+
+// STRPOS of a word that is only at the end of the text.
+void BM_StrPosOccurrenceUtf8(benchmark::State& state) {
+  const std::string needle = "needle";
+  const std::string text = absl::StrCat(GetText(state), " ", needle);
+  int64_t out;
+  absl::Status error;
+  for (auto s : state) {
+    ABSL_CHECK(StrPosOccurrenceUtf8(text, needle, 1, 1, &out, &error));
+    benchmark::DoNotOptimize(out);
+  }
+  SetBytesProcessed(state, text);
+}
+BENCHMARK(BM_StrPosOccurrenceUtf8)->Apply(TextArgs);
+
+void BM_TrimSpacesUtf8(benchmark::State& state) {
+  const std::string spaces(16, ' ');
+  const std::string text = absl::StrCat(spaces, GetText(state), spaces);
+  absl::string_view out;
+  absl::Status error;
+  for (auto s : state) {
+    ABSL_CHECK(TrimSpacesUtf8(text, &out, &error));
+    benchmark::DoNotOptimize(out);
+  }
+}
+BENCHMARK(BM_TrimSpacesUtf8)->Apply(TextArgs);
+
+// TRIM(text, '-_.') with a Utf8Trimmer initialized once, as the reference
+// implementation does for constant characters to trim.
+void BM_Utf8TrimmerTrim(benchmark::State& state) {
+  const std::string padding = "-_.-_.-_.-_.-_.-";
+  const std::string text = absl::StrCat(padding, GetText(state), padding);
+  Utf8Trimmer trimmer;
+  absl::Status error;
+  ABSL_CHECK(trimmer.Initialize("-_.", &error));
+  absl::string_view out;
+  for (auto s : state) {
+    ABSL_CHECK(trimmer.Trim(text, &out, &error));
+    benchmark::DoNotOptimize(out);
+  }
+}
+BENCHMARK(BM_Utf8TrimmerTrim)->Apply(TextArgs);
+
+// REPLACE(text, ' ', '_'), which replaces every word separator.
+void BM_ReplaceUtf8(benchmark::State& state) {
+  const std::string text = GetText(state);
+  std::string out;
+  absl::Status error;
+  for (auto s : state) {
+    ABSL_CHECK(ReplaceUtf8(text, " ", "_", &out, &error));
+    benchmark::DoNotOptimize(out);
+  }
+  SetBytesProcessed(state, text);
+}
+BENCHMARK(BM_ReplaceUtf8)->Apply(TextArgs);
+
+// REPLACE(text, 'lazy fox', 'cat'), with a multi-byte search string.
+void BM_ReplaceUtf8Words(benchmark::State& state) {
+  const std::string text = GetText(state);
+  std::string out;
+  absl::Status error;
+  for (auto s : state) {
+    ABSL_CHECK(ReplaceUtf8(text, "lazy fox", "cat", &out, &error));
+    benchmark::DoNotOptimize(out);
+  }
+  SetBytesProcessed(state, text);
+}
+BENCHMARK(BM_ReplaceUtf8Words)->Apply(TextArgs);
+
+// SPLIT(text, ', '), which only matches at the end of the text.
+void BM_SplitUtf8(benchmark::State& state) {
+  const std::string text = absl::StrCat(GetText(state), ", end");
+  std::vector<absl::string_view> out;
+  absl::Status error;
+  for (auto s : state) {
+    ABSL_CHECK(SplitUtf8(text, ", ", &out, &error));
+    benchmark::DoNotOptimize(out);
+  }
+  SetBytesProcessed(state, text);
+}
+BENCHMARK(BM_SplitUtf8)->Apply(TextArgs);
+
+// SPLIT(text, ''), which splits the text into characters.
+void BM_SplitUtf8Characters(benchmark::State& state) {
+  const std::string text = GetText(state);
+  std::vector<absl::string_view> out;
+  absl::Status error;
+  for (auto s : state) {
+    ABSL_CHECK(SplitUtf8(text, "", &out, &error));
+    benchmark::DoNotOptimize(out);
+  }
+  SetBytesProcessed(state, text);
+}
+BENCHMARK(BM_SplitUtf8Characters)->Apply(TextArgs);
+
+void BM_ReverseUtf8(benchmark::State& state) {
+  const std::string text = GetText(state);
+  std::string out;
+  absl::Status error;
+  for (auto s : state) {
+    ABSL_CHECK(ReverseUtf8(text, &out, &error));
+    benchmark::DoNotOptimize(out);
+  }
+  SetBytesProcessed(state, text);
+}
+BENCHMARK(BM_ReverseUtf8)->Apply(TextArgs);
+
+}  // namespace
+}  // namespace functions
+}  // namespace zetasql
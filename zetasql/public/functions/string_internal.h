@@ -0,0 +1,198 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Kernels for the UTF-8 string functions in string.cc.  Text is mostly ASCII,
+// so these skip blocks of 16 ASCII bytes with one SSE2 comparison (two 8-byte
+// words elsewhere), and decode the other blocks a code point at a time.
+
+#ifndef ZETASQL_PUBLIC_FUNCTIONS_STRING_INTERNAL_H_
+#define ZETASQL_PUBLIC_FUNCTIONS_STRING_INTERNAL_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "absl/numeric/bits.h"
+#include "absl/strings/string_view.h"
+#include "unicode/utf8.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace zetasql {
+namespace functions {
+// Do not use any methods from the string_internal namespace.
+namespace string_internal {
+
+constexpr uint64_t kHighBits = 0x8080808080808080ULL;
+
+// The number of bytes that IsAsciiBlock() tests at once.
+constexpr int kBlockSize = 16;
+
+// Returns true if the kBlockSize bytes at <data> are all ASCII.
+inline bool IsAsciiBlock(const char* data) {
+#ifdef __SSE2__
+  return _mm_movemask_epi8(
+             _mm_loadu_si128(reinterpret_cast<const __m128i*>(data))) == 0;
+#else
+  uint64_t words[2];
+  memcpy(words, data, sizeof(words));
+  return ((words[0] | words[1]) & kHighBits) == 0;
+#endif
+}
+
+// Returns the number of leading ASCII bytes in [data, data + size).
+inline size_t AsciiPrefixLength(const char* data, size_t size) {
+  size_t i = 0;
+#ifdef __SSE2__
+  for (; i + kBlockSize <= size; i += kBlockSize) {
+    const __m128i block =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(block));
+    if (mask != 0) return i + absl::countr_zero(mask);
+  }
+#endif
+  for (; i + 8 <= size; i += 8) {
+    uint64_t word;
+    memcpy(&word, data + i, sizeof(word));
+    if ((word & kHighBits) != 0) break;
+  }
+  for (; i < size; ++i) {
+    if (static_cast<uint8_t>(data[i]) >= 0x80) break;
+  }
+  return i;
+}
+
+inline bool IsAscii(absl::string_view str) {
+  return AsciiPrefixLength(str.data(), str.size()) == str.size();
+}
+
+// Returns true and sets <*count> to the number of code points in <str> if it
+// is well-formed UTF-8, with the same rules as U8_NEXT.  Returns false
+// otherwise.
+inline bool CountCodePoints(absl::string_view str, int64_t* count) {
+  const char* data = str.data();
+  const size_t size = str.size();
+  int64_t code_points = 0;
+  size_t i = 0;
+  while (i < size) {
+    if (size - i >= kBlockSize && IsAsciiBlock(data + i)) {
+      code_points += kBlockSize;
+      i += kBlockSize;
+      continue;
+    }
+    // Decode at least to the end of the block, which costs about as much as
+    // testing it for non-ASCII text that only has the odd ASCII space.
+    const size_t block_end = std::min<size_t>(i + kBlockSize, size);
+    while (i < block_end) {
+      UChar32 character;
+      U8_NEXT(data, i, size, character);
+      if (character < 0) return false;
+      ++code_points;
+    }
+  }
+  *count = code_points;
+  return true;
+}
+
+inline bool IsWellFormedUtf8(absl::string_view str) {
+  int64_t unused;
+  return CountCodePoints(str, &unused);
+}
+
+// Returns haystack.find(needle, pos).  Candidates are found with memchr() on
+// the first byte of <needle> until that byte turns out to be common.  Then,
+// with SSE2, the first and last byte of <needle> are compared at 16 positions
+// at a time, and the rest of <needle> only where both match.
+inline size_t FindSubstring(absl::string_view haystack,
+                            absl::string_view needle, size_t pos = 0) {
+  const size_t size = haystack.size();
+  if (needle.size() < 2 || pos > size || needle.size() > size - pos) {
+    return haystack.find(needle, pos);
+  }
+  const char* data = haystack.data();
+  const size_t last_start = size - needle.size();
+  size_t i = pos;
+  // memchr() is faster than the filter below while it skips long spans, so
+  // only give up on it after this many false matches.
+  constexpr int kMaxFalseMatches = 8;
+  for (int false_matches = 0; false_matches < kMaxFalseMatches;
+       ++false_matches) {
+    const void* match = memchr(data + i, needle.front(), last_start - i + 1);
+    if (match == nullptr) return absl::string_view::npos;
+    i = static_cast<const char*>(match) - data;
+    if (memcmp(data + i + 1, needle.data() + 1, needle.size() - 1) == 0) {
+      return i;
+    }
+    if (++i > last_start) return absl::string_view::npos;
+  }
+#ifdef __SSE2__
+  const size_t last_offset = needle.size() - 1;
+  const __m128i first = _mm_set1_epi8(needle.front());
+  const __m128i last = _mm_set1_epi8(needle.back());
+  for (; i + kBlockSize <= last_start + 1; i += kBlockSize) {
+    const __m128i block_first =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    const __m128i block_last = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(data + i + last_offset));
+    uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(
+        _mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last))));
+    while (mask != 0) {
+      const size_t candidate = i + absl::countr_zero(mask);
+      if (memcmp(data + candidate + 1, needle.data() + 1,
+                 needle.size() - 2) == 0) {
+        return candidate;
+      }
+      mask &= mask - 1;
+    }
+  }
+#endif
+  return haystack.find(needle, i);
+}
+
+// Writes the ASCII string <str> to <out>, with lowercase letters mapped to
+// uppercase.  <out> must have room for str.size() bytes.
+inline void AsciiToUpper(absl::string_view str, char* out) {
+  for (size_t i = 0; i < str.size(); ++i) {
+    const uint8_t c = static_cast<uint8_t>(str[i]);
+    out[i] = static_cast<char>(
+        c - (static_cast<uint8_t>(c - 'a') < 26 ? 'a' - 'A' : 0));
+  }
+}
+
+// Writes the ASCII string <str> to <out>, with uppercase letters mapped to
+// lowercase.  <out> must have room for str.size() bytes.
+inline void AsciiToLower(absl::string_view str, char* out) {
+  for (size_t i = 0; i < str.size(); ++i) {
+    const uint8_t c = static_cast<uint8_t>(str[i]);
+    out[i] = static_cast<char>(
+        c + (static_cast<uint8_t>(c - 'A') < 26 ? 'a' - 'A' : 0));
+  }
+}
+
+// Returns true if <c> has the Unicode White_Space property.  Only valid for
+// ASCII characters.
+inline bool IsAsciiWhiteSpace(uint8_t c) {
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+}  // namespace string_internal
+}  // namespace functions
+}  // namespace zetasql
+
+#endif  // ZETASQL_PUBLIC_FUNCTIONS_STRING_INTERNAL_H_
@@ -0,0 +1,162 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/public/functions/string_internal.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/random/random.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/string_view.h"
+#include "unicode/utf8.h"
+
+namespace zetasql {
+namespace functions {
+namespace string_internal {
+namespace {
+
+// Pieces of test strings: ASCII, multi-byte characters, and then ill-formed
+// sequences.
+constexpr size_t kNumValidPieces = 9;
+const std::vector<std::string>& GetPieces() {
+  static const auto* pieces = new std::vector<std::string>{
+      "a",        "Z",        " ",           "\t",       "abcdefghijklmnop",
+      "\xC3\xA9", "\xCE\xA3", "\xE3\x81\x82", "\xF0\x9F\x98\x80",
+      "\xC3",     "\xFF",     "\xED\xA0\x80", "\xF0\x9F\x98",
+  };
+  return *pieces;
+}
+
+// Returns <num_strings> random strings of up to 40 pieces.  The ill-formed
+// pieces are only used if <allow_invalid>.
+std::vector<std::string> RandomStrings(int num_strings, bool allow_invalid) {
+  const std::vector<std::string>& pieces = GetPieces();
+  const size_t num_pieces = allow_invalid ? pieces.size() : kNumValidPieces;
+  absl::BitGen gen;
+  std::vector<std::string> strings;
+  for (int i = 0; i < num_strings; ++i) {
+    std::string str;
+    const int length = absl::Uniform(gen, 0, 40);
+    for (int j = 0; j < length; ++j) {
+      str += pieces[absl::Uniform<size_t>(gen, 0, num_pieces)];
+    }
+    strings.push_back(str);
+  }
+  return strings;
+}
+
+bool CountCodePointsReference(absl::string_view str, int64_t* count) {
+  int64_t code_points = 0;
+  for (size_t i = 0; i < str.size();) {
+    UChar32 character;
+    U8_NEXT(str.data(), i, str.size(), character);
+    if (character < 0) return false;
+    ++code_points;
+  }
+  *count = code_points;
+  return true;
+}
+
+TEST(StringInternalTest, AsciiPrefixLength) {
+  for (size_t size = 0; size < 70; ++size) {
+    for (size_t non_ascii = 0; non_ascii <= size; ++non_ascii) {
+      std::string str(size, 'x');
+      if (non_ascii < size) str[non_ascii] = '\x80';
+      EXPECT_EQ(AsciiPrefixLength(str.data(), str.size()), non_ascii)
+          << size << " " << non_ascii;
+      EXPECT_EQ(IsAscii(str), non_ascii == size);
+      if (size == kBlockSize) {
+        EXPECT_EQ(IsAsciiBlock(str.data()), non_ascii == size) << non_ascii;
+      }
+    }
+  }
+}
+
+TEST(StringInternalTest, CountCodePointsMatchesU8Next) {
+  for (const std::string& str : RandomStrings(5000, /*allow_invalid=*/true)) {
+    int64_t expected = -1;
+    const bool expected_valid = CountCodePointsReference(str, &expected);
+    int64_t count = -1;
+    ASSERT_EQ(CountCodePoints(str, &count), expected_valid) << str;
+    EXPECT_EQ(IsWellFormedUtf8(str), expected_valid) << str;
+    if (expected_valid) {
+      EXPECT_EQ(count, expected) << str;
+    }
+  }
+}
+
+TEST(StringInternalTest, FindSubstringMatchesFind) {
+  const std::vector<std::string> strings =
+      RandomStrings(500, /*allow_invalid=*/false);
+  const std::vector<std::string> needles = {
+      "", "a", "aa", "ab", "a\xC3\xA9", "\xE3\x81\x82\xE3\x81\x82", " \t",
+      "abcdefghijklmnop", "\xF0\x9F\x98\x80" "a"};
+  for (const std::string& str : strings) {
+    for (const std::string& needle : needles) {
+      for (size_t pos = 0; pos <= str.size() + 1; pos += 7) {
+        EXPECT_EQ(FindSubstring(str, needle, pos),
+                  absl::string_view(str).find(needle, pos))
+            << str << " " << needle << " " << pos;
+      }
+    }
+  }
+  // Matches at every position of a long string, and overlapping matches.
+  const std::string long_string(100, 'a');
+  for (size_t pos = 0; pos <= 100; ++pos) {
+    EXPECT_EQ(FindSubstring(long_string, "aaa", pos),
+              pos <= 97 ? pos : absl::string_view::npos);
+  }
+  // The first byte of <needle> is common, which switches from memchr() to
+  // comparing blocks of positions.
+  std::string common_first_byte;
+  for (int i = 0; i < 50; ++i) common_first_byte += "ab";
+  for (size_t pos = 0; pos <= 100; ++pos) {
+    const std::string str = common_first_byte.substr(0, pos) + "ac" +
+                            common_first_byte.substr(pos);
+    EXPECT_EQ(FindSubstring(str, "ac"), pos);
+    EXPECT_EQ(FindSubstring(str, "ac", pos + 1), absl::string_view::npos);
+    EXPECT_EQ(FindSubstring(str, "abc"), absl::string_view::npos);
+  }
+}
+
+TEST(StringInternalTest, AsciiCaseMapping) {
+  std::string all_ascii;
+  for (int c = 0; c < 0x80; ++c) all_ascii.push_back(static_cast<char>(c));
+  std::string out(all_ascii.size(), '\0');
+  AsciiToUpper(all_ascii, out.data());
+  EXPECT_EQ(out, absl::AsciiStrToUpper(all_ascii));
+  AsciiToLower(all_ascii, out.data());
+  EXPECT_EQ(out, absl::AsciiStrToLower(all_ascii));
+}
+
+TEST(StringInternalTest, IsAsciiWhiteSpace) {
+  // The ASCII characters with the Unicode White_Space property.
+  const std::string white_space = "\t\n\v\f\r ";
+  for (int c = 0; c < 0x80; ++c) {
+    EXPECT_EQ(IsAsciiWhiteSpace(c),
+              white_space.find(static_cast<char>(c)) != std::string::npos)
+        << c;
+  }
+}
+
+}  // namespace
+}  // namespace string_internal
+}  // namespace functions
+}  // namespace zetasql
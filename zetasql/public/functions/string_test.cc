@@ -467,6 +467,32 @@ TEST(SubstrWithLength, Utf8) {
   EXPECT_EQ(out, "ЩФБ");
 }
 
+// Positions in runs of 16 or more ASCII characters skip them a block at a time.
+TEST(SubstrWithLength, MixedAsciiAndUtf8) {
+  constexpr absl::string_view kStr =
+      "abcdefghijklmnopqrstбвгuvwxyzABCDEFGHIJKLMN";
+  absl::Status error;
+  absl::string_view out;
+  EXPECT_TRUE(SubstrWithLengthUtf8(kStr, 21, 5, &out, &error));
+  EXPECT_EQ(out, "бвгuv");
+  EXPECT_TRUE(SubstrWithLengthUtf8(kStr, 2, 40, &out, &error));
+  EXPECT_EQ(out, "bcdefghijklmnopqrstбвгuvwxyzABCDEFGHIJKL");
+  EXPECT_TRUE(SubstrWithLengthUtf8(kStr, -22, 4, &out, &error));
+  EXPECT_EQ(out, "вгuv");
+  EXPECT_TRUE(SubstrWithLengthUtf8(kStr, -40, 30, &out, &error));
+  EXPECT_EQ(out, "defghijklmnopqrstбвгuvwxyzABCD");
+  EXPECT_TRUE(SubstrWithLengthUtf8(kStr, -40, 5, &out, &error));
+  EXPECT_EQ(out, "defgh");
+  EXPECT_FALSE(SubstrWithLengthUtf8("abcdefghijklmnopqrst\xA4uvwxyz", 22, 2,
+                                    &out, &error));
+
+  int64_t position;
+  EXPECT_TRUE(StrposUtf8(kStr, "uv", &position, &error));
+  EXPECT_EQ(position, 24);
+  EXPECT_TRUE(StrposUtf8(kStr, "MN", &position, &error));
+  EXPECT_EQ(position, 42);
+}
+
 TEST(Replace, HandleExplodingStringLength) {
   absl::Status error;
   std::string generation0 = "22222222";
@@ -607,6 +633,80 @@ TEST(Trim, Utf8) {
   TestUtf8Trimmer(trimmer, kIllFormed, kIllFormed, kIllFormed, kIllFormed);
 }
 
+// Characters to trim that are all ASCII are checked byte by byte, and trimming
+// white space only uses icu for non-ASCII characters.
+TEST(Trim, AsciiFastPaths) {
+  constexpr absl::string_view kIllFormed = "\xA4";
+  Utf8Trimmer trimmer;
+  absl::Status error;
+  EXPECT_TRUE(trimmer.Initialize("xy", &error));
+  TestUtf8Trimmer(trimmer, "xyaxy", "axy", "xya", "a");
+  TestUtf8Trimmer(trimmer, "xyбxy", "бxy", "xyб", "б");
+  TestUtf8Trimmer(trimmer, "xy", "", "", "");
+  TestUtf8Trimmer(trimmer, "xy\ufffdxy", "\ufffdxy", "xy\ufffd", "\ufffd");
+  TestUtf8Trimmer(trimmer, kIllFormed, kIllFormed, kIllFormed, kIllFormed);
+
+  // Trimming a mix of ASCII and other characters.
+  EXPECT_TRUE(trimmer.Initialize("xб", &error));
+  TestUtf8Trimmer(trimmer, "xбaбx", "aбx", "xбa", "a");
+
+  absl::string_view out;
+  EXPECT_TRUE(TrimSpacesUtf8(" \t\n\v\f\rabc \r\n", &out, &error));
+  EXPECT_EQ(out, "abc");
+  EXPECT_TRUE(TrimSpacesUtf8(" \t\r\n ", &out, &error));
+  EXPECT_EQ(out, "");
+  // Non-ASCII white space, after ASCII white space.
+  EXPECT_TRUE(TrimSpacesUtf8(" \u00a0 \u3000abc\u2028 \u0085 ", &out, &error));
+  EXPECT_EQ(out, "abc");
+  EXPECT_TRUE(LeftTrimSpacesUtf8(" \u00a0б ", &out, &error));
+  EXPECT_EQ(out, "б ");
+  EXPECT_TRUE(RightTrimSpacesUtf8(" б\u00a0 ", &out, &error));
+  EXPECT_EQ(out, " б");
+  // Control characters that are not white space are not trimmed.
+  EXPECT_TRUE(TrimSpacesUtf8("\x1c\x1f", &out, &error));
+  EXPECT_EQ(out, "\x1c\x1f");
+  EXPECT_TRUE(TrimSpacesUtf8(" \xA4 ", &out, &error));
+  EXPECT_EQ(out, "\xA4");
+}
+
+TEST(UpperLower, AsciiAndUtf8) {
+  absl::Status error;
+  std::string out;
+  EXPECT_TRUE(UpperUtf8("abc XYZ 123 @[`{", &out, &error));
+  EXPECT_EQ(out, "ABC XYZ 123 @[`{");
+  EXPECT_TRUE(LowerUtf8("abc XYZ 123 @[`{", &out, &error));
+  EXPECT_EQ(out, "abc xyz 123 @[`{");
+  EXPECT_TRUE(UpperUtf8("straße", &out, &error));
+  EXPECT_EQ(out, "STRASSE");
+  // A final sigma depends on the preceding ASCII letters.
+  EXPECT_TRUE(LowerUtf8("ABΣ", &out, &error));
+  EXPECT_EQ(out, "abς");
+  EXPECT_TRUE(LowerUtf8("Σ", &out, &error));
+  EXPECT_EQ(out, "σ");
+}
+
+TEST(Reverse, MixedAsciiAndUtf8) {
+  absl::Status error;
+  std::string out;
+  EXPECT_TRUE(ReverseUtf8("abcdefghijklmnopqrstuvwxyz", &out, &error));
+  EXPECT_EQ(out, "zyxwvutsrqponmlkjihgfedcba");
+  EXPECT_TRUE(ReverseUtf8("abcбвг𐍈xyz0123456789abcdefgh", &out, &error));
+  EXPECT_EQ(out, "hgfedcba9876543210zyx𐍈гвбcba");
+  EXPECT_FALSE(ReverseUtf8("abc\xA4xyz", &out, &error));
+}
+
+TEST(Length, MixedAsciiAndUtf8) {
+  absl::Status error;
+  int64_t out;
+  EXPECT_TRUE(LengthUtf8("", &out, &error));
+  EXPECT_EQ(out, 0);
+  EXPECT_TRUE(LengthUtf8("abcdefghijklmnopqrstuvwxyz", &out, &error));
+  EXPECT_EQ(out, 26);
+  EXPECT_TRUE(LengthUtf8("abcdefghijklmnopбвг𐍈xyz", &out, &error));
+  EXPECT_EQ(out, 23);
+  EXPECT_FALSE(LengthUtf8("abcdefghijklmnop\xA4", &out, &error));
+}
+
 TEST(Split, Utf8) {
   absl::Status error;
   std::vector<std::string> result;
@@ -670,6 +770,20 @@ TEST(Split, Utf8) {
   EXPECT_TRUE(SplitBytes("विभिवि", "भि", &result, &error));
   EXPECT_THAT(result, ::testing::ElementsAre("वि", "वि"));
 
+  // Empty delimiter with a mix of ASCII and other characters.
+  EXPECT_TRUE(SplitUtf8("abбвcd𐍈e", "", &result, &error));
+  EXPECT_THAT(result, ::testing::ElementsAre("a", "b", "б", "в", "c", "d", "𐍈",
+                                             "e"));
+  EXPECT_FALSE(SplitUtf8("ab\xA4", "", &result, &error));
+  error = absl::OkStatus();
+
+  // Delimiters at the start and end, repeated, and longer than 16 bytes.
+  EXPECT_TRUE(SplitUtf8(",,a,,", ",,", &result, &error));
+  EXPECT_THAT(result, ::testing::ElementsAre("", "a", ""));
+  EXPECT_TRUE(SplitUtf8("abcdefghijklmnopqrstuvwxyz-abcdefghijklmnopqrstuvwxyz",
+                        "abcdefghijklmnopqrstuvwxyz", &result, &error));
+  EXPECT_THAT(result, ::testing::ElementsAre("", "-", ""));
+
   // UTF8 string with invalid UTF8 delimiter fails.
   EXPECT_FALSE(SplitUtf8("विभि", "\xA4", &result, &error));
   EXPECT_THAT(
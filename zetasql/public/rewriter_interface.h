@@ -82,6 +82,24 @@ class Rewriter {
     return Rewrite(options, *input, catalog, type_factory, output_properties);
   }
 
+  // Change-tracking variant of the in-place Rewrite() above. Sets '*changed'
+  // to false if the returned tree is exactly 'input', unmodified.
+  //
+  // The rewrite driver uses this to tell when the set of rewriters has reached
+  // a fixed point without re-checking the whole tree for relevant rewriters.
+  // Rewriters that can tell cheaply whether they made a change should override
+  // this. The default calls Rewrite() and conservatively reports a change.
+  virtual absl::StatusOr<std::unique_ptr<const ResolvedNode>>
+  RewriteWithChangeTracking(const AnalyzerOptions& options,
+                            std::unique_ptr<const ResolvedNode> input,
+                            Catalog& catalog, TypeFactory& type_factory,
+                            AnalyzerOutputProperties& output_properties,
+                            bool* changed) const {
+    *changed = true;
+    return Rewrite(options, std::move(input), catalog, type_factory,
+                   output_properties);
+  }
+
   virtual std::string Name() const = 0;
 
  protected:
@@ -404,14 +404,20 @@ void SimpleCatalog::AddOwnedTable(absl::string_view name,
   owned_tables_.push_back(std::move(table));
 }
 
-bool SimpleCatalog::AddOwnedTableIfNotPresent(
-    absl::string_view name, std::unique_ptr<const Table> table) {
+bool SimpleCatalog::AddTableIfNotPresent(absl::string_view name,
+                                         const Table* table) {
   absl::MutexLock l(&mutex_);
   const std::string canonical_name = absl::AsciiStrToLower(name);
-  if (!zetasql_base::InsertIfNotPresent(&global_names_, canonical_name) ||
-      !zetasql_base::InsertIfNotPresent(&tables_, canonical_name, table.get())) {
+  return zetasql_base::InsertIfNotPresent(&global_names_, canonical_name) &&
+         zetasql_base::InsertIfNotPresent(&tables_, canonical_name, table);
+}
+
+bool SimpleCatalog::AddOwnedTableIfNotPresent(
+    absl::string_view name, std::unique_ptr<const Table> table) {
+  if (!AddTableIfNotPresent(name, table.get())) {
     return false;
   }
+  absl::MutexLock l(&mutex_);
   owned_tables_.emplace_back(std::move(table));
   return true;
 }
@@ -619,14 +625,14 @@ void SimpleCatalog::AddOwnedFunction(const Function* function) {
   AddOwnedFunction(function->Name(), absl::WrapUnique(function));
 }
 
-bool SimpleCatalog::AddOwnedFunctionIfNotPresent(
-    const std::string& name, std::unique_ptr<Function>* function) {
+bool SimpleCatalog::AddFunctionIfNotPresent(const std::string& name,
+                                            const Function* function) {
   absl::MutexLock l(&mutex_);
   // If the function name exists, return false.
   if (functions_.contains(absl::AsciiStrToLower(name))) {
     return false;
   }
-  const std::string alias_name = (*function)->alias_name();
+  const std::string& alias_name = function->alias_name();
   // If the function has an alias and the alias exists, return false.
   if (!alias_name.empty() &&
       zetasql_base::CaseCompare(alias_name, name) != 0) {
@@ -634,7 +640,17 @@ bool SimpleCatalog::AddOwnedFunctionIfNotPresent(
       return false;
     }
   }
-  AddOwnedFunctionLocked(name, std::move(*function));
+  AddFunctionLocked(name, function);
+  return true;
+}
+
+bool SimpleCatalog::AddOwnedFunctionIfNotPresent(
+    const std::string& name, std::unique_ptr<Function>* function) {
+  if (!AddFunctionIfNotPresent(name, function->get())) {
+    return false;
+  }
+  absl::MutexLock l(&mutex_);
+  owned_functions_.emplace_back(std::move(*function));
   return true;
 }
 
@@ -160,6 +160,8 @@ class SimpleCatalog : public EnumerableCatalog {
   void AddTable(absl::string_view name, const Table* table)
       ABSL_LOCKS_EXCLUDED(mutex_);
   void AddTable(const Table* table) ABSL_LOCKS_EXCLUDED(mutex_);
+  bool AddTableIfNotPresent(absl::string_view name, const Table* table)
+      ABSL_LOCKS_EXCLUDED(mutex_);
   void AddOwnedTable(absl::string_view name, std::unique_ptr<const Table> table)
       ABSL_LOCKS_EXCLUDED(mutex_);
   bool AddOwnedTableIfNotPresent(absl::string_view name,
@@ -230,6 +232,10 @@ class SimpleCatalog : public EnumerableCatalog {
   void AddFunction(const std::string& name, const Function* function)
       ABSL_LOCKS_EXCLUDED(mutex_);
   void AddFunction(const Function* function) ABSL_LOCKS_EXCLUDED(mutex_);
+  // Return true if actually inserted.
+  bool AddFunctionIfNotPresent(const std::string& name,
+                               const Function* function)
+      ABSL_LOCKS_EXCLUDED(mutex_);
   void AddOwnedFunction(const std::string& name,
                         std::unique_ptr<const Function> function);
   void AddOwnedFunction(std::unique_ptr<const Function> function)
@@ -18,6 +18,8 @@
 
 #include <ctype.h>
 
+#include <cstdint>
+#include <cstring>
 #include <iterator>
 #include <string>
 #include <vector>
@@ -53,6 +55,34 @@ static int HexDigitToInt(char x) {
   return x & 0xf;
 }
 
+// Returns a pointer to the first byte in [<p>, <end>) that is equal to <a> or
+// <b>, or <end> if there is none.  String literals are mostly runs of plain
+// characters, and can be megabytes long in generated SQL, so this checks eight
+// bytes at a time.
+static const char* FindFirstOf(const char* p, const char* end, char a,
+                               char b) {
+  constexpr uint64_t kLowBits = 0x0101010101010101ULL;
+  constexpr uint64_t kHighBits = 0x8080808080808080ULL;
+  const uint64_t a_bytes = kLowBits * static_cast<uint8_t>(a);
+  const uint64_t b_bytes = kLowBits * static_cast<uint8_t>(b);
+  while (end - p >= 8) {
+    uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+    // A byte of <word> matches iff the corresponding byte of the xor is zero.
+    const uint64_t a_xor = word ^ a_bytes;
+    const uint64_t b_xor = word ^ b_bytes;
+    if ((((a_xor - kLowBits) & ~a_xor) | ((b_xor - kLowBits) & ~b_xor)) &
+        kHighBits) {
+      break;
+    }
+    p += 8;
+  }
+  while (p < end && *p != a && *p != b) {
+    ++p;
+  }
+  return p;
+}
+
 // Returns true when following conditions are met:
 // - <closing_str> is a suffix of <source>.
 // - No other unescaped occurrence of <closing_str> inside <source> (apart from
@@ -68,8 +98,21 @@ static bool CheckForClosingString(absl::string_view source,
   const char* p = source.data();
   const char* end = source.end();
 
+  // <closing_str> can only start before <limit>.
+  const char* limit = source.size() >= closing_str.size()
+                          ? end - closing_str.size() + 1
+                          : p;
+
   bool is_closed = false;
-  while (p + closing_str.length() <= end) {
+  while (p < limit) {
+    // Characters other than a backslash or the first character of
+    // <closing_str> can be skipped in bulk.
+    const char* next = FindFirstOf(p, limit, '\\', closing_str[0]);
+    if (next != p) {
+      is_closed = false;
+      p = next;
+      continue;
+    }
     if (*p != '\\') {
       const int cur_pos = p - source.begin();
       const bool is_closing =
@@ -184,6 +227,14 @@ static bool CUnescapeInternal(absl::string_view source,
   const char* last_byte = end - 1;
 
   while (p < end) {
+    // Copy runs of characters that are not escapes or newlines in bulk.
+    const char* run_end = FindFirstOf(p, end, '\\', '\r');
+    if (run_end != p) {
+      std::memcpy(d, p, run_end - p);
+      d += run_end - p;
+      p = run_end;
+      continue;
+    }
     if (*p != '\\') {
       if (*p != '\r') {
         *d++ = *p++;
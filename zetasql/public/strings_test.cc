@@ -929,6 +929,25 @@ TEST(StringsTest, TestNewlines) {
   ExpectParsedString("a\r\nb", {"'''a\\r\\nb'''"});
 }
 
+// Long literals are scanned several bytes at a time; check escapes, newlines
+// and quotes at every position relative to that.
+TEST(StringsTest, LongLiterals) {
+  for (int prefix_length = 0; prefix_length < 20; ++prefix_length) {
+    const std::string prefix(prefix_length, 'a');
+    const std::string suffix(20 - prefix_length, 'b');
+    ExpectParsedString(absl::StrCat(prefix, "\n", suffix),
+                       {absl::StrCat("'", prefix, "\\n", suffix, "'"),
+                        absl::StrCat("'''", prefix, "\r\n", suffix, "'''")});
+    ExpectParsedString(absl::StrCat(prefix, "'", suffix),
+                       {absl::StrCat("'", prefix, "\\'", suffix, "'"),
+                        absl::StrCat("\"", prefix, "'", suffix, "\"")});
+    ExpectParsedString(absl::StrCat(prefix, "\\x", suffix),
+                       {absl::StrCat("r'", prefix, "\\x", suffix, "'")});
+    TestInvalidString(absl::StrCat("'", prefix, "'", suffix, "'"),
+                      prefix_length + 1, "String cannot contain unescaped '");
+  }
+}
+
 TEST(RawStringsTest, CompareRawAndRegularStringParsing) {
   ExpectParsedString("\\n",
                      {"r'\\n'", "r\"\\n\"", "r'''\\n'''", "r\"\"\"\\n\"\"\""});
@@ -25,6 +25,7 @@
 #include <set>
 #include <stack>
 #include <string>
+#include <tuple>
 #include <unordered_set>
 #include <utility>
 #include <variant>
@@ -32,6 +33,7 @@
 
 #include "zetasql/base/logging.h"
 #include "google/protobuf/descriptor.h"
+#include "zetasql/analyzer/expr_matching_helpers.h"
 #include "zetasql/analyzer/expr_resolver_helper.h"
 #include "zetasql/common/aggregate_null_handling.h"
 #include "zetasql/common/thread_stack.h"
@@ -62,6 +64,8 @@
 #include "zetasql/resolved_ast/resolved_node_kind.pb.h"
 #include "zetasql/resolved_ast/serialization.pb.h"
 #include "absl/cleanup/cleanup.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -1544,6 +1548,15 @@ absl::StatusOr<std::unique_ptr<ValueExpr>> Algebrizer::AlgebrizeExpression(
       "Out of stack space due to deeply nested query expression "
       "during algebrizing");
 
+  if (!common_subexpression_variables_.empty()) {
+    auto it = common_subexpression_variables_.find(expr);
+    if (it != common_subexpression_variables_.end()) {
+      ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ValueExpr> deref,
+                       DerefExpr::Create(it->second, expr->type()));
+      return deref;
+    }
+  }
+
   if (!expr->type()->IsSupportedType(language_options_)) {
     return ::zetasql_base::InvalidArgumentErrorBuilder()
            << "Type not found: "
@@ -4384,6 +4397,148 @@ Algebrizer::AlgebrizeExceptIntersectScan(
   }
 }
 
+// Returns true if <function> may skip evaluating some of its arguments, or
+// evaluate them without propagating their errors.
+static bool IsConditionalFunction(const Function* function) {
+  static const auto* kConditionalFunctions =
+      new absl::flat_hash_set<absl::string_view>{
+          "$and",     "$or",    "$case_no_value", "$case_with_value",
+          "coalesce", "if",     "ifnull",         "nullif",
+          "iferror",  "iserror", "nulliferror"};
+  return function->IsZetaSQLBuiltin() &&
+         kConditionalFunctions->contains(function->Name());
+}
+
+// Appends to <candidates> the subexpressions of <expr>, including <expr>
+// itself, that are worth evaluating only once and that are evaluated whenever
+// <expr> is, along with the height of each. Subexpressions under conditional
+// functions, SAFE function calls, safe casts, subqueries and lambdas are not
+// collected, since computing them ahead of time could raise errors that the
+// query does not. Returns the height of <expr> counting only the collected
+// paths, so a subexpression's height is always less than that of any
+// collected expression that contains it.
+static int CollectCommonSubexpressionCandidates(
+    const ResolvedExpr* expr,
+    std::vector<std::pair<const ResolvedExpr*, int>>* candidates) {
+  std::vector<const ResolvedExpr*> children;
+  bool is_candidate = false;
+  switch (expr->node_kind()) {
+    case RESOLVED_FUNCTION_CALL: {
+      const ResolvedFunctionCall* call = expr->GetAs<ResolvedFunctionCall>();
+      is_candidate = true;
+      if (call->error_mode() != ResolvedFunctionCall::SAFE_ERROR_MODE &&
+          !IsConditionalFunction(call->function())) {
+        for (const auto& argument : call->argument_list()) {
+          children.push_back(argument.get());
+        }
+      }
+      break;
+    }
+    case RESOLVED_CAST: {
+      const ResolvedCast* cast = expr->GetAs<ResolvedCast>();
+      is_candidate = true;
+      if (!cast->return_null_on_error()) {
+        children.push_back(cast->expr());
+      }
+      break;
+    }
+    case RESOLVED_GET_PROTO_FIELD:
+      is_candidate = true;
+      children.push_back(expr->GetAs<ResolvedGetProtoField>()->expr());
+      break;
+    case RESOLVED_GET_JSON_FIELD:
+      is_candidate = true;
+      children.push_back(expr->GetAs<ResolvedGetJsonField>()->expr());
+      break;
+    case RESOLVED_GET_STRUCT_FIELD:
+      children.push_back(expr->GetAs<ResolvedGetStructField>()->expr());
+      break;
+    case RESOLVED_MAKE_STRUCT:
+      for (const auto& field : expr->GetAs<ResolvedMakeStruct>()->field_list()) {
+        children.push_back(field.get());
+      }
+      break;
+    default:
+      break;
+  }
+
+  int height = 0;
+  for (const ResolvedExpr* child : children) {
+    height = std::max(height,
+                      CollectCommonSubexpressionCandidates(child, candidates) + 1);
+  }
+  if (is_candidate) {
+    candidates->emplace_back(expr, height);
+  }
+  return height;
+}
+
+absl::Status Algebrizer::AlgebrizeCommonSubexpressions(
+    absl::Span<const ResolvedExpr* const> exprs,
+    std::vector<std::unique_ptr<ExprArg>>* arguments) {
+  std::vector<std::pair<const ResolvedExpr*, int>> candidates;
+  for (const ResolvedExpr* expr : exprs) {
+    CollectCommonSubexpressionCandidates(expr, &candidates);
+  }
+  if (candidates.size() < 2) {
+    return absl::OkStatus();
+  }
+
+  // Group equivalent candidates. Candidates are only compared with
+  // IsSameExpressionForGroupBy() if they have the same node kind, height and
+  // type, which keeps the number of comparisons down. Volatile expressions
+  // are never equivalent.
+  struct Group {
+    int height;
+    std::vector<const ResolvedExpr*> members;
+  };
+  std::vector<Group> groups;
+  absl::flat_hash_map<std::tuple<ResolvedNodeKind, int, const Type*>,
+                      std::vector<int>>
+      groups_by_signature;
+  for (const auto& [candidate, height] : candidates) {
+    std::vector<int>& signature_groups = groups_by_signature[std::make_tuple(
+        candidate->node_kind(), height, candidate->type())];
+    bool found = false;
+    for (int group_index : signature_groups) {
+      ZETASQL_ASSIGN_OR_RETURN(
+          found, IsSameExpressionForGroupBy(groups[group_index].members.front(),
+                                            candidate));
+      if (found) {
+        groups[group_index].members.push_back(candidate);
+        break;
+      }
+    }
+    if (!found) {
+      signature_groups.push_back(static_cast<int>(groups.size()));
+      groups.push_back(Group{height, {candidate}});
+    }
+  }
+
+  std::vector<const Group*> repeated_groups;
+  for (const Group& group : groups) {
+    if (group.members.size() > 1) {
+      repeated_groups.push_back(&group);
+    }
+  }
+  std::stable_sort(repeated_groups.begin(), repeated_groups.end(),
+                   [](const Group* group1, const Group* group2) {
+                     return group1->height < group2->height;
+                   });
+  for (const Group* group : repeated_groups) {
+    // This must happen before the group's own occurrences are recorded, or
+    // the first occurrence would be algebrized as a read of itself.
+    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ValueExpr> value,
+                     AlgebrizeExpression(group->members.front()));
+    const VariableId variable = variable_gen_->GetNewVariableName("cse");
+    arguments->push_back(std::make_unique<ExprArg>(variable, std::move(value)));
+    for (const ResolvedExpr* member : group->members) {
+      common_subexpression_variables_[member] = variable;
+    }
+  }
+  return absl::OkStatus();
+}
+
 absl::StatusOr<std::unique_ptr<RelationalOp>> Algebrizer::AlgebrizeProjectScan(
     const ResolvedProjectScan* resolved_project,
     std::vector<FilterConjunctInfo*>* active_conjuncts) {
@@ -4422,6 +4577,26 @@ absl::StatusOr<std::unique_ptr<RelationalOp>> Algebrizer::AlgebrizeProjectScan(
   // Assign variables to the new columns and algebrize their definitions.
   std::vector<std::unique_ptr<ExprArg>> arguments;
   arguments.reserve(defined_columns_and_exprs.size());
+  // The recorded subexpressions belong to this projection. This can be nested
+  // in another one, through a subquery in its expressions, so the enclosing
+  // projection's subexpressions are set aside and restored on every return.
+  absl::flat_hash_map<const ResolvedExpr*, VariableId>
+      enclosing_common_subexpression_variables;
+  enclosing_common_subexpression_variables.swap(
+      common_subexpression_variables_);
+  absl::Cleanup restore_common_subexpressions =
+      [this, &enclosing_common_subexpression_variables] {
+        common_subexpression_variables_ =
+            std::move(enclosing_common_subexpression_variables);
+      };
+  if (algebrizer_options_.eliminate_common_subexpressions) {
+    std::vector<const ResolvedExpr*> exprs;
+    exprs.reserve(defined_columns_and_exprs.size());
+    for (const auto& entry : defined_columns_and_exprs) {
+      exprs.push_back(entry.second);
+    }
+    ZETASQL_RETURN_IF_ERROR(AlgebrizeCommonSubexpressions(exprs, &arguments));
+  }
   for (const auto& entry : defined_columns_and_exprs) {
     const ResolvedColumn& column = entry.first;
     const ResolvedExpr* expr = entry.second;
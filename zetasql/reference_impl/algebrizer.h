@@ -48,9 +48,11 @@
 #include "gtest/gtest_prod.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/types/optional.h"
+#include "absl/types/span.h"
 #include "absl/types/variant.h"
 #include "zetasql/base/status.h"
 
@@ -76,6 +78,11 @@ struct AlgebrizerOptions {
   // LIMIT instead of LimitOp(SortOp), which saves memory.
   bool allow_order_by_limit_operator = false;
 
+  // If true, deterministic subexpressions that occur more than once among the
+  // expressions computed by a single projection are evaluated once per row,
+  // into a separate slot, and every occurrence reads that slot.
+  bool eliminate_common_subexpressions = false;
+
   // If true, the algebrizer attempts to push down filters into the highest
   // ancestor node that is either a join or an EvaluatorTableScanOp node. In the
   // latter case, the filter remains in its original location because
@@ -431,6 +438,16 @@ class Algebrizer {
   absl::StatusOr<std::unique_ptr<RelationalOp>> AlgebrizeProjectScan(
       const ResolvedProjectScan* resolved_project,
       std::vector<FilterConjunctInfo*>* active_conjuncts);
+  // Finds subexpressions that occur more than once among <exprs> and that
+  // are evaluated whenever the expression containing them is. Algebrizes one
+  // copy of each into <arguments>, under a new variable, and records that
+  // variable for all of its occurrences in 'common_subexpression_variables_'.
+  // AlgebrizeExpression() then reads the variable instead of evaluating an
+  // occurrence again. Inner subexpressions are added to <arguments> before
+  // the expressions that contain them.
+  absl::Status AlgebrizeCommonSubexpressions(
+      absl::Span<const ResolvedExpr* const> exprs,
+      std::vector<std::unique_ptr<ExprArg>>* arguments);
   // 'limit' and 'offset' may both be NULL or both non-NULL.
   absl::StatusOr<std::unique_ptr<SortOp>> AlgebrizeOrderByScan(
       const ResolvedOrderByScan* scan, std::unique_ptr<ValueExpr> limit,
@@ -946,6 +963,10 @@ class Algebrizer {
   // Generates variable names corresponding to query parameters or columns.
   // Owned by 'column_to_variable_'.
   VariableGenerator* variable_gen_;
+  // Subexpressions that AlgebrizeCommonSubexpressions() has computed into a
+  // variable, for the projection being algebrized.
+  absl::flat_hash_map<const ResolvedExpr*, VariableId>
+      common_subexpression_variables_;
   // Maps parameters to variables for named parameters or else contains a list
   // of positional parameters. Not owned.
   Parameters* parameters_;
@@ -1532,6 +1532,28 @@ absl::StatusOr<JSONValueConstRef> GetJSONValueConstRef(
   return json_storage.GetConstRef();
 }
 
+// Returns the time zone named by arguments[<index>], resolved with
+// MakeTimeZone(), or nullopt if that is not a non-null constant string.  Like
+// regexps and formats, an invalid constant time zone is not reported here, but
+// for each row, so that SAFE function variants work correctly.
+std::optional<absl::StatusOr<absl::TimeZone>> ResolveConstTimeZone(
+    const std::vector<std::unique_ptr<AlgebraArg>>& arguments, size_t index) {
+  if (index >= arguments.size() ||
+      !arguments[index]->value_expr()->IsConstant()) {
+    return std::nullopt;
+  }
+  const Value& timezone_string =
+      static_cast<const ConstExpr*>(arguments[index]->value_expr())->value();
+  if (timezone_string.is_null() || timezone_string.type_kind() != TYPE_STRING) {
+    return std::nullopt;
+  }
+  absl::TimeZone timezone;
+  absl::Status status =
+      functions::MakeTimeZone(timezone_string.string_value(), &timezone);
+  if (!status.ok()) return status;
+  return timezone;
+}
+
 }  // namespace
 
 absl::Status MakeMaxArrayValueByteSizeExceededError(
@@ -2079,29 +2101,42 @@ BuiltinScalarFunction::CreateValidatedRaw(
     case FunctionKind::kTimeTrunc:
     case FunctionKind::kDateTrunc:
     case FunctionKind::kTimestampTrunc:
-      return new DateTimeTruncFunction(kind, output_type);
+      return new DateTimeTruncFunction(kind, output_type,
+                                       ResolveConstTimeZone(arguments, 2));
     case FunctionKind::kLastDay:
       return new LastDayFunction(kind, output_type);
     case FunctionKind::kExtractFrom:
-      return new ExtractFromFunction(kind, output_type);
+      return new ExtractFromFunction(kind, output_type,
+                                     ResolveConstTimeZone(arguments, 2));
     case FunctionKind::kExtractDateFrom:
-      return new ExtractDateFromFunction(kind, output_type);
+      return new ExtractDateFromFunction(kind, output_type,
+                                         ResolveConstTimeZone(arguments, 1));
     case FunctionKind::kExtractTimeFrom:
-      return new ExtractTimeFromFunction(kind, output_type);
+      return new ExtractTimeFromFunction(kind, output_type,
+                                         ResolveConstTimeZone(arguments, 1));
     case FunctionKind::kExtractDatetimeFrom:
-      return new ExtractDatetimeFromFunction(kind, output_type);
+      return new ExtractDatetimeFromFunction(
+          kind, output_type, ResolveConstTimeZone(arguments, 1));
     case FunctionKind::kFormatDate:
     case FunctionKind::kFormatDatetime:
     case FunctionKind::kFormatTimestamp:
-      return new FormatDateDatetimeTimestampFunction(kind, output_type);
     case FunctionKind::kFormatTime:
-      return new FormatTimeFunction(kind, output_type);
+    case FunctionKind::kParseDate:
+    case FunctionKind::kParseDatetime:
+    case FunctionKind::kParseTime:
+    case FunctionKind::kParseTimestamp: {
+      ZETASQL_ASSIGN_OR_RETURN(
+          auto fct, CreateDateTimeFormatFunction(kind, output_type, arguments));
+      return fct.release();
+    }
     case FunctionKind::kTimestamp:
-      return new TimestampConversionFunction(kind, output_type);
+      return new TimestampConversionFunction(
+          kind, output_type, ResolveConstTimeZone(arguments, 1));
     case FunctionKind::kDate:
     case FunctionKind::kTime:
     case FunctionKind::kDatetime:
-      return new CivilTimeConstructionAndConversionFunction(kind, output_type);
+      return new CivilTimeConstructionAndConversionFunction(
+          kind, output_type, ResolveConstTimeZone(arguments, 1));
     case FunctionKind::kTimestampSeconds:
     case FunctionKind::kTimestampMillis:
     case FunctionKind::kTimestampMicros:
@@ -2125,14 +2160,6 @@ BuiltinScalarFunction::CreateValidatedRaw(
       return new ToProtoFunction(kind, output_type);
     case FunctionKind::kEnumValueDescriptorProto:
       return new EnumValueDescriptorProtoFunction(kind, output_type);
-    case FunctionKind::kParseDate:
-      return new ParseDateFunction(kind, output_type);
-    case FunctionKind::kParseDatetime:
-      return new ParseDatetimeFunction(kind, output_type);
-    case FunctionKind::kParseTime:
-      return new ParseTimeFunction(kind, output_type);
-    case FunctionKind::kParseTimestamp:
-      return new ParseTimestampFunction(kind, output_type);
     case FunctionKind::kIntervalCtor:
     case FunctionKind::kMakeInterval:
     case FunctionKind::kJustifyHours:
@@ -2382,6 +2409,106 @@ BuiltinScalarFunction::CreateRegexpFunction(
                                           output_type);
 }
 
+namespace {
+
+// FORMAT_DATE, FORMAT_DATETIME and FORMAT_TIMESTAMP expand both %Q and %J.
+constexpr functions::FormatDateTimestampOptions kFormatDateTimestampOptions = {
+    .expand_Q = true, .expand_J = true};
+
+// Returns a <Compiled> built from <args> and the format string in the first
+// of <arguments>, or null if that is not a non-null constant.
+template <typename Compiled, typename... Args>
+std::unique_ptr<const Compiled> CompileConstFormat(
+    const std::vector<std::unique_ptr<AlgebraArg>>& arguments,
+    const Args&... args) {
+  if (arguments.empty() || !arguments[0]->value_expr()->IsConstant()) {
+    return nullptr;
+  }
+  const Value& format =
+      static_cast<const ConstExpr*>(arguments[0]->value_expr())->value();
+  if (format.is_null() || format.type_kind() != TYPE_STRING) {
+    return nullptr;
+  }
+  return std::make_unique<const Compiled>(format.string_value(), args...);
+}
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<BuiltinScalarFunction>>
+BuiltinScalarFunction::CreateDateTimeFormatFunction(
+    FunctionKind kind, const Type* output_type,
+    const std::vector<std::unique_ptr<AlgebraArg>>& arguments) {
+  using functions::DateTimeFormatter;
+  using functions::DateTimeFormatTarget;
+  using functions::DateTimeParser;
+  ZETASQL_RET_CHECK_GE(arguments.size(), 2);
+  // Like regexps, constant formats are compiled without reporting errors here.
+  // Errors in the format are reported for each row instead, so that SAFE
+  // function variants work correctly.
+  switch (kind) {
+    case FunctionKind::kFormatDate:
+    case FunctionKind::kFormatDatetime:
+    case FunctionKind::kFormatTimestamp: {
+      std::unique_ptr<const DateTimeFormatter> const_formatter;
+      switch (arguments[1]->value_expr()->output_type()->kind()) {
+        case TYPE_DATE:
+          const_formatter = CompileConstFormat<DateTimeFormatter>(
+              arguments, DateTimeFormatTarget::kDate,
+              kFormatDateTimestampOptions);
+          break;
+        case TYPE_DATETIME:
+          const_formatter = CompileConstFormat<DateTimeFormatter>(
+              arguments, DateTimeFormatTarget::kDatetime,
+              kFormatDateTimestampOptions);
+          break;
+        case TYPE_TIMESTAMP:
+          const_formatter = CompileConstFormat<DateTimeFormatter>(
+              arguments, DateTimeFormatTarget::kTimestamp,
+              kFormatDateTimestampOptions);
+          break;
+        default:
+          break;
+      }
+      return std::make_unique<FormatDateDatetimeTimestampFunction>(
+          std::move(const_formatter), kind, output_type,
+          ResolveConstTimeZone(arguments, 2));
+    }
+    case FunctionKind::kFormatTime:
+      return std::make_unique<FormatTimeFunction>(
+          CompileConstFormat<DateTimeFormatter>(arguments,
+                                                DateTimeFormatTarget::kTime,
+                                                kFormatDateTimestampOptions),
+          kind, output_type);
+    case FunctionKind::kParseDate:
+      return std::make_unique<ParseDateFunction>(
+          CompileConstFormat<DateTimeParser>(arguments,
+                                             DateTimeFormatTarget::kDate,
+                                             /*parse_version2=*/true),
+          kind, output_type);
+    case FunctionKind::kParseDatetime:
+      return std::make_unique<ParseDatetimeFunction>(
+          CompileConstFormat<DateTimeParser>(arguments,
+                                             DateTimeFormatTarget::kDatetime,
+                                             /*parse_version2=*/true),
+          kind, output_type);
+    case FunctionKind::kParseTime:
+      return std::make_unique<ParseTimeFunction>(
+          CompileConstFormat<DateTimeParser>(arguments,
+                                             DateTimeFormatTarget::kTime,
+                                             /*parse_version2=*/true),
+          kind, output_type);
+    case FunctionKind::kParseTimestamp:
+      return std::make_unique<ParseTimestampFunction>(
+          CompileConstFormat<DateTimeParser>(arguments,
+                                             DateTimeFormatTarget::kTimestamp,
+                                             /*parse_version2=*/true),
+          kind, output_type, ResolveConstTimeZone(arguments, 2));
+    default:
+      ZETASQL_RET_CHECK_FAIL() << "Unexpected function kind: "
+                       << static_cast<int>(kind);
+  }
+}
+
 bool BuiltinScalarFunction::HasNulls(absl::Span<const Value> args) {
   for (const auto& value : args) {
     if (value.is_null()) return true;
@@ -8848,37 +8975,37 @@ absl::StatusOr<Value> FormatDateDatetimeTimestampFunction::Eval(
   ABSL_DCHECK_LE(args.size(), 3);
   if (HasNulls(args)) return Value::Null(output_type());
   std::string result_string;
+  std::optional<functions::DateTimeFormatter> format;
   switch (args[1].type_kind()) {
     case TYPE_DATE:
-      ZETASQL_RETURN_IF_ERROR(functions::FormatDateToString(
-          args[0].string_value(), args[1].date_value(),
-          {.expand_Q = true, .expand_J = true}, &result_string));
+      ZETASQL_RETURN_IF_ERROR(
+          GetFormat(args[0].string_value(), &format,
+                    functions::DateTimeFormatTarget::kDate,
+                    kFormatDateTimestampOptions)
+              ->FormatDate(args[1].date_value(), &result_string));
       break;
     case TYPE_DATETIME:
-      ZETASQL_RETURN_IF_ERROR(functions::FormatDatetimeToStringWithOptions(
-          args[0].string_value(), args[1].datetime_value(),
-          {.expand_Q = true, .expand_J = true}, &result_string));
+      ZETASQL_RETURN_IF_ERROR(
+          GetFormat(args[0].string_value(), &format,
+                    functions::DateTimeFormatTarget::kDatetime,
+                    kFormatDateTimestampOptions)
+              ->FormatDatetime(args[1].datetime_value(), &result_string));
       break;
     case TYPE_TIMESTAMP: {
-      if (args.size() == 2) {
-        ZETASQL_RETURN_IF_ERROR(functions::FormatTimestampToString(
-            args[0].string_value(),
-            context->GetLanguageOptions().LanguageFeatureEnabled(
-                FEATURE_TIMESTAMP_NANOS)
-                ? args[1].ToTime()
-                : absl::FromUnixMicros(args[1].ToUnixMicros()),
-            context->GetDefaultTimeZone(), {.expand_Q = true, .expand_J = true},
-            &result_string));
-      } else {
-        ZETASQL_RETURN_IF_ERROR(functions::FormatTimestampToString(
-            args[0].string_value(),
-            context->GetLanguageOptions().LanguageFeatureEnabled(
-                FEATURE_TIMESTAMP_NANOS)
-                ? args[1].ToTime()
-                : absl::FromUnixMicros(args[1].ToUnixMicros()),
-            args[2].string_value(), {.expand_Q = true, .expand_J = true},
-            &result_string));
+      absl::TimeZone timezone = context->GetDefaultTimeZone();
+      if (args.size() == 3) {
+        ZETASQL_RETURN_IF_ERROR(GetTimeZone(args[2].string_value(), &timezone));
       }
+      ZETASQL_RETURN_IF_ERROR(
+          GetFormat(args[0].string_value(), &format,
+                    functions::DateTimeFormatTarget::kTimestamp,
+                    kFormatDateTimestampOptions)
+              ->FormatTimestamp(
+                  context->GetLanguageOptions().LanguageFeatureEnabled(
+                      FEATURE_TIMESTAMP_NANOS)
+                      ? args[1].ToTime()
+                      : absl::FromUnixMicros(args[1].ToUnixMicros()),
+                  timezone, &result_string));
       break;
     }
     default:
@@ -8895,8 +9022,11 @@ absl::StatusOr<Value> FormatTimeFunction::Eval(
   ABSL_DCHECK_EQ(args.size(), 2);
   if (HasNulls(args)) return Value::Null(output_type());
   std::string result_string;
-  ZETASQL_RETURN_IF_ERROR(functions::FormatTimeToString(
-      args[0].string_value(), args[1].time_value(), &result_string));
+  std::optional<functions::DateTimeFormatter> format;
+  ZETASQL_RETURN_IF_ERROR(GetFormat(args[0].string_value(), &format,
+                            functions::DateTimeFormatTarget::kTime,
+                            kFormatDateTimestampOptions)
+                      ->FormatTime(args[1].time_value(), &result_string));
   return Value::String(result_string);
 }
 
@@ -8908,8 +9038,10 @@ absl::StatusOr<Value> TimestampConversionFunction::Eval(
     absl::Time timestamp;
     ZETASQL_RETURN_IF_ERROR(ValidateMicrosPrecision(args[0], context));
     if (args.size() == 2 && args[1].type()->IsString()) {
+      absl::TimeZone timezone;
+      ZETASQL_RETURN_IF_ERROR(GetTimeZone(args[1].string_value(), &timezone));
       ZETASQL_RETURN_IF_ERROR(functions::ConvertDatetimeToTimestamp(
-          args[0].datetime_value(), args[1].string_value(), &timestamp));
+          args[0].datetime_value(), timezone, &timestamp));
     } else if (args.size() == 1) {
       ZETASQL_RETURN_IF_ERROR(functions::ConvertDatetimeToTimestamp(
           args[0].datetime_value(), context->GetDefaultTimeZone(), &timestamp));
@@ -8920,9 +9052,11 @@ absl::StatusOr<Value> TimestampConversionFunction::Eval(
   } else if (!args.empty() && args[0].type()->IsString()) {
     int64_t timestamp_micros;
     if (args.size() == 2 && args[1].type()->IsString()) {
+      absl::TimeZone timezone;
+      ZETASQL_RETURN_IF_ERROR(GetTimeZone(args[1].string_value(), &timezone));
       ZETASQL_RETURN_IF_ERROR(functions::ConvertStringToTimestamp(
-          args[0].string_value(), args[1].string_value(),
-          functions::kMicroseconds, false, &timestamp_micros));
+          args[0].string_value(), timezone, functions::kMicroseconds, false,
+          &timestamp_micros));
     } else if (args.size() == 1) {
       ZETASQL_RETURN_IF_ERROR(functions::ConvertStringToTimestamp(
           args[0].string_value(), context->GetDefaultTimeZone(),
@@ -8934,9 +9068,11 @@ absl::StatusOr<Value> TimestampConversionFunction::Eval(
   } else if (!args.empty() && args[0].type()->IsDate()) {
     int64_t timestamp_micros;
     if (args.size() == 2 && args[1].type()->IsString()) {
+      absl::TimeZone timezone;
+      ZETASQL_RETURN_IF_ERROR(GetTimeZone(args[1].string_value(), &timezone));
       ZETASQL_RETURN_IF_ERROR(functions::ConvertDateToTimestamp(
-          args[0].date_value(), functions::kMicroseconds,
-          args[1].string_value(), &timestamp_micros));
+          args[0].date_value(), functions::kMicroseconds, timezone,
+          &timestamp_micros));
     } else if (args.size() == 1) {
       ZETASQL_RETURN_IF_ERROR(functions::ConvertDateToTimestamp(
           args[0].date_value(), functions::kMicroseconds,
@@ -8981,9 +9117,10 @@ absl::StatusOr<Value> CivilTimeConstructionAndConversionFunction::Eval(
             functions::DATE, args[0].datetime_value(), &date));
       } else if (!args.empty() && args[0].type()->IsTimestamp()) {
         if (args.size() == 2 && args[1].type()->IsString()) {
-          ZETASQL_RETURN_IF_ERROR(
-              functions::ExtractFromTimestamp(functions::DATE, args[0].ToTime(),
-                                              args[1].string_value(), &date));
+          absl::TimeZone timezone;
+          ZETASQL_RETURN_IF_ERROR(GetTimeZone(args[1].string_value(), &timezone));
+          ZETASQL_RETURN_IF_ERROR(functions::ExtractFromTimestamp(
+              functions::DATE, args[0].ToTime(), timezone, &date));
         } else if (args.size() == 1) {
           ZETASQL_RETURN_IF_ERROR(functions::ExtractFromTimestamp(
               functions::DATE, args[0].ToTime(), context->GetDefaultTimeZone(),
@@ -9020,8 +9157,10 @@ absl::StatusOr<Value> CivilTimeConstructionAndConversionFunction::Eval(
       } else if (!args.empty() && args[0].type()->IsTimestamp()) {
         ZETASQL_RETURN_IF_ERROR(ValidateMicrosPrecision(args[0], context));
         if (args.size() == 2 && args[1].type()->IsString()) {
+          absl::TimeZone timezone;
+          ZETASQL_RETURN_IF_ERROR(GetTimeZone(args[1].string_value(), &timezone));
           ZETASQL_RETURN_IF_ERROR(functions::ConvertTimestampToTime(
-              args[0].ToTime(), args[1].string_value(), &time));
+              args[0].ToTime(), timezone, &time));
         } else if (args.size() == 1) {
           ZETASQL_RETURN_IF_ERROR(functions::ConvertTimestampToTime(
               args[0].ToTime(), context->GetDefaultTimeZone(), &time));
@@ -9052,8 +9191,10 @@ absl::StatusOr<Value> CivilTimeConstructionAndConversionFunction::Eval(
       } else if (!args.empty() && args[0].type()->IsTimestamp()) {
         ZETASQL_RETURN_IF_ERROR(ValidateMicrosPrecision(args[0], context));
         if (args.size() == 2 && args[1].type()->IsString()) {
+          absl::TimeZone timezone;
+          ZETASQL_RETURN_IF_ERROR(GetTimeZone(args[1].string_value(), &timezone));
           ZETASQL_RETURN_IF_ERROR(functions::ConvertTimestampToDatetime(
-              args[0].ToTime(), args[1].string_value(), &datetime));
+              args[0].ToTime(), timezone, &datetime));
         } else if (args.size() == 1) {
           ZETASQL_RETURN_IF_ERROR(functions::ConvertTimestampToDatetime(
               args[0].ToTime(), context->GetDefaultTimeZone(), &datetime));
@@ -9231,10 +9372,12 @@ absl::StatusOr<Value> ParseDateFunction::Eval(
     EvaluationContext* context) const {
   ABSL_DCHECK_EQ(args.size(), 2);
   if (HasNulls(args)) return Value::Null(output_type());
+  std::optional<functions::DateTimeParser> format;
   int32_t date;
-  ZETASQL_RETURN_IF_ERROR(functions::ParseStringToDate(args[0].string_value(),
-                                               args[1].string_value(),
-                                               /*parse_version2=*/true, &date));
+  ZETASQL_RETURN_IF_ERROR(GetFormat(args[0].string_value(), &format,
+                            functions::DateTimeFormatTarget::kDate,
+                            /*parse_version2=*/true)
+                      ->ParseDate(args[1].string_value(), &date));
   return Value::Date(date);
 }
 
@@ -9243,11 +9386,15 @@ absl::StatusOr<Value> ParseDatetimeFunction::Eval(
     EvaluationContext* context) const {
   ABSL_DCHECK_EQ(args.size(), 2);
   if (HasNulls(args)) return Value::Null(output_type());
+  std::optional<functions::DateTimeParser> format;
   DatetimeValue datetime;
-  ZETASQL_RETURN_IF_ERROR(functions::ParseStringToDatetime(
-      args[0].string_value(), args[1].string_value(),
-      GetTimestampScale(context->GetLanguageOptions()), /*parse_version2=*/true,
-      &datetime));
+  ZETASQL_RETURN_IF_ERROR(
+      GetFormat(args[0].string_value(), &format,
+                functions::DateTimeFormatTarget::kDatetime,
+                /*parse_version2=*/true)
+          ->ParseDatetime(args[1].string_value(),
+                          GetTimestampScale(context->GetLanguageOptions()),
+                          &datetime));
   return Value::Datetime(datetime);
 }
 
@@ -9256,10 +9403,14 @@ absl::StatusOr<Value> ParseTimeFunction::Eval(
     EvaluationContext* context) const {
   ABSL_DCHECK_EQ(args.size(), 2);
   if (HasNulls(args)) return Value::Null(output_type());
+  std::optional<functions::DateTimeParser> format;
   TimeValue time;
-  ZETASQL_RETURN_IF_ERROR(functions::ParseStringToTime(
-      args[0].string_value(), args[1].string_value(),
-      GetTimestampScale(context->GetLanguageOptions()), &time));
+  ZETASQL_RETURN_IF_ERROR(
+      GetFormat(args[0].string_value(), &format,
+                functions::DateTimeFormatTarget::kTime,
+                /*parse_version2=*/true)
+          ->ParseTime(args[1].string_value(),
+                      GetTimestampScale(context->GetLanguageOptions()), &time));
   return Value::Time(time);
 }
 
@@ -9268,30 +9419,25 @@ absl::StatusOr<Value> ParseTimestampFunction::Eval(
     EvaluationContext* context) const {
   ZETASQL_RET_CHECK(args.size() == 2 || args.size() == 3);
   if (HasNulls(args)) return Value::Null(output_type());
+  absl::TimeZone timezone = context->GetDefaultTimeZone();
+  if (args.size() == 3) {
+    ZETASQL_RETURN_IF_ERROR(GetTimeZone(args[2].string_value(), &timezone));
+  }
+  std::optional<functions::DateTimeParser> format;
+  const functions::DateTimeParser* parser =
+      GetFormat(args[0].string_value(), &format,
+                functions::DateTimeFormatTarget::kTimestamp,
+                /*parse_version2=*/true);
   if (context->GetLanguageOptions().LanguageFeatureEnabled(
           FEATURE_TIMESTAMP_NANOS)) {
     absl::Time timestamp;
-    if (args.size() == 2) {
-      ZETASQL_RETURN_IF_ERROR(functions::ParseStringToTimestamp(
-          args[0].string_value(), args[1].string_value(),
-          context->GetDefaultTimeZone(), /*parse_version2=*/true, &timestamp));
-    } else {
-      ZETASQL_RETURN_IF_ERROR(functions::ParseStringToTimestamp(
-          args[0].string_value(), args[1].string_value(),
-          args[2].string_value(), /*parse_version2=*/true, &timestamp));
-    }
+    ZETASQL_RETURN_IF_ERROR(
+        parser->ParseTimestamp(args[1].string_value(), timezone, &timestamp));
     return Value::Timestamp(timestamp);
   } else {
     int64_t timestamp;
-    if (args.size() == 2) {
-      ZETASQL_RETURN_IF_ERROR(functions::ParseStringToTimestamp(
-          args[0].string_value(), args[1].string_value(),
-          context->GetDefaultTimeZone(), /*parse_version2=*/true, &timestamp));
-    } else {
-      ZETASQL_RETURN_IF_ERROR(functions::ParseStringToTimestamp(
-          args[0].string_value(), args[1].string_value(),
-          args[2].string_value(), /*parse_version2=*/true, &timestamp));
-    }
+    ZETASQL_RETURN_IF_ERROR(
+        parser->ParseTimestamp(args[1].string_value(), timezone, &timestamp));
     return Value::TimestampFromUnixMicros(timestamp);
   }
 }
@@ -9315,16 +9461,13 @@ absl::StatusOr<Value> DateTimeTruncFunction::Eval(
       return values::Date(date);
     }
     case TYPE_TIMESTAMP: {
-      int64_t int64_timestamp;
-      if (args.size() == 2) {
-        ZETASQL_RETURN_IF_ERROR(functions::TimestampTrunc(args[0].ToUnixMicros(),
-                                                  context->GetDefaultTimeZone(),
-                                                  part, &int64_timestamp));
-      } else {
-        ZETASQL_RETURN_IF_ERROR(functions::TimestampTrunc(args[0].ToUnixMicros(),
-                                                  args[2].string_value(), part,
-                                                  &int64_timestamp));
+      absl::TimeZone timezone = context->GetDefaultTimeZone();
+      if (args.size() == 3) {
+        ZETASQL_RETURN_IF_ERROR(GetTimeZone(args[2].string_value(), &timezone));
       }
+      int64_t int64_timestamp;
+      ZETASQL_RETURN_IF_ERROR(functions::TimestampTrunc(
+          args[0].ToUnixMicros(), timezone, part, &int64_timestamp));
       return Value::TimestampFromUnixMicros(int64_timestamp);
     }
     case TYPE_DATETIME: {
@@ -9769,18 +9912,17 @@ absl::StatusOr<Value> ExtractFromFunction::Eval(
           functions::ExtractFromDate(part, args[0].date_value(), &value32));
       return output_type()->IsInt64() ? Value::Int64(value32)
                                       : Value::Int32(value32);
-    case TYPE_TIMESTAMP:
-      if (args.size() == 2) {
-        ZETASQL_RETURN_IF_ERROR(functions::ExtractFromTimestamp(
-            part, args[0].ToUnixMicros(), functions::kMicroseconds,
-            context->GetDefaultTimeZone(), &value32));
-      } else {
-        ZETASQL_RETURN_IF_ERROR(functions::ExtractFromTimestamp(
-            part, args[0].ToUnixMicros(), functions::kMicroseconds,
-            args[2].string_value(), &value32));
+    case TYPE_TIMESTAMP: {
+      absl::TimeZone timezone = context->GetDefaultTimeZone();
+      if (args.size() == 3) {
+        ZETASQL_RETURN_IF_ERROR(GetTimeZone(args[2].string_value(), &timezone));
       }
+      ZETASQL_RETURN_IF_ERROR(functions::ExtractFromTimestamp(
+          part, args[0].ToUnixMicros(), functions::kMicroseconds, timezone,
+          &value32));
       return output_type()->IsInt64() ? Value::Int64(value32)
                                       : Value::Int32(value32);
+    }
     case TYPE_DATETIME:
       ZETASQL_RETURN_IF_ERROR(functions::ExtractFromDatetime(
           part, args[0].datetime_value(), &value32));
@@ -9811,15 +9953,13 @@ absl::StatusOr<Value> ExtractDateFromFunction::Eval(
   int32_t value32;
   switch (args[0].type_kind()) {
     case TYPE_TIMESTAMP: {
-      if (args.size() == 1) {
-        ZETASQL_RETURN_IF_ERROR(functions::ExtractFromTimestamp(
-            functions::DATE, args[0].ToUnixMicros(), functions::kMicroseconds,
-            context->GetDefaultTimeZone(), &value32));
-      } else {
-        ZETASQL_RETURN_IF_ERROR(functions::ExtractFromTimestamp(
-            functions::DATE, args[0].ToUnixMicros(), functions::kMicroseconds,
-            args[1].string_value(), &value32));
+      absl::TimeZone timezone = context->GetDefaultTimeZone();
+      if (args.size() == 2) {
+        ZETASQL_RETURN_IF_ERROR(GetTimeZone(args[1].string_value(), &timezone));
       }
+      ZETASQL_RETURN_IF_ERROR(functions::ExtractFromTimestamp(
+          functions::DATE, args[0].ToUnixMicros(), functions::kMicroseconds,
+          timezone, &value32));
       break;
     }
     case TYPE_DATETIME: {
@@ -9849,13 +9989,12 @@ absl::StatusOr<Value> ExtractTimeFromFunction::Eval(
           functions::ExtractTimeFromDatetime(args[0].datetime_value(), &time));
       break;
     case TYPE_TIMESTAMP: {
-      if (args.size() == 1) {
-        ZETASQL_RETURN_IF_ERROR(functions::ConvertTimestampToTime(
-            args[0].ToTime(), context->GetDefaultTimeZone(), &time));
-      } else {
-        ZETASQL_RETURN_IF_ERROR(functions::ConvertTimestampToTime(
-            args[0].ToTime(), args[1].string_value(), &time));
+      absl::TimeZone timezone = context->GetDefaultTimeZone();
+      if (args.size() == 2) {
+        ZETASQL_RETURN_IF_ERROR(GetTimeZone(args[1].string_value(), &timezone));
       }
+      ZETASQL_RETURN_IF_ERROR(
+          functions::ConvertTimestampToTime(args[0].ToTime(), timezone, &time));
       break;
     }
     default:
@@ -9872,14 +10011,13 @@ absl::StatusOr<Value> ExtractDatetimeFromFunction::Eval(
   if (args[0].is_null() || (args.size() == 2 && args[1].is_null())) {
     return Value::NullDatetime();
   }
-  DatetimeValue datetime;
-  if (args.size() == 1) {
-    ZETASQL_RETURN_IF_ERROR(functions::ConvertTimestampToDatetime(
-        args[0].ToTime(), context->GetDefaultTimeZone(), &datetime));
-  } else {
-    ZETASQL_RETURN_IF_ERROR(functions::ConvertTimestampToDatetime(
-        args[0].ToTime(), args[1].string_value(), &datetime));
+  absl::TimeZone timezone = context->GetDefaultTimeZone();
+  if (args.size() == 2) {
+    ZETASQL_RETURN_IF_ERROR(GetTimeZone(args[1].string_value(), &timezone));
   }
+  DatetimeValue datetime;
+  ZETASQL_RETURN_IF_ERROR(functions::ConvertTimestampToDatetime(args[0].ToTime(),
+                                                        timezone, &datetime));
   return Value::Datetime(datetime);
 }
 
@@ -21,6 +21,7 @@
 
 #include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -30,6 +31,7 @@
 #include "google/protobuf/descriptor.h"
 #include "zetasql/public/function.h"
 #include "zetasql/public/functions/date_time_util.h"
+#include "zetasql/public/functions/parse_date_time.h"
 #include "zetasql/public/functions/regexp.h"
 #include "zetasql/public/language_options.h"
 #include "zetasql/public/proto/type_annotation.pb.h"
@@ -46,6 +48,7 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "absl/types/span.h"
 #include "re2/re2.h"
 #include "zetasql/base/status.h"
@@ -558,6 +561,12 @@ class BuiltinScalarFunction : public ScalarFunctionBody {
       FunctionKind kind, const Type* output_type,
       const std::vector<std::unique_ptr<AlgebraArg>>& arguments);
 
+  // Creates a FORMAT_ or PARSE_ date/time function.
+  static absl::StatusOr<std::unique_ptr<BuiltinScalarFunction>>
+  CreateDateTimeFormatFunction(
+      FunctionKind kind, const Type* output_type,
+      const std::vector<std::unique_ptr<AlgebraArg>>& arguments);
+
   FunctionKind kind_;
 };
 
@@ -1386,17 +1395,85 @@ class DateTimeUnaryFunction : public SimpleBuiltinScalarFunction {
                              EvaluationContext* context) const override;
 };
 
-class FormatDateDatetimeTimestampFunction : public SimpleBuiltinScalarFunction {
+// Base class of functions with a time zone string argument.
+class TimeZoneArgumentFunction : public SimpleBuiltinScalarFunction {
  public:
-  using SimpleBuiltinScalarFunction::SimpleBuiltinScalarFunction;
+  // <const_timezone> is resolved at prepare time from a constant time zone
+  // argument, and holds the error if that is not a valid time zone; nullopt if
+  // the time zone argument is not constant or not present.
+  TimeZoneArgumentFunction(
+      FunctionKind kind, const Type* output_type,
+      std::optional<absl::StatusOr<absl::TimeZone>> const_timezone =
+          std::nullopt)
+      : SimpleBuiltinScalarFunction(kind, output_type),
+        const_timezone_(std::move(const_timezone)) {}
+
+ protected:
+  // Sets <timezone> to the time zone named by <timezone_string>, the value of
+  // the time zone argument.  Uses the constant time zone if there is one.
+  absl::Status GetTimeZone(absl::string_view timezone_string,
+                           absl::TimeZone* timezone) const {
+    if (!const_timezone_.has_value()) {
+      return functions::MakeTimeZone(timezone_string, timezone);
+    }
+    if (!const_timezone_->ok()) return const_timezone_->status();
+    *timezone = **const_timezone_;
+    return absl::OkStatus();
+  }
+
+ private:
+  const std::optional<absl::StatusOr<absl::TimeZone>> const_timezone_;
+};
+
+// Base class of the FORMAT_ and PARSE_ date/time functions, whose first
+// argument is a format string compiled into a <Compiled> (DateTimeFormatter or
+// DateTimeParser).
+template <typename Compiled>
+class DateTimeFormatFunction : public TimeZoneArgumentFunction {
+ public:
+  // <const_format> is compiled at prepare time from a constant format
+  // argument; null if the format argument is not constant.  <const_timezone>
+  // is as for TimeZoneArgumentFunction.
+  DateTimeFormatFunction(
+      std::unique_ptr<const Compiled> const_format, FunctionKind kind,
+      const Type* output_type,
+      std::optional<absl::StatusOr<absl::TimeZone>> const_timezone =
+          std::nullopt)
+      : TimeZoneArgumentFunction(kind, output_type, std::move(const_timezone)),
+        const_format_(std::move(const_format)) {}
+
+  DateTimeFormatFunction(const DateTimeFormatFunction&) = delete;
+  DateTimeFormatFunction& operator=(const DateTimeFormatFunction&) = delete;
+
+ protected:
+  // Returns the compiled <format_string>.  Uses the constant format if there
+  // is one, and otherwise compiles <format_string> and <args> into <storage>,
+  // which must outlive the returned format.
+  template <typename... Args>
+  const Compiled* GetFormat(absl::string_view format_string,
+                            std::optional<Compiled>* storage,
+                            Args&&... args) const {
+    if (const_format_ != nullptr) return const_format_.get();
+    return &storage->emplace(format_string, std::forward<Args>(args)...);
+  }
+
+ private:
+  const std::unique_ptr<const Compiled> const_format_;
+};
+
+class FormatDateDatetimeTimestampFunction
+    : public DateTimeFormatFunction<functions::DateTimeFormatter> {
+ public:
+  using DateTimeFormatFunction::DateTimeFormatFunction;
   absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
                              absl::Span<const Value> args,
                              EvaluationContext* context) const override;
 };
 
-class FormatTimeFunction : public SimpleBuiltinScalarFunction {
+class FormatTimeFunction
+    : public DateTimeFormatFunction<functions::DateTimeFormatter> {
  public:
-  using SimpleBuiltinScalarFunction::SimpleBuiltinScalarFunction;
+  using DateTimeFormatFunction::DateTimeFormatFunction;
   absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
                              absl::Span<const Value> args,
                              EvaluationContext* context) const override;
@@ -1450,33 +1527,37 @@ class EnumValueDescriptorProtoFunction : public SimpleBuiltinScalarFunction {
                              EvaluationContext* context) const override;
 };
 
-class ParseDateFunction : public SimpleBuiltinScalarFunction {
+class ParseDateFunction
+    : public DateTimeFormatFunction<functions::DateTimeParser> {
  public:
-  using SimpleBuiltinScalarFunction::SimpleBuiltinScalarFunction;
+  using DateTimeFormatFunction::DateTimeFormatFunction;
   absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
                              absl::Span<const Value> args,
                              EvaluationContext* context) const override;
 };
 
-class ParseDatetimeFunction : public SimpleBuiltinScalarFunction {
+class ParseDatetimeFunction
+    : public DateTimeFormatFunction<functions::DateTimeParser> {
  public:
-  using SimpleBuiltinScalarFunction::SimpleBuiltinScalarFunction;
+  using DateTimeFormatFunction::DateTimeFormatFunction;
   absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
                              absl::Span<const Value> args,
                              EvaluationContext* context) const override;
 };
 
-class ParseTimeFunction : public SimpleBuiltinScalarFunction {
+class ParseTimeFunction
+    : public DateTimeFormatFunction<functions::DateTimeParser> {
  public:
-  using SimpleBuiltinScalarFunction::SimpleBuiltinScalarFunction;
+  using DateTimeFormatFunction::DateTimeFormatFunction;
   absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
                              absl::Span<const Value> args,
                              EvaluationContext* context) const override;
 };
 
-class ParseTimestampFunction : public SimpleBuiltinScalarFunction {
+class ParseTimestampFunction
+    : public DateTimeFormatFunction<functions::DateTimeParser> {
  public:
-  using SimpleBuiltinScalarFunction::SimpleBuiltinScalarFunction;
+  using DateTimeFormatFunction::DateTimeFormatFunction;
   absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
                              absl::Span<const Value> args,
                              EvaluationContext* context) const override;
@@ -1490,9 +1571,9 @@ class DateTimeDiffFunction : public SimpleBuiltinScalarFunction {
                              EvaluationContext* context) const override;
 };
 
-class DateTimeTruncFunction : public SimpleBuiltinScalarFunction {
+class DateTimeTruncFunction : public TimeZoneArgumentFunction {
  public:
-  using SimpleBuiltinScalarFunction::SimpleBuiltinScalarFunction;
+  using TimeZoneArgumentFunction::TimeZoneArgumentFunction;
   absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
                              absl::Span<const Value> args,
                              EvaluationContext* context) const override;
@@ -1506,50 +1587,50 @@ class LastDayFunction : public SimpleBuiltinScalarFunction {
                              EvaluationContext* context) const override;
 };
 
-class ExtractFromFunction : public SimpleBuiltinScalarFunction {
+class ExtractFromFunction : public TimeZoneArgumentFunction {
  public:
-  using SimpleBuiltinScalarFunction::SimpleBuiltinScalarFunction;
+  using TimeZoneArgumentFunction::TimeZoneArgumentFunction;
   absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
                              absl::Span<const Value> args,
                              EvaluationContext* context) const override;
 };
 
-class TimestampConversionFunction : public SimpleBuiltinScalarFunction {
+class TimestampConversionFunction : public TimeZoneArgumentFunction {
  public:
-  using SimpleBuiltinScalarFunction::SimpleBuiltinScalarFunction;
+  using TimeZoneArgumentFunction::TimeZoneArgumentFunction;
   absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
                              absl::Span<const Value> args,
                              EvaluationContext* context) const override;
 };
 
 class CivilTimeConstructionAndConversionFunction
-    : public SimpleBuiltinScalarFunction {
+    : public TimeZoneArgumentFunction {
  public:
-  using SimpleBuiltinScalarFunction::SimpleBuiltinScalarFunction;
+  using TimeZoneArgumentFunction::TimeZoneArgumentFunction;
   absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
                              absl::Span<const Value> args,
                              EvaluationContext* context) const override;
 };
 
-class ExtractDateFromFunction : public SimpleBuiltinScalarFunction {
+class ExtractDateFromFunction : public TimeZoneArgumentFunction {
  public:
-  using SimpleBuiltinScalarFunction::SimpleBuiltinScalarFunction;
+  using TimeZoneArgumentFunction::TimeZoneArgumentFunction;
   absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
                              absl::Span<const Value> args,
                              EvaluationContext* context) const override;
 };
 
-class ExtractTimeFromFunction : public SimpleBuiltinScalarFunction {
+class ExtractTimeFromFunction : public TimeZoneArgumentFunction {
  public:
-  using SimpleBuiltinScalarFunction::SimpleBuiltinScalarFunction;
+  using TimeZoneArgumentFunction::TimeZoneArgumentFunction;
   absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
                              absl::Span<const Value> args,
                              EvaluationContext* context) const override;
 };
 
-class ExtractDatetimeFromFunction : public SimpleBuiltinScalarFunction {
+class ExtractDatetimeFromFunction : public TimeZoneArgumentFunction {
  public:
-  using SimpleBuiltinScalarFunction::SimpleBuiltinScalarFunction;
+  using TimeZoneArgumentFunction::TimeZoneArgumentFunction;
   absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
                              absl::Span<const Value> args,
                              EvaluationContext* context) const override;
@@ -723,6 +723,22 @@ class TreeGenerator(object):
         classes.append('%s.%s' % (name, enum_type.name))
     return classes
 
+  def _MessageScalarTypes(self):
+    """Returns the distinct ScalarTypes that are stored as proto messages.
+
+    These are the scalar field types without a proto setter, other than Type
+    and ResolvedColumn, which ResolvedASTBinarySerializer stores in tables of
+    their own.  The binary serializer falls back to their proto encoding.
+    """
+    types = {}
+    for node in self.nodes:
+      for field in node['fields']:
+        ctype = field['ctype']
+        if (isinstance(ctype, ScalarType) and not ctype.has_proto_setter and
+            ctype.ctype not in ('const Type*', 'ResolvedColumn')):
+          types.setdefault(ctype.ctype, ctype)
+    return [types[name] for name in sorted(types)]
+
   def _GetNodeByName(self, name):
     return self.node_map[name]
 
@@ -918,6 +934,7 @@ class TreeGenerator(object):
         'root_node_name': ROOT_NODE_NAME,
         'root_child_nodes': self.root_child_nodes,
         'java_enum_classes': self._JavaEnumClasses(),
+        'message_scalar_types': self._MessageScalarTypes(),
         'timestamp': time.ctime(),
     }
     assert len(input_file_paths) == len(output_file_paths)
@@ -16,6 +16,7 @@
 
 #include "zetasql/resolved_ast/query_expression.h"
 
+#include <cstddef>
 #include <map>
 #include <memory>
 #include <string>
@@ -34,25 +35,35 @@
 
 namespace zetasql {
 
-// Joins entries present in <list> (with pairs as elements) separated by
-// <delimiter>. While appending each pair we add the second element (if present)
-// as an alias to the first element.
-static std::string JoinListWithAliases(
+// Appends entries present in <list> (with pairs as elements) to <output>,
+// separated by <delimiter>. While appending each pair we add the second element
+// (if present) as an alias to the first element.
+static void AppendListWithAliases(
     const std::vector<std::pair<std::string, std::string>>& list,
-    absl::string_view delimiter) {
-  std::string list_str;
+    absl::string_view delimiter, std::string* output) {
   bool first = true;
   for (const auto& entry : list) {
-    if (!first) absl::StrAppend(&list_str, delimiter);
+    if (!first) absl::StrAppend(output, delimiter);
 
     if (entry.second.empty()) {
-      absl::StrAppend(&list_str, entry.first);
+      absl::StrAppend(output, entry.first);
     } else {
-      absl::StrAppend(&list_str, entry.first, " AS ", entry.second);
+      absl::StrAppend(output, entry.first, " AS ", entry.second);
     }
     first = false;
   }
-  return list_str;
+}
+
+// Returns the total length of the strings in <list>, plus <per_entry_overhead>
+// for each entry.
+static size_t ListWithAliasesSize(
+    const std::vector<std::pair<std::string, std::string>>& list,
+    size_t per_entry_overhead) {
+  size_t size = 0;
+  for (const auto& entry : list) {
+    size += entry.first.size() + entry.second.size() + per_entry_overhead;
+  }
+  return size;
 }
 
 absl::StatusOr<QueryExpression::QueryType> QueryExpression::GetQueryType()
@@ -86,6 +97,8 @@ void QueryExpression::ClearAllClauses() {
   select_as_modifier_.clear();
   query_hints_.clear();
   from_.clear();
+  wrapped_query_.reset();
+  wrapped_alias_.clear();
   where_.clear();
   set_op_type_.clear();
   set_op_modifier_.clear();
@@ -93,6 +106,8 @@ void QueryExpression::ClearAllClauses() {
   set_op_scan_list_.clear();
   corresponding_set_op_output_column_list_.clear();
   group_by_list_.clear();
+  rollup_column_id_list_.clear();
+  grouping_set_id_list_.clear();
   group_by_hints_.clear();
   order_by_list_.clear();
   order_by_hints_.clear();
@@ -104,34 +119,76 @@ void QueryExpression::ClearAllClauses() {
   unpivot_.clear();
 }
 
+size_t QueryExpression::SQLQuerySizeHint() const {
+  // Every clause adds a keyword and a few separators on top of its text; the
+  // constant below covers the longest of those ("WITH RECURSIVE ", " GROUP BY
+  // GROUPING SETS(", ...) so that the hint is rarely an underestimate.
+  constexpr size_t kClauseOverhead = 24;
+  size_t size = ListWithAliasesSize(with_list_, /*per_entry_overhead=*/6) +
+                ListWithAliasesSize(select_list_, /*per_entry_overhead=*/6) +
+                anonymization_options_.size() + query_hints_.size() +
+                select_as_modifier_.size() + from_.size() + pivot_.size() +
+                unpivot_.size() + where_.size() + group_by_hints_.size() +
+                order_by_hints_.size() + limit_.size() + offset_.size() +
+                kClauseOverhead * 8;
+  if (wrapped_query_ != nullptr) {
+    size += wrapped_query_->SQLQuerySizeHint() + wrapped_alias_.size() +
+            kClauseOverhead;
+  }
+  for (const auto& qe : set_op_scan_list_) {
+    size += qe->SQLQuerySizeHint() + set_op_type_.size() +
+            set_op_modifier_.size() + set_op_column_match_mode_.size() +
+            query_hints_.size() + select_as_modifier_.size() + kClauseOverhead;
+  }
+  for (const auto& [column_id, sql] : group_by_list_) {
+    // A group by column may be repeated across grouping sets; this does not
+    // try to account for that.
+    size += sql.size() + 2;
+  }
+  for (const std::string& order_by : order_by_list_) {
+    size += order_by.size() + 2;
+  }
+  return size;
+}
+
 std::string QueryExpression::GetSQLQuery() const {
   std::string sql;
+  sql.reserve(SQLQuerySizeHint());
+  AppendSQLQuery(&sql);
+  return sql;
+}
+
+void QueryExpression::AppendSQLQuery(std::string* output) const {
+  std::string& sql = *output;
   if (!with_list_.empty()) {
     absl::StrAppend(&sql, "WITH ");
     if (with_recursive_) {
       absl::StrAppend(&sql, "RECURSIVE ");
     }
-    absl::StrAppend(&sql, JoinListWithAliases(with_list_, ", "), " ");
+    AppendListWithAliases(with_list_, ", ", &sql);
+    absl::StrAppend(&sql, " ");
   }
   if (!select_list_.empty()) {
     ABSL_DCHECK(set_op_type_.empty() && set_op_modifier_.empty() &&
            set_op_scan_list_.empty());
-    absl::StrAppend(&sql, "SELECT ",
-                    anonymization_options_.empty()
-                        ? ""
-                        : absl::StrCat(anonymization_options_, " "),
-                    query_hints_.empty() ? "" : absl::StrCat(query_hints_, " "),
-                    select_as_modifier_.empty()
-                        ? ""
-                        : absl::StrCat(select_as_modifier_, " "),
-                    JoinListWithAliases(select_list_, ", "));
+    absl::StrAppend(&sql, "SELECT ");
+    if (!anonymization_options_.empty()) {
+      absl::StrAppend(&sql, anonymization_options_, " ");
+    }
+    if (!query_hints_.empty()) {
+      absl::StrAppend(&sql, query_hints_, " ");
+    }
+    if (!select_as_modifier_.empty()) {
+      absl::StrAppend(&sql, select_as_modifier_, " ");
+    }
+    AppendListWithAliases(select_list_, ", ", &sql);
   }
 
   if (!set_op_scan_list_.empty()) {
     ABSL_DCHECK(!set_op_type_.empty());
     ABSL_DCHECK(!set_op_modifier_.empty());
     ABSL_DCHECK(select_list_.empty());
-    ABSL_DCHECK(from_.empty() && where_.empty() && group_by_list_.empty());
+    ABSL_DCHECK(!HasFromClause() && where_.empty() && group_by_list_.empty());
     for (int i = 0; i < set_op_scan_list_.size(); ++i) {
       QueryExpression* qe = set_op_scan_list_[i].get();
       if (!select_as_modifier_.empty()) {
@@ -151,11 +208,18 @@ std::string QueryExpression::GetSQLQuery() const {
           absl::StrAppend(&sql, " ", set_op_column_match_mode_);
         }
       }
-      absl::StrAppend(&sql, "(", qe->GetSQLQuery(), ")");
+      // Nested queries are written straight into <output> rather than built
+      // up separately and copied in.
+      absl::StrAppend(&sql, "(");
+      qe->AppendSQLQuery(&sql);
+      absl::StrAppend(&sql, ")");
     }
   }
 
-  if (!from_.empty()) {
+  if (wrapped_query_ != nullptr) {
+    absl::StrAppend(&sql, " FROM ");
+    AppendWrappedQuery(&sql);
+  } else if (!from_.empty()) {
     absl::StrAppend(&sql, " FROM ", from_);
   }
 
@@ -171,10 +235,11 @@ std::string QueryExpression::GetSQLQuery() const {
   }
 
   if (!group_by_list_.empty()) {
-    absl::StrAppend(
-        &sql, " GROUP ",
-        group_by_hints_.empty() ? "" : absl::StrCat(group_by_hints_, " "),
-        "BY ");
+    absl::StrAppend(&sql, " GROUP ");
+    if (!group_by_hints_.empty()) {
+      absl::StrAppend(&sql, group_by_hints_, " ");
+    }
+    absl::StrAppend(&sql, "BY ");
     // Legacy ROLLUP
     if (!rollup_column_id_list_.empty()) {
       absl::StrAppend(
@@ -255,22 +320,25 @@ std::string QueryExpression::GetSQLQuery() const {
     } else {
       // We assume while iterating the group_by_list_, the entries will be
       // sorted by the column id.
-      absl::StrAppend(
-          &sql,
-          absl::StrJoin(
-              group_by_list_, ", ",
-              [](std::string* out,
-                 const std::pair<int, std::string>& column_id_and_string) {
-                absl::StrAppend(out, column_id_and_string.second);
-              }));
+      bool first = true;
+      for (const auto& [column_id, group_by_sql] : group_by_list_) {
+        absl::StrAppend(&sql, first ? "" : ", ", group_by_sql);
+        first = false;
+      }
     }
   }
 
   if (!order_by_list_.empty()) {
-    absl::StrAppend(
-        &sql, " ORDER ",
-        order_by_hints_.empty() ? "" : absl::StrCat(order_by_hints_, " "),
-        "BY ", absl::StrJoin(order_by_list_, ", "));
+    absl::StrAppend(&sql, " ORDER ");
+    if (!order_by_hints_.empty()) {
+      absl::StrAppend(&sql, order_by_hints_, " ");
+    }
+    absl::StrAppend(&sql, "BY ");
+    bool first = true;
+    for (const std::string& order_by : order_by_list_) {
+      absl::StrAppend(&sql, first ? "" : ", ", order_by);
+      first = false;
+    }
   }
 
   if (!limit_.empty()) {
@@ -280,8 +348,6 @@ std::string QueryExpression::GetSQLQuery() const {
   if (!offset_.empty()) {
     absl::StrAppend(&sql, " OFFSET ", offset_);
   }
-
-  return sql;
 }
 
 bool QueryExpression::CanFormSQLQuery() const {
@@ -291,9 +357,64 @@ bool QueryExpression::CanFormSQLQuery() const {
 void QueryExpression::Wrap(absl::string_view alias) {
   ABSL_DCHECK(CanFormSQLQuery());
   ABSL_DCHECK(!alias.empty());
-  const std::string sql = GetSQLQuery();
-  ClearAllClauses();
-  from_ = absl::StrCat("(", sql, ") AS ", alias);
+  auto wrapped_query = std::make_unique<QueryExpression>();
+  wrapped_query->MoveClausesFrom(this);
+  wrapped_query_ = std::move(wrapped_query);
+  wrapped_alias_ = std::string(alias);
+}
+
+void QueryExpression::MoveClausesFrom(QueryExpression* other) {
+  with_list_ = std::move(other->with_list_);
+  with_recursive_ = other->with_recursive_;
+  select_list_ = std::move(other->select_list_);
+  corresponding_set_op_output_column_list_ =
+      std::move(other->corresponding_set_op_output_column_list_);
+  select_as_modifier_ = std::move(other->select_as_modifier_);
+  query_hints_ = std::move(other->query_hints_);
+  from_ = std::move(other->from_);
+  wrapped_query_ = std::move(other->wrapped_query_);
+  wrapped_alias_ = std::move(other->wrapped_alias_);
+  where_ = std::move(other->where_);
+  set_op_type_ = std::move(other->set_op_type_);
+  set_op_modifier_ = std::move(other->set_op_modifier_);
+  set_op_column_match_mode_ = std::move(other->set_op_column_match_mode_);
+  set_op_scan_list_ = std::move(other->set_op_scan_list_);
+  group_by_list_ = std::move(other->group_by_list_);
+  rollup_column_id_list_ = std::move(other->rollup_column_id_list_);
+  grouping_set_id_list_ = std::move(other->grouping_set_id_list_);
+  group_by_hints_ = std::move(other->group_by_hints_);
+  order_by_list_ = std::move(other->order_by_list_);
+  order_by_hints_ = std::move(other->order_by_hints_);
+  limit_ = std::move(other->limit_);
+  offset_ = std::move(other->offset_);
+  anonymization_options_ = std::move(other->anonymization_options_);
+  pivot_ = std::move(other->pivot_);
+  unpivot_ = std::move(other->unpivot_);
+  // Moved-from strings and containers are only valid, not necessarily empty.
+  other->ClearAllClauses();
+}
+
+void QueryExpression::AppendWrappedQuery(std::string* output) const {
+  absl::StrAppend(output, "(");
+  wrapped_query_->AppendSQLQuery(output);
+  absl::StrAppend(output, ") AS ", wrapped_alias_);
+}
+
+const std::string QueryExpression::FromClause() const {
+  if (wrapped_query_ == nullptr) return from_;
+  std::string from;
+  from.reserve(wrapped_query_->SQLQuerySizeHint() + wrapped_alias_.size() + 6);
+  AppendWrappedQuery(&from);
+  return from;
+}
+
+std::string* QueryExpression::MutableFromClause() {
+  if (wrapped_query_ != nullptr) {
+    from_ = FromClause();
+    wrapped_query_.reset();
+    wrapped_alias_.clear();
+  }
+  return &from_;
 }
 
 bool QueryExpression::TrySetWithClause(
@@ -17,6 +17,7 @@
 #ifndef ZETASQL_RESOLVED_AST_QUERY_EXPRESSION_H_
 #define ZETASQL_RESOLVED_AST_QUERY_EXPRESSION_H_
 
+#include <cstddef>
 #include <map>
 #include <memory>
 #include <string>
@@ -55,8 +56,20 @@ class QueryExpression {
 
   std::string GetSQLQuery() const;
 
+  // Appends the same text as GetSQLQuery() to <output>. Nested set operation
+  // inputs are appended in place, so a query is written out with no
+  // intermediate strings for its subqueries.
+  void AppendSQLQuery(std::string* output) const;
+
+  // Returns an estimate of the length of GetSQLQuery(), computed from the
+  // lengths of the clause texts without building the query. Callers use it to
+  // reserve their output buffer up front.
+  size_t SQLQuerySizeHint() const;
+
   // Mutates the QueryExpression, wrapping its previous form as a subquery in
-  // the from_ clause, with the given <alias>.
+  // the FROM clause, with the given <alias>. The previous form is kept as a
+  // QueryExpression, so its text is only written out by GetSQLQuery() or
+  // AppendSQLQuery() (or FromClause()), not at every level of nesting.
   void Wrap(absl::string_view alias);
 
   // The below TrySet... methods return true if we are able to set the concerned
@@ -108,7 +121,9 @@ class QueryExpression {
   // inside the QueryExpression. Otherwise false.
   bool HasWithClause() const { return !with_list_.empty(); }
   bool HasSelectClause() const { return !select_list_.empty(); }
-  bool HasFromClause() const { return !from_.empty(); }
+  bool HasFromClause() const {
+    return !from_.empty() || wrapped_query_ != nullptr;
+  }
   bool HasWhereClause() const { return !where_.empty(); }
   bool HasSetOpScanList() const { return !set_op_scan_list_.empty(); }
   bool HasGroupByClause() const { return !group_by_list_.empty(); }
@@ -123,7 +138,7 @@ class QueryExpression {
 
   void ResetSelectClause();
 
-  const std::string FromClause() const { return from_; }
+  const std::string FromClause() const;
 
   // Returns an immutable reference to select_list_. For QueryExpression built
   // from a SetOp scan, it returns the select_list_ of its first subquery.
@@ -149,8 +164,9 @@ class QueryExpression {
 
   // Returns a mutable pointer to the from_ clause of QueryExpression. Used
   // while building sql for a sample scan so as to rewrite the from_ clause to
-  // include the TABLESAMPLE clause.
-  std::string* MutableFromClause() { return &from_; }
+  // include the TABLESAMPLE clause. A subquery added by Wrap() is written out
+  // into the clause text first.
+  std::string* MutableFromClause();
 
   // Returns a mutable pointer to the select_list_ of QueryExpression. Used
   // while building sql for a sample scan that has a WITH WEIGHT clause.
@@ -166,6 +182,13 @@ class QueryExpression {
  private:
   void ClearAllClauses();
 
+  // Moves all the clauses of <other> into this QueryExpression, which must
+  // have none, and leaves <other> with none.
+  void MoveClausesFrom(QueryExpression* other);
+
+  // Appends "(<wrapped_query_>) AS <wrapped_alias_>" to <output>.
+  void AppendWrappedQuery(std::string* output) const;
+
   // Fields below define the text associated with different clauses of a SQL
   // query. Some principles:
   // * The text does not include the keyword corresponding to the clause.
@@ -191,6 +214,10 @@ class QueryExpression {
   std::string query_hints_;
 
   std::string from_;
+  // Set by Wrap() instead of <from_>: the FROM clause is this query as a
+  // subquery, with alias <wrapped_alias_>.
+  std::unique_ptr<QueryExpression> wrapped_query_;
+  std::string wrapped_alias_;
   std::string where_;
 
   // Contains the keyword corresponding to the set operation (UNION | INTERSECT
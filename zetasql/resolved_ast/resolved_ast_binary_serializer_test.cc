@@ -0,0 +1,188 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/resolved_ast/resolved_ast_binary_serializer.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "zetasql/base/testing/status_matchers.h"
+#include "zetasql/public/analyzer.h"
+#include "zetasql/public/analyzer_options.h"
+#include "zetasql/public/analyzer_output.h"
+#include "zetasql/public/id_string.h"
+#include "zetasql/public/language_options.h"
+#include "zetasql/public/options.pb.h"
+#include "zetasql/public/simple_catalog.h"
+#include "zetasql/public/type.h"
+#include "zetasql/public/value.pb.h"
+#include "zetasql/resolved_ast/resolved_ast.h"
+#include "zetasql/resolved_ast/resolved_node.h"
+#include "zetasql/resolved_ast/serialization.pb.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+
+namespace zetasql {
+namespace {
+
+using ::zetasql_base::testing::StatusIs;
+
+class ResolvedASTBinarySerializerTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    const Type* proto_type;
+    ZETASQL_ASSERT_OK(type_factory_.MakeProtoType(ValueProto::descriptor(),
+                                          &proto_type));
+    const Type* array_type;
+    ZETASQL_ASSERT_OK(
+        type_factory_.MakeArrayType(type_factory_.get_int64(), &array_type));
+    table_ = std::make_unique<SimpleTable>(
+        "t",
+        std::vector<SimpleTable::NameAndType>{
+            {"a", type_factory_.get_int64()},
+            {"b", type_factory_.get_string()},
+            {"arr", array_type},
+            {"p", proto_type}},
+        /*serialization_id=*/1);
+    catalog_.AddTable(table_.get());
+    catalog_.AddBuiltinFunctions(
+        BuiltinFunctionOptions::AllReleasedFunctions());
+
+    options_.mutable_language()->EnableMaximumLanguageFeatures();
+    options_.mutable_language()->SetSupportsAllStatementKinds();
+    options_.set_parse_location_record_type(
+        PARSE_LOCATION_RECORD_FULL_NODE_SCOPE);
+  }
+
+  std::unique_ptr<const AnalyzerOutput> Analyze(absl::string_view sql) {
+    std::unique_ptr<const AnalyzerOutput> output;
+    ZETASQL_EXPECT_OK(
+        AnalyzeStatement(sql, options_, &catalog_, &type_factory_, &output));
+    return output;
+  }
+
+  ResolvedNode::RestoreParams MakeRestoreParams(
+      const FileDescriptorSetMap& map) {
+    std::vector<const google::protobuf::DescriptorPool*> pools;
+    for (const auto& entry : map) pools.push_back(entry.first);
+    return ResolvedNode::RestoreParams(pools, &catalog_, &type_factory_,
+                                       &string_pool_);
+  }
+
+  TypeFactory type_factory_;
+  SimpleCatalog catalog_{"catalog"};
+  std::unique_ptr<SimpleTable> table_;
+  AnalyzerOptions options_;
+  IdStringPool string_pool_;
+};
+
+TEST_F(ResolvedASTBinarySerializerTest, Statements) {
+  const std::vector<std::string> statements = {
+      "SELECT a, b, a + 1 AS c FROM t WHERE a > 5 ORDER BY b DESC LIMIT 10",
+      "SELECT b, COUNT(*), SUM(DISTINCT a) FROM t GROUP BY b "
+      "HAVING COUNT(*) > 1",
+      "SELECT x, off FROM t, UNNEST(arr) AS x WITH OFFSET off",
+      "WITH q AS (SELECT a FROM t) SELECT * FROM q UNION ALL SELECT 1",
+      "SELECT ROW_NUMBER() OVER (PARTITION BY b ORDER BY a), "
+      "SUM(a) OVER (ORDER BY a ROWS BETWEEN 2 PRECEDING AND CURRENT ROW) "
+      "FROM t",
+      "SELECT CAST(a AS STRING), STRUCT(a, b AS y), [1, 2], p.int64_value, "
+      "IF(a IS NULL, 'x', b), (SELECT MAX(a) FROM t) FROM t",
+      "INSERT INTO t (a, b) VALUES (1, 'x'), (2, NULL)",
+      "UPDATE t SET a = a + 1 WHERE b = 'y'",
+      "DELETE FROM t WHERE a IN (1, 2, 3)",
+      "CREATE TEMP FUNCTION f(x INT64) AS (x + 1)",
+  };
+  for (const std::string& sql : statements) {
+    SCOPED_TRACE(sql);
+    std::unique_ptr<const AnalyzerOutput> output = Analyze(sql);
+    ASSERT_NE(output, nullptr);
+    const ResolvedStatement* statement = output->resolved_statement();
+
+    FileDescriptorSetMap map;
+    std::string serialized;
+    ZETASQL_ASSERT_OK(
+        ResolvedASTBinarySerializer::Serialize(statement, &map, &serialized));
+    ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ResolvedNode> deserialized,
+                         ResolvedASTBinarySerializer::Deserialize(
+                             serialized, MakeRestoreParams(map)));
+    // Unlike RestoreFrom(), parse locations are preserved, so the debug
+    // strings must match exactly.
+    EXPECT_EQ(statement->DebugString(), deserialized->DebugString());
+  }
+}
+
+TEST_F(ResolvedASTBinarySerializerTest, DoesNotMarkFieldsAccessed) {
+  std::unique_ptr<const AnalyzerOutput> output =
+      Analyze("SELECT a FROM t WHERE b = 'x'");
+  ASSERT_NE(output, nullptr);
+  output->resolved_statement()->ClearFieldsAccessed();
+
+  FileDescriptorSetMap map;
+  std::string serialized;
+  ZETASQL_ASSERT_OK(ResolvedASTBinarySerializer::Serialize(
+      output->resolved_statement(), &map, &serialized));
+  EXPECT_FALSE(output->resolved_statement()->CheckFieldsAccessed().ok());
+}
+
+TEST_F(ResolvedASTBinarySerializerTest, SmallerThanProto) {
+  std::unique_ptr<const AnalyzerOutput> output = Analyze(
+      "SELECT a, b, a + a * a, CONCAT(b, b) FROM t WHERE a = 1 AND b = 'x'");
+  ASSERT_NE(output, nullptr);
+
+  FileDescriptorSetMap map;
+  std::string serialized;
+  ZETASQL_ASSERT_OK(ResolvedASTBinarySerializer::Serialize(
+      output->resolved_statement(), &map, &serialized));
+  AnyResolvedStatementProto proto;
+  FileDescriptorSetMap proto_map;
+  ZETASQL_ASSERT_OK(output->resolved_statement()->SaveTo(&proto_map, &proto));
+  EXPECT_LT(serialized.size(), proto.ByteSizeLong());
+}
+
+TEST_F(ResolvedASTBinarySerializerTest, InvalidInput) {
+  FileDescriptorSetMap map;
+  EXPECT_THAT(
+      ResolvedASTBinarySerializer::Deserialize("", MakeRestoreParams(map)),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ResolvedASTBinarySerializer::Deserialize(
+                  "not a tree", MakeRestoreParams(map)),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  std::unique_ptr<const AnalyzerOutput> output =
+      Analyze("SELECT a FROM t WHERE b = 'z'");
+  ASSERT_NE(output, nullptr);
+  std::string serialized;
+  ZETASQL_ASSERT_OK(ResolvedASTBinarySerializer::Serialize(
+      output->resolved_statement(), &map, &serialized));
+  const ResolvedNode::RestoreParams params = MakeRestoreParams(map);
+
+  // Every truncation of a valid buffer is rejected.
+  for (int size = 0; size < serialized.size(); ++size) {
+    EXPECT_THAT(ResolvedASTBinarySerializer::Deserialize(
+                    absl::string_view(serialized).substr(0, size), params),
+                StatusIs(absl::StatusCode::kInvalidArgument))
+        << size;
+  }
+  EXPECT_THAT(ResolvedASTBinarySerializer::Deserialize(serialized + "x", params),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace zetasql
@@ -17,6 +17,7 @@
 #include "zetasql/resolved_ast/resolved_node.h"
 
 #include <algorithm>
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <queue>
@@ -24,6 +25,7 @@
 #include <string>
 #include <vector>
 
+#include "zetasql/base/arena.h"
 #include "zetasql/base/logging.h"
 #include "google/protobuf/descriptor.h"
 #include "zetasql/common/thread_stack.h"
@@ -53,6 +55,55 @@ namespace zetasql {
 
 // ResolvedNode::RestoreFrom is generated in resolved_node.cc.template.
 
+namespace {
+
+thread_local zetasql_base::UnsafeArena* current_node_arena = nullptr;
+
+// Every node allocation is prefixed with a header recording whether it came
+// from the heap or from an arena, so that operator delete knows whether to
+// free it.  The header is padded to keep the node maximally aligned.
+enum class NodeAllocation : char { kHeap, kArena };
+constexpr size_t kNodeHeaderSize = alignof(std::max_align_t);
+
+}  // namespace
+
+ResolvedNode::ArenaScope::ArenaScope(zetasql_base::UnsafeArena* arena)
+    : previous_arena_(current_node_arena) {
+  current_node_arena = arena;
+}
+
+ResolvedNode::ArenaScope::~ArenaScope() {
+  current_node_arena = previous_arena_;
+}
+
+zetasql_base::UnsafeArena* ResolvedNode::ArenaScope::current_arena() {
+  return current_node_arena;
+}
+
+void* ResolvedNode::operator new(size_t size) {
+  char* block;
+  NodeAllocation allocation;
+  if (current_node_arena != nullptr) {
+    block = static_cast<char*>(current_node_arena->AllocAligned(
+        kNodeHeaderSize + size, kNodeHeaderSize));
+    allocation = NodeAllocation::kArena;
+  } else {
+    block = static_cast<char*>(::operator new(kNodeHeaderSize + size));
+    allocation = NodeAllocation::kHeap;
+  }
+  *reinterpret_cast<NodeAllocation*>(block) = allocation;
+  return block + kNodeHeaderSize;
+}
+
+void ResolvedNode::operator delete(void* ptr) {
+  if (ptr == nullptr) return;
+  char* block = static_cast<char*>(ptr) - kNodeHeaderSize;
+  if (*reinterpret_cast<NodeAllocation*>(block) == NodeAllocation::kHeap) {
+    ::operator delete(block);
+  }
+  // Arena memory is released with the arena.
+}
+
 absl::Status ResolvedNode::Accept(ResolvedASTVisitor* visitor) const {
   return absl::OkStatus();
 }
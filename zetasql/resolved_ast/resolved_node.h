@@ -17,6 +17,7 @@
 #ifndef ZETASQL_RESOLVED_AST_RESOLVED_NODE_H_
 #define ZETASQL_RESOLVED_AST_RESOLVED_NODE_H_
 
+#include <cstddef>
 #include <memory>
 #include <set>
 #include <string>
@@ -36,6 +37,10 @@
 #include "absl/types/span.h"
 #include "zetasql/base/status.h"
 
+namespace zetasql_base {
+class UnsafeArena;
+}  // namespace zetasql_base
+
 namespace zetasql {
 
 class ResolvedASTVisitor;
@@ -63,6 +68,43 @@ class ResolvedNode {
   ResolvedNode& operator=(const ResolvedNode&) = delete;
   virtual ~ResolvedNode() {}
 
+  // Resolved nodes are normally allocated one at a time on the heap.  While an
+  // ArenaScope is live on the current thread, nodes created on that thread are
+  // instead allocated in its arena, which makes building a large tree cheaper
+  // and lets its memory be released in bulk with the arena.
+  //
+  // Nodes are still owned through std::unique_ptr, and deleting one still
+  // runs its destructor; only the memory of arena-allocated nodes is left to
+  // the arena.  A tree may mix heap and arena nodes, e.g. after rewriting an
+  // arena-allocated tree outside of the scope.
+  //
+  // Arena-allocated nodes must not outlive the arena.  The analyzer installs
+  // a scope when AnalyzerOptions::allocate_resolved_ast_in_arena() is set,
+  // and the AnalyzerOutput holding the tree keeps its arena alive.
+  //
+  // Scopes nest; the innermost one wins, and a scope with a NULL <arena>
+  // restores heap allocation.
+  class ArenaScope {
+   public:
+    explicit ArenaScope(zetasql_base::UnsafeArena* arena);
+    ~ArenaScope();
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+    // Returns the arena that nodes created on this thread are allocated in,
+    // or NULL if they are allocated on the heap.
+    static zetasql_base::UnsafeArena* current_arena();
+
+   private:
+    zetasql_base::UnsafeArena* const previous_arena_;
+  };
+
+  // Allocates in ArenaScope::current_arena() if set, and on the heap
+  // otherwise.  Array forms are not overridden since nodes are never
+  // allocated in arrays.
+  static void* operator new(size_t size);
+  static void operator delete(void* ptr);
+
   // Return this node's kind.
   // e.g. zetasql::RESOLVED_TABLE_SCAN for ResolvedTableScan.
   virtual ResolvedNodeKind node_kind() const = 0;
@@ -20,10 +20,12 @@
 #include <utility>
 #include <vector>
 
+#include "zetasql/base/arena.h"
 #include "zetasql/base/testing/status_matchers.h"
 #include "zetasql/public/types/type.h"
 #include "zetasql/public/types/type_factory.h"
 #include "zetasql/public/types/type_parameters.h"
+#include "zetasql/public/value.h"
 #include "zetasql/resolved_ast/resolved_ast.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -105,4 +107,42 @@ TEST(ResolvedColumnDefinitionTest, TestGetFullTypeParameters) {
             "[null,(max_length=10),[(precision=10,scale=5)],null]");
 }
 
+TEST(ResolvedNodeTest, ArenaScope) {
+  zetasql_base::UnsafeArena arena(/*block_size=*/1024);
+  zetasql_base::UnsafeArena other_arena(/*block_size=*/1024);
+  EXPECT_EQ(ResolvedNode::ArenaScope::current_arena(), nullptr);
+
+  std::unique_ptr<const ResolvedExpr> heap_literal =
+      MakeResolvedLiteral(Value::Int64(1));
+  std::vector<std::unique_ptr<const ResolvedExpr>> args;
+  std::unique_ptr<const ResolvedExpr> expr;
+  {
+    ResolvedNode::ArenaScope scope(&arena);
+    EXPECT_EQ(ResolvedNode::ArenaScope::current_arena(), &arena);
+    const size_t bytes_before = arena.status().bytes_allocated();
+    args.push_back(MakeResolvedLiteral(Value::Int64(2)));
+    EXPECT_GT(arena.status().bytes_allocated(), bytes_before);
+    {
+      // Nested scopes override the outer one, and a NULL arena restores heap
+      // allocation.
+      ResolvedNode::ArenaScope inner_scope(&other_arena);
+      EXPECT_EQ(ResolvedNode::ArenaScope::current_arena(), &other_arena);
+      args.push_back(MakeResolvedLiteral(Value::Int64(3)));
+      ResolvedNode::ArenaScope heap_scope(nullptr);
+      EXPECT_EQ(ResolvedNode::ArenaScope::current_arena(), nullptr);
+      args.push_back(std::move(heap_literal));
+    }
+    EXPECT_EQ(ResolvedNode::ArenaScope::current_arena(), &arena);
+    expr = MakeResolvedMakeStruct(types::EmptyStructType(), std::move(args));
+  }
+  EXPECT_EQ(ResolvedNode::ArenaScope::current_arena(), nullptr);
+  EXPECT_GT(other_arena.status().bytes_allocated(), 0);
+
+  // A tree mixing heap and arena nodes is used and deleted as usual.
+  EXPECT_EQ(expr->GetAs<ResolvedMakeStruct>()->field_list_size(), 3);
+  EXPECT_THAT(expr->DebugString(),
+              testing::HasSubstr("Literal(type=INT64, value=3)"));
+  expr.reset();
+}
+
 }  // namespace zetasql
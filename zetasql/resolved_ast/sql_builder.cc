@@ -1464,8 +1464,9 @@ absl::Status SQLBuilder::VisitResolvedSubqueryExpr(
       result->query_expression.release());
   ZETASQL_RETURN_IF_ERROR(AddSelectListIfNeeded(node->subquery()->column_list(),
                                         subquery_result.get()));
-  absl::StrAppend(&text, "(", subquery_result->GetSQLQuery(), ")",
-                  node->in_expr() == nullptr ? "" : ")");
+  absl::StrAppend(&text, "(");
+  subquery_result->AppendSQLQuery(&text);
+  absl::StrAppend(&text, ")", node->in_expr() == nullptr ? "" : ")");
 
   PushQueryFragment(node, text);
   return absl::OkStatus();
@@ -3869,7 +3870,7 @@ absl::Status SQLBuilder::VisitResolvedQueryStmt(const ResolvedQueryStmt* node) {
     ZETASQL_RET_CHECK_EQ(query_expression->SelectList().size(), 1);
     query_expression->SetSelectAsModifier("AS VALUE");
   }
-  absl::StrAppend(&sql, query_expression->GetSQLQuery());
+  query_expression->AppendSQLQuery(&sql);
 
   PushQueryFragment(node, sql);
   return absl::OkStatus();
@@ -4034,7 +4035,8 @@ absl::Status SQLBuilder::GetCreateViewStatement(
     ZETASQL_RET_CHECK_EQ(query_expression->SelectList().size(), 1);
     query_expression->SetSelectAsModifier("AS VALUE");
   }
-  absl::StrAppend(&sql, " AS ", query_expression->GetSQLQuery());
+  absl::StrAppend(&sql, " AS ");
+  query_expression->AppendSQLQuery(&sql);
 
   PushQueryFragment(node, sql);
   return absl::OkStatus();
@@ -4513,7 +4515,8 @@ absl::Status SQLBuilder::VisitResolvedCreateTableAsSelectStmt(
     ZETASQL_RET_CHECK_EQ(query_expression->SelectList().size(), 1);
     query_expression->SetSelectAsModifier(" AS VALUE");
   }
-  absl::StrAppend(&sql, " AS ", query_expression->GetSQLQuery());
+  absl::StrAppend(&sql, " AS ");
+  query_expression->AppendSQLQuery(&sql);
 
   PushQueryFragment(node, sql);
   return absl::OkStatus();
@@ -4653,15 +4656,17 @@ absl::Status SQLBuilder::VisitResolvedCreateModelStmt(
           ProcessQuery(resolved_aliased_query->query(),
                        resolved_aliased_query->output_column_list()));
       std::unique_ptr<QueryExpression> subquery_expression(subquery_result);
-      absl::StrAppend(&aliased_query_sql, " AS (",
-                      subquery_expression->GetSQLQuery(), ")");
+      absl::StrAppend(&aliased_query_sql, " AS (");
+      subquery_expression->AppendSQLQuery(&aliased_query_sql);
+      absl::StrAppend(&aliased_query_sql, ")");
       aliased_query_list_strs.push_back(aliased_query_sql);
     }
     absl::StrAppend(&sql, " AS (", absl::StrJoin(aliased_query_list_strs, ","),
                     ")");
   } else if (query_expression) {
     // Append SELECT statement.
-    absl::StrAppend(&sql, " AS ", query_expression->GetSQLQuery());
+    absl::StrAppend(&sql, " AS ");
+    query_expression->AppendSQLQuery(&sql);
   }
 
   PushQueryFragment(node, sql);
@@ -4836,7 +4841,8 @@ absl::Status SQLBuilder::VisitResolvedCreateMaterializedViewStmt(
       ZETASQL_RET_CHECK_EQ(query_expression->SelectList().size(), 1);
       query_expression->SetSelectAsModifier(" AS VALUE");
     }
-    absl::StrAppend(&sql, " AS ", query_expression->GetSQLQuery());
+    absl::StrAppend(&sql, " AS ");
+    query_expression->AppendSQLQuery(&sql);
   } else if (node->replica_source() != nullptr) {
     ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<QueryFragment> result,
                      ProcessNode(node->replica_source()));
@@ -5043,7 +5049,8 @@ absl::Status SQLBuilder::VisitResolvedCreateTableFunctionStmt(
     ZETASQL_ASSIGN_OR_RETURN(QueryExpression * query_result,
                      ProcessQuery(node->query(), node->output_column_list()));
     std::unique_ptr<QueryExpression> query_expression(query_result);
-    absl::StrAppend(&sql, " AS ", query_expression->GetSQLQuery());
+    absl::StrAppend(&sql, " AS ");
+    query_expression->AppendSQLQuery(&sql);
   } else if (!node->code().empty()) {
     if (is_external_language) {
       absl::StrAppend(&sql, " AS ", ToStringLiteral(node->code()));
@@ -5151,7 +5158,8 @@ absl::Status SQLBuilder::VisitResolvedExportDataStmt(
     ZETASQL_RET_CHECK_EQ(query_expression->SelectList().size(), 1);
     query_expression->SetSelectAsModifier("AS VALUE");
   }
-  absl::StrAppend(&sql, "AS ", query_expression->GetSQLQuery());
+  absl::StrAppend(&sql, "AS ");
+  query_expression->AppendSQLQuery(&sql);
 
   PushQueryFragment(node, sql);
   return absl::OkStatus();
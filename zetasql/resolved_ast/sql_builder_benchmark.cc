@@ -0,0 +1,111 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Benchmarks for regenerating SQL from resolved ASTs with SQLBuilder, over
+// deeply nested queries of the kind produced by query federation and
+// rewriters: stacked subqueries, long chains of set operations and wide
+// SELECT lists.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "zetasql/base/logging.h"
+#include "zetasql/public/analyzer.h"
+#include "zetasql/public/analyzer_options.h"
+#include "zetasql/public/analyzer_output.h"
+#include "zetasql/public/builtin_function_options.h"
+#include "zetasql/public/simple_catalog.h"
+#include "zetasql/public/type.h"
+#include "zetasql/resolved_ast/sql_builder.h"
+#include "benchmark/benchmark.h"
+#include "absl/strings/str_cat.h"
+
+namespace zetasql {
+namespace {
+
+// SELECT a + 1 AS a, b FROM (SELECT a + 1 AS a, b FROM (... FROM t) AS q0)
+// with <depth> levels of nesting.
+std::string MakeNestedSubqueries(int depth) {
+  std::string sql = "SELECT a, b FROM t";
+  for (int i = 0; i < depth; ++i) {
+    sql = absl::StrCat("SELECT a + 1 AS a, b FROM (", sql, ") AS q", i,
+                       " WHERE a > ", i);
+  }
+  return sql;
+}
+
+// SELECT a, b FROM t WHERE a = 0 UNION ALL (SELECT ... UNION ALL (...))
+// with <depth> levels of nesting.
+std::string MakeNestedSetOperations(int depth) {
+  std::string sql = "SELECT a, b FROM t";
+  for (int i = 0; i < depth; ++i) {
+    sql = absl::StrCat("SELECT a, b FROM t WHERE a = ", i, " UNION ALL (", sql,
+                       ")");
+  }
+  return sql;
+}
+
+// SELECT with <num_columns> computed columns.
+std::string MakeWideSelect(int num_columns) {
+  std::string sql = "SELECT ";
+  for (int i = 0; i < num_columns; ++i) {
+    absl::StrAppend(&sql, i == 0 ? "" : ", ", "a + ", i, " AS c", i);
+  }
+  absl::StrAppend(&sql, " FROM t");
+  return sql;
+}
+
+void RunSQLBuilder(benchmark::State& state, const std::string& sql) {
+  TypeFactory type_factory;
+  SimpleCatalog catalog("catalog", &type_factory);
+  catalog.AddOwnedTable(new SimpleTable(
+      "t", {{"a", type_factory.get_int64()}, {"b", type_factory.get_string()}}));
+  catalog.AddBuiltinFunctions(BuiltinFunctionOptions::AllReleasedFunctions());
+
+  AnalyzerOptions options;
+  std::unique_ptr<const AnalyzerOutput> output;
+  ZETASQL_CHECK_OK(AnalyzeStatement(sql, options, &catalog, &type_factory, &output));
+
+  int64_t bytes = 0;
+  for (auto s : state) {
+    SQLBuilder builder;
+    ZETASQL_CHECK_OK(builder.Process(*output->resolved_statement()));
+    std::string result = builder.sql();
+    bytes += result.size();
+    benchmark::DoNotOptimize(result);
+  }
+  state.SetBytesProcessed(bytes);
+}
+
+void BM_SQLBuilderNestedSubqueries(benchmark::State& state) {
+  RunSQLBuilder(state, MakeNestedSubqueries(state.range(0)));
+}
+BENCHMARK(BM_SQLBuilderNestedSubqueries)->Range(4, 256);
+
+void BM_SQLBuilderNestedSetOperations(benchmark::State& state) {
+  RunSQLBuilder(state, MakeNestedSetOperations(state.range(0)));
+}
+BENCHMARK(BM_SQLBuilderNestedSetOperations)->Range(4, 256);
+
+void BM_SQLBuilderWideSelect(benchmark::State& state) {
+  RunSQLBuilder(state, MakeWideSelect(state.range(0)));
+}
+BENCHMARK(BM_SQLBuilderWideSelect)->Range(16, 4 << 10);
+
+}  // namespace
+}  // namespace zetasql
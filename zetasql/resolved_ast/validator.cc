@@ -442,6 +442,9 @@ absl::Status Validator::ValidateResolvedFunctionCallBase(
 absl::Status Validator::ValidateStandaloneResolvedExpr(
     const ResolvedExpr* expr) {
   Reset();
+  if (options_.structural_validation_only) {
+    return ValidateResolvedNodeStructure(expr);
+  }
   const absl::Status status =
       ValidateResolvedExpr({} /* visible_columns */,
                            {} /* visible_parameters */,
@@ -2713,9 +2716,77 @@ void Validator::Reset() {
 absl::Status Validator::ValidateResolvedStatement(
     const ResolvedStatement* statement) {
   Reset();
+  if (options_.structural_validation_only) {
+    return ValidateResolvedNodeStructure(statement);
+  }
   return ValidateResolvedStatementInternal(statement);
 }
 
+absl::Status Validator::ValidateResolvedNodeStructure(
+    const ResolvedNode* root) {
+  VALIDATOR_RET_CHECK(nullptr != root);
+  absl::flat_hash_set<const ResolvedNode*> nodes_seen;
+  // Walk the tree with an explicit stack, so that deep trees don't run out of
+  // stack space.
+  std::vector<const ResolvedNode*> stack = {root};
+  std::vector<const ResolvedNode*> children;
+  absl::Status status;
+  while (!stack.empty()) {
+    const ResolvedNode* node = stack.back();
+    stack.pop_back();
+    status = ValidateNodeStructure(node, &nodes_seen);
+    if (!status.ok()) break;
+    children.clear();
+    node->GetChildNodes(&children);
+    stack.insert(stack.end(), children.begin(), children.end());
+  }
+  if (!status.ok()) {
+    return ::zetasql_base::InternalErrorBuilder()
+           << "Resolved AST validation failed: " << status.message() << "\n"
+           << root->DebugString({{error_context_, "(validation failed here)"}});
+  }
+  return absl::OkStatus();
+}
+
+absl::Status Validator::ValidateNodeStructure(
+    const ResolvedNode* node,
+    absl::flat_hash_set<const ResolvedNode*>* nodes_seen) {
+  PushErrorContext push(this, node);
+  VALIDATOR_RET_CHECK(nullptr != node);
+  VALIDATOR_RET_CHECK(nodes_seen->insert(node).second)
+      << "Node appears more than once in the tree: "
+      << node->node_kind_string();
+  if (!node->IsExpression()) {
+    return absl::OkStatus();
+  }
+  const ResolvedExpr* expr = node->GetAs<ResolvedExpr>();
+  VALIDATOR_RET_CHECK(expr->type() != nullptr)
+      << "ResolvedExpr does not have a Type";
+  if (expr->type_annotation_map() != nullptr) {
+    VALIDATOR_RET_CHECK(
+        expr->type_annotation_map()->HasCompatibleStructure(expr->type()));
+  }
+  if (!language_options_.LanguageFeatureEnabled(
+          FEATURE_V_1_3_COLLATION_SUPPORT)) {
+    VALIDATOR_RET_CHECK(
+        !CollationAnnotation::ExistsIn(expr->type_annotation_map()));
+  }
+  if (expr->Is<ResolvedFunctionCallBase>()) {
+    const ResolvedFunctionCallBase* call =
+        expr->GetAs<ResolvedFunctionCallBase>();
+    VALIDATOR_RET_CHECK(call->function() != nullptr)
+        << "ResolvedFunctionCall does not have a Function";
+    VALIDATOR_RET_CHECK(call->signature().IsConcrete())
+        << "ResolvedFunctionCall must have a concrete signature";
+    VALIDATOR_RET_CHECK(
+        call->type()->Equals(call->signature().result_type().type()))
+        << "Resolved function call type: " << call->type()->DebugString()
+        << ", signature result type: "
+        << call->signature().result_type().type()->DebugString();
+  }
+  return absl::OkStatus();
+}
+
 absl::Status Validator::ValidateResolvedStatementInternal(
     const ResolvedStatement* statement) {
   VALIDATOR_RET_CHECK(nullptr != statement);
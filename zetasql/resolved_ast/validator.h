@@ -53,6 +53,15 @@ struct ValidatorOptions {
   // are checked.
   // TODO: Add validation for non anonymization options and hints.
   AllowedHintsAndOptions allowed_hints_and_options;
+
+  // When set to true, only the structure of the tree is validated: every
+  // node appears once in the tree, every expression has a Type compatible
+  // with its annotations, and every function call has a Function and a
+  // concrete signature matching its Type.  This is a single pass over the
+  // tree that checks each node on its own, without tracking column
+  // visibility, so it is much cheaper than full validation.  It is meant for
+  // keeping some validation on where full validation is too expensive.
+  bool structural_validation_only = false;
 };
 
 // Used to validate generated Resolved AST structures.
@@ -73,6 +82,13 @@ class Validator {
   absl::Status ValidateStandaloneResolvedExpr(const ResolvedExpr* expr);
 
  private:
+  // Implements ValidatorOptions::structural_validation_only for the tree
+  // rooted at <root>.
+  absl::Status ValidateResolvedNodeStructure(const ResolvedNode* root);
+  absl::Status ValidateNodeStructure(
+      const ResolvedNode* node,
+      absl::flat_hash_set<const ResolvedNode*>* nodes_seen);
+
   // Statements.
   absl::Status ValidateResolvedStatementInternal(
       const ResolvedStatement* statement);
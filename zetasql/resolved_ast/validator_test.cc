@@ -411,6 +411,38 @@ TEST(ValidatorTest, InvalidStatementDueToDuplicateColumnIds) {
               StatusIs(absl::StatusCode::kInternal));
 }
 
+TEST(ValidatorTest, StructuralValidationOnly) {
+  IdStringPool pool;
+  TypeFactory type_factory;
+  Validator validator(LanguageOptions(),
+                      ValidatorOptions{.structural_validation_only = true});
+
+  // Column visibility is not checked.
+  std::unique_ptr<ResolvedQueryStmt> query_stmt =
+      MakeSelect1StmtWithWrongColumnId(pool);
+  ZETASQL_EXPECT_OK(validator.ValidateResolvedStatement(query_stmt.get()));
+  ResolvedColumn column(1, zetasql::IdString::MakeGlobal("tbl"),
+                        zetasql::IdString::MakeGlobal("col1"),
+                        types::Int64Type());
+  std::unique_ptr<ResolvedFunctionCall> expr = WrapInFunctionCall(
+      &type_factory, MakeResolvedLiteral(Value::Int64(1)),
+      MakeResolvedColumnRef(types::Int64Type(), column, false));
+  ZETASQL_EXPECT_OK(validator.ValidateStandaloneResolvedExpr(expr.get()));
+
+  // The structure of each node is still checked.
+  expr->set_type(types::StringType());
+  for (int i = 0; i < 2; ++i) {
+    absl::Status status = validator.ValidateStandaloneResolvedExpr(expr.get());
+    EXPECT_THAT(status, StatusIs(absl::StatusCode::kInternal,
+                                 HasSubstr("Resolved function call type: "
+                                           "STRING, signature result type: "
+                                           "INT64")));
+    EXPECT_THAT(status.message(),
+                HasSubstr("FunctionCall(test_group:test(INT64, INT64) -> "
+                          "INT64) (validation failed here)"));
+  }
+}
+
 TEST(ValidateTest, QueryStmtWithNullExpr) {
   IdStringPool pool;
   std::unique_ptr<ResolvedQueryStmt> query_stmt = MakeSelect1Stmt(pool);